@@ -18,14 +18,131 @@
 
 #include <boost/format.hpp>
 
+#include <phool/PHThreadPool.h>
+
+#include <algorithm>
 #include <cassert>  // for assert
 #include <cmath>
+#include <complex>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #define ALMOST_ZERO 0.00001
 
+namespace
+{
+  // discrete Fourier transform of fixed length, for the cyclic convolutions in phi.
+  // radix-2 for powers of two, Bluestein's chirp-z algorithm on top of it otherwise.
+  class PhiFFT
+  {
+   public:
+    using cplx = std::complex<double>;
+
+    explicit PhiFFT(int n)
+      : m_n(n)
+    {
+      m_size = 1;
+      while (m_size < n)
+      {
+        m_size *= 2;
+      }
+      if (m_size == n)
+      {
+        return;
+      }
+      // chirp w_k = exp(-i pi k^2/n), k^2 taken modulo 2n to keep the argument small
+      m_size = 1;
+      while (m_size < 2 * n - 1)
+      {
+        m_size *= 2;
+      }
+      m_chirp.resize(n);
+      for (long k = 0; k < n; ++k)
+      {
+        m_chirp[k] = std::polar(1., -M_PI * ((k * k) % (2 * n)) / n);
+      }
+      m_chirp_fft.assign(m_size, cplx(0, 0));
+      m_chirp_fft[0] = std::conj(m_chirp[0]);
+      for (int k = 1; k < n; ++k)
+      {
+        m_chirp_fft[k] = m_chirp_fft[m_size - k] = std::conj(m_chirp[k]);
+      }
+      radix2(m_chirp_fft, false);
+    }
+
+    // in place transform of data[0..n), not normalized.  work is a scratch buffer.
+    void transform(std::vector<cplx> &data, std::vector<cplx> &work, bool inverse) const
+    {
+      if (m_chirp.empty())
+      {
+        radix2(data, inverse);
+        return;
+      }
+      // the inverse is the conjugate of the forward transform of the conjugate
+      work.assign(m_size, cplx(0, 0));
+      for (int k = 0; k < m_n; ++k)
+      {
+        work[k] = (inverse ? std::conj(data[k]) : data[k]) * m_chirp[k];
+      }
+      radix2(work, false);
+      for (int k = 0; k < m_size; ++k)
+      {
+        work[k] *= m_chirp_fft[k];
+      }
+      radix2(work, true);
+      for (int k = 0; k < m_n; ++k)
+      {
+        const cplx value = work[k] * m_chirp[k] / double(m_size);
+        data[k] = inverse ? std::conj(value) : value;
+      }
+    }
+
+   private:
+    // iterative radix-2 transform of data[0..size), size a power of two
+    static void radix2(std::vector<cplx> &data, bool inverse)
+    {
+      const int size = data.size();
+      for (int i = 1, j = 0; i < size; ++i)
+      {
+        int bit = size >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+          j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+          std::swap(data[i], data[j]);
+        }
+      }
+      for (int len = 2; len <= size; len <<= 1)
+      {
+        const cplx wlen = std::polar(1., (inverse ? 2 : -2) * M_PI / len);
+        for (int i = 0; i < size; i += len)
+        {
+          cplx w(1, 0);
+          for (int k = 0; k < len / 2; ++k)
+          {
+            const cplx u = data[i + k];
+            const cplx v = data[i + k + len / 2] * w;
+            data[i + k] = u + v;
+            data[i + k + len / 2] = u - v;
+            w *= wlen;
+          }
+        }
+      }
+    }
+
+    int m_n = 0;
+    int m_size = 0;
+    std::vector<cplx> m_chirp;
+    std::vector<cplx> m_chirp_fft;
+  };
+}  // namespace
+
 AnnularFieldSim::AnnularFieldSim(float in_innerRadius, float in_outerRadius, float in_outerZ,
                                  int r, int roi_r0, int roi_r1, int /*in_rLowSpacing*/, int /*in_rHighSize*/,
                                  int phi, int roi_phi0, int roi_phi1, int /*in_phiLowSpacing*/, int /*in_phiHighSize*/,
@@ -1314,6 +1431,16 @@ void AnnularFieldSim::populate_analytic_fieldmap(){
 
 void AnnularFieldSim::populate_fieldmap()
 {
+  if (useFFTPhiConvolution)
+  {
+    if ((lookupCase == PhiSlice || lookupCase == Full3D) && truncation_length <= 0)
+    {
+      populate_fieldmap_fft();
+      return;
+    }
+    std::cout << "populate_fieldmap: FFT phi convolution needs the PhiSlice or Full3D lookup without truncation, using the direct sum" << std::endl;
+  }
+
   // sum the E field at every point in the region of interest
   //  remember that Efield uses relative indices
   std::cout << boost::str(boost::format("in pop_fieldmap, n=(%d,%d,%d)") % nr % nphi % nz) << std::endl;
@@ -1355,6 +1482,116 @@ void AnnularFieldSim::populate_fieldmap()
   return;
 }
 
+void AnnularFieldSim::populate_fieldmap_fft()
+{
+  // same field as populate_fieldmap with the PhiSlice or Full3D lookup, but the sum over source phi is done for all field phi at once:
+  // the lookup is only used for field cells at roi phi index 0, where it is a function g(j) of the source phi index j.
+  // The field at any other phi is the same sum with the charge shifted in phi, rotated by the phi difference,
+  // i.e. a cyclic cross-correlation of g and q in phi, computed with FFTs.
+  // For the PhiSlice lookup, j is relative to the field phi (shift=phi), for Full3D it is the global source phi (shift=phi-phimin_roi).
+  std::cout << boost::str(boost::format("populating fieldmap for (%dx%dx%d) grid with (%dx%dx%d) source, summing phi by FFT") % nr_roi % nphi_roi % nz_roi % nr % nphi % nz) << std::endl;
+
+  using cplx = std::complex<double>;
+  const PhiFFT fft(nphi);
+  const int phioffset = (lookupCase == Full3D) ? phimin_roi : 0;
+
+  // spectra of the charge in each (r,z) ring of source cells
+  std::vector<cplx> qspectrum(static_cast<size_t>(nr) * nz * nphi);
+  {
+    std::vector<cplx> data(nphi);
+    std::vector<cplx> work;
+    for (int ir = 0; ir < nr; ir++)
+    {
+      for (int iz = 0; iz < nz; iz++)
+      {
+        for (int iphi = 0; iphi < nphi; iphi++)
+        {
+          data[iphi] = q->GetChargeInBin(ir, iphi, iz);
+        }
+        fft.transform(data, work, false);
+        std::copy(data.begin(), data.end(), qspectrum.begin() + (static_cast<size_t>(ir) * nz + iz) * nphi);
+      }
+    }
+  }
+
+  // per thread buffers
+  struct Scratch
+  {
+    std::vector<cplx> xy, z, work;
+    std::vector<cplx> acc_x, acc_y, acc_z;
+  };
+
+  PHThreadPool pool(nThreads);
+  std::vector<Scratch> scratch(pool.size());
+  std::cout << boost::str(boost::format("populate_fieldmap_fft: %d (r,z) slices on %d threads") % (nr_roi * nz_roi) % pool.size()) << std::endl;
+
+  pool.parallel_for(nr_roi * nz_roi, [&](size_t task, unsigned int worker)
+                    {
+    const int r = rmin_roi + task / nz_roi;
+    const int z = zmin_roi + task % nz_roi;
+    Scratch &buf = scratch[worker];
+    buf.xy.resize(nphi);
+    buf.z.resize(nphi);
+    buf.acc_x.assign(nphi, cplx(0, 0));
+    buf.acc_y.assign(nphi, cplx(0, 0));
+    buf.acc_z.assign(nphi, cplx(0, 0));
+
+    for (int ir = 0; ir < nr; ir++)
+    {
+      for (int iz = 0; iz < nz; iz++)
+      {
+        for (int j = 0; j < nphi; j++)
+        {
+          TVector3 g = (lookupCase == Full3D) ? Epartial->Get(r - rmin_roi, 0, z - zmin_roi, ir, j, iz) : Epartial_phislice->Get(r - rmin_roi, 0, z - zmin_roi, ir, j, iz);
+          if (ir == r && iz == z && j == phioffset)
+          {
+            g = zero_vector;  // dont' compute self-to-self field.
+          }
+          // x and y are real, transform them together
+          buf.xy[j] = cplx(g.X(), g.Y());
+          buf.z[j] = g.Z();
+        }
+        fft.transform(buf.xy, buf.work, false);
+        fft.transform(buf.z, buf.work, false);
+
+        // correlation:  spectrum of sum_j g(j) q(j+shift) is conj(G)*Q
+        const cplx *qs = &qspectrum[(static_cast<size_t>(ir) * nz + iz) * nphi];
+        for (int k = 0; k < nphi; k++)
+        {
+          const cplx xyk = buf.xy[k];
+          const cplx xymk = std::conj(buf.xy[(nphi - k) % nphi]);
+          const cplx gx = 0.5 * (xyk + xymk);
+          const cplx gy = cplx(0, -0.5) * (xyk - xymk);
+          buf.acc_x[k] += std::conj(gx) * qs[k];
+          buf.acc_y[k] += std::conj(gy) * qs[k];
+          buf.acc_z[k] += std::conj(buf.z[k]) * qs[k];
+        }
+      }
+    }
+
+    // back to phi space, the x and y results are real, transform them together
+    for (int k = 0; k < nphi; k++)
+    {
+      buf.xy[k] = buf.acc_x[k] + cplx(0, 1) * buf.acc_y[k];
+      buf.z[k] = buf.acc_z[k];
+    }
+    fft.transform(buf.xy, buf.work, true);
+    fft.transform(buf.z, buf.work, true);
+
+    const TVector3 slicepos = GetRoiCellCenter(r - rmin_roi, 0, z - zmin_roi);
+    for (int phi = phimin_roi; phi < phimax_roi; phi++)
+    {
+      const int shift = ((phi - phioffset) % nphi + nphi) % nphi;
+      TVector3 localF(buf.xy[shift].real() / nphi, buf.xy[shift].imag() / nphi, buf.z[shift].real() / nphi);
+      const TVector3 pos = GetRoiCellCenter(r - rmin_roi, phi - phimin_roi, z - zmin_roi);
+      float rotphi = pos.Phi() - slicepos.Phi();
+      localF.RotateZ(rotphi);
+      localF += Eexternal->Get(r - rmin_roi, phi - phimin_roi, z - zmin_roi);
+      Efield->Set(r - rmin_roi, phi - phimin_roi, z - zmin_roi, localF);  // sets in roi coordinates.
+    } });
+  return;
+}
+
 void AnnularFieldSim::populate_lookup()
 {
   // with 'f' being the position the field is being measured at, and 'o' being the position of the charge generating the field.
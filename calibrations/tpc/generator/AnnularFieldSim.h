@@ -93,6 +93,19 @@ class AnnularFieldSim
     truncation_length = x;
     return;
   }
+  // compute the space charge field in populate_fieldmap as a cyclic convolution in phi, using FFTs.
+  // Only for PhiSlice and Full3D lookups without truncation, otherwise the direct sum is used.
+  void UseFFTPhiConvolution(bool b)
+  {
+    useFFTPhiConvolution = b;
+    return;
+  }
+  // number of threads used for the FFT field calculation.  0 uses all hardware threads.
+  void SetNumThreads(unsigned int n)
+  {
+    nThreads = n;
+    return;
+  }
 
   // getters for internal states:
   const std::string GetLookupString();
@@ -188,6 +201,7 @@ class AnnularFieldSim
   TVector3 GetWeightedCellCenter(int r, int phi, int z);
   TVector3 fieldIntegral(float zdest, const TVector3 &start, MultiArray<TVector3> *field);
   void populate_fieldmap();
+  void populate_fieldmap_fft();
   // now handled by setting 'analytic' lookup:  void populate_analytic_fieldmap();
   void populate_lookup();
   void populate_full3d_lookup();
@@ -299,6 +313,8 @@ class AnnularFieldSim
   LookupCase lookupCase;  // which lookup system to instantiate and use.
   ChargeCase chargeCase;  // which charge model to use
   int truncation_length;  // distance in cells (full 3D metric in units of bins)
+  bool useFFTPhiConvolution = false;  // sum the field over phi by FFT in populate_fieldmap
+  unsigned int nThreads = 1;          // threads for populate_fieldmap_fft
 
   // variables related to the region of interest:
   //
@@ -12,14 +12,95 @@
 #include <TSystem.h>
 #include <TTree.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <climits>
 #include <cmath>    // for NAN, isfinite
 #include <cstdint>  // for uint64_t
+#include <cstdio>   // for std::rename
+#include <cstdlib>  // for getenv
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>   // for numeric_limits, numeric_limits<>::max_digits10
 #include <set>      // for set
+#include <sstream>
 #include <utility>  // for pair, make_pair
 
+namespace
+{
+  //! layout version of the column file, bump if the layout changes
+  constexpr uint32_t column_version = 1;
+
+  //! start of the column file, followed by the sorted channels (int32),
+  //! one ColumnDescriptor per field, the field names and the columns, each aligned to 8 bytes
+  struct ColumnFileHeader
+  {
+    char magic[8]{'C', 'D', 'B', 'T', 'C', 'O', 'L', '\0'};
+    uint32_t version{column_version};
+    uint32_t nfields{0};
+    uint64_t nchannels{0};
+    int64_t source_size{0};
+    int64_t source_mtime{0};
+  };
+
+  //! location of one field in the column file. The first character of the name is the type
+  struct ColumnDescriptor
+  {
+    uint64_t name_offset{0};
+    uint64_t name_length{0};
+    uint64_t data_offset{0};
+  };
+
+  std::size_t align8(std::size_t size)
+  {
+    return (size + 7) & ~static_cast<std::size_t>(7);
+  }
+
+  //! size of one column entry for given type, 0 for unknown types
+  std::size_t column_entry_size(char type)
+  {
+    switch (type)
+    {
+    case 'F':
+    case 'I':
+      return 4;
+    case 'D':
+    case 'g':
+      return 8;
+    default:
+      return 0;
+    }
+  }
+
+  //! size and modification time of the payload, false if it is not a local file
+  bool source_stat(const std::string &filename, int64_t &size, int64_t &mtime)
+  {
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) != 0)
+    {
+      return false;
+    }
+    size = buf.st_size;
+    mtime = buf.st_mtime;
+    return true;
+  }
+
+  //! column file name: payload file name plus a hash of its full path
+  std::string column_filename(const std::string &cachedir, const std::string &filename)
+  {
+    const std::string::size_type slash = filename.find_last_of('/');
+    const std::string basename = (slash == std::string::npos) ? filename : filename.substr(slash + 1);
+    std::ostringstream name;
+    name << cachedir << "/" << basename << "." << std::hex << std::hash<std::string>{}(filename) << ".columns";
+    return name.str();
+  }
+}  // namespace
+
 CDBTTree::CDBTTree(const std::string &fname)
   : m_Filename(fname)
 {
@@ -29,6 +110,10 @@ CDBTTree::~CDBTTree()
 {
   m_FloatEntryMap.clear();
   m_SingleFloatEntryMap.clear();
+  if (m_ColumnMap)
+  {
+    munmap(m_ColumnMap, m_ColumnMapSize);
+  }
 }
 
 void CDBTTree::SetFloatValue(int channel, const std::string &name, float value)
@@ -873,3 +958,313 @@ uint64_t CDBTTree::GetUInt64Value(int channel, const std::string &name, int verb
   }
   return calibiter->second;
 }
+
+CDBTTree::FieldHandle CDBTTree::field(const std::string &name, int verbose)
+{
+  return FieldHandle(&m_ChannelIndex, static_cast<const float *>(GetColumn('F', name, verbose)));
+}
+
+CDBTTree::Field<double> CDBTTree::doubleField(const std::string &name, int verbose)
+{
+  return Field<double>(&m_ChannelIndex, static_cast<const double *>(GetColumn('D', name, verbose)));
+}
+
+CDBTTree::Field<int> CDBTTree::intField(const std::string &name, int verbose)
+{
+  return Field<int>(&m_ChannelIndex, static_cast<const int *>(GetColumn('I', name, verbose)));
+}
+
+CDBTTree::Field<uint64_t> CDBTTree::uint64Field(const std::string &name, int verbose)
+{
+  return Field<uint64_t>(&m_ChannelIndex, static_cast<const uint64_t *>(GetColumn('g', name, verbose)));
+}
+
+const void *CDBTTree::GetColumn(char type, const std::string &name, int verbose)
+{
+  LoadColumns();
+  auto iter = m_Columns.find(type + name);
+  if (iter == m_Columns.end())
+  {
+    if (verbose > 0)
+    {
+      std::cout << PHWHERE << " Could not find " << name << " among per channel calibrations of type " << type << std::endl;
+    }
+    return nullptr;
+  }
+  return iter->second;
+}
+
+void CDBTTree::LoadColumns()
+{
+  if (m_ColumnsLoaded)
+  {
+    return;
+  }
+  m_ColumnsLoaded = true;
+
+  // the column file is only used for payloads which were not read or modified yet
+  const bool empty_multiple = m_FloatEntryMap.empty() && m_DoubleEntryMap.empty() &&
+                              m_IntEntryMap.empty() && m_UInt64EntryMap.empty();
+  if (m_ColumnCacheDir.empty())
+  {
+    const char *cachedir = getenv("CDBTTREE_COLUMN_CACHE");
+    m_ColumnCacheDir = cachedir ? cachedir : "";
+  }
+  int64_t source_size = 0;
+  int64_t source_mtime = 0;
+  const bool use_cache = empty_multiple && !m_ColumnCacheDir.empty() && source_stat(m_Filename, source_size, source_mtime);
+  const std::string columnfile = use_cache ? column_filename(m_ColumnCacheDir, m_Filename) : "";
+  if (use_cache && ReadColumnFile(columnfile))
+  {
+    return;
+  }
+
+  if (empty_multiple)
+  {
+    LoadCalibrations();
+  }
+  BuildColumns();
+  if (use_cache)
+  {
+    WriteColumnFile(columnfile);
+  }
+}
+
+void CDBTTree::BuildColumns()
+{
+  // all channels and fields, sorted
+  std::set<int> channel_set;
+  std::map<std::string, std::size_t> field_offsets;
+  const auto collect = [&channel_set, &field_offsets](const auto &entrymap)
+  {
+    for (const auto &channel_entry : entrymap)
+    {
+      channel_set.insert(channel_entry.first);
+      for (const auto &field : channel_entry.second)
+      {
+        field_offsets.insert(std::make_pair(field.first, 0));
+      }
+    }
+  };
+  collect(m_FloatEntryMap);
+  collect(m_DoubleEntryMap);
+  collect(m_IntEntryMap);
+  collect(m_UInt64EntryMap);
+  const std::vector<int32_t> channels(channel_set.begin(), channel_set.end());
+
+  // layout
+  const std::size_t nchannels = channels.size();
+  const std::size_t descriptor_offset = align8(sizeof(ColumnFileHeader) + nchannels * sizeof(int32_t));
+  std::size_t offset = descriptor_offset + field_offsets.size() * sizeof(ColumnDescriptor);
+  std::vector<ColumnDescriptor> descriptors;
+  for (const auto &field : field_offsets)
+  {
+    ColumnDescriptor descriptor;
+    descriptor.name_offset = offset;
+    descriptor.name_length = field.first.size();
+    descriptors.push_back(descriptor);
+    offset += field.first.size();
+  }
+  offset = align8(offset);
+  auto descriptor_iter = descriptors.begin();
+  for (auto &field : field_offsets)
+  {
+    field.second = offset;
+    descriptor_iter->data_offset = offset;
+    ++descriptor_iter;
+    offset = align8(offset + nchannels * column_entry_size(field.first[0]));
+  }
+
+  m_ColumnBuffer.assign(offset / sizeof(uint64_t), 0);
+  char *data = reinterpret_cast<char *>(m_ColumnBuffer.data());
+  ColumnFileHeader header;
+  header.nfields = field_offsets.size();
+  header.nchannels = nchannels;
+  std::memcpy(data, &header, sizeof(header));
+  std::memcpy(data + sizeof(header), channels.data(), nchannels * sizeof(int32_t));
+  std::memcpy(data + descriptor_offset, descriptors.data(), descriptors.size() * sizeof(ColumnDescriptor));
+  descriptor_iter = descriptors.begin();
+  for (const auto &field : field_offsets)
+  {
+    std::memcpy(data + descriptor_iter->name_offset, field.first.data(), field.first.size());
+    ++descriptor_iter;
+  }
+
+  // columns, missing values are the ones returned by the Get*Value methods
+  const auto set_missing = [nchannels](char *column, auto missing)
+  {
+    for (std::size_t row = 0; row < nchannels; ++row)
+    {
+      std::memcpy(column + row * sizeof(missing), &missing, sizeof(missing));
+    }
+  };
+  for (const auto &field : field_offsets)
+  {
+    char *column = data + field.second;
+    switch (field.first[0])
+    {
+    case 'F':
+      set_missing(column, Field<float>::missing());
+      break;
+    case 'D':
+      set_missing(column, Field<double>::missing());
+      break;
+    case 'I':
+      set_missing(column, Field<int>::missing());
+      break;
+    case 'g':
+      set_missing(column, Field<uint64_t>::missing());
+      break;
+    default:
+      break;
+    }
+  }
+  const auto fill = [&](const auto &entrymap)
+  {
+    for (const auto &channel_entry : entrymap)
+    {
+      const std::size_t row = std::lower_bound(channels.begin(), channels.end(), channel_entry.first) - channels.begin();
+      for (const auto &field : channel_entry.second)
+      {
+        std::memcpy(data + field_offsets.find(field.first)->second + row * sizeof(field.second), &field.second, sizeof(field.second));
+      }
+    }
+  };
+  fill(m_FloatEntryMap);
+  fill(m_DoubleEntryMap);
+  fill(m_IntEntryMap);
+  fill(m_UInt64EntryMap);
+
+  IndexColumns(data, offset);
+}
+
+bool CDBTTree::IndexColumns(const char *data, std::size_t size)
+{
+  m_Columns.clear();
+  m_ChannelIndex = ChannelIndex();
+
+  ColumnFileHeader header;
+  if (size < sizeof(header))
+  {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  const ColumnFileHeader expected;
+  const std::size_t nchannels = header.nchannels;
+  const std::size_t descriptor_offset = align8(sizeof(header) + nchannels * sizeof(int32_t));
+  if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+      header.version != column_version ||
+      nchannels > size / sizeof(int32_t) ||
+      descriptor_offset + header.nfields * sizeof(ColumnDescriptor) > size)
+  {
+    return false;
+  }
+
+  // channels must be sorted for the binary search
+  const int32_t *channels = reinterpret_cast<const int32_t *>(data + sizeof(header));
+  if (std::adjacent_find(channels, channels + nchannels, std::greater_equal<int32_t>()) != channels + nchannels)
+  {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < header.nfields; ++i)
+  {
+    ColumnDescriptor descriptor;
+    std::memcpy(&descriptor, data + descriptor_offset + i * sizeof(ColumnDescriptor), sizeof(descriptor));
+    if (descriptor.name_length == 0 || descriptor.name_offset > size || descriptor.name_length > size - descriptor.name_offset)
+    {
+      m_Columns.clear();
+      return false;
+    }
+    std::string name(data + descriptor.name_offset, descriptor.name_length);
+    const std::size_t entry_size = column_entry_size(name[0]);
+    if (entry_size == 0 || descriptor.data_offset % 8 != 0 ||
+        descriptor.data_offset > size || nchannels * entry_size > size - descriptor.data_offset)
+    {
+      m_Columns.clear();
+      return false;
+    }
+    m_Columns.insert(std::make_pair(name, data + descriptor.data_offset));
+  }
+
+  m_ChannelIndex.m_Channels = channels;
+  m_ChannelIndex.m_Size = nchannels;
+  if (nchannels > 0)
+  {
+    // direct lookup table if the channels are not too sparse
+    const int64_t range = static_cast<int64_t>(channels[nchannels - 1]) - channels[0] + 1;
+    if (range <= static_cast<int64_t>(2 * nchannels + 64))
+    {
+      m_ChannelIndex.m_MinChannel = channels[0];
+      m_ChannelIndex.m_Rows.assign(range, -1);
+      for (std::size_t row = 0; row < nchannels; ++row)
+      {
+        m_ChannelIndex.m_Rows[channels[row] - channels[0]] = row;
+      }
+    }
+  }
+  return true;
+}
+
+bool CDBTTree::ReadColumnFile(const std::string &columnfile)
+{
+  const int fd = open(columnfile.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat buf;
+  if (fstat(fd, &buf) != 0 || static_cast<std::size_t>(buf.st_size) < sizeof(ColumnFileHeader))
+  {
+    close(fd);
+    return false;
+  }
+  const std::size_t size = buf.st_size;
+  // the mapping is shared with every other job which maps the same file
+  void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+  {
+    return false;
+  }
+
+  ColumnFileHeader header;
+  std::memcpy(&header, mapped, sizeof(header));
+  int64_t source_size = 0;
+  int64_t source_mtime = 0;
+  source_stat(m_Filename, source_size, source_mtime);
+  if (header.source_size != source_size || header.source_mtime != source_mtime ||
+      !IndexColumns(static_cast<const char *>(mapped), size))
+  {
+    std::cout << PHWHERE << " ignoring outdated column file " << columnfile << std::endl;
+    munmap(mapped, size);
+    return false;
+  }
+  m_ColumnMap = mapped;
+  m_ColumnMapSize = size;
+  return true;
+}
+
+void CDBTTree::WriteColumnFile(const std::string &columnfile) const
+{
+  ColumnFileHeader header;
+  std::memcpy(&header, reinterpret_cast<const char *>(m_ColumnBuffer.data()), sizeof(header));
+  source_stat(m_Filename, header.source_size, header.source_mtime);
+
+  // write to a job specific file and rename it, so concurrent jobs never see a partial file
+  const std::string tmpfile = columnfile + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmpfile, std::ios::binary);
+  if (!out)
+  {
+    std::cout << PHWHERE << " could not create column file " << tmpfile << std::endl;
+    return;
+  }
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(m_ColumnBuffer.data()) + sizeof(header), m_ColumnBuffer.size() * sizeof(uint64_t) - sizeof(header));
+  out.close();
+  if (!out || std::rename(tmpfile.c_str(), columnfile.c_str()) != 0)
+  {
+    std::cout << PHWHERE << " could not write column file " << columnfile << std::endl;
+    std::remove(tmpfile.c_str());
+  }
+}
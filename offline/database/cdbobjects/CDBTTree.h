@@ -1,18 +1,99 @@
 #ifndef CDBOBJECTS_CDBTTREE_H
 #define CDBOBJECTS_CDBTTREE_H
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 class TTree;
 
 class CDBTTree
 {
  public:
+  //! maps channels to rows of the per channel columns
+  class ChannelIndex
+  {
+   public:
+    //! row of channel, -1 if the channel is not found
+    int row(int channel) const
+    {
+      if (!m_Rows.empty())
+      {
+        // dense channel range
+        const unsigned int offset = static_cast<unsigned int>(channel) - static_cast<unsigned int>(m_MinChannel);
+        return offset < m_Rows.size() ? m_Rows[offset] : -1;
+      }
+      const int32_t *end = m_Channels + m_Size;
+      const int32_t *iter = std::lower_bound(m_Channels, end, channel);
+      return (iter != end && *iter == channel) ? static_cast<int>(iter - m_Channels) : -1;
+    }
+
+   private:
+    friend class CDBTTree;
+    const int32_t *m_Channels = nullptr;
+    std::size_t m_Size = 0;
+    int m_MinChannel = 0;
+    std::vector<int> m_Rows;
+  };
+
+  //! per channel values of one field, stored in a contiguous array
+  /**
+   * returned by field(), doubleField(), intField() and uint64Field().
+   * Missing channels or fields give the same value as the Get*Value methods
+   * (NaN, INT_MIN or UINT64_MAX). Valid as long as the CDBTTree exists
+   */
+  template <class T>
+  class Field
+  {
+   public:
+    Field() = default;
+
+    //! value for given channel
+    T operator[](int channel) const
+    {
+      const int row = m_Values ? m_Index->row(channel) : -1;
+      return (row < 0) ? missing() : m_Values[row];
+    }
+
+    //! false if the field was not found
+    explicit operator bool() const { return m_Values; }
+
+    //! value used for missing channels
+    static T missing()
+    {
+      if (std::numeric_limits<T>::has_quiet_NaN)
+      {
+        return std::numeric_limits<T>::quiet_NaN();
+      }
+      return std::is_signed<T>::value ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+
+   private:
+    friend class CDBTTree;
+    Field(const ChannelIndex *index, const T *values)
+      : m_Index(index)
+      , m_Values(values)
+    {
+    }
+    const ChannelIndex *m_Index = nullptr;
+    const T *m_Values = nullptr;
+  };
+
+  using FieldHandle = Field<float>;
+
   CDBTTree() = default;
   explicit CDBTTree(const std::string &fname);
   ~CDBTTree();
+
+  //! owns the mapped column file
+  CDBTTree(const CDBTTree &) = delete;
+  CDBTTree &operator=(const CDBTTree &) = delete;
+
   void SetFloatValue(int channel, const std::string &name, float value);
   void SetDoubleValue(int channel, const std::string &name, double value);
   void SetIntValue(int channel, const std::string &name, int value);
@@ -38,6 +119,19 @@ class CDBTTree
   uint64_t GetSingleUInt64Value(const std::string &name, int verbose = 1);
   uint64_t GetUInt64Value(int channel, const std::string &name, int verbose = 1);
 
+  //! per channel field handles, for fast lookups in the event loop
+  /**
+   * the first call compiles all per channel fields into one column per field.
+   * If a column cache directory is set (SetColumnCacheDir or the CDBTTREE_COLUMN_CACHE
+   * environment variable), the columns are written there as a binary file and
+   * later jobs map this file instead of reading the TTree
+   */
+  FieldHandle field(const std::string &name, int verbose = 1);
+  Field<double> doubleField(const std::string &name, int verbose = 1);
+  Field<int> intField(const std::string &name, int verbose = 1);
+  Field<uint64_t> uint64Field(const std::string &name, int verbose = 1);
+  void SetColumnCacheDir(const std::string &dir) { m_ColumnCacheDir = dir; }
+
  private:
   enum
   {
@@ -57,6 +151,26 @@ class CDBTTree
   std::map<std::string, int> m_SingleIntEntryMap;
   std::map<int, std::map<std::string, uint64_t>> m_UInt64EntryMap;
   std::map<std::string, uint64_t> m_SingleUInt64EntryMap;
+
+  //! compile the columns, from the column cache if possible
+  void LoadColumns();
+  //! fill column buffer from the per channel maps
+  void BuildColumns();
+  //! set channel index and columns from buffer in column file layout, false if the buffer is not valid
+  bool IndexColumns(const char *data, std::size_t size);
+  //! map column cache file, false if it does not exist or is outdated
+  bool ReadColumnFile(const std::string &columnfile);
+  void WriteColumnFile(const std::string &columnfile) const;
+  //! column of given type ('F', 'D', 'I' or 'g') and name, nullptr if not found
+  const void *GetColumn(char type, const std::string &name, int verbose);
+
+  std::string m_ColumnCacheDir;
+  bool m_ColumnsLoaded = false;
+  std::vector<uint64_t> m_ColumnBuffer;
+  void *m_ColumnMap = nullptr;
+  std::size_t m_ColumnMapSize = 0;
+  ChannelIndex m_ChannelIndex;
+  std::map<std::string, const void *> m_Columns;
 };
 
 #endif
@@ -0,0 +1,116 @@
+#include "EventPrefetcher.h"
+
+#include <Event/Event.h>
+#include <Event/Eventiterator.h>
+
+#include <chrono>
+
+namespace
+{
+  double seconds_since(const std::chrono::steady_clock::time_point &start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}  // namespace
+
+EventPrefetcher::EventPrefetcher(const std::string &name, Eventiterator *iterator, const unsigned int depth)
+  : m_Name(name)
+  , m_EventIterator(iterator)
+  , m_Depth(depth > 0 ? depth : 1)
+{
+  m_thread = std::thread(&EventPrefetcher::run, this);
+}
+
+EventPrefetcher::~EventPrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_not_full.notify_all();
+  m_thread.join();
+  for (auto evt : m_queue)
+  {
+    delete evt;
+  }
+  m_queue.clear();
+}
+
+void EventPrefetcher::run()
+{
+  while (true)
+  {
+    {
+      // backpressure: wait until the event loop made room in the queue
+      const auto start = std::chrono::steady_clock::now();
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_not_full.wait(lock, [this]
+                      { return m_stop || m_queue.size() < m_Depth; });
+      m_producer_wait += seconds_since(start);
+      if (m_stop)
+      {
+        return;
+      }
+    }
+    // the expensive part (read + decompression) runs without the lock
+    Event *evt = m_EventIterator->getNextEvent();
+    // the event still points into the read buffer of the iterator, which the
+    // next read overwrites. Give it its own copy of the data before queuing it
+    if (evt)
+    {
+      evt->convert();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!evt)
+      {
+        m_eof = true;
+      }
+      else
+      {
+        m_queue.push_back(evt);
+      }
+    }
+    m_not_empty.notify_one();
+    if (!evt)
+    {
+      return;
+    }
+  }
+}
+
+Event *EventPrefetcher::getNextEvent()
+{
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_queue.empty() && !m_eof)
+  {
+    ++m_empty_pops;
+  }
+  m_not_empty.wait(lock, [this]
+                   { return !m_queue.empty() || m_eof; });
+  m_consumer_wait += seconds_since(start);
+  if (m_queue.empty())
+  {
+    return nullptr;
+  }
+  m_queue_sum += m_queue.size();
+  ++m_nevents;
+  Event *evt = m_queue.front();
+  m_queue.pop_front();
+  lock.unlock();
+  m_not_full.notify_one();
+  return evt;
+}
+
+void EventPrefetcher::Print(std::ostream &os) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  os << m_Name << ": prefetch depth " << m_Depth
+     << ", events: " << m_nevents
+     << ", average queue depth: " << (m_nevents ? static_cast<double>(m_queue_sum) / m_nevents : 0.)
+     << ", queue empty: " << m_empty_pops << " times"
+     << ", event loop stalled: " << m_consumer_wait << " s"
+     << ", reader blocked on full queue: " << m_producer_wait << " s"
+     << std::endl;
+}
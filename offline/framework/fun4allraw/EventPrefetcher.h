@@ -0,0 +1,70 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALLRAW_EVENTPREFETCHER_H
+#define FUN4ALLRAW_EVENTPREFETCHER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class Event;
+class Eventiterator;
+
+//! reads events from an Eventiterator on a background thread
+/*!
+ * The thread calls Eventiterator::getNextEvent() (file read and decompression)
+ * ahead of the event loop and keeps up to depth events in a queue. When the queue
+ * is full the thread waits until the event loop took an event (backpressure).
+ * Queued events are converted (Event::convert()) so they do not share the
+ * read buffer of the iterator.
+ * getNextEvent() returns the oldest queued event, ownership goes to the caller
+ * exactly as for Eventiterator::getNextEvent(). A nullptr is returned once the
+ * iterator is exhausted.
+ *
+ * While a prefetcher is active the Eventiterator must not be used directly.
+ * The prefetcher has to be deleted before the Eventiterator.
+ */
+class EventPrefetcher
+{
+ public:
+  EventPrefetcher(const std::string &name, Eventiterator *iterator, const unsigned int depth);
+  ~EventPrefetcher();
+
+  EventPrefetcher(const EventPrefetcher &) = delete;
+  EventPrefetcher &operator=(const EventPrefetcher &) = delete;
+
+  //! next event, blocks until one is read. nullptr at end of file
+  Event *getNextEvent();
+
+  //! queue depth and stall times
+  void Print(std::ostream &os = std::cout) const;
+
+ private:
+  void run();
+
+  std::string m_Name;
+  Eventiterator *m_EventIterator{nullptr};
+  unsigned int m_Depth{1};
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+  std::deque<Event *> m_queue;
+  bool m_eof{false};
+  bool m_stop{false};
+
+  //! statistics
+  uint64_t m_nevents{0};
+  uint64_t m_queue_sum{0};
+  uint64_t m_empty_pops{0};
+  double m_consumer_wait{0};
+  double m_producer_wait{0};
+
+  std::thread m_thread;
+};
+
+#endif
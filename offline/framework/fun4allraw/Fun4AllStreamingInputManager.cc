@@ -631,7 +631,7 @@ int Fun4AllStreamingInputManager::FillGl1()
       iter->CleanupUsedPackets(m_Gl1RawHitMap.begin()->first);
     }
     m_Gl1RawHitMap.begin()->second.Gl1RawHitVector.clear();
-    m_Gl1RawHitMap.erase(m_Gl1RawHitMap.begin());
+    m_Gl1RawHitMap.pop_front();
   }
   // std::cout << "size  m_Gl1RawHitMap: " <<  m_Gl1RawHitMap.size()
   // 	    << std::endl;
@@ -697,7 +697,7 @@ int Fun4AllStreamingInputManager::FillIntt()
     }
    
     m_InttRawHitMap.begin()->second.InttRawHitVector.clear();
-    m_InttRawHitMap.erase(m_InttRawHitMap.begin());
+    m_InttRawHitMap.pop_front();
     
     iret = FillInttPool();
     if (iret)
@@ -790,7 +790,7 @@ int Fun4AllStreamingInputManager::FillIntt()
       iter->CleanupUsedPackets(m_InttRawHitMap.begin()->first);
     }
     m_InttRawHitMap.begin()->second.InttRawHitVector.clear();
-    m_InttRawHitMap.erase(m_InttRawHitMap.begin());
+    m_InttRawHitMap.pop_front();
     if (m_InttRawHitMap.empty())
     {
       break;
@@ -874,7 +874,7 @@ int Fun4AllStreamingInputManager::FillMvtx()
     m_MvtxRawHitMap.begin()->second.MvtxFeeIdInfoVector.clear();
     m_MvtxRawHitMap.begin()->second.MvtxL1TrgBco.clear();
     m_MvtxRawHitMap.begin()->second.MvtxRawHitVector.clear();
-    m_MvtxRawHitMap.erase(m_MvtxRawHitMap.begin());
+    m_MvtxRawHitMap.pop_front();
     
     iret = FillMvtxPool();
     if (iret)
@@ -999,7 +999,7 @@ int Fun4AllStreamingInputManager::FillMvtx()
       }
       m_MvtxRawHitMap.begin()->second.MvtxRawHitVector.clear();
       m_MvtxRawHitMap.begin()->second.MvtxL1TrgBco.clear();
-      m_MvtxRawHitMap.erase(m_MvtxRawHitMap.begin());
+      m_MvtxRawHitMap.pop_front();
       // m_MvtxRawHitMap.empty() need to be checked here since we do not call FillPoolMvtx()
       if (m_MvtxRawHitMap.empty())
       {
@@ -1042,7 +1042,7 @@ int Fun4AllStreamingInputManager::FillMvtx()
       }
       m_MvtxRawHitMap.begin()->second.MvtxRawHitVector.clear();
       m_MvtxRawHitMap.begin()->second.MvtxL1TrgBco.clear();
-      m_MvtxRawHitMap.erase(m_MvtxRawHitMap.begin());
+      m_MvtxRawHitMap.pop_front();
       // m_MvtxRawHitMap.empty() need to be checked here since we do not call FillPoolMvtx()
       if (m_MvtxRawHitMap.empty())
       {
@@ -1109,7 +1109,7 @@ int Fun4AllStreamingInputManager::FillMicromegas()
     { poolinput->CleanupUsedPackets(m_MicromegasRawHitMap.begin()->first, true); }
 
     // remove
-    m_MicromegasRawHitMap.erase(m_MicromegasRawHitMap.begin());
+    m_MicromegasRawHitMap.pop_front();
 
     // fill pools again
     iret = FillMicromegasPool();
@@ -1126,17 +1126,18 @@ int Fun4AllStreamingInputManager::FillMicromegas()
   }
 
   // store hits relevant for this trigger and cleanup
-  for( auto iter = m_MicromegasRawHitMap.begin(); iter != m_MicromegasRawHitMap.end() && iter->first <= last_bco;  iter = m_MicromegasRawHitMap.erase(iter))
+  while (!m_MicromegasRawHitMap.empty() && m_MicromegasRawHitMap.front().first <= last_bco)
   {
-    for (const auto &hititer : iter->second.MicromegasRawHitVector)
+    for (const auto &hititer : m_MicromegasRawHitMap.front().second.MicromegasRawHitVector)
     {
       container->AddHit(hititer);
     }
 
     for (const auto &poolinput : m_MicromegasInputVector)
     {
-      poolinput->CleanupUsedPackets(iter->first);
+      poolinput->CleanupUsedPackets(m_MicromegasRawHitMap.front().first);
     }
+    m_MicromegasRawHitMap.pop_front();
   }
 
   return 0;
@@ -1191,7 +1192,7 @@ int Fun4AllStreamingInputManager::FillTpc()
 
     }
       m_TpcRawHitMap.begin()->second.TpcRawHitVector.clear();
-      m_TpcRawHitMap.erase(m_TpcRawHitMap.begin());
+      m_TpcRawHitMap.pop_front();
       iret = FillTpcPool();
       if (iret)
       {
@@ -1252,7 +1253,7 @@ int Fun4AllStreamingInputManager::FillTpc()
   
     }
       m_TpcRawHitMap.begin()->second.TpcRawHitVector.clear();
-      m_TpcRawHitMap.erase(m_TpcRawHitMap.begin());
+      m_TpcRawHitMap.pop_front();
       if (m_TpcRawHitMap.empty())
       {
         break;
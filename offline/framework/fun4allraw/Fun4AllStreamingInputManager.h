@@ -4,6 +4,7 @@
 #define FUN4ALLRAW_FUN4ALLSTREAMINGINPUTMANAGER_H
 
 #include "InputManagerType.h"
+#include "StreamingBcoIndex.h"
 
 #include <fun4all/Fun4AllInputManager.h>
 
@@ -74,30 +75,57 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
     std::vector<MvtxFeeIdInfo *> MvtxFeeIdInfoVector;
     std::vector<MvtxRawHit *> MvtxRawHitVector;
     unsigned int EventFoundCounter{0};
+    void clear()
+    {
+      MvtxL1TrgBco.clear();
+      MvtxFeeIdInfoVector.clear();
+      MvtxRawHitVector.clear();
+      EventFoundCounter = 0;
+    }
   };
 
   struct Gl1RawHitInfo
   {
     std::vector<Gl1Packet *> Gl1RawHitVector;
     unsigned int EventFoundCounter{0};
+    void clear()
+    {
+      Gl1RawHitVector.clear();
+      EventFoundCounter = 0;
+    }
   };
 
   struct InttRawHitInfo
   {
     std::vector<InttRawHit *> InttRawHitVector;
     unsigned int EventFoundCounter{0};
+    void clear()
+    {
+      InttRawHitVector.clear();
+      EventFoundCounter = 0;
+    }
   };
 
   struct MicromegasRawHitInfo
   {
     std::vector<MicromegasRawHit *> MicromegasRawHitVector;
     unsigned int EventFoundCounter{0};
+    void clear()
+    {
+      MicromegasRawHitVector.clear();
+      EventFoundCounter = 0;
+    }
   };
 
   struct TpcRawHitInfo
   {
     std::vector<TpcRawHit *> TpcRawHitVector;
     unsigned int EventFoundCounter{0};
+    void clear()
+    {
+      TpcRawHitVector.clear();
+      EventFoundCounter = 0;
+    }
   };
 
   void createQAHistos();
@@ -130,11 +158,11 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   std::vector<SingleStreamingInput *> m_MicromegasInputVector;
   std::vector<SingleStreamingInput *> m_MvtxInputVector;
   std::vector<SingleStreamingInput *> m_TpcInputVector;
-  std::map<uint64_t, Gl1RawHitInfo> m_Gl1RawHitMap;
-  std::map<uint64_t, InttRawHitInfo> m_InttRawHitMap;
-  std::map<uint64_t, MicromegasRawHitInfo> m_MicromegasRawHitMap;
-  std::map<uint64_t, MvtxRawHitInfo> m_MvtxRawHitMap;
-  std::map<uint64_t, TpcRawHitInfo> m_TpcRawHitMap;
+  StreamingBcoIndex<Gl1RawHitInfo> m_Gl1RawHitMap;
+  StreamingBcoIndex<InttRawHitInfo> m_InttRawHitMap;
+  StreamingBcoIndex<MicromegasRawHitInfo> m_MicromegasRawHitMap;
+  StreamingBcoIndex<MvtxRawHitInfo> m_MvtxRawHitMap;
+  StreamingBcoIndex<TpcRawHitInfo> m_TpcRawHitMap;
   std::map<int, std::map<int, uint64_t>> m_InttPacketFeeBcoMap;
 
   // QA histos
@@ -54,7 +54,7 @@ void SingleGl1PoolInput::FillPool(const unsigned int /*nbclks*/)
   //  std::set<uint64_t> saved_beamclocks;
   while (GetSomeMoreEvents())
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(getNextEvent());
     while (!evt)
     {
       fileclose();
@@ -63,7 +63,7 @@ void SingleGl1PoolInput::FillPool(const unsigned int /*nbclks*/)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(getNextEvent());
     }
     if (Verbosity() > 2)
     {
@@ -80,7 +80,7 @@ void SingleGl1PoolInput::FillPool(const unsigned int /*nbclks*/)
       if (evt->getEvtType() == ENDRUNEVENT)
       {
         AllDone(1);
-        std::unique_ptr<Event> nextevt(GetEventiterator()->getNextEvent());
+        std::unique_ptr<Event> nextevt(getNextEvent());
         if (nextevt)
         {
           std::cout << PHWHERE << " Found event after End Run Event " << std::endl;
@@ -218,8 +218,8 @@ void SingleGl1PoolInput::CleanupUsedPackets(const uint64_t bclk)
   {
     m_FEEBclkMap.erase(iter);
     m_BclkStack.erase(iter);
-    m_Gl1RawHitMap.erase(iter);
   }
+  m_Gl1RawHitMap.erase_until(bclk);
 }
 
 bool SingleGl1PoolInput::CheckPoolDepth(const uint64_t bclk)
@@ -272,7 +272,7 @@ bool SingleGl1PoolInput::GetSomeMoreEvents()
 
   uint64_t lowest_bclk = m_Gl1RawHitMap.begin()->first;
   lowest_bclk += m_BcoRange;
-  uint64_t last_bclk = m_Gl1RawHitMap.rbegin()->first;
+  uint64_t last_bclk = m_Gl1RawHitMap.back().first;
   if (Verbosity() > 1)
   {
     std::cout << PHWHERE << "first bclk 0x" << std::hex << lowest_bclk
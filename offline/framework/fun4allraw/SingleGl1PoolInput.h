@@ -2,6 +2,7 @@
 #define FUN4ALLRAW_SINGLEGL1POOLINPUT_H
 
 #include "SingleStreamingInput.h"
+#include "StreamingBcoIndex.h"
 
 #include <cstdint>
 #include <list>
@@ -35,7 +36,7 @@ class SingleGl1PoolInput : public SingleStreamingInput
   //! map bco to packet
   std::map<unsigned int, uint64_t> m_packet_bco;
 
-  std::map<uint64_t, std::vector<Gl1Packet *>> m_Gl1RawHitMap;
+  StreamingBcoIndex<std::vector<Gl1Packet *>> m_Gl1RawHitMap;
   std::set<uint64_t> m_FEEBclkMap;
   std::set<uint64_t> m_BclkStack;
 };
@@ -64,7 +64,7 @@ void SingleHcalTriggerInput::FillPool(const unsigned int keep)
   }
   while (GetSomeMoreEvents(keep))
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(getNextEvent());
     while (!evt)
     {
       fileclose();
@@ -73,7 +73,7 @@ void SingleHcalTriggerInput::FillPool(const unsigned int keep)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(getNextEvent());
     }
     if (Verbosity() > 2)
     {
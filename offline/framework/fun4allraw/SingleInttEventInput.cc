@@ -62,7 +62,7 @@ void SingleInttEventInput::FillPool(const uint64_t minBCO)
   //  std::set<uint64_t> saved_beamclocks;
   while (GetSomeMoreEvents(0))
   {
-    Event *evt = GetEventiterator()->getNextEvent();
+    Event *evt = getNextEvent();
     while (!evt)
     {
       fileclose();
@@ -71,7 +71,7 @@ void SingleInttEventInput::FillPool(const uint64_t minBCO)
         AllDone(1);
         return;
       }
-      evt = GetEventiterator()->getNextEvent();
+      evt = getNextEvent();
     }
     if (Verbosity() > 2)
     {
@@ -287,8 +287,8 @@ void SingleInttEventInput::CleanupUsedPackets(const uint64_t bclk)
       bclkstack.erase(iter);
     }
     m_BeamClockFEE.erase(iter);
-    m_InttRawHitMap.erase(iter);
   }
+  m_InttRawHitMap.erase_until(bclk);
 }
 
 bool SingleInttEventInput::CheckPoolDepth(const uint64_t bclk)
@@ -359,7 +359,7 @@ bool SingleInttEventInput::GetSomeMoreEvents(const uint64_t ibclk)
   {
     if (bcliter.second <= localbclk)
     {
-      uint64_t highest_bclk = m_InttRawHitMap.rbegin()->first;
+      uint64_t highest_bclk = m_InttRawHitMap.back().first;
       if ((highest_bclk - m_InttRawHitMap.begin()->first) < MaxBclkDiff())
       {
         // std::cout << "FEE " << bcliter.first << " bclk: "
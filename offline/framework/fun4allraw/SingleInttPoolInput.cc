@@ -63,7 +63,7 @@ void SingleInttPoolInput::FillPool(const uint64_t minBCO)
   //  std::set<uint64_t> saved_beamclocks;
   while (GetSomeMoreEvents(0))
   {
-    Event *evt = GetEventiterator()->getNextEvent();
+    Event *evt = getNextEvent();
     while (!evt)
     {
       fileclose();
@@ -72,7 +72,7 @@ void SingleInttPoolInput::FillPool(const uint64_t minBCO)
         AllDone(1);
         return;
       }
-      evt = GetEventiterator()->getNextEvent();
+      evt = getNextEvent();
     }
     if (Verbosity() > 2)
     {
@@ -321,7 +321,7 @@ void SingleInttPoolInput::CleanupUsedPackets(const uint64_t bclk)
 {
   m_BclkStack.erase(m_BclkStack.begin(), m_BclkStack.upper_bound(bclk));
   m_BeamClockFEE.erase(m_BeamClockFEE.begin(), m_BeamClockFEE.upper_bound(bclk));
-  m_InttRawHitMap.erase(m_InttRawHitMap.begin(), m_InttRawHitMap.upper_bound(bclk));
+  m_InttRawHitMap.erase_until(bclk);
 }
 
 bool SingleInttPoolInput::CheckPoolDepth(const uint64_t bclk)
@@ -392,7 +392,7 @@ bool SingleInttPoolInput::GetSomeMoreEvents(const uint64_t ibclk)
   {
     if (bcliter.second <= localbclk)
     {
-      uint64_t highest_bclk = m_InttRawHitMap.rbegin()->first;
+      uint64_t highest_bclk = m_InttRawHitMap.back().first;
       if ((highest_bclk - m_InttRawHitMap.begin()->first) < MaxBclkDiff())
       {
         // std::cout << "FEE " << bcliter.first << " bclk: "
@@ -62,7 +62,7 @@ void SingleLL1TriggerInput::FillPool(const unsigned int keep)
   }
   while (GetSomeMoreEvents(keep))
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(getNextEvent());
     while (!evt)
     {
       fileclose();
@@ -71,7 +71,7 @@ void SingleLL1TriggerInput::FillPool(const unsigned int keep)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(getNextEvent());
     }
     if (Verbosity() > 2)
     {
@@ -3,6 +3,7 @@
 
 #include "MicromegasBcoMatchingInformation.h"
 #include "SingleStreamingInput.h"
+#include "StreamingBcoIndex.h"
 
 #include <phool/PHTimer.h>
 
@@ -71,7 +72,7 @@ class SingleMicromegasPoolInput_v1 : public SingleStreamingInput
   std::map<uint64_t, std::set<int>> m_BeamClockFEE;
 
   //! store list of raw hits matching a given bco
-  std::map<uint64_t, std::vector<MicromegasRawHit *>> m_MicromegasRawHitMap;
+  StreamingBcoIndex<std::vector<MicromegasRawHit *>> m_MicromegasRawHitMap;
 
   //! store current list of BCO on a per fee basis.
   /** only packets for which a given FEE have data are stored */
@@ -201,7 +201,7 @@ void SingleMicromegasPoolInput_v2::FillPool(const unsigned int /*nbclks*/)
   while (GetSomeMoreEvents())
   {
     // std::cout << "SingleMicromegasPoolInput_v2::FillPool" << std::endl;
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(getNextEvent());
     while (!evt)
     {
       fileclose();
@@ -212,7 +212,7 @@ void SingleMicromegasPoolInput_v2::FillPool(const unsigned int /*nbclks*/)
       }
 
       // get next event
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(getNextEvent());
     }
 
     if (Verbosity() > 2)
@@ -318,9 +318,9 @@ void SingleMicromegasPoolInput_v2::CleanupUsedPackets(const uint64_t bclk, bool
 {
 
   // delete all raw hits associated to bco smaller than reference, and remove from map
-  for(auto iter = m_MicromegasRawHitMap.begin(); iter != m_MicromegasRawHitMap.end() && (iter->first <= bclk); iter = m_MicromegasRawHitMap.erase(iter))
+  for (; !m_MicromegasRawHitMap.empty() && (m_MicromegasRawHitMap.front().first <= bclk); m_MicromegasRawHitMap.pop_front())
   {
-    for (const auto& rawhit : iter->second)
+    for (const auto& rawhit : m_MicromegasRawHitMap.front().second)
     {
       if( dropped )
       {
@@ -374,7 +374,7 @@ bool SingleMicromegasPoolInput_v2::GetSomeMoreEvents()
   {
     if (bcliter.second <= lowest_bclk)
     {
-      uint64_t highest_bclk = m_MicromegasRawHitMap.rbegin()->first;
+      uint64_t highest_bclk = m_MicromegasRawHitMap.back().first;
       if ((highest_bclk - m_MicromegasRawHitMap.begin()->first) < MaxBclkDiff())
       {
         return true;
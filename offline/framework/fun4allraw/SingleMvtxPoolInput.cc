@@ -62,7 +62,7 @@ void SingleMvtxPoolInput::FillPool(const uint64_t minBCO)
   //  std::set<uint64_t> saved_beamclocks;
   while (GetSomeMoreEvents())
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(getNextEvent());
     while (!evt)
     {
       fileclose();
@@ -71,7 +71,7 @@ void SingleMvtxPoolInput::FillPool(const uint64_t minBCO)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(getNextEvent());
     }
     if (Verbosity() > 2)
     {
@@ -259,7 +259,7 @@ void SingleMvtxPoolInput::Print(const std::string &what) const
 void SingleMvtxPoolInput::CleanupUsedPackets(const uint64_t bclk)
 {
   m_BclkStack.erase(m_BclkStack.begin(), m_BclkStack.upper_bound(bclk));
-  m_MvtxRawHitMap.erase(m_MvtxRawHitMap.begin(), m_MvtxRawHitMap.upper_bound(bclk));
+  m_MvtxRawHitMap.erase_until(bclk);
   m_FeeStrobeMap.erase(m_FeeStrobeMap.begin(), m_FeeStrobeMap.upper_bound(bclk));
   for(auto& [feeid, gtmbcoset] : m_FeeGTML1BCOMap)
   {
@@ -325,7 +325,7 @@ bool SingleMvtxPoolInput::GetSomeMoreEvents()
   {
     if (bcliter.second <= lowest_bclk)
     {
-      uint64_t highest_bclk = m_MvtxRawHitMap.rbegin()->first;
+      uint64_t highest_bclk = m_MvtxRawHitMap.back().first;
       if ((highest_bclk - m_MvtxRawHitMap.begin()->first) < MaxBclkDiff())
       {
         // std::cout << "FEE " << bcliter.first << " bclk: "
@@ -1,5 +1,6 @@
 #include "SinglePrdfInput.h"
 
+#include "EventPrefetcher.h"
 #include "Fun4AllPrdfInputPoolManager.h"
 
 #include <frog/FROG.h>
@@ -26,6 +27,7 @@ SinglePrdfInput::SinglePrdfInput(const std::string &name, Fun4AllPrdfInputPoolMa
 
 SinglePrdfInput::~SinglePrdfInput()
 {
+  delete m_Prefetcher;
   delete m_EventIterator;
   delete[] plist;
   delete[] m_PacketEventNumberOffset;
@@ -47,7 +49,7 @@ void SinglePrdfInput::FillPool(const unsigned int nevents)
   }
   for (unsigned int ievt = 0; ievt < nevents; ievt++)
   {
-    Event *evt = m_EventIterator->getNextEvent();
+    Event *evt = getNextEvent();
     if (!evt)
     {
       fileclose();
@@ -56,7 +58,7 @@ void SinglePrdfInput::FillPool(const unsigned int nevents)
         AllDone(1);
         return;
       }
-      evt = m_EventIterator->getNextEvent();
+      evt = getNextEvent();
       if (!evt)
       {
         std::cout << PHWHERE << "Event is nullptr" << std::endl;
@@ -357,6 +359,10 @@ int SinglePrdfInput::fileopen(const std::string &filenam)
     std::cout << PHWHERE << Name() << ": could not open file " << fname << std::endl;
     return -1;
   }
+  if (m_PrefetchDepth > 0)
+  {
+    m_Prefetcher = new EventPrefetcher(Name(), m_EventIterator, m_PrefetchDepth);
+  }
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
   return 0;
@@ -369,6 +375,16 @@ int SinglePrdfInput::fileclose()
     std::cout << Name() << ": fileclose: No Input file open" << std::endl;
     return -1;
   }
+  // the prefetch thread uses the event iterator, stop it first
+  if (m_Prefetcher)
+  {
+    if (Verbosity() > 0)
+    {
+      m_Prefetcher->Print();
+    }
+    delete m_Prefetcher;
+    m_Prefetcher = nullptr;
+  }
   delete m_EventIterator;
   m_EventIterator = nullptr;
   IsOpen(0);
@@ -378,6 +394,15 @@ int SinglePrdfInput::fileclose()
   return 0;
 }
 
+Event *SinglePrdfInput::getNextEvent()
+{
+  if (m_Prefetcher)
+  {
+    return m_Prefetcher->getNextEvent();
+  }
+  return m_EventIterator->getNextEvent();
+}
+
 void SinglePrdfInput::MakeReference(const bool b)
 {
   m_MeReferenceFlag = b;
@@ -12,6 +12,8 @@
 #include <utility>  // for pair
 #include <vector>
 
+class Event;
+class EventPrefetcher;
 class Eventiterator;
 class Fun4AllPrdfInputPoolManager;
 class Packet;
@@ -22,6 +24,12 @@ class SinglePrdfInput : public Fun4AllBase, public InputFileHandler
   explicit SinglePrdfInput(const std::string &name, Fun4AllPrdfInputPoolManager *inman);
   ~SinglePrdfInput() override;
   Eventiterator *GetEventIterator() { return m_EventIterator; }
+  //! next event, taken from the prefetch queue if prefetching is enabled
+  Event *getNextEvent();
+  //! read up to n events ahead on a background thread, 0 (default) reads in the event loop.
+  //! Takes effect when the next file is opened
+  void PrefetchDepth(const unsigned int n) { m_PrefetchDepth = n; }
+  unsigned int PrefetchDepth() const { return m_PrefetchDepth; }
   virtual void FillPool(const unsigned int nevents);
   int RunNumber() const { return m_RunNumber; }
   void RunNumber(const int irun) { m_RunNumber = irun; }
@@ -45,6 +53,7 @@ class SinglePrdfInput : public Fun4AllBase, public InputFileHandler
     unsigned int EventFoundCounter = 0;
   };
   Eventiterator *m_EventIterator = nullptr;
+  EventPrefetcher *m_Prefetcher = nullptr;
   Fun4AllPrdfInputPoolManager *m_InputMgr = nullptr;
   Packet **plist = nullptr;
   unsigned int m_NumSpecialEvents = 0;
@@ -52,6 +61,7 @@ class SinglePrdfInput : public Fun4AllBase, public InputFileHandler
   int *m_PacketEventNumberOffset = nullptr;  // packet event counters start at 0 but we start with event number 1
   int m_RunNumber = 0;
   int m_EventsThisFile = 0;
+  unsigned int m_PrefetchDepth = 0;
   int m_AllDone = 0;
   bool m_MeReferenceFlag = false;
   std::map<int, std::vector<Packet *>> m_PacketMap;
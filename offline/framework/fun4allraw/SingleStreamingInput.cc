@@ -1,9 +1,12 @@
 #include "SingleStreamingInput.h"
 
+#include "EventPrefetcher.h"
+
 #include <frog/FROG.h>
 
 #include <phool/phool.h>
 
+#include <Event/Event.h>
 #include <Event/Eventiterator.h>
 #include <Event/fileEventiterator.h>
 
@@ -19,6 +22,7 @@ SingleStreamingInput::SingleStreamingInput(const std::string &name)
 
 SingleStreamingInput::~SingleStreamingInput()
 {
+  delete m_Prefetcher;
   delete m_EventIterator;
 }
 
@@ -49,6 +53,10 @@ int SingleStreamingInput::fileopen(const std::string &filenam)
     std::cout << PHWHERE << Name() << ": could not open file " << fname << std::endl;
     return -1;
   }
+  if (m_PrefetchDepth > 0)
+  {
+    m_Prefetcher = new EventPrefetcher(Name(), m_EventIterator, m_PrefetchDepth);
+  }
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
   return 0;
@@ -61,6 +69,16 @@ int SingleStreamingInput::fileclose()
     std::cout << Name() << ": fileclose: No Input file open" << std::endl;
     return -1;
   }
+  // the prefetch thread uses the event iterator, stop it first
+  if (m_Prefetcher)
+  {
+    if (Verbosity() > 0)
+    {
+      m_Prefetcher->Print();
+    }
+    delete m_Prefetcher;
+    m_Prefetcher = nullptr;
+  }
   delete m_EventIterator;
   m_EventIterator = nullptr;
   IsOpen(0);
@@ -70,8 +88,21 @@ int SingleStreamingInput::fileclose()
   return 0;
 }
 
+Event *SingleStreamingInput::getNextEvent()
+{
+  if (m_Prefetcher)
+  {
+    return m_Prefetcher->getNextEvent();
+  }
+  return m_EventIterator->getNextEvent();
+}
+
 void SingleStreamingInput::Print(const std::string &what) const
 {
+  if ((what == "ALL" || what == "PREFETCH") && m_Prefetcher)
+  {
+    m_Prefetcher->Print();
+  }
   if (what == "ALL" || what == "FEE")
   {
     for (const auto &bcliter : m_BeamClockFEE)
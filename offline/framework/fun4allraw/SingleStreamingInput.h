@@ -9,6 +9,8 @@
 #include <set>
 #include <string>
 
+class Event;
+class EventPrefetcher;
 class Eventiterator;
 class Fun4AllEvtInputPoolManager;
 class Fun4AllStreamingInputManager;
@@ -20,6 +22,12 @@ class SingleStreamingInput : public Fun4AllBase, public InputFileHandler
   explicit SingleStreamingInput(const std::string &name);
   ~SingleStreamingInput() override;
   virtual Eventiterator *GetEventIterator() { return m_EventIterator; }
+  //! next event, taken from the prefetch queue if prefetching is enabled
+  Event *getNextEvent();
+  //! read up to n events ahead on a background thread, 0 (default) reads in the event loop.
+  //! Takes effect when the next file is opened
+  void PrefetchDepth(const unsigned int n) { m_PrefetchDepth = n; }
+  unsigned int PrefetchDepth() const { return m_PrefetchDepth; }
   virtual void FillPool(const uint64_t) { return; }
   virtual void FillPool(const unsigned int = 1) { return; }
   virtual void RunNumber(const int runno) { m_RunNumber = runno; }
@@ -112,12 +120,14 @@ class SingleStreamingInput : public Fun4AllBase, public InputFileHandler
 
  private:
   Eventiterator *m_EventIterator{nullptr};
+  EventPrefetcher *m_Prefetcher{nullptr};
   //  Fun4AllEvtInputPoolManager *m_InputMgr {nullptr};
   Fun4AllStreamingInputManager *m_StreamingInputMgr{nullptr};
   uint64_t m_MaxBclkSpread{1000000};
   unsigned int m_EventNumberOffset{1};  // packet event counters start at 0 but we start with event number 1
   int m_RunNumber{0};
   int m_EventsThisFile{0};
+  unsigned int m_PrefetchDepth{0};
   int m_AllDone{0};
   int m_SubsystemEnum{0};
   std::map<uint64_t, std::set<int>> m_BeamClockFEE;
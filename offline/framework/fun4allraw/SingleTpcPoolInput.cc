@@ -42,7 +42,7 @@ void SingleTpcPoolInput::FillPool(const uint64_t minBCO)
   //  std::set<uint64_t> saved_beamclocks;
   while (GetSomeMoreEvents(0))
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(getNextEvent());
     while (!evt)
     {
       fileclose();
@@ -51,7 +51,7 @@ void SingleTpcPoolInput::FillPool(const uint64_t minBCO)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(getNextEvent());
     }
     if (Verbosity() > 2)
     {
@@ -351,8 +351,8 @@ void SingleTpcPoolInput::CleanupUsedPackets(const uint64_t bclk)
   {
     m_BclkStack.erase(iter);
     m_BeamClockFEE.erase(iter);
-    m_TpcRawHitMap.erase(iter);
   }
+  m_TpcRawHitMap.erase_until(bclk);
 }
 
 bool SingleTpcPoolInput::CheckPoolDepth(const uint64_t bclk)
@@ -418,7 +418,7 @@ bool SingleTpcPoolInput::GetSomeMoreEvents(const uint64_t ibclk)
   {
     if (bcliter.second <= localbclk)
     {
-      uint64_t highest_bclk = m_TpcRawHitMap.rbegin()->first;
+      uint64_t highest_bclk = m_TpcRawHitMap.back().first;
       if ((highest_bclk - m_TpcRawHitMap.begin()->first) < MaxBclkDiff())
       {
         // std::cout << "FEE " << bcliter.first << " bclk: "
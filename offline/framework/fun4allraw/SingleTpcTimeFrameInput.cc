@@ -209,7 +209,7 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
     }
 
     TimeTracker getNextEventTimer(m_getNextEventTimer, "getNextEvent", m_hNorm);
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(getNextEvent());
     while (!evt)
     {
       fileclose();
@@ -218,7 +218,7 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(getNextEvent());
       RunNumber(0);
     }
 
@@ -1,10 +1,13 @@
 #include "SingleTriggerInput.h"
 
+#include "EventPrefetcher.h"
+
 #include <frog/FROG.h>
 
 #include <ffarawobjects/CaloPacket.h>
 #include <phool/phool.h>
 
+#include <Event/Event.h>
 #include <Event/Eventiterator.h>
 #include <Event/fileEventiterator.h>
 #include <Event/packet.h>
@@ -30,6 +33,7 @@ SingleTriggerInput::~SingleTriggerInput()
     delete openfiles.second;
   }
   m_PacketDumpFile.clear();
+  delete m_Prefetcher;
   delete m_EventIterator;
 }
 
@@ -60,6 +64,10 @@ int SingleTriggerInput::fileopen(const std::string &filenam)
     std::cout << PHWHERE << Name() << ": could not open file " << fname << std::endl;
     return -1;
   }
+  if (m_PrefetchDepth > 0)
+  {
+    m_Prefetcher = new EventPrefetcher(Name(), m_EventIterator, m_PrefetchDepth);
+  }
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
   return 0;
@@ -72,6 +80,16 @@ int SingleTriggerInput::fileclose()
     std::cout << Name() << ": fileclose: No Input file open" << std::endl;
     return -1;
   }
+  // the prefetch thread uses the event iterator, stop it first
+  if (m_Prefetcher)
+  {
+    if (Verbosity() > 0)
+    {
+      m_Prefetcher->Print();
+    }
+    delete m_Prefetcher;
+    m_Prefetcher = nullptr;
+  }
   delete m_EventIterator;
   m_EventIterator = nullptr;
   IsOpen(0);
@@ -81,8 +99,21 @@ int SingleTriggerInput::fileclose()
   return 0;
 }
 
+Event *SingleTriggerInput::getNextEvent()
+{
+  if (m_Prefetcher)
+  {
+    return m_Prefetcher->getNextEvent();
+  }
+  return m_EventIterator->getNextEvent();
+}
+
 void SingleTriggerInput::Print(const std::string &what) const
 {
+  if ((what == "ALL" || what == "PREFETCH") && m_Prefetcher)
+  {
+    m_Prefetcher->Print();
+  }
   if (what == "ALL" || what == "FEE")
   {
     for (const auto &bcliter : m_BeamClockFEE)
@@ -12,6 +12,8 @@
 #include <string>
 #include <vector>
 
+class Event;
+class EventPrefetcher;
 class Eventiterator;
 class Fun4AllPrdfInputTriggerManager;
 class OfflinePacket;
@@ -24,6 +26,12 @@ class SingleTriggerInput : public Fun4AllBase, public InputFileHandler
   explicit SingleTriggerInput(const std::string &name);
   ~SingleTriggerInput() override;
   virtual Eventiterator *GetEventIterator() { return m_EventIterator; }
+  //! next event, taken from the prefetch queue if prefetching is enabled
+  Event *getNextEvent();
+  //! read up to n events ahead on a background thread, 0 (default) reads in the event loop.
+  //! Takes effect when the next file is opened
+  void PrefetchDepth(const unsigned int n) { m_PrefetchDepth = n; }
+  unsigned int PrefetchDepth() const { return m_PrefetchDepth; }
   virtual void FillPool(const unsigned int = 1) { return; }
   virtual void RunNumber(const int runno) { m_RunNumber = runno; }
   virtual int RunNumber() const { return m_RunNumber; }
@@ -69,10 +77,12 @@ class SingleTriggerInput : public Fun4AllBase, public InputFileHandler
   // we have accessors for these here
  private:
   Eventiterator *m_EventIterator{nullptr};
+  EventPrefetcher *m_Prefetcher{nullptr};
   Fun4AllPrdfInputTriggerManager *m_TriggerInputMgr{nullptr};
   int m_ddump_flag{0};
   int m_RunNumber{0};
   int m_EventsThisFile{0};
+  unsigned int m_PrefetchDepth{0};
   int m_AllDone{0};
   int m_SubsystemEnum{0};
   int m_DefaultEventNumberOffset{0};
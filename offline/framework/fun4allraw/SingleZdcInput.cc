@@ -44,7 +44,7 @@ void SingleZdcInput::FillPool(const unsigned int nevents)
   }
   for (unsigned int ievt = 0; ievt < nevents; ievt++)
   {
-    Event *evt = GetEventIterator()->getNextEvent();
+    Event *evt = getNextEvent();
     if (!evt)
     {
       fileclose();
@@ -53,7 +53,7 @@ void SingleZdcInput::FillPool(const unsigned int nevents)
         AllDone(1);
         return;
       }
-      evt = GetEventIterator()->getNextEvent();
+      evt = getNextEvent();
       if (!evt)
       {
         std::cout << PHWHERE << "Event is nullptr" << std::endl;
@@ -0,0 +1,198 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALLRAW_STREAMINGBCOINDEX_H
+#define FUN4ALLRAW_STREAMINGBCOINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+//! time ordered BCO -> payload index for the streaming event builders
+/*!
+ * Drop in replacement for the std::map<uint64_t, T> used to stage raw hits
+ * by beam clock. Entries are kept sorted by BCO in a ring buffer:
+ * - data arrives mostly in BCO order, so inserting a new BCO is a push at
+ *   the back, an out of order BCO is moved down to its place by swapping
+ *   with its (few) successors
+ * - lookup of an existing BCO checks the newest entry first, then bisects
+ * - consuming the oldest BCOs (pop_front, erase_until) only moves the head
+ *
+ * Slots are not freed when an entry is consumed, the payload is clear()'ed
+ * and reused for the next BCO which lands in that slot. So after the first few
+ * hundred crossings the per BCO hit vectors do not allocate anymore.
+ * T must provide clear().
+ *
+ * Iterators follow the std::map conventions (it->first is the BCO,
+ * it->second the payload) and are invalidated by any insertion or removal.
+ */
+template <class T>
+class StreamingBcoIndex
+{
+ public:
+  using value_type = std::pair<uint64_t, T>;
+
+  template <class Index, class Value>
+  class Iterator
+  {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = Value;
+    using pointer = Value *;
+    using reference = Value &;
+
+    Iterator(Index *index, std::size_t pos)
+      : m_index(index)
+      , m_pos(pos)
+    {
+    }
+    reference operator*() const { return m_index->at(m_pos); }
+    pointer operator->() const { return &m_index->at(m_pos); }
+    Iterator &operator++()
+    {
+      ++m_pos;
+      return *this;
+    }
+    bool operator==(const Iterator &other) const { return m_pos == other.m_pos; }
+    bool operator!=(const Iterator &other) const { return m_pos != other.m_pos; }
+
+   private:
+    Index *m_index{nullptr};
+    std::size_t m_pos{0};
+  };
+
+  using iterator = Iterator<StreamingBcoIndex, value_type>;
+  using const_iterator = Iterator<const StreamingBcoIndex, const value_type>;
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, m_size); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, m_size); }
+
+  //! oldest BCO, index must not be empty
+  value_type &front() { return at(0); }
+  const value_type &front() const { return at(0); }
+
+  //! newest BCO, index must not be empty
+  value_type &back() { return at(m_size - 1); }
+  const value_type &back() const { return at(m_size - 1); }
+
+  //! entry for bco, end() if there is none
+  iterator find(const uint64_t bco)
+  {
+    const std::size_t pos = lower_bound(bco);
+    return (pos < m_size && at(pos).first == bco) ? iterator(this, pos) : end();
+  }
+  const_iterator find(const uint64_t bco) const
+  {
+    const std::size_t pos = lower_bound(bco);
+    return (pos < m_size && at(pos).first == bco) ? const_iterator(this, pos) : end();
+  }
+
+  //! payload for bco, a new (empty) entry is created if needed
+  T &operator[](const uint64_t bco)
+  {
+    if (m_size > 0)
+    {
+      // most hits belong to the latest BCO
+      if (back().first == bco)
+      {
+        return back().second;
+      }
+      if (back().first > bco)
+      {
+        const std::size_t pos = lower_bound(bco);
+        if (at(pos).first == bco)
+        {
+          return at(pos).second;
+        }
+      }
+    }
+    if (m_size == m_ring.size())
+    {
+      grow();
+    }
+    std::size_t pos = m_size++;
+    value_type &slot = at(pos);
+    slot.first = bco;
+    slot.second.clear();
+    // move the new entry down to its place
+    while (pos > 0 && at(pos - 1).first > bco)
+    {
+      std::swap(at(pos - 1), at(pos));
+      --pos;
+    }
+    return at(pos).second;
+  }
+
+  //! remove the oldest BCO, index must not be empty
+  void pop_front()
+  {
+    m_head = (m_head + 1) & (m_ring.size() - 1);
+    --m_size;
+  }
+
+  //! remove all BCOs <= bco, same as map.erase(map.begin(), map.upper_bound(bco))
+  void erase_until(const uint64_t bco)
+  {
+    while (m_size > 0 && front().first <= bco)
+    {
+      pop_front();
+    }
+  }
+
+  void clear()
+  {
+    m_head = 0;
+    m_size = 0;
+  }
+
+  //! entry at logical position pos, 0 is the oldest BCO
+  value_type &at(const std::size_t pos) { return m_ring[(m_head + pos) & (m_ring.size() - 1)]; }
+  const value_type &at(const std::size_t pos) const { return m_ring[(m_head + pos) & (m_ring.size() - 1)]; }
+
+ private:
+  //! first logical position with BCO >= bco
+  std::size_t lower_bound(const uint64_t bco) const
+  {
+    std::size_t lo = 0;
+    std::size_t hi = m_size;
+    while (lo < hi)
+    {
+      const std::size_t mid = (lo + hi) / 2;
+      if (at(mid).first < bco)
+      {
+        lo = mid + 1;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  //! double the ring size (always a power of two), the payloads are moved
+  void grow()
+  {
+    std::vector<value_type> ring(std::max<std::size_t>(2 * m_ring.size(), 64));
+    for (std::size_t i = 0; i < m_size; ++i)
+    {
+      ring[i] = std::move(at(i));
+    }
+    m_ring.swap(ring);
+    m_head = 0;
+  }
+
+  std::vector<value_type> m_ring;
+  std::size_t m_head{0};
+  std::size_t m_size{0};
+};
+
+#endif
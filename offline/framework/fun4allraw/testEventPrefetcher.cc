@@ -0,0 +1,119 @@
+// compares the events delivered by the EventPrefetcher with the events read
+// directly from a second Eventiterator on the same file (the serial path)
+//
+// usage: testEventPrefetcher <prdf file> [prefetch depth, default 4]
+// returns 0 if all events and packets are identical
+
+#include "EventPrefetcher.h"
+
+#include <Event/Event.h>
+#include <Event/fileEventiterator.h>
+#include <Event/packet.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  std::vector<int> raw_words(Event *evt)
+  {
+    std::vector<int> words(evt->getEvtLength() + 1);
+    int nw = 0;
+    evt->Copy(words.data(), words.size(), &nw);
+    words.resize(nw);
+    return words;
+  }
+
+  bool same_packets(Event *serial, Event *prefetched)
+  {
+    constexpr int maxpackets = 10000;
+    std::vector<Packet *> serial_packets(maxpackets, nullptr);
+    std::vector<Packet *> prefetched_packets(maxpackets, nullptr);
+    const int nserial = serial->getPacketList(serial_packets.data(), maxpackets);
+    const int nprefetched = prefetched->getPacketList(prefetched_packets.data(), maxpackets);
+    bool same = (nserial == nprefetched);
+    for (int i = 0; same && i < nserial; i++)
+    {
+      same = serial_packets[i]->getIdentifier() == prefetched_packets[i]->getIdentifier() &&
+             serial_packets[i]->getLength() == prefetched_packets[i]->getLength() &&
+             serial_packets[i]->getHitFormat() == prefetched_packets[i]->getHitFormat();
+    }
+    for (int i = 0; i < nserial; i++)
+    {
+      delete serial_packets[i];
+    }
+    for (int i = 0; i < nprefetched; i++)
+    {
+      delete prefetched_packets[i];
+    }
+    return same;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+    std::cout << "usage: " << argv[0] << " <prdf file> [prefetch depth]" << std::endl;
+    return 1;
+  }
+  const unsigned int depth = (argc > 2) ? std::stoul(argv[2]) : 4;
+
+  int status = 0;
+  fileEventiterator serial_iter(argv[1], status);
+  if (status)
+  {
+    std::cout << "could not open " << argv[1] << std::endl;
+    return 1;
+  }
+  fileEventiterator prefetched_iter(argv[1], status);
+  if (status)
+  {
+    std::cout << "could not open " << argv[1] << " a second time" << std::endl;
+    return 1;
+  }
+
+  int nevents = 0;
+  int ndiff = 0;
+  {
+    EventPrefetcher prefetcher("testEventPrefetcher", &prefetched_iter, depth);
+    while (true)
+    {
+      Event *serial = serial_iter.getNextEvent();
+      Event *prefetched = prefetcher.getNextEvent();
+      // let the prefetch thread refill its queue, the iterator reads the
+      // following events while we still look at this one
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      if (!serial || !prefetched)
+      {
+        if (serial || prefetched)
+        {
+          std::cout << "event count differs after " << nevents << " events" << std::endl;
+          ndiff++;
+        }
+        delete serial;
+        delete prefetched;
+        break;
+      }
+      if (serial->getEvtSequence() != prefetched->getEvtSequence() ||
+          serial->getEvtType() != prefetched->getEvtType() ||
+          raw_words(serial) != raw_words(prefetched) ||
+          !same_packets(serial, prefetched))
+      {
+        std::cout << "event " << nevents << " (sequence " << serial->getEvtSequence()
+                  << ") differs from the serial read" << std::endl;
+        ndiff++;
+      }
+      nevents++;
+      delete serial;
+      delete prefetched;
+    }
+    prefetcher.Print();
+  }
+  std::cout << nevents << " events compared with prefetch depth " << depth
+            << ", " << ndiff << " differences" << std::endl;
+  return (ndiff > 0) ? 1 : 0;
+}
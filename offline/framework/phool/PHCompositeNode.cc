@@ -51,11 +51,71 @@ bool PHCompositeNode::addNode(PHNode* newNode)
   // No conflict, so we can append the new node.
   //
   newNode->setParent(this);
+  treeChanged();
   return (subNodes.append(newNode));
 }
 
+void PHCompositeNode::updateIndex()
+{
+  const unsigned long version = treeVersion();
+  if (indexVersion == version)
+  {
+    return;
+  }
+  nodeIndex.clear();
+  fillIndex(this);
+  indexVersion = version;
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void PHCompositeNode::fillIndex(PHCompositeNode* node)
+{
+  PHPointerListIterator<PHNode> nodeIter(node->subNodes);
+  PHNode* thisNode;
+  while ((thisNode = nodeIter()))
+  {
+    nodeIndex[thisNode->getName()].push_back(thisNode);
+    if (thisNode->getType() == "PHCompositeNode")
+    {
+      fillIndex(static_cast<PHCompositeNode*>(thisNode));
+    }
+  }
+}
+
+PHNode* PHCompositeNode::findFirst(const std::string& requiredName)
+{
+  std::lock_guard<std::mutex> lock(indexMutex);
+  updateIndex();
+  auto iter = nodeIndex.find(requiredName);
+  if (iter == nodeIndex.end())
+  {
+    return nullptr;
+  }
+  return iter->second.front();
+}
+
+PHNode* PHCompositeNode::findFirst(const std::string& requiredType, const std::string& requiredName)
+{
+  std::lock_guard<std::mutex> lock(indexMutex);
+  updateIndex();
+  auto iter = nodeIndex.find(requiredName);
+  if (iter == nodeIndex.end())
+  {
+    return nullptr;
+  }
+  for (PHNode* node : iter->second)
+  {
+    if (node->getType() == requiredType)
+    {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
 void PHCompositeNode::prune()
 {
+  treeChanged();
   PHPointerListIterator<PHNode> nodeIter(subNodes);
   PHNode* thisNode;
   while ((thisNode = nodeIter()))
@@ -75,6 +135,7 @@ void PHCompositeNode::prune()
 
 void PHCompositeNode::forgetMe(PHNode* child)
 {
+  treeChanged();
   // if this PHCompositeNode is supposed to be deleted,
   // do not remove the child from the list,
   // otherwise the clearanddestroy() bookkeeping gets
@@ -7,7 +7,11 @@
 #include "PHNode.h"
 #include "PHPointerList.h"
 
+#include <limits>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class PHIOManager;
 
@@ -31,6 +35,14 @@ class PHCompositeNode : public PHNode
   //
   void prune() override;
 
+  //
+  // Search this subtree depth first, same result as PHNodeIterator::findFirst.
+  // The nodes are looked up in a name index which is rebuilt on the first
+  // search after the structure of the node tree changed
+  //
+  PHNode *findFirst(const std::string &name);
+  PHNode *findFirst(const std::string &type, const std::string &name);
+
   //
   // I/O functions
   //
@@ -44,6 +56,13 @@ class PHCompositeNode : public PHNode
 
  private:
   PHCompositeNode() = delete;
+  void updateIndex();
+  void fillIndex(PHCompositeNode *);
+
+  // all nodes in this subtree with a given name, in depth first order
+  std::unordered_map<std::string, std::vector<PHNode *>> nodeIndex;
+  unsigned long indexVersion = std::numeric_limits<unsigned long>::max();
+  std::mutex indexMutex;
 };
 
 #endif
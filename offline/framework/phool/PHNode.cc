@@ -14,6 +14,8 @@
 
 #include <iostream>
 
+std::atomic<unsigned long> PHNode::version_counter{0};
+
 PHNode::PHNode(const std::string& n)
   : PHNode(n, "")
 {
@@ -52,12 +54,33 @@ PHNode::PHNode(const std::string& n, const std::string& typ)
 
 PHNode::~PHNode()
 {
+  treeChanged();
   if (parent)
   {
     parent->forgetMe(this);
   }
 }
 
+PHNode* PHNode::getRoot()
+{
+  PHNode* node = this;
+  while (node->parent)
+  {
+    node = node->parent;
+  }
+  return node;
+}
+
+const PHNode* PHNode::getRoot() const
+{
+  const PHNode* node = this;
+  while (node->parent)
+  {
+    node = node->parent;
+  }
+  return node;
+}
+
 // Implementation of external functions.
 std::ostream&
 operator<<(std::ostream& stream, const PHNode& node)
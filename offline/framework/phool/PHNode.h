@@ -4,6 +4,7 @@
 //  Declaration of class PHNode
 //  Purpose: abstract base class for all node classes
 
+#include <atomic>
 #include <iosfwd>
 #include <string>
 
@@ -25,8 +26,20 @@ class PHNode
   const std::string getType() const { return type; }
   const std::string getName() const { return name; }
   const std::string getClass() const { return objectclass; }
-  void setParent(PHNode *p) { parent = p; }
-  void setName(const std::string &n) { name = n; }
+  void setParent(PHNode *p)
+  {
+    if (parent)
+    {
+      treeChanged();
+    }
+    parent = p;
+    treeChanged();
+  }
+  void setName(const std::string &n)
+  {
+    name = n;
+    treeChanged();
+  }
   void setObjectType(const std::string &n) { objecttype = n; }
   virtual void prune() = 0;
   virtual void print(const std::string &) = 0;
@@ -37,7 +50,17 @@ class PHNode
   virtual bool getResetFlag() const { return reset_able; }
   void makeTransient() { persistent = false; }
 
+  //! version of the node tree this node belongs to, kept on the root node.
+  //! It changes whenever the structure of this tree changes (nodes added,
+  //! removed, renamed or moved). Versions are unique across all trees, so
+  //! changes in other trees do not invalidate the lookup index of PHCompositeNode
+  unsigned long treeVersion() const { return getRoot()->tree_version; }
+
  protected:
+  void treeChanged() { getRoot()->tree_version = ++version_counter; }
+  PHNode *getRoot();
+  const PHNode *getRoot() const;
+
   PHNode *parent = nullptr;
   bool persistent = true;
   std::string type = "PHNode";
@@ -47,6 +70,9 @@ class PHNode
   std::string objectclass;
 
  private:
+  static std::atomic<unsigned long> version_counter;
+  std::atomic<unsigned long> tree_version{++version_counter};
+
   PHNode() = delete;
   PHNode(const PHNode &) = delete;
   PHNode &operator=(const PHNode &) = delete;
@@ -0,0 +1,134 @@
+#include "PHThreadPool.h"
+
+PHThreadPool::PHThreadPool(unsigned int nthreads)
+{
+  if (nthreads == 0)
+  {
+    nthreads = std::thread::hardware_concurrency();
+  }
+  if (nthreads == 0)
+  {
+    nthreads = 1;
+  }
+  m_queues.reserve(nthreads);
+  for (unsigned int i = 0; i < nthreads; ++i)
+  {
+    m_queues.emplace_back(new WorkQueue);
+  }
+  m_workers.reserve(nthreads);
+  for (unsigned int i = 0; i < nthreads; ++i)
+  {
+    m_workers.emplace_back(&PHThreadPool::worker_loop, this, i);
+  }
+}
+
+PHThreadPool::~PHThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all();
+  for (auto &worker : m_workers)
+  {
+    worker.join();
+  }
+}
+
+void PHThreadPool::parallel_for(std::size_t ntasks, const Task &func)
+{
+  if (ntasks == 0)
+  {
+    return;
+  }
+  // deal tasks round robin, the workers are idle so no locking is needed here
+  const unsigned int nworkers = size();
+  for (std::size_t task = 0; task < ntasks; ++task)
+  {
+    m_queues[task % nworkers]->tasks.push_back(task);
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_func = &func;
+  m_exception = nullptr;
+  m_active = nworkers;
+  ++m_generation;
+  m_start.notify_all();
+  m_done.wait(lock, [this]
+              { return m_active == 0; });
+  m_func = nullptr;
+  if (m_exception)
+  {
+    std::rethrow_exception(m_exception);
+  }
+}
+
+bool PHThreadPool::next_task(unsigned int worker, std::size_t &task)
+{
+  {
+    WorkQueue &own = *m_queues[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty())
+    {
+      task = own.tasks.front();
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+  const unsigned int nworkers = size();
+  for (unsigned int i = 1; i < nworkers; ++i)
+  {
+    WorkQueue &victim = *m_queues[(worker + i) % nworkers];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty())
+    {
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void PHThreadPool::worker_loop(unsigned int worker)
+{
+  unsigned long seen_generation = 0;
+  while (true)
+  {
+    const Task *func = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start.wait(lock, [this, seen_generation]
+                   { return m_stop || m_generation != seen_generation; });
+      if (m_stop)
+      {
+        return;
+      }
+      seen_generation = m_generation;
+      func = m_func;
+    }
+
+    std::size_t task = 0;
+    while (next_task(worker, task))
+    {
+      try
+      {
+        (*func)(task, worker);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exception)
+        {
+          m_exception = std::current_exception();
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_active == 0)
+    {
+      m_done.notify_one();
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef PHOOL_PHTHREADPOOL_H
+#define PHOOL_PHTHREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! persistent pool of worker threads for data parallel loops inside a module
+/*!
+ * The workers are started once (typically in InitRun) and stay alive until
+ * the pool is destroyed, so there is no per event thread creation.
+ * parallel_for(ntasks, func) calls func(task, worker) for every task in [0, ntasks)
+ * and returns when all of them are done. Tasks are dealt round robin into one queue
+ * per worker. A worker takes tasks from the front of its own queue and, once that
+ * is empty, steals from the back of the other queues, so uneven task sizes are
+ * balanced automatically. The worker index can be used to address per thread
+ * scratch buffers which need no locking.
+ *
+ * parallel_for is not reentrant: it must not be called from within a task
+ */
+class PHThreadPool
+{
+ public:
+  using Task = std::function<void(std::size_t /*task*/, unsigned int /*worker*/)>;
+
+  //! create pool with nthreads workers, 0 uses the number of hardware threads
+  explicit PHThreadPool(unsigned int nthreads = 0);
+  ~PHThreadPool();
+
+  PHThreadPool(const PHThreadPool &) = delete;
+  PHThreadPool &operator=(const PHThreadPool &) = delete;
+
+  //! number of worker threads
+  unsigned int size() const { return m_workers.size(); }
+
+  //! run func for each task in [0, ntasks), blocks until all tasks are done.
+  //! The first exception thrown by a task is rethrown in the calling thread
+  void parallel_for(std::size_t ntasks, const Task &func);
+
+ private:
+  //! task queue of one worker
+  struct WorkQueue
+  {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+  };
+
+  void worker_loop(unsigned int worker);
+
+  //! get next task, own queue first then steal from the others
+  bool next_task(unsigned int worker, std::size_t &task);
+
+  std::vector<std::thread> m_workers;
+  std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_done;
+  const Task *m_func = nullptr;
+  unsigned long m_generation = 0;
+  unsigned int m_active = 0;
+  bool m_stop = false;
+  std::exception_ptr m_exception;
+};
+
+#endif
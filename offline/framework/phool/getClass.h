@@ -1,6 +1,7 @@
 #ifndef PHOOL_GETCLASS_H
 #define PHOOL_GETCLASS_H
 
+#include "PHCompositeNode.h"
 #include "PHDataNode.h"
 #include "PHIODataNode.h"
 #include "PHNode.h"
@@ -10,15 +11,12 @@
 
 #include <string>
 
-class PHCompositeNode;
-
 namespace findNode
 {
+  //! object stored in a PHDataNode or PHIODataNode, nullptr if node is null or of wrong type
   template <class T>
-  T *getClass(PHCompositeNode *top, const std::string &name)
+  T *getNodeObject(PHNode *FoundNode)
   {
-    PHNodeIterator iter(top);
-    PHNode *FoundNode = iter.findFirst(name);  // returns pointer to PHNode
     if (!FoundNode)
     {
       return nullptr;
@@ -55,6 +53,65 @@ namespace findNode
 
     return nullptr;
   }
+
+  template <class T>
+  T *getClass(PHCompositeNode *top, const std::string &name)
+  {
+    PHNodeIterator iter(top);
+    PHNode *FoundNode = iter.findFirst(name);  // returns pointer to PHNode
+    return getNodeObject<T>(FoundNode);
+  }
+
+  //! handle to a node object for modules which want to avoid the name lookup
+  //! in every event. Resolve it once (e.g. in InitRun), get() then only
+  //! looks up the node again if the structure of the node tree changed.
+  //! The object itself is taken from the node at each call, so objects which
+  //! are replaced inside their node (like the PRDF event) are picked up
+  template <class T>
+  class NodeHandle
+  {
+   public:
+    NodeHandle() = default;
+    NodeHandle(PHCompositeNode *top, const std::string &name)
+    {
+      resolve(top, name);
+    }
+
+    T *resolve(PHCompositeNode *top, const std::string &name)
+    {
+      m_top = top;
+      m_name = name;
+      m_node = nullptr;
+      m_version = top ? top->treeVersion() - 1 : 0;
+      return get();
+    }
+
+    T *get()
+    {
+      if (!m_top)
+      {
+        return nullptr;
+      }
+      const unsigned long version = m_top->treeVersion();
+      if (m_version != version)
+      {
+        PHNodeIterator iter(m_top);
+        m_node = iter.findFirst(m_name);
+        m_version = version;
+      }
+      return getNodeObject<T>(m_node);
+    }
+
+    T *operator->() { return get(); }
+    explicit operator bool() { return get() != nullptr; }
+    const std::string &name() const { return m_name; }
+
+   private:
+    PHCompositeNode *m_top = nullptr;
+    PHNode *m_node = nullptr;
+    unsigned long m_version = 0;
+    std::string m_name;
+  };
 }  // namespace findNode
 
 #endif
@@ -3,11 +3,15 @@
 #include <iostream>
 
 // --------------------------------------------------
-Ort::Session *onnxSession(std::string &modelfile)
+Ort::Session *onnxSession(std::string &modelfile, int intraop_nthreads)
 {
   Ort::Env env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "fit");
   Ort::SessionOptions sessionOptions;
   sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+  if (intraop_nthreads > 0)
+  {
+    sessionOptions.SetIntraOpNumThreads(intraop_nthreads);
+  }
 
   return new Ort::Session(env, modelfile.c_str(), sessionOptions);
 }
@@ -63,3 +67,64 @@ std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &inpu
   session->Run(Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(), 1, outputNames.data(), outputTensors.data(), 1);
   return outputTensorValues;
 }
+
+OnnxBatchInference::OnnxBatchInference(Ort::Session *session, const std::vector<int64_t> &itemshape, int64_t nreturn)
+  : m_session(session)
+  , m_memoryInfo(Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault))
+  , m_nreturn(nreturn)
+{
+  m_inputDims.push_back(0);
+  for (auto dim : itemshape)
+  {
+    m_inputDims.push_back(dim);
+    m_itemsize *= dim;
+  }
+  m_outputDims = {0, nreturn};
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  char *name = m_session->GetInputName(0, allocator);
+  m_inputName = name;
+  allocator.Free(name);
+  name = m_session->GetOutputName(0, allocator);
+  m_outputName = name;
+  allocator.Free(name);
+}
+
+float *OnnxBatchInference::input(int N)
+{
+  size_t len = N * m_itemsize;
+  if (m_input.size() < len)
+  {
+    m_input.resize(len);
+  }
+  return m_input.data();
+}
+
+const float *OnnxBatchInference::run(int N)
+{
+  size_t inputlen = N * m_itemsize;
+  size_t outputlen = N * m_nreturn;
+  if (m_input.size() < inputlen)
+  {
+    m_input.resize(inputlen);
+  }
+  if (m_output.size() < outputlen)
+  {
+    m_output.resize(outputlen);
+  }
+  if (N == 0)
+  {
+    return m_output.data();
+  }
+  m_inputDims[0] = N;
+  m_outputDims[0] = N;
+
+  // the tensors only wrap the existing buffers, nothing is copied
+  Ort::Value inputTensor = Ort::Value::CreateTensor<float>(m_memoryInfo, m_input.data(), inputlen, m_inputDims.data(), m_inputDims.size());
+  Ort::Value outputTensor = Ort::Value::CreateTensor<float>(m_memoryInfo, m_output.data(), outputlen, m_outputDims.data(), m_outputDims.size());
+
+  const char *inputNames[] = {m_inputName.c_str()};
+  const char *outputNames[] = {m_outputName.c_str()};
+  m_session->Run(Ort::RunOptions{nullptr}, inputNames, &inputTensor, 1, outputNames, &outputTensor, 1);
+  return m_output.data();
+}
@@ -7,12 +7,53 @@
 #include <onnxruntime_cxx_api.h>
 #pragma GCC diagnostic pop
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 // This is a stub for some ONNX code refactoring
 
-Ort::Session *onnxSession(std::string &modelfile);
+//! intraop_nthreads sets the number of threads used inside an operator, 0 is the onnxruntime default
+Ort::Session *onnxSession(std::string &modelfile, int intraop_nthreads = 0);
 
 std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &input, int N, int Nsamp, int Nreturn);
 
 std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &input, int N, int Nx, int Ny, int Nz, int Nreturn);
 
+//! batched inference: inputs of N items are packed into one [N, ...] tensor and
+//! the session is run once. The input and output buffers are kept between calls
+//! (they only grow) and the input/output names are looked up once
+class OnnxBatchInference
+{
+ public:
+  //! itemshape is the shape of a single item without the batch dimension,
+  //! e.g. {31} for waveforms or {5, 5, 1} for tower images
+  OnnxBatchInference(Ort::Session *session, const std::vector<int64_t> &itemshape, int64_t nreturn);
+
+  //! number of input values per item
+  int64_t itemsize() const { return m_itemsize; }
+
+  //! number of output values per item
+  int64_t nreturn() const { return m_nreturn; }
+
+  //! input buffer for N items, item i starts at i * itemsize()
+  float *input(int N);
+
+  //! run on the first N items of the input buffer, returns N * nreturn() values
+  //! which stay valid until the next call
+  const float *run(int N);
+
+ private:
+  Ort::Session *m_session{nullptr};
+  Ort::MemoryInfo m_memoryInfo;
+  std::vector<int64_t> m_inputDims;
+  std::vector<int64_t> m_outputDims;
+  int64_t m_itemsize{1};
+  int64_t m_nreturn{1};
+  std::string m_inputName;
+  std::string m_outputName;
+  std::vector<float> m_input;
+  std::vector<float> m_output;
+};
+
 #endif
@@ -74,6 +74,12 @@ int CaloTowerBuilder::InitRun(PHCompositeNode *topNode)
   {
     WaveformProcessing->set_bitFlipRecovery(m_dobitfliprecovery);
   }
+  WaveformProcessing->set_templatefit_validation(m_validate_templatefit);
+  WaveformProcessing->set_templatefit_tolerance(m_tolerance_amp, m_tolerance_time, m_tolerance_ped, m_tolerance_chi2);
+  WaveformProcessing->set_fastfit_newton_steps(m_fastfit_newton_steps);
+  WaveformProcessing->set_fastfit_scan_step(m_fastfit_scan_step);
+  WaveformProcessing->set_onnx_batch(m_onnx_batch);
+  WaveformProcessing->set_onnx_nthreads(m_onnx_nthreads);
 
   if (m_dettype == CaloTowerDefs::CEMC)
   {
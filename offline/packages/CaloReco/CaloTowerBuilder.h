@@ -89,6 +89,39 @@ class CaloTowerBuilder : public SubsysReco
     m_dobitfliprecovery = dobitfliprecovery;
   }
 
+  void set_templatefit_validation(bool validate)
+  {
+    m_validate_templatefit = validate;
+  }
+
+  void set_templatefit_tolerance(float amp, float time, float ped, float chi2)
+  {
+    m_tolerance_amp = amp;
+    m_tolerance_time = time;
+    m_tolerance_ped = ped;
+    m_tolerance_chi2 = chi2;
+  }
+
+  void set_fastfit_newton_steps(int nsteps)
+  {
+    m_fastfit_newton_steps = nsteps;
+  }
+
+  void set_fastfit_scan_step(float step)
+  {
+    m_fastfit_scan_step = step;
+  }
+
+  void set_onnx_batch(bool batch)
+  {
+    m_onnx_batch = batch;
+  }
+
+  void set_onnx_nthreads(int nthreads)
+  {
+    m_onnx_nthreads = nthreads;
+  }
+
   void set_tbt_softwarezerosuppression(const std::string &url)
   {
     m_zsURL = url;
@@ -122,6 +155,8 @@ class CaloTowerBuilder : public SubsysReco
   int m_nchannels{192};
   int m_nzerosuppsamples{2};
   int m_nsoftwarezerosuppression{40};
+  int m_onnx_nthreads{0};
+  bool m_onnx_batch{false};
   CaloTowerDefs::DetectorSystem m_dettype{CaloTowerDefs::CEMC};
   CaloTowerDefs::BuilderType m_buildertype{CaloTowerDefs::kPRDFTowerv1};
   CaloWaveformProcessing::process _processingtype{CaloWaveformProcessing::NONE};
@@ -133,6 +168,13 @@ class CaloTowerBuilder : public SubsysReco
   float m_timeLim_low{-3.0};
   float m_timeLim_high{4.0};
   bool m_dobitfliprecovery{false};
+  bool m_validate_templatefit{false};
+  float m_tolerance_amp{0.01};
+  float m_tolerance_time{0.05};
+  float m_tolerance_ped{1.0};
+  float m_tolerance_chi2{0.05};
+  int m_fastfit_newton_steps{5};
+  float m_fastfit_scan_step{0.5};
 
   std::string m_fieldname;
   std::string m_calibName;
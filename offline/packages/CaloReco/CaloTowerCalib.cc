@@ -275,6 +275,19 @@ int CaloTowerCalib::InitRun(PHCompositeNode *topNode)
     }
   } //possibly get rid of
 
+  if (cdbttree)
+  {
+    m_calib = cdbttree->field(m_fieldname);
+  }
+  if (m_dotimecalib)
+  {
+    m_calib_time = cdbttree_time->field(m_fieldname_time);
+  }
+  if (m_doZScrosscalib)
+  {
+    m_calib_ZScrosscalib = cdbttree_ZScrosscalib->field(m_fieldname_ZScrosscalib);
+  }
+
   PHNodeIterator iter(topNode);
 
   // Looking for the DST node
@@ -315,11 +328,11 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
     TowerInfo *caloinfo_raw = _raw_towers->get_tower_at_channel(channel);
     _calib_towers->get_tower_at_channel(channel)->copy_tower(caloinfo_raw);
     float raw_amplitude = caloinfo_raw->get_energy();
-    float calibconst = cdbttree->GetFloatValue(key, m_fieldname);
+    float calibconst = m_calib[key];
     bool isZS = caloinfo_raw->get_isZS();
     if (isZS && m_doZScrosscalib)
     {
-      float crosscalibconst = cdbttree_ZScrosscalib->GetFloatValue(key, m_fieldname_ZScrosscalib);
+      float crosscalibconst = m_calib_ZScrosscalib[key];
       if (crosscalibconst == 0) 
       { 
         crosscalibconst = 1; 
@@ -342,7 +355,7 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
       {
       //I realized that there is no point to do timing calibration for the towerinfov1 object since the resolution is not enough...
       float raw_time = caloinfo_raw->get_time_float();
-      float meantime = cdbttree_time->GetFloatValue(key, m_fieldname_time);
+      float meantime = m_calib_time[key];
       _calib_towers->get_tower_at_channel(channel)->set_time_float(raw_time - meantime);
       }
     }
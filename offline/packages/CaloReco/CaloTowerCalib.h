@@ -7,12 +7,13 @@
 
 #include <calobase/TowerInfoContainer.h>  // for TowerInfoContainer, TowerIn...
 
+#include <cdbobjects/CDBTTree.h>
+
 #include <fun4all/SubsysReco.h>
 
 #include <iostream>
 #include <string>
 
-class CDBTTree;
 class PHCompositeNode;
 class TowerInfoContainer;
 
@@ -114,6 +115,10 @@ class CaloTowerCalib : public SubsysReco
   CDBTTree *cdbttree = nullptr;
   CDBTTree *cdbttree_time = nullptr;
   CDBTTree *cdbttree_ZScrosscalib = nullptr;
+  // per channel calibrations, set in InitRun
+  CDBTTree::FieldHandle m_calib;
+  CDBTTree::FieldHandle m_calib_time;
+  CDBTTree::FieldHandle m_calib_ZScrosscalib;
   int m_runNumber;
 };
 
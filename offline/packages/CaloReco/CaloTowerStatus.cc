@@ -183,6 +183,19 @@ int CaloTowerStatus::InitRun(PHCompositeNode *topNode)
     }  
   }
 
+  if (m_doHotChi2)
+  {
+    m_chi2_fraction = m_cdbttree_chi2->field(m_fieldname_chi2);
+  }
+  if (m_doTime)
+  {
+    m_mean_time = m_cdbttree_time->field(m_fieldname_time);
+  }
+  if (m_doHotMap)
+  {
+    m_hotMap_status = m_cdbttree_hotMap->intField(m_fieldname_hotMap);
+  }
+
   if (Verbosity() > 0)
   {
     std::cout << "CaloTowerStatus::Init " << m_detector << "  doing time status =" <<  std::boolalpha << m_doTime << "  doing hotBadChi2=" <<  std::boolalpha << m_doHotChi2 << " doing hot map=" << std::boolalpha << m_doHotMap << std::endl;
@@ -232,15 +245,15 @@ int CaloTowerStatus::process_event(PHCompositeNode * /*topNode*/)
 
     if (m_doHotChi2)
     {
-      fraction_badChi2 = m_cdbttree_chi2->GetFloatValue(key, m_fieldname_chi2);
+      fraction_badChi2 = m_chi2_fraction[key];
     }
     if (m_doTime)
     {
-      mean_time = m_cdbttree_time->GetFloatValue(key, m_fieldname_time);
+      mean_time = m_mean_time[key];
     }
     if (m_doHotMap)
     {
-      hotMap_val = m_cdbttree_hotMap->GetIntValue(key, m_fieldname_hotMap);
+      hotMap_val = m_hotMap_status[key];
     }
     float chi2 = m_raw_towers->get_tower_at_channel(channel)->get_chi2();
     float time = m_raw_towers->get_tower_at_channel(channel)->get_time_float();
@@ -7,12 +7,13 @@
 
 #include <calobase/TowerInfoContainer.h>  // for TowerInfoContainer, TowerIn...
 
+#include <cdbobjects/CDBTTree.h>
+
 #include <fun4all/SubsysReco.h>
 
 #include <iostream>
 #include <string>
 
-class CDBTTree;
 class PHCompositeNode;
 class TowerInfoContainer;
 
@@ -88,6 +89,11 @@ class CaloTowerStatus : public SubsysReco
   CDBTTree *m_cdbttree_time{nullptr};
   CDBTTree *m_cdbttree_hotMap{nullptr};
 
+  // per channel values, set in InitRun
+  CDBTTree::FieldHandle m_chi2_fraction;
+  CDBTTree::FieldHandle m_mean_time;
+  CDBTTree::Field<int> m_hotMap_status;
+
   bool m_doHotChi2{true};
   bool m_doTime{true};
   bool m_doHotMap{true};
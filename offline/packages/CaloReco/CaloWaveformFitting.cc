@@ -12,10 +12,13 @@
 #include <HFitInterface.h>
 #include <Math/WrappedMultiTF1.h>
 #include <Math/WrappedTF1.h>
+#include <ROOT/TSeq.hxx>
 #include <ROOT/TThreadExecutor.hxx>
 #include <ROOT/TThreadedObject.hxx>
 
 #include <pthread.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <limits>
@@ -42,9 +45,139 @@ void CaloWaveformFitting::initialize_processing(const std::string &templatefile)
   fin->Close();
   delete fin;
   m_peakTimeTemp = h_template->GetBinCenter(h_template->GetMaximumBin());
+  build_template_table();
   t = new ROOT::TThreadExecutor(_nthreads);
 }
 
+void CaloWaveformFitting::build_template_table()
+{
+  // sample the template between the first and last bin center with a fixed number
+  // of points per bin. The nodes contain all bin centers, so linear interpolation
+  // in the table reproduces TH1::Interpolate exactly
+  static const int oversampling = 16;
+  int nbins = h_template->GetNbinsX();
+  double binwidth = h_template->GetBinWidth(1);
+  m_template_table_xmin = h_template->GetBinCenter(1);
+  m_template_table_stepinv = oversampling / binwidth;
+  int npoints = (nbins - 1) * oversampling + 1;
+  m_template_table.resize(npoints);
+  for (int i = 0; i < npoints; i++)
+  {
+    m_template_table[i] = h_template->Interpolate(m_template_table_xmin + i / m_template_table_stepinv);
+  }
+}
+
+double CaloWaveformFitting::template_table_value(double x, double &derivative) const
+{
+  // like TH1::Interpolate the template is constant outside the bin centers
+  double u = (x - m_template_table_xmin) * m_template_table_stepinv;
+  int last = m_template_table.size() - 1;
+  if (u <= 0)
+  {
+    derivative = 0;
+    return m_template_table.front();
+  }
+  if (u >= last)
+  {
+    derivative = 0;
+    return m_template_table.back();
+  }
+  int k = static_cast<int>(u);
+  double slope = m_template_table[k + 1] - m_template_table[k];
+  derivative = slope * m_template_table_stepinv;
+  return m_template_table[k] + (u - k) * slope;
+}
+
+double CaloWaveformFitting::fit_template_fast(const std::vector<float> &v, int nsamples, double tmin, double tmax, double &amp, double &time, double &ped) const
+{
+  // per thread scratch buffers, allocated once
+  thread_local std::vector<double> tval;
+  thread_local std::vector<double> tderiv;
+  tval.resize(nsamples);
+  tderiv.resize(nsamples);
+
+  double sv = 0;
+  for (int i = 0; i < nsamples; i++)
+  {
+    sv += v[i];
+  }
+
+  // for a given time the model A*T(x-t)+P is linear in A and P,
+  // solve for them in closed form and return the chi2
+  auto solve = [&](double t0, double &a, double &p)
+  {
+    double st = 0;
+    double stt = 0;
+    double stv = 0;
+    for (int i = 0; i < nsamples; i++)
+    {
+      double val = template_table_value(i - t0, tderiv[i]);
+      tval[i] = val;
+      st += val;
+      stt += val * val;
+      stv += val * v[i];
+    }
+    double det = nsamples * stt - st * st;
+    a = (det != 0) ? (nsamples * stv - st * sv) / det : 0;
+    p = (sv - a * st) / nsamples;
+    double chi2 = 0;
+    for (int i = 0; i < nsamples; i++)
+    {
+      double r = v[i] - a * tval[i] - p;
+      chi2 += r * r;
+    }
+    return chi2;
+  };
+
+  // coarse scan over the allowed time range
+  double a = 0;
+  double p = 0;
+  double best_chi2 = std::numeric_limits<double>::max();
+  time = tmin;
+  for (double t0 = tmin; t0 <= tmax; t0 += _fastfit_scan_step)
+  {
+    double chi2 = solve(t0, a, p);
+    if (chi2 < best_chi2)
+    {
+      best_chi2 = chi2;
+      time = t0;
+    }
+  }
+
+  // Gauss-Newton refinement of the time, amplitude and pedestal are re-solved at every step
+  best_chi2 = solve(time, amp, ped);
+  for (int istep = 0; istep < _fastfit_newton_steps; istep++)
+  {
+    // residual r_i = v_i - A T(i-t) - P, dr_i/dt = A T'(i-t)
+    double rj = 0;
+    double jj = 0;
+    for (int i = 0; i < nsamples; i++)
+    {
+      double r = v[i] - amp * tval[i] - ped;
+      double j = amp * tderiv[i];
+      rj += r * j;
+      jj += j * j;
+    }
+    if (jj <= 0)
+    {
+      break;
+    }
+    double tnew = std::clamp(time - rj / jj, tmin, tmax);
+    double chi2 = solve(tnew, a, p);
+    if (chi2 >= best_chi2)
+    {
+      // restore the tables of the best point and stop
+      solve(time, amp, ped);
+      break;
+    }
+    best_chi2 = chi2;
+    time = tnew;
+    amp = a;
+    ped = p;
+  }
+  return best_chi2;
+}
+
 std::vector<std::vector<float>> CaloWaveformFitting::process_waveform(std::vector<std::vector<float>> waveformvector)
 {
   int size1 = waveformvector.size();
@@ -269,6 +402,107 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
   return fit_params;
 }
 
+std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit_fast(std::vector<std::vector<float>> chnlvector)
+{
+  // same treatment as calo_processing_templatefit but the fit is done with
+  // fit_template_fast, no ROOT objects are created per channel.
+  // The waveforms do not carry the channel index as last element
+  int nchnls = chnlvector.size();
+  std::vector<std::vector<float>> fit_params(nchnls);
+  auto func = [&](unsigned int ch)
+  {
+    std::vector<float> &v = chnlvector[ch];
+    int size1 = v.size();
+    if (size1 == _nzerosuppresssamples)
+    {
+      float chi2 = std::numeric_limits<float>::quiet_NaN();
+      if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
+      {
+        chi2 = 1000000;
+      }
+      fit_params[ch] = {v.at(1) - v.at(0), std::numeric_limits<float>::quiet_NaN(), v.at(0), chi2, 0};
+      return;
+    }
+    float maxheight = 0;
+    int maxbin = 0;
+    for (int i = 0; i < size1; i++)
+    {
+      if (v.at(i) > maxheight)
+      {
+        maxheight = v.at(i);
+        maxbin = i;
+      }
+    }
+    float pedestal = 1500;
+    if (maxbin > 4)
+    {
+      pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
+    }
+    else if (maxbin > 3)
+    {
+      pedestal = (v.at(maxbin - 4));
+    }
+    else
+    {
+      pedestal = 0.5 * (v.at(size1 - 3) + v.at(size1 - 2));
+    }
+
+    if ((_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
+    {
+      float chi2 = std::numeric_limits<float>::quiet_NaN();
+      if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
+      {
+        chi2 = 1000000;
+      }
+      fit_params[ch] = {v.at(6) - v.at(0), std::numeric_limits<float>::quiet_NaN(), v.at(0), chi2, 0};
+      return;
+    }
+
+    double tmin = -1 * m_peakTimeTemp;
+    double tmax = size1 - m_peakTimeTemp;
+    if (m_setTimeLim)
+    {
+      tmin = m_timeLim_low;
+      tmax = m_timeLim_high;
+    }
+    double amp = 0;
+    double time = 0;
+    double ped = 0;
+    double chi2min = fit_template_fast(v, size1, tmin, tmax, amp, time, ped);
+    chi2min /= size1 - 3;  // divide by the number of dof
+    if (chi2min > _chi2threshold && (ped < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (ped > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery)
+    {
+      std::vector<float> rv(v.begin(), v.end());  // temporary recovered waveform
+      unsigned int bits[3] = {8192, 4096, 2048};
+      for (auto bit : bits)
+      {
+        for (int i = 0; i < size1; i++)
+        {
+          if (((unsigned int) rv.at(i) & bit) && ((unsigned int) rv.at(i) % bit > _bfr_lowpedestalthreshold))
+          {
+            rv.at(i) = rv.at(i) - bit;
+          }
+        }
+      }
+      double recover_amp = 0;
+      double recover_time = 0;
+      double recover_ped = 0;
+      double recover_chi2min = fit_template_fast(rv, size1, -1 * m_peakTimeTemp, size1 - m_peakTimeTemp, recover_amp, recover_time, recover_ped);
+      recover_chi2min /= size1 - 3;  // divide by the number of dof
+      if (recover_chi2min < _chi2lowthreshold && recover_ped < _bfr_highpedestalthreshold && recover_ped > _bfr_lowpedestalthreshold)
+      {
+        v = rv;
+        fit_params[ch] = {(float) recover_amp, (float) recover_time, (float) recover_ped, (float) recover_chi2min, 1};
+        return;
+      }
+    }
+    fit_params[ch] = {(float) amp, (float) time, (float) ped, (float) chi2min, 0};
+  };
+
+  t->Foreach(func, ROOT::TSeqU(nchnls));
+  return fit_params;
+}
+
 void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax)
 {
   int n = 3;
@@ -51,8 +51,21 @@ class CaloWaveformFitting
     _dobitfliprecovery = dobitfliprecovery;
   }
 
+  //! number of Gauss-Newton iterations on the time in the fast template fit
+  void set_fastfit_newton_steps(int nsteps)
+  {
+    _fastfit_newton_steps = nsteps;
+  }
+
+  //! step (in samples) of the coarse time scan in the fast template fit
+  void set_fastfit_scan_step(float step)
+  {
+    _fastfit_scan_step = step;
+  }
+
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
   std::vector<std::vector<float>> calo_processing_templatefit(std::vector<std::vector<float>> chnlvector);
+  std::vector<std::vector<float>> calo_processing_templatefit_fast(std::vector<std::vector<float>> chnlvector);
   std::vector<std::vector<float>> calo_processing_fast(std::vector<std::vector<float>> chnlvector);
   std::vector<std::vector<float>> calo_processing_nyquist(std::vector<std::vector<float>> chnlvector);
 
@@ -69,8 +82,18 @@ class CaloWaveformFitting
   float psinc(float t, std::vector<float> &vec_signal_samples);
   double template_function(double *x, double *par);
 
+  // dense lookup table of the template for the fast fit
+  void build_template_table();
+  double template_table_value(double x, double &derivative) const;
+  double fit_template_fast(const std::vector<float> &v, int nsamples, double tmin, double tmax, double &amp, double &time, double &ped) const;
+
   TProfile *h_template {nullptr};
   double m_peakTimeTemp {0};
+  std::vector<double> m_template_table;
+  double m_template_table_xmin {0};
+  double m_template_table_stepinv {0};
+  int _fastfit_newton_steps{5};
+  float _fastfit_scan_step{0.5};
   int _nthreads{1};
   int _nzerosuppresssamples{2};
   int _nsoftwarezerosuppression{40};
@@ -7,6 +7,7 @@
 
 #include <algorithm>                  // for max
 #include <cassert>
+#include <cmath>
 #include <cstdlib>                   // for getenv
 #include <iostream>
 #include <memory>                     // for allocator_traits<>::value_type
@@ -14,8 +15,16 @@
 
 Ort::Session *onnxmodule;
 
+CaloWaveformProcessing::CaloWaveformProcessing() = default;
+
 CaloWaveformProcessing::~CaloWaveformProcessing()
 {
+  if (m_validate_templatefit)
+  {
+    std::cout << "CaloWaveformProcessing: fast template fit validation, "
+              << m_mismatched_channels << " of " << m_validated_channels
+              << " channels outside of tolerance" << std::endl;
+  }
   delete m_Fitter;
 }
 
@@ -23,13 +32,15 @@ void CaloWaveformProcessing::initialize_processing()
 {
   char *calibrationsroot = getenv("CALIBRATIONROOT");
   assert(calibrationsroot);
-  if (m_processingtype == CaloWaveformProcessing::TEMPLATE)
+  if (m_processingtype == CaloWaveformProcessing::TEMPLATE || m_processingtype == CaloWaveformProcessing::TEMPLATE_FAST)
   {
     std::string calibrations_repo_template = std::string(calibrationsroot) + "/WaveformProcessing/templates/" + m_template_input_file;
     url_template = CDBInterface::instance()->getUrl(m_template_name, calibrations_repo_template);
     m_Fitter = new CaloWaveformFitting();
     m_Fitter->initialize_processing(url_template);
     m_Fitter->set_nthreads(get_nthreads());
+    m_Fitter->set_fastfit_newton_steps(m_fastfit_newton_steps);
+    m_Fitter->set_fastfit_scan_step(m_fastfit_scan_step);
     if (m_setTimeLim)
     {
       m_Fitter->set_timeFitLim(m_timeLim_low,m_timeLim_high);
@@ -48,7 +59,8 @@ void CaloWaveformProcessing::initialize_processing()
   {
     std::string calibrations_repo_model = std::string(calibrationsroot) + "/WaveformProcessing/models/" + m_model_name;
     url_onnx = CDBInterface::instance()->getUrl(m_model_name, calibrations_repo_model);
-    onnxmodule = onnxSession(url_onnx);
+    onnxmodule = onnxSession(url_onnx, m_onnx_nthreads);
+    m_onnxBatch = std::make_unique<OnnxBatchInference>(onnxmodule, std::vector<int64_t>{31}, 3);
   }
   else if (m_processingtype == CaloWaveformProcessing::NYQUIST)
   {
@@ -71,9 +83,24 @@ std::vector<std::vector<float>> CaloWaveformProcessing::process_waveform(std::ve
     }
     fitresults = m_Fitter->calo_processing_templatefit(waveformvector);
   }
+  if (m_processingtype == CaloWaveformProcessing::TEMPLATE_FAST)
+  {
+    fitresults = m_Fitter->calo_processing_templatefit_fast(waveformvector);
+    if (m_validate_templatefit)
+    {
+      validate_templatefit(waveformvector, fitresults);
+    }
+  }
   if (m_processingtype == CaloWaveformProcessing::ONNX)
   {
-    fitresults = CaloWaveformProcessing::calo_processing_ONNX(waveformvector);
+    if (m_onnx_batch)
+    {
+      fitresults = CaloWaveformProcessing::calo_processing_ONNX_batch(waveformvector);
+    }
+    else
+    {
+      fitresults = CaloWaveformProcessing::calo_processing_ONNX(waveformvector);
+    }
   }
   if (m_processingtype == CaloWaveformProcessing::FAST)
   {
@@ -115,6 +142,79 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(std
   return fit_values;
 }
 
+void CaloWaveformProcessing::validate_templatefit(const std::vector<std::vector<float>> &waveformvector, const std::vector<std::vector<float>> &fitresults)
+{
+  std::vector<std::vector<float>> reference_input = waveformvector;
+  int size1 = reference_input.size();
+  for (int i = 0; i < size1; i++)
+  {
+    reference_input.at(i).push_back(i);
+  }
+  std::vector<std::vector<float>> reference = m_Fitter->calo_processing_templatefit(reference_input);
+  for (int i = 0; i < size1; i++)
+  {
+    const std::vector<float> &fast = fitresults.at(i);
+    const std::vector<float> &ref = reference.at(i);
+    // zero suppressed channels have a NaN time, nothing was fitted
+    if (std::isnan(ref.at(1)))
+    {
+      continue;
+    }
+    m_validated_channels++;
+    bool ok = std::abs(fast.at(0) - ref.at(0)) <= m_tolerance_amp * std::abs(ref.at(0)) &&
+              std::abs(fast.at(1) - ref.at(1)) <= m_tolerance_time &&
+              std::abs(fast.at(2) - ref.at(2)) <= m_tolerance_ped &&
+              std::abs(fast.at(3) - ref.at(3)) <= m_tolerance_chi2 * std::abs(ref.at(3));
+    if (!ok)
+    {
+      m_mismatched_channels++;
+      if (Verbosity() > 0)
+      {
+        std::cout << "CaloWaveformProcessing::validate_templatefit - channel " << i
+                  << " fast amp/time/ped/chi2: " << fast.at(0) << "/" << fast.at(1) << "/" << fast.at(2) << "/" << fast.at(3)
+                  << " template: " << ref.at(0) << "/" << ref.at(1) << "/" << ref.at(2) << "/" << ref.at(3)
+                  << std::endl;
+      }
+    }
+  }
+}
+
+std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX_batch(const std::vector<std::vector<float>> &chnlvector)
+{
+  // same input as calo_processing_ONNX (all but the last sample, scaled by 1/1000)
+  // but packed into a single [nchnls, 31] tensor
+  int nchnls = chnlvector.size();
+  int64_t itemsize = m_onnxBatch->itemsize();
+  float *input = m_onnxBatch->input(nchnls);
+  for (int m = 0; m < nchnls; m++)
+  {
+    const std::vector<float> &v = chnlvector[m];
+    int64_t nsamples = std::min<int64_t>(static_cast<int64_t>(v.size()) - 1, itemsize);
+    float *row = input + m * itemsize;
+    for (int64_t k = 0; k < nsamples; k++)
+    {
+      row[k] = v[k] / 1000.0;
+    }
+    std::fill(row + nsamples, row + itemsize, 0);
+  }
+  const float *output = m_onnxBatch->run(nchnls);
+  int64_t nreturn = m_onnxBatch->nreturn();
+  std::vector<std::vector<float>> fit_values(nchnls);
+  for (int m = 0; m < nchnls; m++)
+  {
+    std::vector<float> &val = fit_values[m];
+    val.assign(output + m * nreturn, output + (m + 1) * nreturn);
+    for (int i = 0; i < nreturn; i++)
+    {
+      if (i == 0 || i == 2)
+      {
+        val[i] = val[i] * 1000;
+      }
+    }
+  }
+  return fit_values;
+}
+
 int CaloWaveformProcessing::get_nthreads()
 {
   if (m_Fitter)
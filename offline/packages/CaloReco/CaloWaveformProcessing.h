@@ -3,10 +3,12 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 class CaloWaveformFitting;
+class OnnxBatchInference;
 
 class CaloWaveformProcessing : public SubsysReco
 {
@@ -18,9 +20,10 @@ class CaloWaveformProcessing : public SubsysReco
     ONNX = 2,
     FAST = 3,
     NYQUIST = 4,
+    TEMPLATE_FAST = 5,
   };
 
-  CaloWaveformProcessing() = default;
+  CaloWaveformProcessing();
   ~CaloWaveformProcessing() override;
 
   void set_processing_type(CaloWaveformProcessing::process modelno)
@@ -53,6 +56,18 @@ class CaloWaveformProcessing : public SubsysReco
 
   void set_nthreads(int nthreads);
 
+  //! run the ONNX model once on all channels instead of once per channel
+  void set_onnx_batch(bool batch)
+  {
+    m_onnx_batch = batch;
+  }
+
+  //! number of intra-op threads of the ONNX session, 0 uses the onnxruntime default
+  void set_onnx_nthreads(int nthreads)
+  {
+    m_onnx_nthreads = nthreads;
+  }
+
   int get_nthreads();
 
   void set_softwarezerosuppression(bool usezerosuppression,int softwarezerosuppression)
@@ -72,12 +87,42 @@ class CaloWaveformProcessing : public SubsysReco
     _dobitfliprecovery = dobitfliprecovery;
   }
 
+  //! in TEMPLATE_FAST mode also run the ROOT template fit and compare the results
+  void set_templatefit_validation(bool validate)
+  {
+    m_validate_templatefit = validate;
+  }
+
+  //! tolerances for the TEMPLATE_FAST validation: relative amplitude, time (samples), pedestal (adc), relative chi2
+  void set_templatefit_tolerance(float amp, float time, float ped, float chi2)
+  {
+    m_tolerance_amp = amp;
+    m_tolerance_time = time;
+    m_tolerance_ped = ped;
+    m_tolerance_chi2 = chi2;
+  }
+
+  //! number of Gauss-Newton iterations on the time in the TEMPLATE_FAST fit
+  void set_fastfit_newton_steps(int nsteps)
+  {
+    m_fastfit_newton_steps = nsteps;
+  }
+
+  //! step (in samples) of the coarse time scan in the TEMPLATE_FAST fit
+  void set_fastfit_scan_step(float step)
+  {
+    m_fastfit_scan_step = step;
+  }
+
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
   std::vector<std::vector<float>> calo_processing_ONNX(std::vector<std::vector<float>> chnlvector);
+  std::vector<std::vector<float>> calo_processing_ONNX_batch(const std::vector<std::vector<float>> &chnlvector);
 
   void initialize_processing();
 
  private:
+  void validate_templatefit(const std::vector<std::vector<float>> &waveformvector, const std::vector<std::vector<float>> &fitresults);
+
   CaloWaveformFitting *m_Fitter = nullptr;
 
   CaloWaveformProcessing::process m_processingtype = CaloWaveformProcessing::TEMPLATE;
@@ -96,5 +141,18 @@ class CaloWaveformProcessing : public SubsysReco
 
   std::string url_onnx;
   std::string m_model_name = "CEMC_ONNX";
+  std::unique_ptr<OnnxBatchInference> m_onnxBatch;
+  bool m_onnx_batch{false};
+  int m_onnx_nthreads{0};
+
+  bool m_validate_templatefit{false};
+  float m_tolerance_amp{0.01};
+  float m_tolerance_time{0.05};
+  float m_tolerance_ped{1.0};
+  float m_tolerance_chi2{0.05};
+  int m_fastfit_newton_steps{5};
+  float m_fastfit_scan_step{0.5};
+  unsigned long m_validated_channels{0};
+  unsigned long m_mismatched_channels{0};
 };
 #endif
@@ -70,13 +70,13 @@ float RawClusterBuilderTopo::calculate_dR(float eta1, float eta2, float phi1, fl
   return sqrt(pow(deta, 2) + pow(dphi, 2));
 }
 
-std::vector<int> RawClusterBuilderTopo::get_adjacent_towers_by_ID(int ID)
+void RawClusterBuilderTopo::calculate_adjacent_towers_by_ID(int ID, std::vector<int> &adjacent_towers)
 {
   int this_layer = get_ilayer_from_ID(ID);
   int this_eta = get_ieta_from_ID(ID);
   int this_phi = get_iphi_from_ID(ID);
 
-  std::vector<int> adjacent_towers;
+  adjacent_towers.clear();
 
   // for both IHCal and OHCal, add adjacent layers in the HCal
   if (this_layer == 0 || this_layer == 1)
@@ -106,7 +106,7 @@ std::vector<int> RawClusterBuilderTopo::get_adjacent_towers_by_ID(int ID)
           {
             if (Verbosity() > 20)
             {
-              std::cout << "RawClusterBuilderTopo::get_adjacent_towers_by_ID : corner growth not allowed " << std::endl;
+              std::cout << "RawClusterBuilderTopo::calculate_adjacent_towers_by_ID : corner growth not allowed " << std::endl;
             }
             continue;
           }
@@ -134,7 +134,7 @@ std::vector<int> RawClusterBuilderTopo::get_adjacent_towers_by_ID(int ID)
         int EMCal_tower = get_ID(2, new_eta, new_phi);
         if (Verbosity() > 20)
         {
-          std::cout << "RawClusterBuilderTopo::get_adjacent_towers_by_ID : HCal tower with eta / phi = " << this_eta << " / " << this_phi << ", adding EMCal tower with eta / phi = " << new_eta << " / " << new_phi << std::endl;
+          std::cout << "RawClusterBuilderTopo::calculate_adjacent_towers_by_ID : HCal tower with eta / phi = " << this_eta << " / " << this_phi << ", adding EMCal tower with eta / phi = " << new_eta << " / " << new_phi << std::endl;
         }
         adjacent_towers.push_back(EMCal_tower);
       }
@@ -178,7 +178,7 @@ std::vector<int> RawClusterBuilderTopo::get_adjacent_towers_by_ID(int ID)
         int IHCal_tower = get_ID(0, HCal_eta, HCal_phi);
         if (Verbosity() > 20)
         {
-          std::cout << "RawClusterBuilderTopo::get_adjacent_towers_by_ID : EMCal tower with eta / phi = " << this_eta << " / " << this_phi << ", adding IHCal tower with eta / phi = " << HCal_eta << " / " << HCal_phi << std::endl;
+          std::cout << "RawClusterBuilderTopo::calculate_adjacent_towers_by_ID : EMCal tower with eta / phi = " << this_eta << " / " << this_phi << ", adding IHCal tower with eta / phi = " << HCal_eta << " / " << HCal_phi << std::endl;
         }
         adjacent_towers.push_back(IHCal_tower);
       }
@@ -186,13 +186,47 @@ std::vector<int> RawClusterBuilderTopo::get_adjacent_towers_by_ID(int ID)
       {
         if (Verbosity() > 20)
         {
-          std::cout << "RawClusterBuilderTopo::get_adjacent_towers_by_ID : EMCal tower with eta / phi = " << this_eta << " / " << this_phi << ", does not have matching IHCal due to large eta " << std::endl;
+          std::cout << "RawClusterBuilderTopo::calculate_adjacent_towers_by_ID : EMCal tower with eta / phi = " << this_eta << " / " << this_phi << ", does not have matching IHCal due to large eta " << std::endl;
         }
       }
     }
   }
+}
+
+void RawClusterBuilderTopo::build_adjacency_table()
+{
+  _EMCAL_NETA = _geom_containers[2]->get_etabins();
+  _EMCAL_NPHI = _geom_containers[2]->get_phibins();
+
+  _HCAL_NETA = _geom_containers[1]->get_etabins();
+  _HCAL_NPHI = _geom_containers[1]->get_phibins();
+
+  // HCal IDs come first, EMCal IDs start at _EMCAL_NPHI * _EMCAL_NETA
+  const int n_IDs = 2 * _EMCAL_NPHI * _EMCAL_NETA;
+
+  _TOWERMAP_STATUS_BY_ID.assign(n_IDs, -2);
+  _TOWERMAP_KEY_BY_ID.assign(n_IDs, 0);
+  _TOWERMAP_E_BY_ID.assign(n_IDs, 0);
+
+  _ADJACENT_TOWERS_OFFSET.assign(n_IDs + 1, 0);
+  _ADJACENT_TOWERS.clear();
+
+  std::vector<int> adjacent_towers;
+  for (int ID = 0; ID < n_IDs; ID++)
+  {
+    // skip IDs between the last HCal and the first EMCal tower
+    if (ID < 2 * _HCAL_NETA * _HCAL_NPHI || ID >= _EMCAL_NPHI * _EMCAL_NETA)
+    {
+      calculate_adjacent_towers_by_ID(ID, adjacent_towers);
+      _ADJACENT_TOWERS.insert(_ADJACENT_TOWERS.end(), adjacent_towers.begin(), adjacent_towers.end());
+    }
+    _ADJACENT_TOWERS_OFFSET[ID + 1] = _ADJACENT_TOWERS.size();
+  }
 
-  return adjacent_towers;
+  if (Verbosity() > 0)
+  {
+    std::cout << "RawClusterBuilderTopo::build_adjacency_table: " << _ADJACENT_TOWERS.size() << " adjacent tower pairs for " << n_IDs << " tower IDs" << std::endl;
+  }
 }
 
 void RawClusterBuilderTopo::export_single_cluster(const std::vector<int> &original_towers)
@@ -212,7 +246,7 @@ void RawClusterBuilderTopo::export_single_cluster(const std::vector<int> &origin
   return;
 }
 
-void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_towers, std::map<int, std::pair<int, int> > tower_ownership, unsigned int n_clusters, std::vector<float> pseudocluster_sumE, std::vector<float> pseudocluster_eta, std::vector<float> pseudocluster_phi)
+void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_towers, std::map<int, std::pair<int, int> > &tower_ownership, unsigned int n_clusters, const std::vector<float> &pseudocluster_sumE, const std::vector<float> &pseudocluster_eta, const std::vector<float> &pseudocluster_phi)
 {
   if (n_clusters != 1)  // if we didn't just pass down from export_single_cluster
   {
@@ -248,20 +282,9 @@ void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_tow
     {
       std::cout << "RawClusterBuilderTopo::export_clusters -> assigning tower " << original_tower << " with ownership ( " << the_pair.first << ", " << the_pair.second << " ) " << std::endl;
     }
-    int this_ieta = get_ieta_from_ID(this_ID);
-    int this_iphi = get_iphi_from_ID(this_ID);
     int this_layer = get_ilayer_from_ID(this_ID);
     float this_E = get_E_from_ID(this_ID);
-
-    int this_key = 0;
-    if (this_layer == 2)
-    {
-      this_key = _EMTOWERMAP_KEY_ETA_PHI[this_ieta][this_iphi];
-    }
-    else
-    {
-      this_key = _TOWERMAP_KEY_LAYER_ETA_PHI[this_layer][this_ieta][this_iphi];
-    }
+    int this_key = _TOWERMAP_KEY_BY_ID[this_ID];
 
     RawTowerGeom *tower_geom = _geom_containers[this_layer]->get_tower_geometry(this_key);
 
@@ -390,6 +413,29 @@ int RawClusterBuilderTopo::InitRun(PHCompositeNode *topNode)
     throw;
   }
 
+  _geom_containers[0] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALIN");
+  _geom_containers[1] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_HCALOUT");
+  _geom_containers[2] = findNode::getClass<RawTowerGeomContainer>(topNode, "TOWERGEOM_CEMC");
+
+  if (!_geom_containers[0])
+  {
+    std::cout << PHWHERE << ": Could not find node TOWERGEOM_HCALIN" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+  if (!_geom_containers[1])
+  {
+    std::cout << PHWHERE << ": Could not find node TOWERGEOM_HCALOUT" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+  if (!_geom_containers[2])
+  {
+    std::cout << PHWHERE << ": Could not find node TOWERGEOM_CEMC" << std::endl;
+    return Fun4AllReturnCodes::ABORTRUN;
+  }
+
+  // tower maps and adjacency only depend on geometry and on the EMCal / HCal and corner neighbor options
+  build_adjacency_table();
+
   if (Verbosity() > 0)
   {
     std::cout << "RawClusterBuilderTopo::InitRun: initialized with EMCal enable = " << _enable_EMCal << " and I+OHCal enable = " << _enable_HCal << std::endl;
@@ -457,52 +503,14 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     std::cout << "RawClusterBuilderTopo::process_event: pointer to TOWERGEOM_HCALOUT: " << _geom_containers[1] << std::endl;
   }
 
-  if (_EMCAL_NETA < 0)
-  {
-    // define geometry only once if it has not been yet
-    _EMCAL_NETA = _geom_containers[2]->get_etabins();
-    _EMCAL_NPHI = _geom_containers[2]->get_phibins();
-
-    _EMTOWERMAP_STATUS_ETA_PHI.resize(_EMCAL_NETA, std::vector<int>(_EMCAL_NPHI, -2));
-    _EMTOWERMAP_KEY_ETA_PHI.resize(_EMCAL_NETA, std::vector<int>(_EMCAL_NPHI, 0));
-    _EMTOWERMAP_E_ETA_PHI.resize(_EMCAL_NETA, std::vector<float>(_EMCAL_NPHI, 0));
-  }
-
-  if (_HCAL_NETA < 0)
-  {
-    // define geometry only once if it has not been yet
-    _HCAL_NETA = _geom_containers[1]->get_etabins();
-    _HCAL_NPHI = _geom_containers[1]->get_phibins();
-
-    _TOWERMAP_STATUS_LAYER_ETA_PHI.resize(2, std::vector<std::vector<int> >(_HCAL_NETA, std::vector<int>(_HCAL_NPHI, -2)));
-    _TOWERMAP_KEY_LAYER_ETA_PHI.resize(2, std::vector<std::vector<int> >(_HCAL_NETA, std::vector<int>(_HCAL_NPHI, 0)));
-    _TOWERMAP_E_LAYER_ETA_PHI.resize(2, std::vector<std::vector<float> >(_HCAL_NETA, std::vector<float>(_HCAL_NPHI, 0)));
-  }
-
   // reset maps
   // but note -- do not reset keys!
-  for (int ieta = 0; ieta < _EMCAL_NETA; ieta++)
-  {
-    for (int iphi = 0; iphi < _EMCAL_NPHI; iphi++)
-    {
-      _EMTOWERMAP_STATUS_ETA_PHI[ieta][iphi] = -2;  // set tower does not exist
-      _EMTOWERMAP_E_ETA_PHI[ieta][iphi] = 0;        // set zero energy
-    }
-  }
-  for (int ilayer = 0; ilayer < 2; ilayer++)
-  {
-    for (int ieta = 0; ieta < _HCAL_NETA; ieta++)
-    {
-      for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
-      {
-        _TOWERMAP_STATUS_LAYER_ETA_PHI[ilayer][ieta][iphi] = -2;  // set tower does not exist
-        _TOWERMAP_E_LAYER_ETA_PHI[ilayer][ieta][iphi] = 0;        // set zero energy
-      }
-    }
-  }
+  std::fill(_TOWERMAP_STATUS_BY_ID.begin(), _TOWERMAP_STATUS_BY_ID.end(), -2);  // set tower does not exist
+  std::fill(_TOWERMAP_E_BY_ID.begin(), _TOWERMAP_E_BY_ID.end(), 0);             // set zero energy
 
   // setup
-  std::vector<std::pair<int, float> > list_of_seeds;
+  std::vector<std::pair<int, float> > &list_of_seeds = _list_of_seeds;
+  list_of_seeds.clear();
 
   // translate towers to our internal representation
   if (_enable_EMCal)
@@ -532,14 +540,14 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      _EMTOWERMAP_STATUS_ETA_PHI[ieta][iphi] = -1;  // change status to unknown
-      _EMTOWERMAP_E_ETA_PHI[ieta][iphi] = this_E;
-      _EMTOWERMAP_KEY_ETA_PHI[ieta][iphi] = key;
+      int ID = get_ID(2, ieta, iphi);
+      _TOWERMAP_STATUS_BY_ID[ID] = -1;  // change status to unknown
+      _TOWERMAP_E_BY_ID[ID] = this_E;
+      _TOWERMAP_KEY_BY_ID[ID] = key;
 
       // use fabs() here for simplicity - if we're not using abs E, negative towers are already excluded
       if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[2])
       {
-        int ID = get_ID(2, ieta, iphi);
         list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
@@ -577,13 +585,13 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[0][ieta][iphi] = -1;  // change status to unknown
-      _TOWERMAP_E_LAYER_ETA_PHI[0][ieta][iphi] = this_E;
-      _TOWERMAP_KEY_LAYER_ETA_PHI[0][ieta][iphi] = key;
+      int ID = get_ID(0, ieta, iphi);
+      _TOWERMAP_STATUS_BY_ID[ID] = -1;  // change status to unknown
+      _TOWERMAP_E_BY_ID[ID] = this_E;
+      _TOWERMAP_KEY_BY_ID[ID] = key;
 
       if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[0])
       {
-        int ID = get_ID(0, ieta, iphi);
         list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
@@ -616,13 +624,13 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[1][ieta][iphi] = -1;  // change status to unknown
-      _TOWERMAP_E_LAYER_ETA_PHI[1][ieta][iphi] = this_E;
-      _TOWERMAP_KEY_LAYER_ETA_PHI[1][ieta][iphi] = key;
+      int ID = get_ID(1, ieta, iphi);
+      _TOWERMAP_STATUS_BY_ID[ID] = -1;  // change status to unknown
+      _TOWERMAP_E_BY_ID[ID] = this_E;
+      _TOWERMAP_KEY_BY_ID[ID] = key;
 
       if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[1])
       {
-        int ID = get_ID(1, ieta, iphi);
         list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
@@ -658,16 +666,19 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
   int cluster_index = 0;  // begin counting clusters
 
-  std::vector<std::vector<int> > all_cluster_towers;  // store final cluster tower lists here
+  // store final cluster tower lists here, one after the other
+  std::vector<int> &all_cluster_towers = _all_cluster_towers;
+  std::vector<int> &all_cluster_towers_offset = _all_cluster_towers_offset;
+  all_cluster_towers.clear();
+  all_cluster_towers_offset.assign(1, 0);
 
-  while (list_of_seeds.size() > 0)
+  for (unsigned int iseed = 0; iseed < list_of_seeds.size(); iseed++)
   {
-    int seed_ID = list_of_seeds.at(0).first;
-    list_of_seeds.erase(list_of_seeds.begin());
+    int seed_ID = list_of_seeds[iseed].first;
 
     if (Verbosity() > 5)
     {
-      std::cout << " RawClusterBuilderTopo::process_event: in seeded loop, current seed has ID = " << seed_ID << " , length of remaining seed vector = " << list_of_seeds.size() << std::endl;
+      std::cout << " RawClusterBuilderTopo::process_event: in seeded loop, current seed has ID = " << seed_ID << " , length of remaining seed vector = " << list_of_seeds.size() - iseed - 1 << std::endl;
     }
 
     // if this seed was already claimed by some other seed during its growth, remove it and do nothing
@@ -684,10 +695,13 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     // this seed tower now owned by new cluster
     set_status_by_ID(seed_ID, cluster_index);
 
-    std::vector<int> cluster_tower_ID;
-    cluster_tower_ID.push_back(seed_ID);
+    // the towers of this cluster are appended to all_cluster_towers
+    const int first_cluster_tower = all_cluster_towers.size();
+    all_cluster_towers.push_back(seed_ID);
 
-    std::vector<int> grow_tower_ID;
+    // grow towers are processed in order, from the front of the list
+    std::vector<int> &grow_tower_ID = _grow_tower_ID;
+    grow_tower_ID.clear();
     grow_tower_ID.push_back(seed_ID);
 
     // iteratively process growth towers, adding > 2 * sigma neighbors to the list for further checking
@@ -697,17 +711,16 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       std::cout << " RawClusterBuilderTopo::process_event: Entering Growth stage for cluster " << cluster_index << std::endl;
     }
 
-    while (grow_tower_ID.size() > 0)
+    for (unsigned int igrow = 0; igrow < grow_tower_ID.size(); igrow++)
     {
-      int grow_ID = grow_tower_ID.at(0);
-      grow_tower_ID.erase(grow_tower_ID.begin());
+      int grow_ID = grow_tower_ID[igrow];
 
       if (Verbosity() > 5)
       {
-        std::cout << " --> cluster " << cluster_index << ", growth stage, examining neighbors of ID " << grow_ID << ", " << grow_tower_ID.size() << " grow towers left" << std::endl;
+        std::cout << " --> cluster " << cluster_index << ", growth stage, examining neighbors of ID " << grow_ID << ", " << grow_tower_ID.size() - igrow - 1 << " grow towers left" << std::endl;
       }
 
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(grow_ID);
+      const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(grow_ID);
 
       for (int this_adjacent_tower_ID : adjacent_tower_IDs)
       {
@@ -759,7 +772,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
         // tower good to be added to cluster and to list of grow towers
         grow_tower_ID.push_back(this_adjacent_tower_ID);
-        cluster_tower_ID.push_back(this_adjacent_tower_ID);
+        all_cluster_towers.push_back(this_adjacent_tower_ID);
         set_status_by_ID(this_adjacent_tower_ID, cluster_index);
         if (Verbosity() > 10)
         {
@@ -769,7 +782,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
       if (Verbosity() > 5)
       {
-        std::cout << " --> after examining neighbors, grow list is now " << grow_tower_ID.size() << ", # of towers in cluster = " << cluster_tower_ID.size() << std::endl;
+        std::cout << " --> after examining neighbors, grow list is now " << grow_tower_ID.size() - igrow - 1 << ", # of towers in cluster = " << all_cluster_towers.size() - first_cluster_tower << std::endl;
       }
     }
 
@@ -779,17 +792,17 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       std::cout << " RawClusterBuilderTopo::process_event: Entering Perimeter stage for cluster " << cluster_index << std::endl;
     }
     // we'll be adding on to the cluster list, so get the # of core towers first
-    int n_core_towers = cluster_tower_ID.size();
+    int n_core_towers = all_cluster_towers.size() - first_cluster_tower;
 
     for (int ic = 0; ic < n_core_towers; ic++)
     {
-      int core_ID = cluster_tower_ID.at(ic);
+      int core_ID = all_cluster_towers[first_cluster_tower + ic];
 
       if (Verbosity() > 5)
       {
         std::cout << " --> cluster " << cluster_index << ", perimeter stage, examining neighbors of ID " << core_ID << ", core cluster # " << ic << " of " << n_core_towers << " total " << std::endl;
       }
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(core_ID);
+      const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(core_ID);
 
       for (int this_adjacent_tower_ID : adjacent_tower_IDs)
       {
@@ -831,7 +844,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         }
 
         // perimeter tower good to be added to cluster
-        cluster_tower_ID.push_back(this_adjacent_tower_ID);
+        all_cluster_towers.push_back(this_adjacent_tower_ID);
         set_status_by_ID(this_adjacent_tower_ID, cluster_index);
         if (Verbosity() > 10)
         {
@@ -841,12 +854,12 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
       if (Verbosity() > 5)
       {
-        std::cout << " --> after examining perimeter neighbors, # of towers in cluster is now = " << cluster_tower_ID.size() << std::endl;
+        std::cout << " --> after examining perimeter neighbors, # of towers in cluster is now = " << all_cluster_towers.size() - first_cluster_tower << std::endl;
       }
     }
 
     // keep track of these
-    all_cluster_towers.push_back(cluster_tower_ID);
+    all_cluster_towers_offset.push_back(all_cluster_towers.size());
 
     // increment cluster index for next one
     cluster_index++;
@@ -863,7 +876,8 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
   for (int cl = 0; cl < original_cluster_index; cl++)
   {
-    std::vector<int> original_towers = all_cluster_towers.at(cl);
+    std::vector<int> &original_towers = _original_towers;
+    original_towers.assign(all_cluster_towers.begin() + all_cluster_towers_offset[cl], all_cluster_towers.begin() + all_cluster_towers_offset[cl + 1]);
 
     if (!_do_split)
     {
@@ -897,7 +911,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       }
 
       // examine neighbors
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(tower_ID);
+      const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(tower_ID);
       int neighbors_in_cluster = 0;
 
       // check for higher neighbor
@@ -1109,7 +1123,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
             pseudocluster_adjacency[s] = false;
           }
           // look over all towers THIS one is adjacent to, and count up...
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
+          const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
 
           for (int this_adjacent_tower_ID : adjacent_tower_IDs)
           {
@@ -1205,7 +1219,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         int neighbor_ID = neighbor_list.at(n);
         if (new_ownerships.at(n) > -1)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
+          const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
 
           for (int this_adjacent_tower_ID : adjacent_tower_IDs)
           {
@@ -1262,7 +1276,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         std::cout << std::endl;
         if (the_pair.first == -1)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
+          const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
 
           for (int this_adjacent_tower_ID : adjacent_tower_IDs)
           {
@@ -1335,7 +1349,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       std::vector<bool> pseudocluster_adjacency;
       pseudocluster_adjacency.resize(local_maxima_ID.size(), false);
 
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(shared_ID);
+      const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(shared_ID);
 
       for (int this_adjacent_tower_ID : adjacent_tower_IDs)
       {
@@ -1410,7 +1424,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         std::cout << std::endl;
         if (the_pair.first == -1)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
+          const AdjacentTowers adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
 
           for (int this_adjacent_tower_ID : adjacent_tower_IDs)
           {
@@ -9,6 +9,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <cstddef>  // for size_t
 #include <map>
 #include <string>
 #include <utility>  // for pair
@@ -100,13 +101,22 @@ class RawClusterBuilderTopo : public SubsysReco
  private:
   void CreateNodes(PHCompositeNode *topNode);
 
-  std::vector<std::vector<std::vector<float> > > _TOWERMAP_E_LAYER_ETA_PHI;
-  std::vector<std::vector<std::vector<int> > > _TOWERMAP_KEY_LAYER_ETA_PHI;
-  std::vector<std::vector<std::vector<int> > > _TOWERMAP_STATUS_LAYER_ETA_PHI;
+  // tower energy, key and status, indexed by tower ID
+  std::vector<float> _TOWERMAP_E_BY_ID;
+  std::vector<int> _TOWERMAP_KEY_BY_ID;
+  std::vector<int> _TOWERMAP_STATUS_BY_ID;
 
-  std::vector<std::vector<float> > _EMTOWERMAP_E_ETA_PHI;
-  std::vector<std::vector<int> > _EMTOWERMAP_KEY_ETA_PHI;
-  std::vector<std::vector<int> > _EMTOWERMAP_STATUS_ETA_PHI;
+  // adjacent towers of each tower ID, in compressed sparse row format:
+  // the neighbors of ID are _ADJACENT_TOWERS[_ADJACENT_TOWERS_OFFSET[ID]] to _ADJACENT_TOWERS[_ADJACENT_TOWERS_OFFSET[ID + 1] - 1]
+  std::vector<int> _ADJACENT_TOWERS_OFFSET;
+  std::vector<int> _ADJACENT_TOWERS;
+
+  // per event work buffers, kept from one event to the next to avoid allocations
+  std::vector<std::pair<int, float> > _list_of_seeds;
+  std::vector<int> _grow_tower_ID;
+  std::vector<int> _all_cluster_towers;
+  std::vector<int> _all_cluster_towers_offset;
+  std::vector<int> _original_towers;
 
   // geometric constants to express IHCal<->EMCal overlap in eta
   static int RawClusterBuilderTopo_constants_EMCal_eta_start_given_IHCal[];
@@ -133,13 +143,42 @@ class RawClusterBuilderTopo : public SubsysReco
     return ((index_emcal_phi + 251)/4) % _HCAL_NPHI;
   }
 
-  std::vector<int> get_adjacent_towers_by_ID(int ID);
+  // range of adjacent tower IDs
+  class AdjacentTowers
+  {
+   public:
+    AdjacentTowers(const int *first, const int *last)
+      : _first(first)
+      , _last(last)
+    {
+    }
+    const int *begin() const { return _first; }
+    const int *end() const { return _last; }
+    size_t size() const { return _last - _first; }
+
+   private:
+    const int *_first;
+    const int *_last;
+  };
+
+  // adjacent towers from the precomputed table
+  AdjacentTowers get_adjacent_towers_by_ID(int ID) const
+  {
+    const int *adjacent_towers = _ADJACENT_TOWERS.data();
+    return {adjacent_towers + _ADJACENT_TOWERS_OFFSET[ID], adjacent_towers + _ADJACENT_TOWERS_OFFSET[ID + 1]};
+  }
+
+  // compute adjacent towers, used to fill the table
+  void calculate_adjacent_towers_by_ID(int ID, std::vector<int> &adjacent_towers);
+
+  // fill the adjacency table and size the tower maps, once geometry is known
+  void build_adjacency_table();
 
   float calculate_dR(float, float, float, float);
 
   void export_single_cluster(const std::vector<int> &);
 
-  void export_clusters(const std::vector<int> &, std::map<int, std::pair<int, int> >, unsigned int, std::vector<float>, std::vector<float>, std::vector<float>);
+  void export_clusters(const std::vector<int> &, std::map<int, std::pair<int, int> > &, unsigned int, const std::vector<float> &, const std::vector<float> &, const std::vector<float> &);
 
   int get_ID(int ilayer, int ieta, int iphi)
   {
@@ -186,34 +225,19 @@ class RawClusterBuilderTopo : public SubsysReco
     }
   }
 
-  int get_status_from_ID(int ID)
+  int get_status_from_ID(int ID) const
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      return _TOWERMAP_STATUS_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
-    }
-    return _EMTOWERMAP_STATUS_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
+    return _TOWERMAP_STATUS_BY_ID[ID];
   }
 
-  float get_E_from_ID(int ID)
+  float get_E_from_ID(int ID) const
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      return _TOWERMAP_E_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
-    }
-    return _EMTOWERMAP_E_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
+    return _TOWERMAP_E_BY_ID[ID];
   }
 
   void set_status_by_ID(int ID, int status)
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)] = status;
-    }
-    else
-    {
-      _EMTOWERMAP_STATUS_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)] = status;
-    }
+    _TOWERMAP_STATUS_BY_ID[ID] = status;
   }
 
   RawClusterContainer *_clusters = nullptr;
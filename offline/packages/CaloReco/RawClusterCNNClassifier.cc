@@ -26,7 +26,9 @@ I trained a crappy CNN to classify EMCal clusters as photon or not photon. S.Li
 #include <phool/onnxlib.h>
 #include <phool/phool.h>
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 RawClusterCNNClassifier::RawClusterCNNClassifier(const std::string &name)
@@ -39,7 +41,8 @@ RawClusterCNNClassifier::~RawClusterCNNClassifier() = default;
 int RawClusterCNNClassifier::Init(PHCompositeNode *topNode)
 {
   // init the onnx model
-  onnxmodule = onnxSession(m_modelPath);
+  onnxmodule = onnxSession(m_modelPath, m_onnx_nthreads);
+  m_onnxBatch = std::make_unique<OnnxBatchInference>(onnxmodule, std::vector<int64_t>{inputDimx, inputDimy, inputDimz}, outputDim);
 
   if (m_inputNodeName == m_outputNodeName)
   {
@@ -93,6 +96,10 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTEVENT;
   }
 
+  // the tower images of all clusters are collected and classified in one go
+  std::vector<RawCluster *> batch_clusters;
+  std::vector<float> batch_input;
+
   RawClusterContainer::Map clusterMap = _clusters->getClustersMap();
   for (auto &clusterPair : clusterMap)
   {
@@ -189,10 +196,20 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
         }
       }
     }
-    std::vector<float> prob = onnxInference(onnxmodule, input, 1, inputDimx, inputDimy, inputDimz, outputDim);
-    // std::cout << "new prob: " << prob[0] << "ET: " << ET << " original prob: " << recoCluster->get_prob() << std::endl;
-    // inplace change for the prob for now
-    recoCluster->set_prob(prob[0]);
+    batch_clusters.push_back(recoCluster);
+    batch_input.insert(batch_input.end(), input.begin(), input.end());
+  }
+
+  int nclusters = batch_clusters.size();
+  if (nclusters > 0)
+  {
+    std::copy(batch_input.begin(), batch_input.end(), m_onnxBatch->input(nclusters));
+    const float *prob = m_onnxBatch->run(nclusters);
+    for (int i = 0; i < nclusters; i++)
+    {
+      // inplace change for the prob for now
+      batch_clusters[i]->set_prob(prob[i * outputDim]);
+    }
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -200,6 +217,7 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
 
 int RawClusterCNNClassifier::End(PHCompositeNode * /*topNode*/)
 {
+  m_onnxBatch.reset();
   delete onnxmodule;
   return Fun4AllReturnCodes::EVENT_OK;
 }
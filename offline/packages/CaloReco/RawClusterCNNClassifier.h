@@ -5,6 +5,8 @@
 
 #include <phool/onnxlib.h>
 
+#include <memory>
+
 class PHCompositeNode;
 class RawClusterContainer;
 
@@ -33,8 +35,11 @@ class RawClusterCNNClassifier : public SubsysReco
 
   void set_min_cluster_e(const float min_cluster_e) { m_min_cluster_e = min_cluster_e; }
 
+  void set_onnx_nthreads(const int nthreads) { m_onnx_nthreads = nthreads; }
+
  private:
   Ort::Session *onnxmodule{nullptr};
+  std::unique_ptr<OnnxBatchInference> m_onnxBatch;
   const int inputDimx{5};
   const int inputDimy{5};
   const int inputDimz{1};
@@ -54,6 +59,8 @@ class RawClusterCNNClassifier : public SubsysReco
 
   float m_min_cluster_e{3};
 
+  int m_onnx_nthreads{0};
+
   void CreateNodes(PHCompositeNode* topNode);
 
 
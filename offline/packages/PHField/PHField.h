@@ -21,6 +21,21 @@ class PHField
       const double Point[4],
       double *Bfield) const = 0;
 
+  //! access field values for a batch of points
+  //! @param[in]  Points  n space time coordinates stored contiguously (x, y, z, t per point)
+  //! @param[out] Bfields n field values stored contiguously (Bx, By, Bz per point)
+  //! @param[in]  n       number of points
+  virtual void GetFieldValues(
+      const double *Points,
+      double *Bfields,
+      const unsigned int n) const
+  {
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      GetFieldValue(Points + 4 * i, Bfields + 3 * i);
+    }
+  }
+
   void Verbosity(const int i) { m_Verbosity = i; }
   int Verbosity() const { return m_Verbosity; }
 
@@ -0,0 +1,346 @@
+#include "PHField3DCartesianGrid.h"
+
+#include <phool/phool.h>
+
+#include <TFile.h>
+#include <TNtuple.h>
+#include <TSystem.h>
+
+#include <Geant4/G4SystemOfUnits.hh>
+
+// stacktrace gives a shadow warning
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+#include <boost/stacktrace.hpp>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+namespace
+{
+  //! number of points which are handled in one go by GetFieldValues
+  constexpr unsigned int batch_size = 64;
+
+  //! grid coordinate of a point along one axis.
+  //! returns the index of the lower node and sets the fraction within the cell
+  inline int cell_index(const double pos, const double min, const double stepinv, const int n, double &fraction)
+  {
+    const double u = (pos - min) * stepinv;
+    // the upper edge of the map belongs to the last cell
+    const int i = std::min(static_cast<int>(u), n - 2);
+    fraction = u - i;
+    return i;
+  }
+}  // namespace
+
+PHField3DCartesianGrid::PHField3DCartesianGrid(const std::string &fname, const float magfield_rescale, const float innerradius, const float outerradius, const float size_z)
+  : filename(fname)
+{
+  std::cout << "\n================ Begin Construct Mag Field =====================" << std::endl;
+  std::cout << "\n-----------------------------------------------------------"
+            << "\n      Magnetic field Module - Verbosity:"
+            << "\n-----------------------------------------------------------";
+
+  // open file
+  TFile *rootinput = TFile::Open(filename.c_str());
+  if (!rootinput)
+  {
+    std::cout << "\n could not open " << filename << " exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  std::cout << "\n ---> "
+               "Reading the field grid from "
+            << filename << " ... " << std::endl;
+
+  //  get root NTuple objects
+  TNtuple *field_map = nullptr;
+  rootinput->GetObject("fieldmap", field_map);
+  if (field_map == nullptr)
+  {
+    std::cout << PHWHERE << " Could not load fieldmap ntuple from "
+              << filename << " exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  Float_t ROOT_X, ROOT_Y, ROOT_Z;
+  Float_t ROOT_BX, ROOT_BY, ROOT_BZ;
+  field_map->SetBranchAddress("x", &ROOT_X);
+  field_map->SetBranchAddress("y", &ROOT_Y);
+  field_map->SetBranchAddress("z", &ROOT_Z);
+  field_map->SetBranchAddress("bx", &ROOT_BX);
+  field_map->SetBranchAddress("by", &ROOT_BY);
+  field_map->SetBranchAddress("bz", &ROOT_BZ);
+
+  // first pass: find the grid extent and granularity
+  std::set<float> xvals;
+  std::set<float> yvals;
+  std::set<float> zvals;
+  for (int i = 0; i < field_map->GetEntries(); i++)
+  {
+    field_map->GetEntry(i);
+    xvals.insert(ROOT_X * cm);
+    yvals.insert(ROOT_Y * cm);
+    zvals.insert(ROOT_Z * cm);
+  }
+  if (xvals.size() < 2 || yvals.size() < 2 || zvals.size() < 2)
+  {
+    std::cout << PHWHERE << " fieldmap in " << filename
+              << " needs at least two grid points per dimension, exiting now" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+  }
+  m_nx = xvals.size();
+  m_ny = yvals.size();
+  m_nz = zvals.size();
+
+  xmin = *(xvals.begin());
+  xmax = *(xvals.rbegin());
+  ymin = *(yvals.begin());
+  ymax = *(yvals.rbegin());
+  zmin = *(zvals.begin());
+  zmax = *(zvals.rbegin());
+
+  xstepsize = (xmax - xmin) / (m_nx - 1);
+  ystepsize = (ymax - ymin) / (m_ny - 1);
+  zstepsize = (zmax - zmin) / (m_nz - 1);
+  xstepinv = 1. / xstepsize;
+  ystepinv = 1. / ystepsize;
+  zstepinv = 1. / zstepsize;
+
+  // second pass: fill the grid nodes
+  m_grid.resize(static_cast<std::size_t>(m_nx) * m_ny * m_nz);
+  for (int i = 0; i < field_map->GetEntries(); i++)
+  {
+    field_map->GetEntry(i);
+    const double x = ROOT_X * cm;
+    const double y = ROOT_Y * cm;
+    const double z = ROOT_Z * cm;
+    if ((std::sqrt(x * x + y * y) >= innerradius &&
+         std::sqrt(x * x + y * y) <= outerradius) ||
+        std::abs(z) > size_z)
+    {
+      const double u[3] = {(x - xmin) * xstepinv, (y - ymin) * ystepinv, (z - zmin) * zstepinv};
+      int idx[3];
+      for (int j = 0; j < 3; j++)
+      {
+        idx[j] = std::lround(u[j]);
+        if (std::abs(u[j] - idx[j]) > 1e-3)
+        {
+          std::cout << PHWHERE << " fieldmap in " << filename
+                    << " is not a regular grid, point x: " << x / cm
+                    << ", y: " << y / cm << ", z: " << z / cm
+                    << " is off the grid. Use PHField3DCartesian for this map, exiting now" << std::endl;
+          gSystem->Exit(1);
+          exit(1);
+        }
+      }
+      GridNode &node = m_grid[index(idx[0], idx[1], idx[2])];
+      node.b[0] = ROOT_BX * tesla * magfield_rescale;
+      node.b[1] = ROOT_BY * tesla * magfield_rescale;
+      node.b[2] = ROOT_BZ * tesla * magfield_rescale;
+      node.b[3] = 1;
+    }
+  }
+
+  std::cout << " ---> grid with " << m_nx << " x " << m_ny << " x " << m_nz
+            << " nodes, step size x/y/z: " << xstepsize / cm << "/" << ystepsize / cm << "/" << zstepsize / cm
+            << " cm" << std::endl;
+
+  delete field_map;
+  delete rootinput;
+  std::cout << "\n================= End Construct Mag Field ======================\n"
+            << std::endl;
+}
+
+PHField3DCartesianGrid::~PHField3DCartesianGrid()
+{
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHField3DCartesianGrid: number of invalid points: " << m_invalid_reported << std::endl;
+  }
+}
+
+void PHField3DCartesianGrid::report_invalid_point(const double x, const double y, const double z) const
+{
+  if (m_invalid_reported++ < 10)
+  {
+    std::cout << "PHField3DCartesianGrid::GetFieldValue: "
+              << "Invalid coordinates: "
+              << "x: " << x / cm
+              << ", y: " << y / cm
+              << ", z: " << z / cm
+              << " bailing out returning zero bfield"
+              << std::endl;
+    std::cout << "Here is the stacktrace: " << std::endl;
+    std::cout << boost::stacktrace::stacktrace();
+    std::cout << "This is not a segfault. Check the stacktrace for the guilty party (typically #2)" << std::endl;
+  }
+}
+
+void PHField3DCartesianGrid::interpolate(const double x, const double y, const double z, double *Bfield) const
+{
+  double fx;
+  double fy;
+  double fz;
+  const int ix = cell_index(x, xmin, xstepinv, m_nx, fx);
+  const int iy = cell_index(y, ymin, ystepinv, m_ny, fy);
+  const int iz = cell_index(z, zmin, zstepinv, m_nz, fz);
+
+  // the two z neighbours are adjacent in memory, so each (x,y) corner pair
+  // is a single 32 byte load
+  const GridNode *c00 = &m_grid[index(ix, iy, iz)];
+  const GridNode *c01 = &m_grid[index(ix, iy + 1, iz)];
+  const GridNode *c10 = &m_grid[index(ix + 1, iy, iz)];
+  const GridNode *c11 = &m_grid[index(ix + 1, iy + 1, iz)];
+
+  // successive linear interpolation in z, y and x of all four lanes at once
+  // (bx, by, bz, valid)
+  std::array<double, 4> v{};
+  for (int l = 0; l < 4; l++)
+  {
+    const double v00 = c00[0].b[l] + fz * (c00[1].b[l] - c00[0].b[l]);
+    const double v01 = c01[0].b[l] + fz * (c01[1].b[l] - c01[0].b[l]);
+    const double v10 = c10[0].b[l] + fz * (c10[1].b[l] - c10[0].b[l]);
+    const double v11 = c11[0].b[l] + fz * (c11[1].b[l] - c11[0].b[l]);
+    const double v0 = v00 + fy * (v01 - v00);
+    const double v1 = v10 + fy * (v11 - v10);
+    v[l] = v0 + fx * (v1 - v0);
+  }
+
+  // any contributing corner outside of the region filled from the input map
+  // gives zero field, as in PHField3DCartesian
+  if (v[3] < 1.)
+  {
+    Bfield[0] = 0.0;
+    Bfield[1] = 0.0;
+    Bfield[2] = 0.0;
+    return;
+  }
+  Bfield[0] = v[0];
+  Bfield[1] = v[1];
+  Bfield[2] = v[2];
+}
+
+void PHField3DCartesianGrid::GetFieldValue(const double point[4], double *Bfield) const
+{
+  const double x = point[0];
+  const double y = point[1];
+  const double z = point[2];
+
+  Bfield[0] = 0.0;
+  Bfield[1] = 0.0;
+  Bfield[2] = 0.0;
+  if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
+  {
+    report_invalid_point(x, y, z);
+    return;
+  }
+
+  if (x < xmin || x > xmax ||
+      y < ymin || y > ymax ||
+      z < zmin || z > zmax)
+  {
+    return;
+  }
+  interpolate(x, y, z, Bfield);
+  if (Verbosity() > 0)
+  {
+    std::cout << "x/y/z: " << x / cm << "/" << y / cm << "/" << z / cm
+              << " bx/by/bz: " << Bfield[0] / tesla << "/" << Bfield[1] / tesla << "/" << Bfield[2] / tesla
+              << std::endl;
+  }
+}
+
+void PHField3DCartesianGrid::GetFieldValues(const double *Points, double *Bfields, const unsigned int n) const
+{
+  // points are handled in blocks: first they are classified, then the cell of
+  // every point inside the map is computed, then all of them are interpolated
+  // lane by lane. The last two steps have independent iterations without
+  // branches on the coordinates, so the compiler can vectorize them.
+  // The arithmetic is the same as in interpolate(), results are identical
+  // to GetFieldValue
+  std::array<unsigned int, batch_size> inside{};
+  std::array<std::size_t, batch_size> corner{};
+  std::array<double, batch_size> fx{};
+  std::array<double, batch_size> fy{};
+  std::array<double, batch_size> fz{};
+  // interpolated bx, by, bz and valid flag, lane after lane
+  std::array<double, 4 * batch_size> v{};
+
+  // distance between neighbouring nodes in y and in x
+  const std::size_t dy = m_nz;
+  const std::size_t dx = static_cast<std::size_t>(m_ny) * m_nz;
+  const GridNode *nodes = m_grid.data();
+
+  for (unsigned int start = 0; start < n; start += batch_size)
+  {
+    const unsigned int end = std::min(n, start + batch_size);
+    unsigned int ninside = 0;
+    for (unsigned int i = start; i < end; i++)
+    {
+      const double *point = Points + 4 * i;
+      double *Bfield = Bfields + 3 * i;
+      Bfield[0] = 0.0;
+      Bfield[1] = 0.0;
+      Bfield[2] = 0.0;
+      if (!std::isfinite(point[0]) || !std::isfinite(point[1]) || !std::isfinite(point[2]))
+      {
+        report_invalid_point(point[0], point[1], point[2]);
+        continue;
+      }
+      if (point[0] >= xmin && point[0] <= xmax &&
+          point[1] >= ymin && point[1] <= ymax &&
+          point[2] >= zmin && point[2] <= zmax)
+      {
+        inside[ninside++] = i;
+      }
+    }
+
+    for (unsigned int j = 0; j < ninside; j++)
+    {
+      const double *point = Points + 4 * inside[j];
+      const int ix = cell_index(point[0], xmin, xstepinv, m_nx, fx[j]);
+      const int iy = cell_index(point[1], ymin, ystepinv, m_ny, fy[j]);
+      const int iz = cell_index(point[2], zmin, zstepinv, m_nz, fz[j]);
+      corner[j] = index(ix, iy, iz);
+    }
+
+    for (int l = 0; l < 4; l++)
+    {
+      double *vl = v.data() + l * batch_size;
+      for (unsigned int j = 0; j < ninside; j++)
+      {
+        const GridNode *c00 = nodes + corner[j];
+        const GridNode *c01 = c00 + dy;
+        const GridNode *c10 = c00 + dx;
+        const GridNode *c11 = c10 + dy;
+        const double v00 = c00[0].b[l] + fz[j] * (c00[1].b[l] - c00[0].b[l]);
+        const double v01 = c01[0].b[l] + fz[j] * (c01[1].b[l] - c01[0].b[l]);
+        const double v10 = c10[0].b[l] + fz[j] * (c10[1].b[l] - c10[0].b[l]);
+        const double v11 = c11[0].b[l] + fz[j] * (c11[1].b[l] - c11[0].b[l]);
+        const double v0 = v00 + fy[j] * (v01 - v00);
+        const double v1 = v10 + fy[j] * (v11 - v10);
+        vl[j] = v0 + fx[j] * (v1 - v0);
+      }
+    }
+
+    // points next to the region filled from the input map keep zero field
+    for (unsigned int j = 0; j < ninside; j++)
+    {
+      if (v[3 * batch_size + j] < 1.)
+      {
+        continue;
+      }
+      double *Bfield = Bfields + 3 * inside[j];
+      Bfield[0] = v[j];
+      Bfield[1] = v[batch_size + j];
+      Bfield[2] = v[2 * batch_size + j];
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#ifndef PHFIELD_PHFIELD3DCARTESIANGRID_H
+#define PHFIELD_PHFIELD3DCARTESIANGRID_H
+
+#include "PHField.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//! 3D field map in Cartesian coordinates stored on a dense regular grid
+/*!
+ * Reads the same ntuple as PHField3DCartesian but keeps the field as a flat
+ * array of nodes with fixed spacing. Cell indices are computed arithmetically,
+ * there is no per-query search and no cached state, so GetFieldValue
+ * can be called concurrently from several threads.
+ */
+class PHField3DCartesianGrid : public PHField
+{
+ public:
+  explicit PHField3DCartesianGrid(const std::string &fname, const float magfield_rescale = 1.0, const float innerradius = 0, const float outerradius = 1.e10, const float size_z = 1.e10);
+  ~PHField3DCartesianGrid() override;
+
+  //! access field value
+  //! Follow the convention of G4ElectroMagneticField
+  //! @param[in]  Point   space time coordinate. x, y, z, t in Geant4/CLHEP units
+  //! @param[out] Bfield  field value. In the case of magnetic field, the order is Bx, By, Bz in in Geant4/CLHEP units
+  void GetFieldValue(const double Point[4], double *Bfield) const override;
+
+  //! access field values for n points at once, see PHField::GetFieldValues
+  void GetFieldValues(const double *Points, double *Bfields, const unsigned int n) const override;
+
+ private:
+  //! one grid node: bx, by, bz and a flag for nodes which were present in the input map,
+  //! padded to 16 bytes so that the four values are interpolated together
+  struct alignas(16) GridNode
+  {
+    float b[4]{};
+  };
+
+  //! flat index of grid node (ix, iy, iz), z runs fastest
+  std::size_t index(const int ix, const int iy, const int iz) const
+  {
+    return (static_cast<std::size_t>(ix) * m_ny + iy) * m_nz + iz;
+  }
+
+  //! trilinear interpolation, no checks on the input coordinates
+  void interpolate(const double x, const double y, const double z, double *Bfield) const;
+
+  //! print diagnostics for non finite coordinates
+  void report_invalid_point(const double x, const double y, const double z) const;
+
+  std::string filename;
+  int m_nx = 0;
+  int m_ny = 0;
+  int m_nz = 0;
+  double xmin = 1000000;
+  double xmax = -1000000;
+  double ymin = 1000000;
+  double ymax = -1000000;
+  double zmin = 1000000;
+  double zmax = -1000000;
+  double xstepsize = NAN;
+  double ystepsize = NAN;
+  double zstepsize = NAN;
+  double xstepinv = NAN;
+  double ystepinv = NAN;
+  double zstepinv = NAN;
+
+  std::vector<GridNode> m_grid;
+
+  //! number of non finite points reported so far
+  mutable std::atomic<int> m_invalid_reported{0};
+};
+
+#endif
@@ -31,6 +31,9 @@ string PHFieldConfig::get_field_config_description() const
   case Field3DCartesian:
     return "3D field map expressed in Cartesian coordinates";
     break;
+  case kField3DCartesianGrid:
+    return "3D field map expressed in Cartesian coordinates on a regular grid";
+    break;
   case kFieldBeast:
     return "Beast Field";
     break;
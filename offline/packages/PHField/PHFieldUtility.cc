@@ -3,6 +3,7 @@
 #include "PHField.h"
 #include "PHField2D.h"
 #include "PHField3DCartesian.h"
+#include "PHField3DCartesianGrid.h"
 #include "PHField3DCylindrical.h"
 #include "PHFieldConfig.h"
 #include "PHFieldConfigv1.h"
@@ -74,6 +75,16 @@ PHFieldUtility::BuildFieldMap(const PHFieldConfig *field_config, float inner_rad
         size_z);
     break;
 
+  case PHFieldConfig::kField3DCartesianGrid:
+    //    return "3D field map expressed in Cartesian coordinates on a regular grid";
+    field = new PHField3DCartesianGrid(
+        field_config->get_filename(),
+        field_config->get_magfield_rescale(),
+        inner_radius,
+        outer_radius,
+        size_z);
+    break;
+
   default:
     std::cout << "PHFieldUtility::BuildFieldMap - Invalid Field Configuration: " << field_config->get_field_config() << std::endl;
     gSystem->Exit(1);
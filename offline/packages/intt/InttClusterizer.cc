@@ -9,6 +9,7 @@
 #include <trackbase/TrkrHit.h>
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
 
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/RawHit.h>
@@ -29,15 +30,12 @@
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/connected_components.hpp>
-
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <limits>
 #include <memory>  // for unique_ptr, make_...
-#include <set>
 #include <vector>  // for vector
 
 namespace
@@ -51,52 +49,6 @@ namespace
   }
 }  // namespace
 
-bool InttClusterizer::ladder_are_adjacent(const std::pair<TrkrDefs::hitkey, TrkrHit*>& lhs, const std::pair<TrkrDefs::hitkey, TrkrHit*>& rhs, const int layer)
-{
-  if (get_z_clustering(layer))
-  {
-    if (fabs(InttDefs::getCol(lhs.first) - InttDefs::getCol(rhs.first)) <= 1)
-    {
-      if (fabs(InttDefs::getRow(lhs.first) - InttDefs::getRow(rhs.first)) <= 1)
-      {
-        return true;
-      }
-    }
-  }
-  else if (fabs(InttDefs::getCol(lhs.first) - InttDefs::getCol(rhs.first)) == 0)
-  {
-    if (fabs(InttDefs::getRow(lhs.first) - InttDefs::getRow(rhs.first)) <= 1)
-    {
-      return true;
-    }
-  }
-
-  return false;
-}
-
-bool InttClusterizer::ladder_are_adjacent(RawHit* lhs, RawHit* rhs, const int layer)
-{
-  if (get_z_clustering(layer))
-  {
-    if (fabs(lhs->getPhiBin() - rhs->getPhiBin()) <= 1)  // col
-    {
-      if (fabs(lhs->getTBin() - rhs->getTBin()) <= 1)  // Row
-      {
-        return true;
-      }
-    }
-  }
-  else if (fabs(lhs->getPhiBin() - rhs->getPhiBin()) <= 1)
-  {
-    if (fabs(lhs->getTBin() - rhs->getTBin()) == 0)
-    {
-      return true;
-    }
-  }
-
-  return false;
-}
-
 InttClusterizer::InttClusterizer(const std::string& name,
                                  unsigned int /*min_layer*/,
                                  unsigned int /*max_layer*/)
@@ -386,63 +338,51 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
     float pitch = geom->get_strip_y_spacing();
     float length = geom->get_strip_z_spacing(type);
 
-    // fill a vector of hits to make things easier - gets every hit in the hitset
-    std::vector<std::pair<TrkrDefs::hitkey, TrkrHit*>> hitvec;
-    TrkrHitSet::ConstRange hitrangei = hitset->getHits();
-    for (TrkrHitSet::ConstIterator hitr = hitrangei.first;
-         hitr != hitrangei.second;
-         ++hitr)
+    // fill a vector of (hitkey, adc) to make things easier - gets every hit in the hitset
+    std::vector<std::pair<TrkrDefs::hitkey, unsigned int>> hitvec;
+    if (auto flat = dynamic_cast<TrkrHitSetv2*>(hitset))
+    {
+      // flat hitsets, no TrkrHit involved
+      const auto& hitkeys = flat->getHitKeys();
+      const auto& adcs = flat->getAdcs();
+      hitvec.reserve(hitkeys.size());
+      for (unsigned int i = 0; i < hitkeys.size(); ++i)
+      {
+        hitvec.emplace_back(hitkeys[i], adcs[i]);
+      }
+    }
+    else
     {
-      hitvec.emplace_back(hitr->first, hitr->second);
+      TrkrHitSet::ConstRange hitrangei = hitset->getHits();
+      for (TrkrHitSet::ConstIterator hitr = hitrangei.first;
+           hitr != hitrangei.second;
+           ++hitr)
+      {
+        hitvec.emplace_back(hitr->first, hitr->second->getAdc());
+      }
     }
     if (Verbosity() > 2)
     {
       std::cout << "hitvec.size(): " << hitvec.size() << std::endl;
     }
 
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
-
     // Find adjacent strips
-    for (unsigned int i = 0; i < hitvec.size(); i++)
-    {
-      for (unsigned int j = i + 1; j < hitvec.size(); j++)
-      {
-        if (ladder_are_adjacent(hitvec[i], hitvec[j], layer))
-        {
-          add_edge(i, j, G);
-        }
-      }
-
-      add_edge(i, i, G);
-    }
-
-    // Find the connections between the vertices of the graph (vertices are the rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    connected_components(G, &component[0]);
-
-    // Loop over the components(hit cells) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
-
-    std::multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit*>> clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
+    // connected strips share a column (or are in adjacent columns with z clustering), and are at most one row apart
+    m_strips.clear();
+    for (const auto& hit : hitvec)
     {
-      cluster_ids.insert(component[i]);                          // one entry per unique cluster id
-      clusters.insert(std::make_pair(component[i], hitvec[i]));  // multiple entries per unique cluster id
+      m_strips.push_back({InttDefs::getRow(hit.first), InttDefs::getCol(hit.first)});
     }
+    const unsigned int nclusters = m_labeler.label(m_strips, 1, get_z_clustering(layer) ? 1 : 0);
 
     // loop over the cluster ID's and make the clusters from the connected hits
-    for (int clusid : cluster_ids)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
       // std::cout << " intt clustering: add cluster number " << clusid << std::endl;
       // get all hits for this cluster ID only
-      std::pair<std::multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit*>>::iterator,
-                std::multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit*>>::iterator>
-          clusrange = clusters.equal_range(clusid);
+      std::size_t nclushits = 0;
+      const auto indices = m_labeler.hits(clusid, nclushits);
+      const auto& bounds = m_labeler.bounds(clusid);
 
       // make the cluster directly in the node tree
       TrkrDefs::cluskey ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
@@ -456,8 +396,9 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       short int crossing = InttDefs::getTimeBucketId(hitset->getHitSetKey());
 
       // determine the size of the cluster in phi and z, useful for track fitting the cluster
-      std::set<int> phibins;
-      std::set<int> zbins;
+      // rows and columns of a cluster are contiguous
+      const unsigned int nphibins = bounds.nrows();
+      const unsigned int nzbins = bounds.ncols();
 
       // determine the cluster position...
       double xlocalsum = 0.0;
@@ -467,17 +408,18 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       unsigned int clus_maxadc = 0.0;
       unsigned nhits = 0;
       // std::cout << PHWHERE << " ckey " << ckey << ":" << std::endl;
-      for (std::multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit*>>::iterator mapiter = clusrange.first; mapiter != clusrange.second; ++mapiter)
+      for (std::size_t ihit = 0; ihit < nclushits; ++ihit)
       {
-        // mapiter->second.first  is the hit key
-        // std::cout << " adding hitkey " << mapiter->second.first << std::endl;
-        int col = InttDefs::getCol((mapiter->second).first);
-        int row = InttDefs::getRow((mapiter->second).first);
-        zbins.insert(col);
-        phibins.insert(row);
+        const auto& hit = hitvec[indices[ihit]];
+        const auto& strip = m_strips[indices[ihit]];
 
-        // mapiter->second.second is the hit
-        unsigned int hit_adc = (mapiter->second).second->getAdc();
+        // hit.first  is the hit key
+        // std::cout << " adding hitkey " << hit.first << std::endl;
+        int col = strip.col;
+        int row = strip.row;
+
+        // hit.second is the adc
+        unsigned int hit_adc = hit.second;
 
         // Add clusterkey/bunch crossing to mmap
         m_clustercrossingassoc->addAssoc(ckey, crossing);
@@ -508,7 +450,7 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
         ++nhits;
 
         // add this cluster-hit association to the association map of (clusterkey,hitkey)
-        m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
+        m_clusterhitassoc->addAssoc(ckey, hit.first);
 
         if (Verbosity() > 2)
         {
@@ -533,20 +475,20 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       float phierror = pitch * invsqrt12;
 
       static constexpr std::array<double, 3> scalefactors_phi = {{0.85, 0.4, 0.33}};
-      if (phibins.size() == 1 && layer < 5)
+      if (nphibins == 1 && layer < 5)
       {
         phierror *= scalefactors_phi[0];
       }
-      else if (phibins.size() == 2 && layer < 5)
+      else if (nphibins == 2 && layer < 5)
       {
         phierror *= scalefactors_phi[1];
       }
-      else if (phibins.size() == 2 && layer > 4)
+      else if (nphibins == 2 && layer > 4)
       {
         phierror *= scalefactors_phi[2];
       }
       // z error.
-      const float zerror = zbins.size() * length * invsqrt12;
+      const float zerror = nzbins * length * invsqrt12;
 
       double cluslocaly = std::numeric_limits<double>::quiet_NaN();
       double cluslocalz = std::numeric_limits<double>::quiet_NaN();
@@ -569,8 +511,8 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       clus->setLocalY(cluslocalz);
       clus->setPhiError(phierror);
       clus->setZError(zerror);
-      clus->setPhiSize(phibins.size());
-      clus->setZSize(zbins.size());
+      clus->setPhiSize(nphibins);
+      clus->setZSize(nzbins);
       // All silicon surfaces have a 1-1 map to hitsetkey.
       // So set subsurface key to 0
       clus->setSubSurfKey(0);
@@ -671,47 +613,24 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       std::cout << "hitvec.size(): " << hitvec.size() << std::endl;
     }
 
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
-
     // Find adjacent strips
-    for (unsigned int i = 0; i < hitvec.size(); i++)
-    {
-      for (unsigned int j = i + 1; j < hitvec.size(); j++)
-      {
-        if (ladder_are_adjacent(hitvec[i], hitvec[j], layer))
-        {
-          add_edge(i, j, G);
-        }
-      }
-
-      add_edge(i, i, G);
-    }
-
-    // Find the connections between the vertices of the graph (vertices are the rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    connected_components(G, &component[0]);
-
-    // Loop over the components(hit cells) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
-
-    std::multimap<int, RawHit*> clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
+    // connected strips share a row (time bin) and are at most one column apart, or are in adjacent rows with z clustering.
+    // Only neighbours at the same or larger bins than an earlier strip are connected to it, as with the boost graph
+    m_strips.clear();
+    for (const auto& hit : hitvec)
     {
-      cluster_ids.insert(component[i]);                          // one entry per unique cluster id
-      clusters.insert(std::make_pair(component[i], hitvec[i]));  // multiple entries per unique cluster id
+      m_strips.push_back({static_cast<int>(hit->getTBin()), static_cast<int>(hit->getPhiBin())});
     }
+    const unsigned int nclusters = m_labeler.label(m_strips, get_z_clustering(layer) ? 1 : 0, 1, true);
 
     // loop over the cluster ID's and make the clusters from the connected hits
-    for (int clusid : cluster_ids)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
       // std::cout << " intt clustering: add cluster number " << clusid << std::endl;
       // get all hits for this cluster ID only
-      auto clusrange = clusters.equal_range(clusid);
+      std::size_t nclushits = 0;
+      const auto indices = m_labeler.hits(clusid, nclushits);
+      const auto& bounds = m_labeler.bounds(clusid);
 
       // make the cluster directly in the node tree
       TrkrDefs::cluskey ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
@@ -725,8 +644,9 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       short int crossing = InttDefs::getTimeBucketId(hitset->getHitSetKey());
 
       // determine the size of the cluster in phi and z, useful for track fitting the cluster
-      std::set<int> phibins;
-      std::set<int> zbins;
+      // rows and columns of a cluster are contiguous
+      const unsigned int nphibins = bounds.nrows();
+      const unsigned int nzbins = bounds.ncols();
 
       // determine the cluster position...
       double xlocalsum = 0.0;
@@ -737,35 +657,32 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
 
       // std::cout << PHWHERE << " ckey " << ckey << ":" << std::endl;
 
-      std::map<int, unsigned int> m_phi, m_z;  // hold data for
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second; ++mapiter)
+      // energy per row and column, indexed from the first row and column of the cluster
+      std::vector<unsigned int> m_phi;
+      std::vector<unsigned int> m_z;
+      if (mClusHitsVerbose)
+      {
+        m_phi.assign(nphibins, 0);
+        m_z.assign(nzbins, 0);
+      }
+      for (std::size_t ihit = 0; ihit < nclushits; ++ihit)
       {
-        // mapiter->second.first  is the hit key
-        // std::cout << " adding hitkey " << mapiter->second.first << std::endl;
-        const auto energy = (mapiter->second)->getAdc();
-        int col = (mapiter->second)->getPhiBin();
-        int row = (mapiter->second)->getTBin();
+        RawHit* hit = hitvec[indices[ihit]];
+        const auto& strip = m_strips[indices[ihit]];
+
+        const auto energy = hit->getAdc();
+        int col = strip.col;
+        int row = strip.row;
         //	    std::cout << " found Tbin(row) " << row << " Phibin(col) " << col << std::endl;
-        zbins.insert(col);
-        phibins.insert(row);
 
         if (mClusHitsVerbose)
         {
-          auto pnew = m_phi.try_emplace(row, energy);
-          if (!pnew.second)
-          {
-            pnew.first->second += energy;
-          }
-
-          pnew = m_z.try_emplace(col, energy);
-          if (!pnew.second)
-          {
-            pnew.first->second += energy;
-          }
+          m_phi[row - bounds.row_min] += energy;
+          m_z[col - bounds.col_min] += energy;
         }
 
-        // mapiter->second.second is the hit
-        unsigned int hit_adc = (mapiter->second)->getAdc();
+        // hit is the hit
+        unsigned int hit_adc = hit->getAdc();
 
         // Add clusterkey/bunch crossing to mmap
         m_clustercrossingassoc->addAssoc(ckey, crossing);
@@ -810,18 +727,18 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       {
         if (Verbosity() > 10)
         {
-          for (auto const& hit : m_phi)
+          for (unsigned int i = 0; i < nphibins; ++i)
           {
-            std::cout << " m_phi(" << hit.first << " : " << hit.second << ") " << std::endl;
+            std::cout << " m_phi(" << bounds.row_min + i << " : " << m_phi[i] << ") " << std::endl;
           }
         }
-        for (auto& hit : m_phi)
+        for (unsigned int i = 0; i < nphibins; ++i)
         {
-          mClusHitsVerbose->addPhiHit(hit.first, (float) hit.second);
+          mClusHitsVerbose->addPhiHit(bounds.row_min + i, (float) m_phi[i]);
         }
-        for (auto& hit : m_z)
+        for (unsigned int i = 0; i < nzbins; ++i)
         {
-          mClusHitsVerbose->addZHit(hit.first, (float) hit.second);
+          mClusHitsVerbose->addZHit(bounds.col_min + i, (float) m_z[i]);
         }
         mClusHitsVerbose->push_hits(ckey);
       }
@@ -838,20 +755,20 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       float phierror = pitch * invsqrt12;
 
       static constexpr std::array<double, 3> scalefactors_phi = {{0.85, 0.4, 0.33}};
-      if (phibins.size() == 1 && layer < 5)
+      if (nphibins == 1 && layer < 5)
       {
         phierror *= scalefactors_phi[0];
       }
-      else if (phibins.size() == 2 && layer < 5)
+      else if (nphibins == 2 && layer < 5)
       {
         phierror *= scalefactors_phi[1];
       }
-      else if (phibins.size() == 2 && layer > 4)
+      else if (nphibins == 2 && layer > 4)
       {
         phierror *= scalefactors_phi[2];
       }
       // z error.
-      const float zerror = zbins.size() * length * invsqrt12;
+      const float zerror = nzbins * length * invsqrt12;
 
       double cluslocaly = std::numeric_limits<double>::quiet_NaN();
       double cluslocalz = std::numeric_limits<double>::quiet_NaN();
@@ -873,8 +790,8 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       clus->setLocalY(cluslocalz);
       clus->setPhiError(phierror);
       clus->setZError(zerror);
-      clus->setPhiSize(phibins.size());
-      clus->setZSize(zbins.size());
+      clus->setPhiSize(nphibins);
+      clus->setZSize(nzbins);
       // All silicon surfaces have a 1-1 map to hitsetkey.
       // So set subsurface key to 0
       clus->setSubSurfKey(0);
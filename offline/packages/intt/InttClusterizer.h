@@ -3,12 +3,14 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <trackbase/PixelClusterLabeler.h>
 #include <trackbase/TrkrDefs.h>
 
 #include <limits>
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 class ClusHitsVerbosev1;
 class PHCompositeNode;
@@ -78,8 +80,6 @@ class InttClusterizer : public SubsysReco
 
  private:
   bool record_ClusHitsVerbose{false};
-  bool ladder_are_adjacent(const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs, const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs, const int layer);
-  bool ladder_are_adjacent(RawHit *lhs, RawHit *rhs, const int layer);
 
   void CalculateLadderThresholds(PHCompositeNode *topNode);
   void ClusterLadderCells(PHCompositeNode *topNode);
@@ -93,6 +93,10 @@ class InttClusterizer : public SubsysReco
   TrkrClusterHitAssoc *m_clusterhitassoc = nullptr;
   TrkrClusterCrossingAssoc *m_clustercrossingassoc = nullptr;
 
+  //! connected strips labeling, and (row, col) of the hits of the current sensor
+  PixelClusterLabeler m_labeler;
+  std::vector<PixelClusterLabeler::Hit> m_strips;
+
   // settings
   float _fraction_of_mip = 0.5;
   std::map<int, float> _thresholds_by_layer;  // layer->threshold
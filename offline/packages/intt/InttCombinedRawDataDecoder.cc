@@ -8,6 +8,7 @@
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
 #include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitv2.h>
 
 #include <ffarawobjects/Gl1RawHit.h>
@@ -93,6 +94,10 @@ int InttCombinedRawDataDecoder::InitRun(PHCompositeNode* topNode)
     PHIODataNode<PHObject>* new_node = new PHIODataNode<PHObject>(trkr_hit_set_container, "TRKR_HITSET", "PHObject");
     trkr_node->addNode(new_node);
   }
+  if (m_flatHitSets)
+  {
+    trkr_hit_set_container->setFlatHitSets(true);
+  }
 
   // Check if INTT event header already exists
   if (m_writeInttEventHeader)
@@ -285,7 +290,8 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
       }
     hit_set_key = InttDefs::genHitSetKey(ofl.layer, ofl.ladder_z, ofl.ladder_phi, time_bucket);
     hit_set_container_itr = trkr_hit_set_container->findOrAddHitSet(hit_set_key);
-    hit = hit_set_container_itr->second->getHit(hit_key);
+    auto flat = dynamic_cast<TrkrHitSetv2*>(hit_set_container_itr->second);
+    const bool exists = flat ? flat->hasHit(hit_key) : (hit_set_container_itr->second->getHit(hit_key) != nullptr);
 
     if(m_outputBcoDiff)
       {
@@ -308,7 +314,7 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
 		  << std::endl;
       }
 
-    if (hit)
+    if (exists)
     {
       continue;
     }
@@ -317,6 +323,11 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
     // dac conversion
     int dac = m_dacmap.GetDAC(raw, adc);
 
+    if (flat)
+    {
+      flat->setAdc(hit_key, dac);
+      continue;
+    }
     hit = new TrkrHitv2;
     //--hit->setAdc(adc);
     hit->setAdc(dac);
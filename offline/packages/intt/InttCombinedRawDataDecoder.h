@@ -50,6 +50,9 @@ class InttCombinedRawDataDecoder : public SubsysReco
   void set_outputBcoDiff(bool flag) {m_outputBcoDiff = flag; }
   void set_triggeredMode(bool flag) {m_triggeredMode = flag; }
 
+  //! store the hits in TrkrHitSetv2 (flat hitkey, adc vectors) instead of one TrkrHitv2 per hit
+  void useFlatHitSets(bool b = true) { m_flatHitSets = b; }
+
  private:
   InttEventInfo* intt_event_header = nullptr;
   std::string m_InttRawNodeName = "INTTRAWHIT";
@@ -67,6 +70,7 @@ class InttCombinedRawDataDecoder : public SubsysReco
   int m_inttFeeOffset = 23;   //23 is the offset for INTT in streaming mode
   bool m_outputBcoDiff = false;
   bool m_triggeredMode = false;
+  bool m_flatHitSets = false;
 
 };
 
@@ -17,11 +17,14 @@
 #include <Event/Event.h>
 #include <Event/EventTypes.h>
 
+#include <phool/PHThreadPool.h>
+
 #include <TCanvas.h>
 #include <TF1.h>
 #include <TH1.h>
 #include <TH2.h>
 #include <TGraphErrors.h>
+#include <TROOT.h>
 #include <TSystem.h>
 #include <TDirectory.h>
 
@@ -147,7 +150,10 @@ int MbdEvent::InitRun()
   // Init parameters of the signal processing
   for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
   {
+    // create the ROOT objects here, FillSignals() may run on the worker threads
+    _mbdsig[ifeech].Init();
     _mbdsig[ifeech].SetCalib(_mbdcal);
+    _mbdsig[ifeech].SetFastFit(_fastfit);
 
     // Do evt-by-evt pedestal using sample range below
     if ( _calpass==1 || _is_online || _no_sampmax>0 )
@@ -173,6 +179,25 @@ int MbdEvent::InitRun()
     }
   }
 
+  // Channels are processed in parallel only with the fast fitter, since the ROOT fits are not thread safe
+  if ( _fastfit && m_num_threads != 1 )
+  {
+    if ( m_threadpool == nullptr )
+    {
+      ROOT::EnableThreadSafety();
+      m_threadpool = std::make_unique<PHThreadPool>(m_num_threads);
+      std::cout << PHWHERE << " processing channels with " << m_threadpool->size() << " threads" << std::endl;
+    }
+  }
+  else
+  {
+    m_threadpool.reset();
+    if ( !_fastfit && m_num_threads != 1 )
+    {
+      std::cout << PHWHERE << " ROOT fits run in one thread, use SetFastFit(1) to process channels in parallel" << std::endl;
+    }
+  }
+
   if ( _calpass > 0 )
   {
     _caldir = "results/"; _caldir += _runnum; _caldir += "/";
@@ -419,14 +444,10 @@ int MbdEvent::SetRawData(CaloPacketContainer *mbdraw, MbdPmtContainer *bbcpmts,
           }
           */
         }
-
-        _mbdsig[feech].SetNSamples( _nsamples );
-        _mbdsig[feech].SetXY(m_samp[feech], m_adc[feech]);
-
-        //std::cout << "feech " << feech << std::endl;
-        //_mbdsig[feech].Print();
       }
 
+      FillSignals(ipkt * NCHPERPKT, NCHPERPKT);
+
       //delete dstp[ipkt];
       //dstp[ipkt] = nullptr;
     }
@@ -522,12 +543,10 @@ int MbdEvent::SetRawData(Event *event, MbdPmtContainer *bbcpmts)
           }
           */
         }
-
-        _mbdsig[feech].SetNSamples( _nsamples );
-        _mbdsig[feech].SetXY(m_samp[feech], m_adc[feech]);
-        //_mbdsig[feech].Print();
       }
 
+      FillSignals(ipkt * NCHPERPKT, NCHPERPKT);
+
       delete p[ipkt];
       p[ipkt] = nullptr;
     }
@@ -547,6 +566,29 @@ int MbdEvent::SetRawData(Event *event, MbdPmtContainer *bbcpmts)
   return status;
 }
 
+void MbdEvent::FillSignals(const int first_feech, const int nfeech)
+{
+  auto fill_signal = [this, first_feech](const std::size_t ich, const unsigned int /*worker*/)
+  {
+    int feech = first_feech + static_cast<int>(ich);
+    _mbdsig[feech].SetNSamples( _nsamples );
+    _mbdsig[feech].SetXY(m_samp[feech], m_adc[feech]);
+    //_mbdsig[feech].Print();
+  };
+
+  if ( m_threadpool )
+  {
+    m_threadpool->parallel_for(nfeech, fill_signal);
+  }
+  else
+  {
+    for (int ich = 0; ich < nfeech; ich++)
+    {
+      fill_signal(ich, 0);
+    }
+  }
+}
+
 int MbdEvent::ProcessRawPackets(MbdPmtContainer *bbcpmts)
 {
   // Do a quick sanity check that all fem counters agree
@@ -584,8 +626,11 @@ int MbdEvent::ProcessRawPackets(MbdPmtContainer *bbcpmts)
   std::array<Double_t,MbdDefs::MBD_N_FEECH> tdc{0.};
   tdc.fill( 0. );
 
-  for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
+  // Pulse processing of each channel only uses its own signal, so channels can be processed in parallel.
+  // Each pmt has one time and one charge channel, so tdc, m_pmttq and m_ampl are written once.
+  auto process_signal = [this, &tdc](const std::size_t ich, const unsigned int /*worker*/)
   {
+    int ifeech = static_cast<int>(ich);
     int pmtch = _mbdgeom->get_pmt(ifeech);
     int type = _mbdgeom->get_type(ifeech);  // 0 = T-channel, 1 = Q-channel
 
@@ -593,7 +638,51 @@ int MbdEvent::ProcessRawPackets(MbdPmtContainer *bbcpmts)
     if (type == 0)
     {
       tdc[pmtch] = _mbdsig[ifeech].MBDTDC(_mbdcal->get_sampmax(ifeech));
+    }
+    else if ( type == 1 )
+    {
+      // Use dCFD method to seed time in charge channels (or as primary if not fitting template).
+      // The spline amplitude is replaced by the template fit, so the fast fitter skips it
+      // std::cout << "getspline " << ifeech << std::endl;
+      if ( !(do_templatefit && _fastfit) )
+      {
+        _mbdsig[ifeech].GetSplineAmpl();
+      }
+      Double_t threshold = 0.5;
+      m_pmttq[pmtch] = _mbdsig[ifeech].dCFD(threshold);
+      m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in adc units
+      if (do_templatefit)
+      {
+        //std::cout << "fittemplate" << std::endl;
+        _mbdsig[ifeech].FitTemplate( _mbdcal->get_sampmax(ifeech) );
+
+        m_pmttq[pmtch] = _mbdsig[ifeech].GetTime(); // in units of sample number
+        m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in units of adc
+      }
+    }
+  };
 
+  if ( m_threadpool )
+  {
+    m_threadpool->parallel_for(MbdDefs::BBC_N_FEECH, process_signal);
+  }
+  else
+  {
+    for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
+    {
+      process_signal(ifeech, 0);
+    }
+  }
+
+  // calibrations, in channel order since charge channels use the time of the time channels
+  for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
+  {
+    int pmtch = _mbdgeom->get_pmt(ifeech);
+    int type = _mbdgeom->get_type(ifeech);  // 0 = T-channel, 1 = Q-channel
+
+    // time channel
+    if (type == 0)
+    {
       if ( tdc[pmtch] < 40. || std::isnan(tdc[pmtch]) || fabs(_mbdcal->get_tt0(pmtch))>100. )
       {
         m_pmttt[pmtch] = std::numeric_limits<Float_t>::quiet_NaN();  // no hit
@@ -610,24 +699,9 @@ int MbdEvent::ProcessRawPackets(MbdPmtContainer *bbcpmts)
     //else if ( type == 1 && !std::isnan(m_pmttt[pmtch]) ) // process charge channels which have good time hit
     else if ( type == 1 ) // process charge channels which have good time hit
     {
-
-      // Use dCFD method to seed time in charge channels (or as primary if not fitting template)
-      // std::cout << "getspline " << ifeech << std::endl;
-      _mbdsig[ifeech].GetSplineAmpl();
-      Double_t threshold = 0.5;
-      m_pmttq[pmtch] = _mbdsig[ifeech].dCFD(threshold);
-      m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in adc units
-      if (do_templatefit)
+      if ( do_templatefit && _verbose )
       {
-        //std::cout << "fittemplate" << std::endl;
-        _mbdsig[ifeech].FitTemplate( _mbdcal->get_sampmax(ifeech) );
-
-        if ( _verbose )
-        {
-          std::cout << "tt " << ifeech << " " << pmtch << " " << m_pmttt[pmtch] << std::endl;
-        }
-        m_pmttq[pmtch] = _mbdsig[ifeech].GetTime(); // in units of sample number
-        m_ampl[ifeech] = _mbdsig[ifeech].GetAmpl(); // in units of adc
+        std::cout << "tt " << ifeech << " " << pmtch << " " << m_pmttt[pmtch] << std::endl;
       }
 
       // calpass 2, uncal_mbd. template fit. make sure qgain = 1, tq_t0 = 0
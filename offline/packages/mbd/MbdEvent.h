@@ -11,9 +11,11 @@
 #include <fun4all/Fun4AllBase.h>
 #endif
 
+#include <memory>
 #include <vector>
 
 class PHCompositeNode;
+class PHThreadPool;
 class Event;
 class MbdPmtContainer;
 class MbdOut;
@@ -44,6 +46,13 @@ class MbdEvent
 
   void SetSim(const int s) { _simflag = s; }
 
+  /** Fit pedestals and templates with the fast fitter, instead of the ROOT TF1 fits (kept for validation) */
+  void SetFastFit(const int f) { _fastfit = f; }
+
+  /** Number of threads for the channel by channel pulse processing, 0 uses all hardware threads.
+   *  Only used with the fast fitter, the ROOT fits always run in one thread */
+  void SetNumThreads(const unsigned int n) { m_num_threads = n; }
+
   float get_bbcz() { return m_bbcz; }
   float get_bbczerr() { return m_bbczerr; }
   float get_bbct0() { return m_bbct0; }
@@ -124,6 +133,13 @@ class MbdEvent
   Float_t m_pmttq[MbdDefs::MBD_N_PMT]{};  // time in each arm
 
   int do_templatefit{1};
+  int _fastfit{0};
+
+  // copy the waveforms of feech [first_feech, first_feech+nfeech) into their MbdSig
+  void FillSignals(const int first_feech, const int nfeech);
+
+  unsigned int m_num_threads{1};
+  std::unique_ptr<PHThreadPool> m_threadpool{nullptr};
 
   // output data
   Short_t m_bbcn[2]{};                                            // num hits for each arm (north and south)
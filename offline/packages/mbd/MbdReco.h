@@ -33,12 +33,19 @@ class MbdReco : public SubsysReco
   void SetCalPass(const int calpass) { _calpass = calpass; }
   void SetMbdTrigOnly(const int m) { _mbdonly = m; }
 
+  // fast pulse fitter, and number of threads for the channel processing (0 = all hardware threads).
+  // Channels are only processed in parallel with the fast fitter
+  void SetFastFit(const int f) { _fastfit = f; }
+  void SetNumThreads(const unsigned int n) { _nthreads = n; }
+
  private:
   int createNodes(PHCompositeNode *topNode);
   int getNodes(PHCompositeNode *topNode);
   int _simflag{0};
   int _calpass{0};
   int _mbdonly{0};  // only use mbd triggers
+  int _fastfit{0};  // use fast fitter instead of ROOT fits
+  unsigned int _nthreads{1};
 
   float m_tres = 0.05;
   std::unique_ptr<TF1> m_gaussian = nullptr;
@@ -13,6 +13,9 @@
 #include <TSpline.h>
 #include <TTree.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <limits>
@@ -28,6 +31,11 @@ MbdSig::MbdSig(const int chnum, const int nsamp)
 
 void MbdSig::Init()
 {
+  if (hRawPulse != nullptr)
+  {
+    return;
+  }
+
   TString name;
 
   name = "hrawpulse";
@@ -111,6 +119,33 @@ void MbdSig::SetTemplateSize(const Int_t nptsx, const Int_t nptsy, const Double_
   h2Template = new THnSparseF(name,name,2,nbins,lowrange,highrange);
   */
   // h2Template->cd( gDirectory );
+
+  FillTemplateTable();
+}
+
+void MbdSig::FillTemplateTable()
+{
+  // Same linear interpolation as TemplateFcn, with the slopes computed once
+  template_table.assign(template_npointsx, TemplatePoint());
+  if (template_npointsx < 2)
+  {
+    return;
+  }
+
+  Double_t step = (template_endtime - template_begintime) / (template_npointsx - 1);
+  for (int i = 0; i < template_npointsx; i++)
+  {
+    if (i >= (int) template_y.size() || i >= (int) template_yrms.size())
+    {
+      break;
+    }
+    template_table[i].y = template_y[i];
+    template_table[i].bad = (template_yrms[i] >= 1.0);
+    if (i + 1 < template_npointsx && i + 1 < (int) template_y.size())
+    {
+      template_table[i].dydx = (template_y[i + 1] - template_y[i]) / step;
+    }
+  }
 }
 
 void MbdSig::SetMinMaxFitTime(const Double_t mintime, const Double_t maxtime)
@@ -441,7 +476,7 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
 
   if (minsamp < 0)
   {
-    static int counter = 0;
+    static std::atomic<int> counter{0};
     if ( counter<1 )
     {
       std::cout << PHWHERE << " ped minsamp " << minsamp << "\t" << max << "\t" << presample << "\t" << nsamps << std::endl;
@@ -451,7 +486,7 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
   }
   if (maxsamp < 0)
   {
-    static int counter = 0;
+    static std::atomic<int> counter{0};
     if ( counter<1 )
     {
       std::cout << PHWHERE << " ped maxsamp " << maxsamp << "\t" << max << "\t" << presample << std::endl;
@@ -474,42 +509,49 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
     rms = 5.0;
   }
 
-  ped_fcn->SetRange(minsamp-0.1,maxsamp+0.1);
-  ped_fcn->SetParameter(0,1500.);
-
   if ( gRawPulse->GetN()==0 )//chiu
   {
     std::cout << PHWHERE << " gRawPulse 0" << std::endl;
   }
 
-  if ( gRawPulse->GetN()==0 )//chiu
+  double chi2 = 0.;
+  double ndf = 0.;
+  double pedfit = 0.;
+  if ( _fastfit )
   {
-    std::cout << PHWHERE << " gRawPulse 0" << std::endl;
+    FitPed0Fast( minsamp, maxsamp, pedfit, chi2, ndf );
   }
-  if ( _verbose )
+  else
   {
-    gRawPulse->Fit( ped_fcn, "RQ" );
+    ped_fcn->SetRange(minsamp-0.1,maxsamp+0.1);
+    ped_fcn->SetParameter(0,1500.);
 
-    double chi2ndf = ped_fcn->GetChisquare()/ped_fcn->GetNDF();
-    if ( chi2ndf > 4.0 )
+    if ( _verbose )
     {
-      gRawPulse->Draw("ap");
-      ped_fcn->Draw("same");
-      PadUpdate();
+      gRawPulse->Fit( ped_fcn, "RQ" );
+
+      double chi2ndf = ped_fcn->GetChisquare()/ped_fcn->GetNDF();
+      if ( chi2ndf > 4.0 )
+      {
+        gRawPulse->Draw("ap");
+        ped_fcn->Draw("same");
+        PadUpdate();
+      }
+    }
+    else
+    {
+      //std::cout << PHWHERE << std::endl;
+      gRawPulse->Fit( ped_fcn, "RNQ" );
     }
-  }
-  else
-  {
-    //std::cout << PHWHERE << std::endl;
-    gRawPulse->Fit( ped_fcn, "RNQ" );
-  }
 
-  double chi2 = ped_fcn->GetChisquare();
-  double ndf = ped_fcn->GetNDF();
+    chi2 = ped_fcn->GetChisquare();
+    ndf = ped_fcn->GetNDF();
+    pedfit = ped_fcn->GetParameter(0);
+  }
 
   if ( chi2/ndf < 4.0 )
   {
-    mean = ped_fcn->GetParameter(0);
+    mean = pedfit;
 
     Double_t x, y;
 
@@ -576,6 +618,59 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
   _verbose = 0;
 }
 
+// Fit of a constant to the raw samples in [minsamp,maxsamp].
+// The chi2 minimum is the weighted mean, so no minimization is needed
+void MbdSig::FitPed0Fast(const Int_t minsamp, const Int_t maxsamp, Double_t &ped, Double_t &chi2, Double_t &ndf)
+{
+  Int_t n = gRawPulse->GetN();
+  Double_t* x = gRawPulse->GetX();
+  Double_t* y = gRawPulse->GetY();
+  Double_t* ey = gRawPulse->GetEY();
+
+  const Double_t xmin = minsamp - 0.1;
+  const Double_t xmax = maxsamp + 0.1;
+
+  auto weight = [ey](const int isamp)
+  { return (ey != nullptr && ey[isamp] > 0.) ? 1.0 / (ey[isamp] * ey[isamp]) : 1.0; };
+
+  Double_t sumw = 0.;
+  Double_t sumwy = 0.;
+  int npts = 0;
+  for (int isamp = 0; isamp < n; isamp++)
+  {
+    if (x[isamp] < xmin || x[isamp] > xmax)
+    {
+      continue;
+    }
+    Double_t w = weight(isamp);
+    sumw += w;
+    sumwy += w * y[isamp];
+    npts++;
+  }
+
+  if (npts == 0)
+  {
+    // failed fit, same as ROOT: chi2/ndf is not a number
+    ped = 0.;
+    chi2 = 0.;
+    ndf = 0.;
+    return;
+  }
+
+  ped = sumwy / sumw;
+  chi2 = 0.;
+  for (int isamp = 0; isamp < n; isamp++)
+  {
+    if (x[isamp] < xmin || x[isamp] > xmax)
+    {
+      continue;
+    }
+    Double_t dy = y[isamp] - ped;
+    chi2 += weight(isamp) * dy * dy;
+  }
+  ndf = npts - 1;
+}
+
 Double_t MbdSig::LeadingEdge(const Double_t threshold)
 {
   // Find first point above threshold
@@ -1029,6 +1124,27 @@ int MbdSig::FitTemplate( const Int_t sampmax )
     return 1;
   }
 
+  if ( _fastfit )
+  {
+    // same two fits as below, with the fast fitter
+    FitTemplateFast( 0., (nsaturated<=3 ? _nsamples : _nsamples-3.5), x_at_max, f_ampl, f_time );
+    if ( f_time<0. || f_time>_nsamples )
+    {
+      f_time = _nsamples*0.5;  // bad fit last time
+    }
+
+    // refit with new range to exclude after-pulses
+    FitTemplateFast( 0., (nsaturated<=3 ? f_time+4.0 : f_time+4.8), f_time, f_ampl, f_time );
+
+    if (_verbose > 0)
+    {
+      cout << "FitTemplate fast " << _ch << "\t" << f_ampl << "\t" << f_time << endl;
+    }
+
+    _verbose = 0;
+    return 1;
+  }
+
   template_fcn->SetParameters(ymax, x_at_max);
   // template_fcn->SetParLimits(1, fit_min_time, fit_max_time);
   // template_fcn->SetParLimits(1, 3, 15);
@@ -1132,6 +1248,153 @@ int MbdSig::FitTemplate( const Int_t sampmax )
   return 1;
 }
 
+// chi2 of the template fit at time t, using the points of gSubPulse in [xmin,xmax].
+// Points are rejected as in TemplateFcn. The amplitude is linear, so it is solved for directly.
+// Returns infinity if there are not enough points to fit
+Double_t MbdSig::TemplateChi2(const Double_t t, const Double_t xmin, const Double_t xmax, Double_t &ampl)
+{
+  Int_t n = gSubPulse->GetN();
+  Double_t* x = gSubPulse->GetX();
+  Double_t* y = gSubPulse->GetY();
+  Int_t nraw = gRawPulse->GetN();
+  Double_t* rawy = gRawPulse->GetY();
+
+  const Double_t step = (template_endtime - template_begintime) / (template_npointsx - 1);
+  const int ntemplate = template_table.size();
+
+  Double_t sumys = 0.;
+  Double_t sumss = 0.;
+  Double_t sumyy = 0.;
+  int npts = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if (x[i] < xmin || x[i] > xmax)
+    {
+      continue;
+    }
+
+    // outside of the template
+    Double_t xx = x[i] - t;
+    if (xx < template_begintime || xx > template_endtime || std::isnan(xx))
+    {
+      continue;
+    }
+
+    Double_t index = (xx - template_begintime) / step;
+    int ilow = static_cast<int>(std::floor(index));
+    int ihigh = static_cast<int>(std::ceil(index));
+    ilow = std::max(ilow, 0);
+    ihigh = std::min(ihigh, ntemplate - 1);
+    if (ilow > ihigh)
+    {
+      continue;
+    }
+
+    // very bad rms in shape
+    if (template_table[ilow].bad || template_table[ihigh].bad)
+    {
+      continue;
+    }
+
+    // ADC saturates
+    int samp_point = static_cast<int>(x[i]);
+    if (samp_point >= 0 && samp_point < nraw && rawy[samp_point] > 16370)
+    {
+      continue;
+    }
+
+    Double_t s = template_table[ilow].y;
+    if (ilow != ihigh)
+    {
+      s += template_table[ilow].dydx * (xx - (template_begintime + ilow * step));
+    }
+
+    sumys += y[i] * s;
+    sumss += s * s;
+    sumyy += y[i] * y[i];
+    npts++;
+  }
+
+  if (npts < 2 || sumss <= 0.)
+  {
+    ampl = 0.;
+    return std::numeric_limits<Double_t>::infinity();
+  }
+
+  ampl = sumys / sumss;
+  return sumyy - ampl * sumys;
+}
+
+// Template fit without TF1: the chi2 is minimized over the time with a scan around t0,
+// refined by a golden section search around the best scan point
+void MbdSig::FitTemplateFast(const Double_t xmin, const Double_t xmax, const Double_t t0, Double_t &ampl, Double_t &time)
+{
+  const Double_t scan_window = 2.0;  // in samples
+  const Double_t scan_step = 0.05;
+  const Double_t tolerance = 1e-4;
+  const int nscan = static_cast<int>(std::lround(2 * scan_window / scan_step));
+
+  Double_t best_t = t0;
+  Double_t best_ampl = 0.;
+  Double_t best_chi2 = std::numeric_limits<Double_t>::infinity();
+
+  auto try_time = [&](const Double_t t)
+  {
+    Double_t a = 0.;
+    Double_t chi2 = TemplateChi2(t, xmin, xmax, a);
+    if (chi2 < best_chi2)
+    {
+      best_chi2 = chi2;
+      best_t = t;
+      best_ampl = a;
+    }
+    return chi2;
+  };
+
+  for (int iscan = 0; iscan <= nscan; iscan++)
+  {
+    try_time(t0 - scan_window + iscan * scan_step);
+  }
+
+  if (std::isinf(best_chi2))
+  {
+    // nothing to fit, keep the starting values
+    ampl = 0.;
+    time = t0;
+    return;
+  }
+
+  const Double_t invphi = (std::sqrt(5.0) - 1.0) / 2.0;
+  Double_t a = best_t - scan_step;
+  Double_t b = best_t + scan_step;
+  Double_t c = b - invphi * (b - a);
+  Double_t d = a + invphi * (b - a);
+  Double_t fc = try_time(c);
+  Double_t fd = try_time(d);
+  while (b - a > tolerance)
+  {
+    if (fc < fd)
+    {
+      b = d;
+      d = c;
+      fd = fc;
+      c = b - invphi * (b - a);
+      fc = try_time(c);
+    }
+    else
+    {
+      a = c;
+      c = d;
+      fc = fd;
+      d = a + invphi * (b - a);
+      fd = try_time(d);
+    }
+  }
+
+  ampl = best_ampl;
+  time = best_t;
+}
+
 int MbdSig::SetTemplate(const std::vector<float>& shape, const std::vector<float>& sherr)
 {
   template_y = shape;
@@ -1172,5 +1435,7 @@ int MbdSig::SetTemplate(const std::vector<float>& shape, const std::vector<float
     }
   }
 
+  FillTemplateTable();
+
   return 1;
 }
@@ -34,10 +34,19 @@ class MbdSig
 
   void SetNSamples( const int s ) { _nsamples = s; }
   void SetY(const Float_t *y, const int invert = 1);
+  /** Create the histograms, graphs and fit functions. Called on the first SetY/SetXY
+      if not done before, has to be called up front if channels are filled in parallel */
+  void Init();
+
   void SetXY(const Float_t *x, const Float_t *y, const int invert = 1);
 
   void SetCalib(MbdCalib *mcal);
 
+  /** Use the fast pedestal and template fits on the sample arrays, instead of the ROOT TF1 fits.
+   *  The ROOT fits are kept for validation, and must run in a single thread. */
+  void SetFastFit(const int f) { _fastfit = f; }
+  int GetFastFit() const { return _fastfit; }
+
   TH1 *GetHist() { return hpulse; }
   TGraphErrors *GetGraph() { return gpulse; }
   Double_t GetAmpl() { return f_ampl; }
@@ -122,11 +131,23 @@ class MbdSig
   void Verbose(const int v) { _verbose = v; }
 
  private:
-  void Init();
+
+  /** Fast fit of the pedestal constant, same as fitting ped_fcn to gRawPulse between minsamp and maxsamp */
+  void FitPed0Fast(const Int_t minsamp, const Int_t maxsamp, Double_t &ped, Double_t &chi2, Double_t &ndf);
+
+  /** Fast template fit of gSubPulse in [xmin,xmax], starting from time t0 */
+  void FitTemplateFast(const Double_t xmin, const Double_t xmax, const Double_t t0, Double_t &ampl, Double_t &time);
+
+  /** chi2 of the template fit for a given time, minimized over the amplitude */
+  Double_t TemplateChi2(const Double_t t, const Double_t xmin, const Double_t xmax, Double_t &ampl);
+
+  /** Precompute the template interpolation table for the fast fit */
+  void FillTemplateTable();
 
   int _ch;
   int _nsamples;
   int _status{0};
+  int _fastfit{0};
 
   int _evt_counter{0};
   MbdCalib *_mbdcal{nullptr};
@@ -185,6 +206,15 @@ class MbdSig
   std::vector<float> template_y;
   std::vector<float> template_yrms;
   TF1 *template_fcn{nullptr};
+
+  /** template point for the fast fit: value, slope to the next point, and whether the shape rms is too large */
+  struct TemplatePoint
+  {
+    Double_t y{0.};
+    Double_t dydx{0.};
+    bool bad{true};
+  };
+  std::vector<TemplatePoint> template_table;  //!
   Double_t fit_min_time{};  //! min time for fit, in original units of waveform data
   Double_t fit_max_time{};  //! max time for fit, in original units of waveform data
 
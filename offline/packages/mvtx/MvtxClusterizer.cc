@@ -20,6 +20,7 @@
 #include <trackbase/TrkrDefs.h>  // for hitkey, getLayer
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitv2.h>
 
 #include <trackbase/RawHit.h>
@@ -42,23 +43,14 @@
 #include <TMatrixTUtils.h>  // for TMatrixTRow
 #include <TVector3.h>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#include <boost/graph/adjacency_list.hpp>
-#pragma GCC diagnostic pop
-
-#include <boost/graph/connected_components.hpp>
-
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>  // for exit
 #include <iostream>
-#include <map>  // for multimap<>::iterator
-#include <set>  // for set, set<>::iterator
 #include <string>
 #include <vector>  // for vector
 
-using namespace boost;
 using namespace std;
 
 namespace
@@ -72,64 +64,6 @@ namespace
   }
 }  // namespace
 
-bool MvtxClusterizer::are_adjacent(
-    const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs,
-    const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs)
-{
-  if (GetZClustering())
-  {
-    // column is first, row is second
-    if (fabs(MvtxDefs::getCol(lhs.first) - MvtxDefs::getCol(rhs.first)) <= 1)
-    {
-      if (fabs(MvtxDefs::getRow(lhs.first) - MvtxDefs::getRow(rhs.first)) <=
-          1)
-      {
-        return true;
-      }
-    }
-  }
-  else
-  {
-    if (fabs(MvtxDefs::getCol(lhs.first) - MvtxDefs::getCol(rhs.first)) == 0)
-    {
-      if (fabs(MvtxDefs::getRow(lhs.first) - MvtxDefs::getRow(rhs.first)) <=
-          1)
-      {
-        return true;
-      }
-    }
-  }
-
-  return false;
-}
-
-bool MvtxClusterizer::are_adjacent(RawHit *lhs, RawHit *rhs)
-{
-  if (GetZClustering())
-  {
-    // column is first, row is second
-    if (fabs(lhs->getPhiBin() - rhs->getPhiBin()) <= 1)  // col
-    {
-      if (fabs(lhs->getTBin() - rhs->getTBin()) <= 1)  // Row
-      {
-        return true;
-      }
-    }
-  }
-  else
-  {
-    if (fabs(lhs->getPhiBin() - rhs->getPhiBin()) == 0)
-    {
-      if (fabs(lhs->getTBin() - rhs->getTBin()) <= 1)
-      {
-        return true;
-      }
-    }
-  }
-
-  return false;
-}
-
 MvtxClusterizer::MvtxClusterizer(const string &name)
   : SubsysReco(name)
   , m_hits(nullptr)
@@ -348,14 +282,27 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       hitset->identify();
     }
 
-    // fill a vector of hits to make things easier
-    std::vector<std::pair<TrkrDefs::hitkey, TrkrHit *> > hitvec;
-
-    TrkrHitSet::ConstRange hitrangei = hitset->getHits();
-    for (TrkrHitSet::ConstIterator hitr = hitrangei.first;
-         hitr != hitrangei.second; ++hitr)
+    // fill a vector of (hitkey, adc) to make things easier
+    std::vector<std::pair<TrkrDefs::hitkey, unsigned int>> hitvec;
+    if (auto flat = dynamic_cast<TrkrHitSetv2 *>(hitset))
+    {
+      // flat hitsets, no TrkrHit involved
+      const auto &hitkeys = flat->getHitKeys();
+      const auto &adcs = flat->getAdcs();
+      hitvec.reserve(hitkeys.size());
+      for (unsigned int i = 0; i < hitkeys.size(); ++i)
+      {
+        hitvec.emplace_back(hitkeys[i], adcs[i]);
+      }
+    }
+    else
     {
-      hitvec.emplace_back(hitr->first, hitr->second);
+      TrkrHitSet::ConstRange hitrangei = hitset->getHits();
+      for (TrkrHitSet::ConstIterator hitr = hitrangei.first;
+           hitr != hitrangei.second; ++hitr)
+      {
+        hitvec.emplace_back(hitr->first, hitr->second->getAdc());
+      }
     }
     if (Verbosity() > 2)
     {
@@ -375,65 +322,46 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
     }
 
     // do the clustering
-    using Graph = adjacency_list<vecS, vecS, undirectedS>;
-    Graph G;
-
-    // loop over hits in this chip
-    for (unsigned int i = 0; i < hitvec.size(); i++)
+    // connected pixels share a column (or are in adjacent columns with z clustering), and are at most one row apart
+    m_pixels.clear();
+    for (const auto &hit : hitvec)
     {
-      for (unsigned int j = 0; j < hitvec.size(); j++)
-      {
-        if (are_adjacent(hitvec[i], hitvec[j]))
-        {
-          add_edge(i, j, G);
-        }
-      }
+      m_pixels.push_back({MvtxDefs::getRow(hit.first), MvtxDefs::getCol(hit.first)});
     }
+    const unsigned int nclusters = m_labeler.label(m_pixels, 1, GetZClustering() ? 1 : 0);
 
-    // Find the connections between the vertices of the graph (vertices are the
-    // rawhits,
-    // connections are made when they are adjacent to one another)
-    vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    connected_components(G, &component[0]);
-
-    // Loop over the components(hits) compiling a list of the
-    // unique connected groups (ie. clusters).
-    set<int> cluster_ids;  // unique components
-    // multimap<int, pixel> clusters;
-    multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit *> > clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
-    {
-      cluster_ids.insert(component[i]);
-      clusters.insert(make_pair(component[i], hitvec[i]));
-    }
     int total_clusters = 0;
-    for (set<int>::iterator clusiter = cluster_ids.begin();
-         clusiter != cluster_ids.end(); ++clusiter)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
-      int clusid = *clusiter;
-      auto clusrange = clusters.equal_range(clusid);
+      std::size_t nhits = 0;
+      const auto indices = m_labeler.hits(clusid, nhits);
+      const auto &bounds = m_labeler.bounds(clusid);
 
       if (Verbosity() > 2)
       {
         cout << "Filling cluster id " << clusid << " of "
-             << std::distance(cluster_ids.begin(), clusiter) << endl;
+             << nclusters << endl;
       }
       ++total_clusters;
       auto ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
 
-      // determine the size of the cluster in phi and z
-      set<int> phibins;
-      set<int> zbins;
-      std::map<int, unsigned int> m_phi,
-          m_z;  // Note, there are no "cut" bins for Svtx Clusters
+      // size of the cluster in phi and z. Rows and columns of a cluster are contiguous
+      const unsigned int nphibins = bounds.nrows();
+      const unsigned int nzbins = bounds.ncols();
+
+      // energy per row and column, indexed from the first row and column of the cluster
+      // Note, there are no "cut" bins for Svtx Clusters
+      std::vector<unsigned int> m_phi;
+      std::vector<unsigned int> m_z;
+      if (mClusHitsVerbose)
+      {
+        m_phi.assign(nphibins, 0);
+        m_z.assign(nzbins, 0);
+      }
 
       // determine the cluster position...
       double locxsum = 0.;
       double loczsum = 0.;
-      const unsigned int nhits =
-          std::distance(clusrange.first, clusrange.second);
 
       double locclusx = NAN;
       double locclusz = NAN;
@@ -447,29 +375,20 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
         exit(1);
       }
 
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second;
-           ++mapiter)
+      for (std::size_t ihit = 0; ihit < nhits; ++ihit)
       {
+        const auto &hit = hitvec[indices[ihit]];
+        const auto &rowcol = m_pixels[indices[ihit]];
+
         // size
-        const auto energy = (mapiter->second).second->getAdc();
-        int col = MvtxDefs::getCol((mapiter->second).first);
-        int row = MvtxDefs::getRow((mapiter->second).first);
-        zbins.insert(col);
-        phibins.insert(row);
+        int col = rowcol.col;
+        int row = rowcol.row;
 
         if (mClusHitsVerbose)
         {
-          auto pnew = m_phi.try_emplace(row, energy);
-          if (!pnew.second)
-          {
-            pnew.first->second += energy;
-          }
-
-          pnew = m_z.try_emplace(col, energy);
-          if (!pnew.second)
-          {
-            pnew.first->second += energy;
-          }
+          const auto energy = hit.second;
+          m_phi[row - bounds.row_min] += energy;
+          m_z[col - bounds.col_min] += energy;
         }
 
         // get local coordinates, in stae reference frame, for hit
@@ -488,27 +407,27 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
         loczsum += local_coords.Z();
         // add the association between this cluster key and this hitkey to the
         // table
-        m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
+        m_clusterhitassoc->addAssoc(ckey, hit.first);
 
-      }  // mapiter
+      }  // ihit
 
       if (mClusHitsVerbose)
       {
         if (Verbosity() > 10)
         {
-          for (auto &hit : m_phi)
+          for (unsigned int i = 0; i < nphibins; ++i)
           {
-            std::cout << " m_phi(" << hit.first << " : " << hit.second << ") "
+            std::cout << " m_phi(" << bounds.row_min + i << " : " << m_phi[i] << ") "
                       << std::endl;
           }
         }
-        for (auto &hit : m_phi)
+        for (unsigned int i = 0; i < nphibins; ++i)
         {
-          mClusHitsVerbose->addPhiHit(hit.first, (float) hit.second);
+          mClusHitsVerbose->addPhiHit(bounds.row_min + i, (float) m_phi[i]);
         }
-        for (auto &hit : m_z)
+        for (unsigned int i = 0; i < nzbins; ++i)
         {
-          mClusHitsVerbose->addZHit(hit.first, (float) hit.second);
+          mClusHitsVerbose->addZHit(bounds.col_min + i, (float) m_z[i]);
         }
         mClusHitsVerbose->push_hits(ckey);
       }
@@ -519,8 +438,8 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
 
       const double pitch = layergeom->get_pixel_x();
       const double length = layergeom->get_pixel_z();
-      const double phisize = phibins.size() * pitch;
-      const double zsize = zbins.size() * length;
+      const double phisize = nphibins * pitch;
+      const double zsize = nzbins * length;
 
       static const double invsqrt12 = 1. / std::sqrt(12);
 
@@ -539,22 +458,22 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       static constexpr std::array<double, 7> scalefactors_phi = {
           {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
 
-      if ((phibins.size() == 1 && zbins.size() == 1) ||
-          (phibins.size() == 2 && zbins.size() == 2))
+      if ((nphibins == 1 && nzbins == 1) ||
+          (nphibins == 2 && nzbins == 2))
       {
         phierror *= scalefactors_phi[0];
       }
-      else if ((phibins.size() == 2 && zbins.size() == 1) ||
-               (phibins.size() == 2 && zbins.size() == 3))
+      else if ((nphibins == 2 && nzbins == 1) ||
+               (nphibins == 2 && nzbins == 3))
       {
         phierror *= scalefactors_phi[1];
       }
-      else if ((phibins.size() == 1 && zbins.size() == 2) ||
-               (phibins.size() == 3 && zbins.size() == 2))
+      else if ((nphibins == 1 && nzbins == 2) ||
+               (nphibins == 3 && nzbins == 2))
       {
         phierror *= scalefactors_phi[2];
       }
-      else if (phibins.size() == 3 && zbins.size() == 3)
+      else if (nphibins == 3 && nzbins == 3)
       {
         phierror *= scalefactors_phi[3];
       }
@@ -569,19 +488,19 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       static constexpr std::array<double, 4> scalefactors_z = {
           {0.47, 0.48, 0.71, 0.55}};
       double zerror = length * invsqrt12;
-      if (zbins.size() == 2 && phibins.size() == 2)
+      if (nzbins == 2 && nphibins == 2)
       {
         zerror *= scalefactors_z[0];
       }
-      else if (zbins.size() == 2 && phibins.size() == 3)
+      else if (nzbins == 2 && nphibins == 3)
       {
         zerror *= scalefactors_z[1];
       }
-      else if (zbins.size() == 3 && phibins.size() == 2)
+      else if (nzbins == 3 && nphibins == 2)
       {
         zerror *= scalefactors_z[2];
       }
-      else if (zbins.size() == 3 && phibins.size() == 3)
+      else if (nzbins == 3 && nphibins == 3)
       {
         zerror *= scalefactors_z[3];
       }
@@ -590,8 +509,8 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       {
         cout << " MvtxClusterizer: cluskey " << ckey << " layer " << layer
              << " rad " << layergeom->get_radius() << " phibins "
-             << phibins.size() << " pitch " << pitch << " phisize " << phisize
-             << " zbins " << zbins.size() << " length " << length << " zsize "
+             << nphibins << " pitch " << pitch << " phisize " << phisize
+             << " zbins " << nzbins << " length " << length << " zsize "
              << zsize << " local x " << locclusx << " local y " << locclusz
              << endl;
       }
@@ -603,8 +522,8 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       clus->setLocalY(locclusz);
       clus->setPhiError(phierror);
       clus->setZError(zerror);
-      clus->setPhiSize(phibins.size());
-      clus->setZSize(zbins.size());
+      clus->setPhiSize(nphibins);
+      clus->setZSize(nzbins);
       // All silicon surfaces have a 1-1 map to hitsetkey.
       // So set subsurface key to 0
       clus->setSubSurfKey(0);
@@ -614,7 +533,7 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
         clus->identify();
       }
 
-      if (zbins.size() <= 127)
+      if (nzbins <= 127)
       {
         m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
       }
@@ -689,66 +608,37 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
     }
 
     // do the clustering
-    using Graph = adjacency_list<vecS, vecS, undirectedS>;
-    Graph G;
-
-    // loop over hits in this chip
-    for (unsigned int i = 0; i < hitvec.size(); i++)
+    // connected pixels share a column (or are in adjacent columns with z clustering), and are at most one row apart
+    m_pixels.clear();
+    for (const auto &hit : hitvec)
     {
-      for (unsigned int j = 0; j < hitvec.size(); j++)
-      {
-        if (are_adjacent(hitvec[i], hitvec[j]))
-        {
-          add_edge(i, j, G);
-        }
-      }
+      m_pixels.push_back({static_cast<int>(hit->getTBin()), static_cast<int>(hit->getPhiBin())});
     }
+    const unsigned int nclusters = m_labeler.label(m_pixels, 1, GetZClustering() ? 1 : 0);
 
-    // Find the connections between the vertices of the graph (vertices are the
-    // rawhits,
-    // connections are made when they are adjacent to one another)
-    vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    connected_components(G, &component[0]);
-
-    // Loop over the components(hits) compiling a list of the
-    // unique connected groups (ie. clusters).
-    set<int> cluster_ids;  // unique components
-    // multimap<int, pixel> clusters;
-
-    multimap<int, RawHit *> clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
-    {
-      cluster_ids.insert(component[i]);
-      clusters.insert(make_pair(component[i], hitvec[i]));
-    }
-    //    cout << "found cluster #: "<< clusters.size()<< endl;
     // loop over the componenets and make clusters
-    for (set<int>::iterator clusiter = cluster_ids.begin();
-         clusiter != cluster_ids.end(); ++clusiter)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
-      int clusid = *clusiter;
-      auto clusrange = clusters.equal_range(clusid);
+      std::size_t nhits = 0;
+      const auto indices = m_labeler.hits(clusid, nhits);
+      const auto &bounds = m_labeler.bounds(clusid);
 
       if (Verbosity() > 2)
       {
         cout << "Filling cluster id " << clusid << " of "
-             << std::distance(cluster_ids.begin(), clusiter) << endl;
+             << nclusters << endl;
       }
 
       // make the cluster directly in the node tree
       auto ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
 
-      // determine the size of the cluster in phi and z
-      set<int> phibins;
-      set<int> zbins;
+      // size of the cluster in phi and z. Rows and columns of a cluster are contiguous
+      const unsigned int nphibins = bounds.nrows();
+      const unsigned int nzbins = bounds.ncols();
 
       // determine the cluster position...
       double locxsum = 0.;
       double loczsum = 0.;
-      const unsigned int nhits =
-          std::distance(clusrange.first, clusrange.second);
 
       double locclusx = NAN;
       double locclusz = NAN;
@@ -762,14 +652,13 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
         exit(1);
       }
 
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second;
-           ++mapiter)
+      for (std::size_t ihit = 0; ihit < nhits; ++ihit)
       {
+        const auto &rowcol = m_pixels[indices[ihit]];
+
         // size
-        int col = (mapiter->second)->getPhiBin();
-        int row = (mapiter->second)->getTBin();
-        zbins.insert(col);
-        phibins.insert(row);
+        int col = rowcol.col;
+        int row = rowcol.row;
 
         // get local coordinates, in stae reference frame, for hit
         auto local_coords = layergeom->get_local_coords_from_pixel(row, col);
@@ -789,7 +678,7 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
         // table
         //	      m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
 
-      }  // mapiter
+      }  // ihit
 
       // This is the local position
       locclusx = locxsum / nhits;
@@ -799,8 +688,8 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
       //	std::cout << " pitch: " <<  pitch << std::endl;
       const double length = layergeom->get_pixel_z();
       //	std::cout << " length: " << length << std::endl;
-      const double phisize = phibins.size() * pitch;
-      const double zsize = zbins.size() * length;
+      const double phisize = nphibins * pitch;
+      const double zsize = nzbins * length;
 
       static const double invsqrt12 = 1. / std::sqrt(12);
 
@@ -818,22 +707,22 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
 
       static constexpr std::array<double, 7> scalefactors_phi = {
           {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
-      if ((phibins.size() == 1 && zbins.size() == 1) ||
-          (phibins.size() == 2 && zbins.size() == 2))
+      if ((nphibins == 1 && nzbins == 1) ||
+          (nphibins == 2 && nzbins == 2))
       {
         phierror *= scalefactors_phi[0];
       }
-      else if ((phibins.size() == 2 && zbins.size() == 1) ||
-               (phibins.size() == 2 && zbins.size() == 3))
+      else if ((nphibins == 2 && nzbins == 1) ||
+               (nphibins == 2 && nzbins == 3))
       {
         phierror *= scalefactors_phi[1];
       }
-      else if ((phibins.size() == 1 && zbins.size() == 2) ||
-               (phibins.size() == 3 && zbins.size() == 2))
+      else if ((nphibins == 1 && nzbins == 2) ||
+               (nphibins == 3 && nzbins == 2))
       {
         phierror *= scalefactors_phi[2];
       }
-      else if (phibins.size() == 3 && zbins.size() == 3)
+      else if (nphibins == 3 && nzbins == 3)
       {
         phierror *= scalefactors_phi[3];
       }
@@ -849,19 +738,19 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
           {0.47, 0.48, 0.71, 0.55}};
       double zerror = length * invsqrt12;
 
-      if (zbins.size() == 2 && phibins.size() == 2)
+      if (nzbins == 2 && nphibins == 2)
       {
         zerror *= scalefactors_z[0];
       }
-      else if (zbins.size() == 2 && phibins.size() == 3)
+      else if (nzbins == 2 && nphibins == 3)
       {
         zerror *= scalefactors_z[1];
       }
-      else if (zbins.size() == 3 && phibins.size() == 2)
+      else if (nzbins == 3 && nphibins == 2)
       {
         zerror *= scalefactors_z[2];
       }
-      else if (zbins.size() == 3 && phibins.size() == 3)
+      else if (nzbins == 3 && nphibins == 3)
       {
         zerror *= scalefactors_z[3];
       }
@@ -870,8 +759,8 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
       {
         cout << " MvtxClusterizer: cluskey " << ckey << " layer " << layer
              << " rad " << layergeom->get_radius() << " phibins "
-             << phibins.size() << " pitch " << pitch << " phisize " << phisize
-             << " zbins " << zbins.size() << " length " << length << " zsize "
+             << nphibins << " pitch " << pitch << " phisize " << phisize
+             << " zbins " << nzbins << " length " << length << " zsize "
              << zsize << " local x " << locclusx << " local y " << locclusz
              << endl;
       }
@@ -883,8 +772,8 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
       clus->setLocalY(locclusz);
       clus->setPhiError(phierror);
       clus->setZError(zerror);
-      clus->setPhiSize(phibins.size());
-      clus->setZSize(zbins.size());
+      clus->setPhiSize(nphibins);
+      clus->setZSize(nzbins);
       // All silicon surfaces have a 1-1 map to hitsetkey.
       // So set subsurface key to 0
       clus->setSubSurfKey(0);
@@ -894,7 +783,7 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
         clus->identify();
       }
 
-      if (zbins.size() <= 127)
+      if (nzbins <= 127)
       {
         m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
       }
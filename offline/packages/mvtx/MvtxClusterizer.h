@@ -8,11 +8,13 @@
 #define MVTX_MVTXCLUSTERIZER_H
 
 #include <fun4all/SubsysReco.h>
+#include <trackbase/PixelClusterLabeler.h>
 #include <trackbase/TrkrCluster.h>
 #include <trackbase/TrkrDefs.h>
 
 #include <string>  // for string
 #include <utility>
+#include <vector>
 
 class ClusHitsVerbose;
 class PHCompositeNode;
@@ -63,10 +65,7 @@ class MvtxClusterizer : public SubsysReco
   ClusHitsVerbose *mClusHitsVerbose{nullptr};
 
  private:
-  // bool are_adjacent(const pixel lhs, const pixel rhs);
   bool record_ClusHitsVerbose{false};
-  bool are_adjacent(const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs, const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs);
-  bool are_adjacent(RawHit *lhs, RawHit *rhs);
 
   void ClusterMvtx(PHCompositeNode *topNode);
   void ClusterMvtxRaw(PHCompositeNode *topNode);
@@ -79,6 +78,10 @@ class MvtxClusterizer : public SubsysReco
 
   TrkrClusterHitAssoc *m_clusterhitassoc;
 
+  //! connected pixels labeling, and (row, col) of the hits of the current chip
+  PixelClusterLabeler m_labeler;
+  std::vector<PixelClusterLabeler::Hit> m_pixels;
+
   // settings
   bool m_makeZClustering;  // z_clustering_option
   bool do_hit_assoc = true;
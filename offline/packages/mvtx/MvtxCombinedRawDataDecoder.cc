@@ -11,6 +11,7 @@
 #include <trackbase/MvtxEventInfov2.h>
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitv2.h>
 
 #include <fun4all/Fun4AllServer.h>
@@ -82,6 +83,10 @@ int MvtxCombinedRawDataDecoder::InitRun(PHCompositeNode *topNode)
                                               "PHObject");
     trkrNode->addNode(newNode);
   }
+  if (m_flatHitSets)
+  {
+    hit_set_container->setFlatHitSets(true);
+  }
 
   // Check if MVTX event header already exists
   if (m_writeMvtxEventHeader)
@@ -255,8 +260,8 @@ int MvtxCombinedRawDataDecoder::process_event(PHCompositeNode *topNode)
     const TrkrDefs::hitkey hitkey = MvtxDefs::genHitKey(col, row);
 
     // find existing hit, or create
-    auto hit = hitset_it->second->getHit(hitkey);
-    if (hit)
+    auto flat = dynamic_cast<TrkrHitSetv2 *>(hitset_it->second);
+    if (flat ? flat->hasHit(hitkey) : (hitset_it->second->getHit(hitkey) != nullptr))
     {
       if(Verbosity() > 1)
       {
@@ -267,18 +272,17 @@ int MvtxCombinedRawDataDecoder::process_event(PHCompositeNode *topNode)
       continue;
     }
 
-    if(m_doOfflineMasking)
+    if(m_doOfflineMasking && m_hot_pixel_mask->is_masked(mvtx_hit))
+    { // Check if the pixel is masked
+      continue;
+    }
+    if (flat)
     {
-      if (!m_hot_pixel_mask->is_masked(mvtx_hit))
-      { // Check if the pixel is masked
-        hit = new TrkrHitv2;
-        hitset_it->second->addHitSpecificKey(hitkey, hit);
-      }
+      flat->setAdc(hitkey, 0);
     }
     else
     {
-      hit = new TrkrHitv2;
-      hitset_it->second->addHitSpecificKey(hitkey, hit);
+      hitset_it->second->addHitSpecificKey(hitkey, new TrkrHitv2);
     }
 
   }
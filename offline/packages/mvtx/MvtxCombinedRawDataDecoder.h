@@ -59,6 +59,9 @@ class MvtxCombinedRawDataDecoder : public SubsysReco
   void  SetStrobeWidth(const float val) { m_strobeWidth = val; }
   float GetStrobeWidth() { return m_strobeWidth; }
 
+  //! store the hits in TrkrHitSetv2 (flat hitkey, adc vectors) instead of one TrkrHitv2 per hit
+  void useFlatHitSets(bool b = true) { m_flatHitSets = b; }
+
  private:
   void removeDuplicates(std::vector<std::pair<uint64_t, uint32_t>>& v);
 
@@ -82,6 +85,8 @@ class MvtxCombinedRawDataDecoder : public SubsysReco
   MvtxPixelMask * m_hot_pixel_mask{nullptr};
 
   bool m_mvtx_is_triggered{false};
+
+  bool m_flatHitSets{false};
 };
 
 #endif
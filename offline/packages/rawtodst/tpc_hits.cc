@@ -8,6 +8,7 @@
 #include <trackbase/TrkrHitSetContainer.h>
 #include <trackbase/TrkrHitSetContainerv1.h>
 #include <trackbase/TrkrHitSetv1.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitv2.h>
 
 #include <fun4all/Fun4AllHistoManager.h>
@@ -92,6 +93,10 @@ int tpc_hits::InitRun(PHCompositeNode *topNode)
     auto newNode = new PHIODataNode<PHObject>(hitsetcontainer, "TRKR_HITSET", "PHObject");
     trkrnode->addNode(newNode);
   }
+  if (m_flatHitSets)
+  {
+    hitsetcontainer->setFlatHitSets(true);
+  }
   topNode->print();
 
   // we reset the BCO for the new run
@@ -234,13 +239,17 @@ int tpc_hits::process_event(PHCompositeNode *topNode)
             // generate hit key
             TrkrDefs::hitkey hitkey = TpcDefs::genHitKey((unsigned int) pad + sector * pads_per_sector[FEE_R[sector] - 1], (unsigned int) t);
             // find existing hit, or create
-            auto hit = hitsetit->second->getHit(hitkey);
-
-            // create hit, assign adc and insert in hitset
-            if (!hit)
+            if (auto flat = dynamic_cast<TrkrHitSetv2 *>(hitsetit->second))
+            {
+              if (!flat->hasHit(hitkey))
+              {
+                flat->setAdc(hitkey, adc);
+              }
+            }
+            else if (!hitsetit->second->getHit(hitkey))
             {
-              // create a new one
-              hit = new TrkrHitv2();
+              // create hit, assign adc and insert in hitset
+              auto hit = new TrkrHitv2();
               hit->setAdc(adc);
               hitsetit->second->addHitSpecificKey(hitkey, hit);
             }
@@ -53,6 +53,9 @@ class tpc_hits : public SubsysReco
 
   // void Print(const std::string &what = "ALL") const override;
 
+  //! store the hits in TrkrHitSetv2 (flat hitkey, adc vectors) instead of one TrkrHitv2 per hit
+  void useFlatHitSets(bool b = true) { m_flatHitSets = b; }
+
  protected:
   Fun4AllHistoManager *hm = nullptr;
   std::string _filename;
@@ -72,6 +75,8 @@ class tpc_hits : public SubsysReco
   int rollover_value;
   int current_BCOBIN;
 
+  bool m_flatHitSets = false;
+
  private:
   TH2 *_h_hit_XY = nullptr;
 };
@@ -6,11 +6,13 @@
 #include <trackbase/TrkrCluster.h>
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 class ClusHitsVerbosev1;
 class PHCompositeNode;
+class PHThreadPool;
 class TrkrHitSet;
 class TrkrHitSetContainer;
 class RawHitSet;
@@ -30,7 +32,7 @@ class TpcClusterizer : public SubsysReco
 {
  public:
   TpcClusterizer(const std::string &name = "TpcClusterizer");
-  ~TpcClusterizer() override = default;
+  ~TpcClusterizer() override;
 
   int InitRun(PHCompositeNode *topNode) override;
   int process_event(PHCompositeNode *topNode) override;
@@ -42,6 +44,8 @@ class TpcClusterizer : public SubsysReco
   void set_do_hit_association(bool do_assoc) { do_hit_assoc = do_assoc; }
   void set_do_wedge_emulation(bool do_wedge) { do_wedge_emulation = do_wedge; }
   void set_do_sequential(bool do_seq) { do_sequential = do_seq; }
+  //! number of worker threads, 0 uses all hardware threads
+  void set_num_threads(unsigned int n) { m_num_threads = n; }
   void set_do_split(bool split) { do_split = split; }
   void set_fixed_window(int fixed) { do_fixed_window = fixed; }
   void set_pedestal(float val) { pedestal = val; }
@@ -114,6 +118,10 @@ class TpcClusterizer : public SubsysReco
   double m_sampa_tbias = 39.6;  // ns
 
   TrainingHitsContainer *m_training;
+
+  //! worker threads, created once in InitRun
+  std::unique_ptr<PHThreadPool> m_threadpool;
+  unsigned int m_num_threads = 0;
 };
 
 #endif
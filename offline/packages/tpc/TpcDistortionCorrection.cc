@@ -6,10 +6,13 @@
 
 #include "TpcDistortionCorrection.h"
 #include "TpcDistortionCorrectionContainer.h"
+#include "TpcDistortionGrid.h"
 
 #include <TH1.h>
 #include <cmath>
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 
 namespace
@@ -42,6 +45,79 @@ namespace
     return check_boundaries(h->GetXaxis(), r) && check_boundaries(h->GetYaxis(), phi);
   }
 
+  // (dr, dphi, dz) corrections interpolated from the histograms. dphi is in histogram units, z interpolation applied for 2D histograms
+  std::array<double, 3> histogram_corrections(const TpcDistortionCorrectionContainer* dcc, int index, double phi, double r, double z, unsigned int mask)
+  {
+    std::array<double, 3> corrections = {{0, 0, 0}};
+    if (dcc->m_dimensions == 3)
+    {
+      if (dcc->m_hDRint[index] && (mask & TpcDistortionCorrection::COORD_R) && check_boundaries(dcc->m_hDRint[index], phi, r, z))
+      {
+        corrections[0] = dcc->m_hDRint[index]->Interpolate(phi, r, z);
+      }
+      if (dcc->m_hDPint[index] && (mask & TpcDistortionCorrection::COORD_PHI) && check_boundaries(dcc->m_hDPint[index], phi, r, z))
+      {
+        corrections[1] = dcc->m_hDPint[index]->Interpolate(phi, r, z);
+      }
+      if (dcc->m_hDZint[index] && (mask & TpcDistortionCorrection::COORD_Z) && check_boundaries(dcc->m_hDZint[index], phi, r, z))
+      {
+        corrections[2] = dcc->m_hDZint[index]->Interpolate(phi, r, z);
+      }
+    }
+    else if (dcc->m_dimensions == 2)
+    {
+      double zterm = 1.0;
+
+      if (dcc->m_interpolate_z)
+      {
+        zterm = (1. - std::abs(z) / 105.5);
+      }
+      if (dcc->m_hDRint[index] && (mask & TpcDistortionCorrection::COORD_R) && check_boundaries(dcc->m_hDRint[index], phi, r))
+      {
+        corrections[0] = dcc->m_hDRint[index]->Interpolate(phi, r) * zterm;
+      }
+      if (dcc->m_hDPint[index] && (mask & TpcDistortionCorrection::COORD_PHI) && check_boundaries(dcc->m_hDPint[index], phi, r))
+      {
+        corrections[1] = dcc->m_hDPint[index]->Interpolate(phi, r) * zterm;
+      }
+      if (dcc->m_hDZint[index] && (mask & TpcDistortionCorrection::COORD_Z) && check_boundaries(dcc->m_hDZint[index], phi, r))
+      {
+        corrections[2] = dcc->m_hDZint[index]->Interpolate(phi, r) * zterm;
+      }
+    }
+    return corrections;
+  }
+
+  // same as histogram_corrections, from the dense grid
+  std::array<double, 3> grid_corrections(const TpcDistortionCorrectionContainer* dcc, int index, double phi, double r, double z, unsigned int mask)
+  {
+    std::array<double, 3> corrections = {{0, 0, 0}};
+    TpcDistortionGrid::Values values;
+    if (!dcc->m_grid[index]->interpolate(phi, r, z, values))
+    {
+      return corrections;
+    }
+
+    double zterm = 1.0;
+    if (dcc->m_dimensions == 2 && dcc->m_interpolate_z)
+    {
+      zterm = (1. - std::abs(z) / 105.5);
+    }
+    if (mask & TpcDistortionCorrection::COORD_R)
+    {
+      corrections[0] = values[0] * zterm;
+    }
+    if (mask & TpcDistortionCorrection::COORD_PHI)
+    {
+      corrections[1] = values[1] * zterm;
+    }
+    if (mask & TpcDistortionCorrection::COORD_Z)
+    {
+      corrections[2] = values[2] * zterm;
+    }
+    return corrections;
+  }
+
 }  // namespace
 
 //________________________________________________________
@@ -58,11 +134,6 @@ Acts::Vector3 TpcDistortionCorrection::get_corrected_position(const Acts::Vector
   const auto z = source.z();
   const int index = z > 0 ? 1 : 0;
 
-  // apply corrections
-  auto phi_new = phi;
-  auto r_new = r;
-  auto z_new = z;
-
   // if the phi correction hist units are cm, we must divide by r to get the dPhi in radians
   auto divisor = r;
 
@@ -72,65 +143,45 @@ Acts::Vector3 TpcDistortionCorrection::get_corrected_position(const Acts::Vector
     divisor = 1.0;
   }
 
-  //set our default corrections to be zero:
-  //first inherit the same type
-  auto dphi=phi;
-  auto dr=r;
-  auto dz=z;
-  //then set them to zero:
-  dphi=0;
-  dr=0;
-  dz=0;
-  
-  //get the corrections from the histograms
-  if (dcc->m_dimensions == 3)
+  // get the corrections from the dense grid if available, from the histograms otherwise
+  std::array<double, 3> corrections;
+  if (dcc->m_grid[index])
   {
-    if (dcc->m_hDPint[index] && (mask & COORD_PHI) && check_boundaries(dcc->m_hDPint[index], phi, r, z))
-    {
-      dphi=dcc->m_hDPint[index]->Interpolate(phi, r, z) / divisor;
-    }
-    if (dcc->m_hDRint[index] && (mask & COORD_R) && check_boundaries(dcc->m_hDRint[index], phi, r, z))
+    corrections = grid_corrections(dcc, index, phi, r, z, mask);
+    if (dcc->m_validate_grid)
     {
-      dr=dcc->m_hDRint[index]->Interpolate(phi, r, z);
-    }
-    if (dcc->m_hDZint[index] && (mask & COORD_Z) && check_boundaries(dcc->m_hDZint[index], phi, r, z))
-    {
-      dz=dcc->m_hDZint[index]->Interpolate(phi, r, z);
+      const auto reference = histogram_corrections(dcc, index, phi, r, z, mask);
+      for (int i = 0; i < 3; ++i)
+      {
+        if (std::abs(corrections[i] - reference[i]) > 1e-6 * std::max(1., std::abs(reference[i])))
+        {
+          std::cout << "TpcDistortionCorrection::get_corrected_position - grid mismatch at (phi, r, z) = (" << phi << ", " << r << ", " << z << ")"
+                    << " component " << i << " grid: " << corrections[i] << " histogram: " << reference[i] << std::endl;
+        }
+      }
+      corrections = reference;
     }
   }
-  else if (dcc->m_dimensions == 2)
+  else
   {
-    double zterm = 1.0;
-
-    if (dcc->m_interpolate_z){
-      zterm=(1. - std::abs(z) / 105.5);
-    }
-    if (dcc->m_hDPint[index] && (mask & COORD_PHI) && check_boundaries(dcc->m_hDPint[index], phi, r))
-    {
-      dphi=dcc->m_hDPint[index]->Interpolate(phi, r) * zterm / divisor;
-    }
-    if (dcc->m_hDRint[index] && (mask & COORD_R) && check_boundaries(dcc->m_hDRint[index], phi, r))
-    {
-      dr=dcc->m_hDRint[index]->Interpolate(phi, r) * zterm;
-    }
-    if (dcc->m_hDZint[index] && (mask & COORD_Z) && check_boundaries(dcc->m_hDZint[index], phi, r))
-    {
-      dz=dcc->m_hDZint[index]->Interpolate(phi, r) * zterm;
-    }
-    
+    corrections = histogram_corrections(dcc, index, phi, r, z, mask);
   }
 
-//if we are scaling, apply the scale factor to each correction
-if(dcc->m_use_scalefactor)
+  auto dr = corrections[0];
+  auto dphi = corrections[1] / divisor;
+  auto dz = corrections[2];
+
+  // if we are scaling, apply the scale factor to each correction
+  if (dcc->m_use_scalefactor)
   {
     dphi *= dcc->m_scalefactor;
     dr *= dcc->m_scalefactor;
     dz *= dcc->m_scalefactor;
   }
 
-  phi_new=phi-dphi;
-  r_new=r-dr;
-  z_new=z-dz;
+  const auto phi_new = phi - dphi;
+  const auto r_new = r - dr;
+  const auto z_new = z - dz;
 
   // update cluster
   const auto x_new = r_new * std::cos(phi_new);
@@ -138,3 +189,12 @@ if(dcc->m_use_scalefactor)
 
   return {x_new, y_new, z_new};
 }
+
+//________________________________________________________
+void TpcDistortionCorrection::get_corrected_positions(Acts::Vector3* positions, std::size_t n, const TpcDistortionCorrectionContainer* dcc, unsigned int mask) const
+{
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    positions[i] = get_corrected_position(positions[i], dcc, mask);
+  }
+}
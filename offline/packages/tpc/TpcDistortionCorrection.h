@@ -9,6 +9,8 @@
 
 #include <Acts/Definitions/Algebra.hpp>
 
+#include <cstddef>
+
 class TpcDistortionCorrectionContainer;
 
 class TpcDistortionCorrection
@@ -45,6 +47,10 @@ class TpcDistortionCorrection
   Acts::Vector3 get_corrected_position(const Acts::Vector3&, const TpcDistortionCorrectionContainer*,
                                        unsigned int mask = COORD_ALL) const;
 
+  //! correct n positions in place, using given DistortionCorrectionObject
+  void get_corrected_positions(Acts::Vector3* positions, std::size_t n, const TpcDistortionCorrectionContainer*,
+                               unsigned int mask = COORD_ALL) const;
+
 };
 
 #endif
@@ -7,7 +7,10 @@
  * \author Hugo Pereira Da Costa <hugo.pereira-da-costa@cea.fr>
  */
 
+#include "TpcDistortionGrid.h"
+
 #include <array>
+#include <memory>
 
 class TH1;
 
@@ -41,6 +44,15 @@ class TpcDistortionCorrectionContainer
    */
   std::array<TH1*, 2> m_hentries = {{nullptr, nullptr}};
   //@}
+
+  //!@name dense copies of the (dR, dPhi, dZ) histograms
+  //@{
+  /// built by TpcLoadDistortionCorrection. When present for a given side, corrections are interpolated from the grid rather than from the histograms
+  std::array<std::unique_ptr<TpcDistortionGrid>, 2> m_grid;
+
+  /// interpolate both grid and histograms, print differences and use the histogram values
+  bool m_validate_grid = false;
+  //@}
 };
 
 #endif
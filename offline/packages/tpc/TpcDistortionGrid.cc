@@ -0,0 +1,185 @@
+/*!
+ * \file TpcDistortionGrid.cc
+ * \brief dense copy of distortion histograms for fast interpolation
+ */
+
+#include "TpcDistortionGrid.h"
+
+#include <TAxis.h>
+#include <TH1.h>
+
+#include <cstddef>
+
+//________________________________________________________
+bool TpcDistortionGrid::Axis::locate(double x, int& bin, double& fraction) const
+{
+  // same bin as TAxis::FindBin. Reject underflow, overflow (and NaN), first and last bin
+  if (!(x >= min && x < max))
+  {
+    return false;
+  }
+  const int root_bin = 1 + int(nbins * (x - min) / (max - min));
+  if (root_bin < 2 || root_bin >= nbins)
+  {
+    return false;
+  }
+
+  // interpolate between the centers of the bins surrounding x, centers as in TAxis::GetBinCenter
+  const double width = (max - min) / nbins;
+  const auto center = [this, width](int b)
+  { return min + (b - 1) * width + 0.5 * width; };
+  const int lower = (x < center(root_bin)) ? root_bin - 1 : root_bin;
+  fraction = (x - center(lower)) / (center(lower + 1) - center(lower));
+  bin = lower - 1;
+  return true;
+}
+
+//________________________________________________________
+bool TpcDistortionGrid::build(const std::vector<const TH1*>& histograms)
+{
+  m_values.clear();
+  m_dimension = 0;
+  m_ncomponents = 0;
+
+  if (histograms.empty() || histograms.size() > max_components)
+  {
+    return false;
+  }
+
+  // binning is taken from the first valid histogram
+  const TH1* reference = nullptr;
+  for (const auto& h : histograms)
+  {
+    if (h)
+    {
+      reference = h;
+      break;
+    }
+  }
+  if (!reference)
+  {
+    return false;
+  }
+
+  const int dimension = reference->GetDimension();
+  if (dimension != 2 && dimension != 3)
+  {
+    return false;
+  }
+
+  const std::array<const TAxis*, 3> reference_axes = {{reference->GetXaxis(), reference->GetYaxis(), reference->GetZaxis()}};
+  for (const auto& h : histograms)
+  {
+    if (!h)
+    {
+      continue;
+    }
+    if (h->GetDimension() != dimension)
+    {
+      return false;
+    }
+    const std::array<const TAxis*, 3> axes = {{h->GetXaxis(), h->GetYaxis(), h->GetZaxis()}};
+    for (int i = 0; i < dimension; ++i)
+    {
+      if (axes[i]->IsVariableBinSize() ||
+          axes[i]->GetNbins() != reference_axes[i]->GetNbins() ||
+          axes[i]->GetXmin() != reference_axes[i]->GetXmin() ||
+          axes[i]->GetXmax() != reference_axes[i]->GetXmax())
+      {
+        return false;
+      }
+    }
+  }
+
+  for (int i = 0; i < 3; ++i)
+  {
+    m_axis[i] = (i < dimension) ? Axis{reference_axes[i]->GetNbins(), reference_axes[i]->GetXmin(), reference_axes[i]->GetXmax()} : Axis();
+  }
+
+  const unsigned int ncomponents = histograms.size();
+  const int nx = m_axis[0].nbins;
+  const int ny = m_axis[1].nbins;
+  const int nz = m_axis[2].nbins;
+  m_values.resize(static_cast<std::size_t>(nx) * ny * nz * ncomponents, 0);
+  for (unsigned int c = 0; c < ncomponents; ++c)
+  {
+    const auto& h = histograms[c];
+    if (!h)
+    {
+      continue;
+    }
+    for (int ix = 0; ix < nx; ++ix)
+    {
+      for (int iy = 0; iy < ny; ++iy)
+      {
+        for (int iz = 0; iz < nz; ++iz)
+        {
+          // TH2::GetBin ignores the z bin
+          m_values[((static_cast<std::size_t>(ix) * ny + iy) * nz + iz) * ncomponents + c] = h->GetBinContent(h->GetBin(ix + 1, iy + 1, iz + 1));
+        }
+      }
+    }
+  }
+
+  m_dimension = dimension;
+  m_ncomponents = ncomponents;
+  return true;
+}
+
+//________________________________________________________
+bool TpcDistortionGrid::interpolate(double phi, double r, double z, Values& values) const
+{
+  int ix = 0;
+  int iy = 0;
+  int iz = 0;
+  double xd = 0;
+  double yd = 0;
+  double zd = 0;
+  if (!valid() ||
+      !m_axis[0].locate(phi, ix, xd) ||
+      !m_axis[1].locate(r, iy, yd) ||
+      (m_dimension == 3 && !m_axis[2].locate(z, iz, zd)))
+  {
+    return false;
+  }
+
+  const int ny = m_axis[1].nbins;
+  const int nz = m_axis[2].nbins;
+  const auto node = [this, ny, nz](int i, int j, int k)
+  { return &m_values[((static_cast<std::size_t>(i) * ny + j) * nz + k) * m_ncomponents]; };
+
+  if (m_dimension == 3)
+  {
+    // same order of operations as TH3::Interpolate
+    const double* v000 = node(ix, iy, iz);
+    const double* v001 = node(ix, iy, iz + 1);
+    const double* v010 = node(ix, iy + 1, iz);
+    const double* v011 = node(ix, iy + 1, iz + 1);
+    const double* v100 = node(ix + 1, iy, iz);
+    const double* v101 = node(ix + 1, iy, iz + 1);
+    const double* v110 = node(ix + 1, iy + 1, iz);
+    const double* v111 = node(ix + 1, iy + 1, iz + 1);
+    for (unsigned int c = 0; c < m_ncomponents; ++c)
+    {
+      const double i1 = v000[c] * (1 - zd) + v001[c] * zd;
+      const double i2 = v010[c] * (1 - zd) + v011[c] * zd;
+      const double j1 = v100[c] * (1 - zd) + v101[c] * zd;
+      const double j2 = v110[c] * (1 - zd) + v111[c] * zd;
+      const double w1 = i1 * (1 - yd) + i2 * yd;
+      const double w2 = j1 * (1 - yd) + j2 * yd;
+      values[c] = w1 * (1 - xd) + w2 * xd;
+    }
+  }
+  else
+  {
+    const double* v00 = node(ix, iy, 0);
+    const double* v01 = node(ix, iy + 1, 0);
+    const double* v10 = node(ix + 1, iy, 0);
+    const double* v11 = node(ix + 1, iy + 1, 0);
+    for (unsigned int c = 0; c < m_ncomponents; ++c)
+    {
+      values[c] = (v00[c] * (1 - yd) + v01[c] * yd) * (1 - xd) + (v10[c] * (1 - yd) + v11[c] * yd) * xd;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,68 @@
+#ifndef TPC_TPCDISTORTIONGRID_H
+#define TPC_TPCDISTORTIONGRID_H
+
+/*!
+ * \file TpcDistortionGrid.h
+ * \brief dense copy of distortion histograms for fast interpolation
+ */
+
+#include <array>
+#include <vector>
+
+class TH1;
+
+//! flat interleaved copy of a set of distortion histograms with identical binning
+/*!
+ * The bin contents of up to four TH2 (phi, r) or TH3 (phi, r, z) histograms are
+ * copied once, at load time, into a single array in which the values of all
+ * histograms for a given bin are stored next to each other.
+ * interpolate() performs the same boundary check as the histogram based code
+ * (the point must not be in the first or last bin of any axis) and the same
+ * (bi/tri)linear interpolation between bin centers as TH2/TH3::Interpolate, but
+ * bins are found with plain arithmetic on uniform axes and all components are
+ * obtained from a single lookup.
+ */
+class TpcDistortionGrid
+{
+ public:
+  static constexpr unsigned int max_components = 4;
+  using Values = std::array<double, max_components>;
+
+  //! copy histograms, nullptr entries give zero
+  /*!
+   * returns false, and leaves the grid invalid, if there are more than max_components histograms,
+   * if they are neither all TH2 nor all TH3, or if their axes are not uniform and identical
+   */
+  bool build(const std::vector<const TH1*>& histograms);
+
+  //! true if build succeeded
+  bool valid() const { return !m_values.empty(); }
+
+  //! dimension of the source histograms
+  int dimension() const { return m_dimension; }
+
+  //! interpolated values at given point, z is ignored for 2D grids
+  /*! returns false and leaves values untouched if the point is outside of the interpolation range */
+  bool interpolate(double phi, double r, double z, Values& values) const;
+
+ private:
+  //! uniform axis
+  struct Axis
+  {
+    int nbins = 1;
+    double min = 0;
+    double max = 1;
+
+    //! lower bin (0 based) and fraction for interpolating at x, false if x is in the first or last bin
+    bool locate(double x, int& bin, double& fraction) const;
+  };
+
+  int m_dimension = 0;
+  unsigned int m_ncomponents = 0;
+  std::array<Axis, 3> m_axis;
+
+  //! bin contents, indexed by ((phi bin * n r bins + r bin) * n z bins + z bin) * number of components + component
+  std::vector<double> m_values;
+};
+
+#endif
@@ -6,6 +6,7 @@
 
 #include "TpcLoadDistortionCorrection.h"
 #include "TpcDistortionCorrectionContainer.h"
+#include "TpcDistortionGrid.h"
 
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <phool/PHCompositeNode.h>
@@ -15,6 +16,8 @@
 #include <TFile.h>
 #include <TH1.h>
 
+#include <memory>
+
 namespace
 {
 
@@ -118,6 +121,25 @@ int TpcLoadDistortionCorrection::InitRun(PHCompositeNode* topNode)
     distortion_correction_object->m_use_scalefactor = m_use_scalefactor[i];
     distortion_correction_object->m_scalefactor = m_scalefactor[i];
 
+    // dense copy of the histograms, used for interpolation
+    distortion_correction_object->m_validate_grid = m_validate_grid;
+    for (int j = 0; j < 2; ++j)
+    {
+      distortion_correction_object->m_grid[j].reset();
+      if (!m_use_grid)
+      {
+        continue;
+      }
+      auto grid = std::make_unique<TpcDistortionGrid>();
+      if (grid->build({distortion_correction_object->m_hDRint[j], distortion_correction_object->m_hDPint[j], distortion_correction_object->m_hDZint[j]}))
+      {
+        distortion_correction_object->m_grid[j] = std::move(grid);
+      }
+      else
+      {
+        std::cout << "TpcLoadDistortionCorrection::InitRun - histograms in " << m_correction_filename[i] << " have non uniform or inconsistent binning, interpolating from histograms" << std::endl;
+      }
+    }
 
     if (Verbosity())
     {
@@ -73,6 +73,18 @@ class TpcLoadDistortionCorrection : public SubsysReco
     m_interpolate_z[i] = flag;
   }
 
+  //! interpolate corrections from dense copies of the histograms (default), rather than from the histograms themselves
+  void set_use_grid(bool flag)
+  {
+    m_use_grid = flag;
+  }
+
+  //! compare grid and histogram interpolation for every corrected position, print differences
+  void set_validate_grid(bool flag)
+  {
+    m_validate_grid = flag;
+  }
+
   //! node name
   void set_node_name(const std::string& value)
   {
@@ -103,6 +115,10 @@ class TpcLoadDistortionCorrection : public SubsysReco
   //! z interpolation
   std::array<bool,nDistortionTypes> m_interpolate_z = {true,true,true,true};
 
+  //! dense grid
+  bool m_use_grid = true;
+  bool m_validate_grid = false;
+
   //! distortion object node name
   std::array<std::string,nDistortionTypes> m_node_name = {"TpcDistortionCorrectionContainerStatic", "TpcDistortionCorrectionContainerAverage", "TpcDistortionCorrectionContainerFluctuation","TpcDistortionCorrectionContainerModuleEdge"};
 };
@@ -141,9 +141,9 @@ Surface ActsGeometry::get_tpc_surface_from_coords(
   unsigned int layer = TrkrDefs::getLayer(hitsetkey);
   unsigned int side = TpcDefs::getSide(hitsetkey);
 
-  auto mapIter = maps().m_tpcSurfaceMap.find(layer);
+  const auto surfaces = maps().getTpcSurfaces(layer);
 
-  if (mapIter == maps().m_tpcSurfaceMap.end())
+  if (!surfaces)
   {
     std::cout << "Error: hitsetkey not found in ActsGeometry::get_tpc_surface_from_coords, hitsetkey = "
               << hitsetkey << std::endl;
@@ -152,7 +152,7 @@ Surface ActsGeometry::get_tpc_surface_from_coords(
 
   double world_phi = atan2(world[1], world[0]);
 
-  std::vector<Surface>& surf_vec = mapIter->second;
+  const SurfaceVec& surf_vec = *surfaces;
   unsigned int surf_index = 999;
 
   // Predict which surface index this phi and side will correspond to
@@ -170,11 +170,10 @@ Surface ActsGeometry::get_tpc_surface_from_coords(
 
   unsigned int nsurf = nsurfm % surf_vec.size();
 
-  Surface this_surf = surf_vec[nsurf];
+  const Surface& this_surf = surf_vec[nsurf];
 
-  auto vec3d = this_surf->center(geometry().getGeoContext());
-  std::vector<double> surf_center = {vec3d(0) / 10.0, vec3d(1) / 10.0, vec3d(2) / 10.0};  // convert from mm to cm
-  double surf_phi = atan2(surf_center[1], surf_center[0]);
+  const auto vec3d = this_surf->center(geometry().getGeoContext());
+  double surf_phi = atan2(vec3d(1), vec3d(0));
   double surfStepPhi = geometry().tpcSurfStepPhi;
 
   if ((world_phi > surf_phi - surfStepPhi / 2.0 && world_phi < surf_phi + surfStepPhi / 2.0))
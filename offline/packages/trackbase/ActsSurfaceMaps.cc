@@ -27,8 +27,106 @@ namespace
   {
     return std::sqrt(square(x) + square(y));
   }
+
+  /// hitsetkey bits below the layer
+  constexpr TrkrDefs::hitsetkey lower_bits_mask = (1U << TrkrDefs::kBitShiftLayer) - 1;
+
+  /// number of lower hitsetkey bits that do not depend on the surface (strobe, crossing)
+  unsigned int surface_index_shift(unsigned int trkrid)
+  {
+    switch (trkrid)
+    {
+    case TrkrDefs::TrkrId::mvtxId:
+      return MvtxDefs::kBitShiftStrobeIdOffset + MvtxDefs::kBitShiftStrobeIdWidth;
+    case TrkrDefs::TrkrId::inttId:
+      return InttDefs::kBitShiftTimeBucketIdOffset + InttDefs::kBitShiftTimeBucketIdWidth;
+    default:
+      return 0;
+    }
+  }
 }  // namespace
 
+void ActsSurfaceMaps::buildLookupTables()
+{
+  const auto build = [](const std::map<TrkrDefs::hitsetkey, Surface>& map, std::vector<LayerSurfaces>& table)
+  {
+    table.clear();
+
+    // index range in each layer
+    for (const auto& [hitsetkey, surface] : map)
+    {
+      const unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+      const unsigned int trkrid = TrkrDefs::getTrkrId(hitsetkey);
+      const unsigned int shift = surface_index_shift(trkrid);
+      const unsigned int index = (hitsetkey & lower_bits_mask) >> shift;
+      if (layer >= table.size())
+      {
+        table.resize(layer + 1);
+      }
+      auto& layer_surfaces = table[layer];
+      if (layer_surfaces.surfaces.empty())
+      {
+        layer_surfaces.trkrid = trkrid;
+        layer_surfaces.shift = shift;
+        layer_surfaces.offset = index;
+        layer_surfaces.surfaces.resize(1);
+      }
+      else if (index < layer_surfaces.offset)
+      {
+        layer_surfaces.surfaces.insert(layer_surfaces.surfaces.begin(), layer_surfaces.offset - index, nullptr);
+        layer_surfaces.offset = index;
+      }
+      else if (index - layer_surfaces.offset >= layer_surfaces.surfaces.size())
+      {
+        layer_surfaces.surfaces.resize(index - layer_surfaces.offset + 1);
+      }
+    }
+
+    // surfaces
+    for (const auto& [hitsetkey, surface] : map)
+    {
+      auto& layer_surfaces = table[TrkrDefs::getLayer(hitsetkey)];
+      auto& entry = layer_surfaces.surfaces[((hitsetkey & lower_bits_mask) >> layer_surfaces.shift) - layer_surfaces.offset];
+      if (!entry)
+      {
+        entry = surface;
+      }
+    }
+  };
+
+  build(m_siliconSurfaceMap, m_siliconLayerSurfaces);
+  build(m_mmSurfaceMap, m_mmLayerSurfaces);
+
+  m_tpcLayerSurfaces.clear();
+  for (const auto& [layer, surfaces] : m_tpcSurfaceMap)
+  {
+    if (layer >= m_tpcLayerSurfaces.size())
+    {
+      m_tpcLayerSurfaces.resize(layer + 1);
+    }
+    m_tpcLayerSurfaces[layer] = surfaces;
+  }
+}
+
+const Surface* ActsSurfaceMaps::findSurface(const std::vector<LayerSurfaces>& table, TrkrDefs::hitsetkey hitsetkey)
+{
+  const unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+  if (layer >= table.size())
+  {
+    return nullptr;
+  }
+  const auto& layer_surfaces = table[layer];
+  const unsigned int index = (hitsetkey & lower_bits_mask) >> layer_surfaces.shift;
+  if (layer_surfaces.trkrid != TrkrDefs::getTrkrId(hitsetkey) ||
+      index < layer_surfaces.offset ||
+      index - layer_surfaces.offset >= layer_surfaces.surfaces.size())
+  {
+    return nullptr;
+  }
+  const auto& surface = layer_surfaces.surfaces[index - layer_surfaces.offset];
+  return surface ? &surface : nullptr;
+}
+
 bool ActsSurfaceMaps::isTpcSurface(const Acts::Surface* surface) const
 {
   return m_tpcVolumeIds.find(surface->geometryId().volume()) != m_tpcVolumeIds.end();
@@ -71,6 +169,16 @@ Surface ActsSurfaceMaps::getSurface(TrkrDefs::cluskey key,
 
 Surface ActsSurfaceMaps::getSiliconSurface(TrkrDefs::hitsetkey hitsetkey) const
 {
+  if (!m_siliconLayerSurfaces.empty())
+  {
+    if (const auto surface = findSurface(m_siliconLayerSurfaces, hitsetkey))
+    {
+      return *surface;
+    }
+    std::cout << "Failed to find silicon surface for hitsetkey " << hitsetkey << std::endl;
+    return nullptr;
+  }
+
   unsigned int trkrid = TrkrDefs::getTrkrId(hitsetkey);
   TrkrDefs::hitsetkey tmpkey = hitsetkey;
 
@@ -105,21 +213,34 @@ Surface ActsSurfaceMaps::getSiliconSurface(TrkrDefs::hitsetkey hitsetkey) const
 Surface ActsSurfaceMaps::getTpcSurface(TrkrDefs::hitsetkey hitsetkey,
                                        TrkrDefs::subsurfkey surfkey) const
 {
-  unsigned int layer = TrkrDefs::getLayer(hitsetkey);
-  const auto iter = m_tpcSurfaceMap.find(layer);
-
-  if (iter != m_tpcSurfaceMap.end())
+  if (const auto surfvec = getTpcSurfaces(TrkrDefs::getLayer(hitsetkey)))
   {
-    auto surfvec = iter->second;
-    return surfvec.at(surfkey);
+    return surfvec->at(surfkey);
   }
 
   /// If it can't be found, return nullptr to skip this cluster
   return nullptr;
 }
 
+const SurfaceVec* ActsSurfaceMaps::getTpcSurfaces(unsigned int layer) const
+{
+  if (!m_tpcLayerSurfaces.empty())
+  {
+    return (layer < m_tpcLayerSurfaces.size() && !m_tpcLayerSurfaces[layer].empty()) ? &m_tpcLayerSurfaces[layer] : nullptr;
+  }
+
+  const auto iter = m_tpcSurfaceMap.find(layer);
+  return (iter == m_tpcSurfaceMap.end()) ? nullptr : &iter->second;
+}
+
 Surface ActsSurfaceMaps::getMMSurface(TrkrDefs::hitsetkey hitsetkey) const
 {
+  if (!m_mmLayerSurfaces.empty())
+  {
+    const auto surface = findSurface(m_mmLayerSurfaces, hitsetkey);
+    return surface ? *surface : nullptr;
+  }
+
   const auto iter = m_mmSurfaceMap.find(hitsetkey);
   return (iter == m_mmSurfaceMap.end()) ? nullptr : iter->second;
 }
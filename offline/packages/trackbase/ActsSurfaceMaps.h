@@ -49,6 +49,16 @@ struct ActsSurfaceMaps
 
   Surface getMMSurface(TrkrDefs::hitsetkey hitsetkey) const;
 
+  //! TPC surfaces for a given layer, nullptr if layer is not found
+  const SurfaceVec* getTpcSurfaces(unsigned int layer) const;
+
+  //! fill the flat lookup tables used by the get*Surface methods from the maps below
+  /*!
+   * must be called again whenever the maps are modified.
+   * If it is never called, surfaces are searched for in the maps directly
+   */
+  void buildLookupTables();
+
   //! map hitset to Surface for the silicon detectors (MVTX and INTT)
   std::map<TrkrDefs::hitsetkey, Surface> m_siliconSurfaceMap;
 
@@ -68,6 +78,28 @@ struct ActsSurfaceMaps
   //! stores all acts volume ids relevant to the micromegas
   /** it is used to quickly tell if a given Acts Surface belongs to micromegas */
   std::set<int> m_micromegasVolumeIds;
+
+ private:
+  //! surfaces of one silicon or micromegas layer
+  /*!
+   * indexed by the hitsetkey bits below the layer, shifted to drop the strobe or crossing bits
+   * and relative to the smallest index found in the layer. Missing surfaces are nullptr
+   */
+  struct LayerSurfaces
+  {
+    unsigned int trkrid = 0;
+    unsigned int shift = 0;
+    unsigned int offset = 0;
+    SurfaceVec surfaces;
+  };
+
+  //! surface matching hitsetkey in flat lookup table, nullptr if not found
+  static const Surface* findSurface(const std::vector<LayerSurfaces>& table, TrkrDefs::hitsetkey hitsetkey);
+
+  //! flat lookup tables, indexed by layer
+  std::vector<LayerSurfaces> m_siliconLayerSurfaces;
+  std::vector<LayerSurfaces> m_mmLayerSurfaces;
+  std::vector<SurfaceVec> m_tpcLayerSurfaces;
 };
 
 #endif
@@ -0,0 +1,188 @@
+/**
+ * @file trackbase/PixelClusterLabeler.cc
+ * @brief connected component labeling of silicon pixels and strips
+ */
+
+#include "PixelClusterLabeler.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+  //! largest scratch grid, in cells. Larger hit bounding boxes use sorted hits instead
+  constexpr std::size_t max_grid_size = 1U << 24U;
+}  // namespace
+
+//_________________________________________________________________
+unsigned int PixelClusterLabeler::find(unsigned int i)
+{
+  while (m_parent[i] != i)
+  {
+    m_parent[i] = m_parent[m_parent[i]];
+    i = m_parent[i];
+  }
+  return i;
+}
+
+//_________________________________________________________________
+unsigned int PixelClusterLabeler::label(const std::vector<Hit>& hits, int max_drow, int max_dcol, bool forward_only)
+{
+  const unsigned int nhits = hits.size();
+  m_parent.resize(nhits);
+  m_labels.resize(nhits);
+  m_bounds.clear();
+  m_offsets.clear();
+  m_indices.clear();
+  if (nhits == 0)
+  {
+    m_offsets.push_back(0);
+    return 0;
+  }
+
+  for (unsigned int i = 0; i < nhits; ++i)
+  {
+    m_parent[i] = i;
+  }
+
+  // the root of each set is its first hit
+  const auto merge = [this](unsigned int i, unsigned int j)
+  {
+    const auto ri = find(i);
+    const auto rj = find(j);
+    if (ri < rj)
+    {
+      m_parent[rj] = ri;
+    }
+    else if (rj < ri)
+    {
+      m_parent[ri] = rj;
+    }
+  };
+
+  // bounding box
+  int row_min = hits[0].row;
+  int row_max = hits[0].row;
+  int col_min = hits[0].col;
+  int col_max = hits[0].col;
+  for (const auto& hit : hits)
+  {
+    row_min = std::min(row_min, hit.row);
+    row_max = std::max(row_max, hit.row);
+    col_min = std::min(col_min, hit.col);
+    col_max = std::max(col_max, hit.col);
+  }
+  const std::size_t nrows = static_cast<std::size_t>(row_max) - row_min + 1;
+  const std::size_t ncols = static_cast<std::size_t>(col_max) - col_min + 1;
+
+  if (nrows * ncols <= max_grid_size)
+  {
+    // place hits one by one in the grid, and connect them to the neighbors already placed.
+    // A hit on an occupied cell is connected to the hit stored there
+    m_grid.resize(std::max(m_grid.size(), nrows * ncols), 0);
+    const auto cell = [&](int row, int col)
+    { return static_cast<std::size_t>(row - row_min) * ncols + (col - col_min); };
+
+    for (unsigned int i = 0; i < nhits; ++i)
+    {
+      const auto& hit = hits[i];
+      const int r0 = std::max(forward_only ? hit.row : hit.row - max_drow, row_min);
+      const int r1 = std::min(hit.row + max_drow, row_max);
+      const int c0 = std::max(forward_only ? hit.col : hit.col - max_dcol, col_min);
+      const int c1 = std::min(hit.col + max_dcol, col_max);
+      for (int row = r0; row <= r1; ++row)
+      {
+        for (int col = c0; col <= c1; ++col)
+        {
+          if (const auto j = m_grid[cell(row, col)])
+          {
+            merge(i, j - 1);
+          }
+        }
+      }
+
+      auto& own = m_grid[cell(hit.row, hit.col)];
+      if (!own)
+      {
+        own = i + 1;
+      }
+    }
+
+    // clear the grid for next call
+    for (const auto& hit : hits)
+    {
+      m_grid[cell(hit.row, hit.col)] = 0;
+    }
+  }
+  else
+  {
+    // sort hits by (row, col), and look for the neighbors of each hit with binary searches
+    using Entry = std::tuple<int, int, unsigned int>;
+    std::vector<Entry> sorted;
+    sorted.reserve(nhits);
+    for (unsigned int i = 0; i < nhits; ++i)
+    {
+      sorted.emplace_back(hits[i].row, hits[i].col, i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    for (unsigned int i = 0; i < nhits; ++i)
+    {
+      const auto& hit = hits[i];
+      for (int row = (forward_only ? hit.row : hit.row - max_drow); row <= hit.row + max_drow; ++row)
+      {
+        auto iter = std::lower_bound(sorted.begin(), sorted.end(), Entry(row, (forward_only ? hit.col : hit.col - max_dcol), 0));
+        for (; iter != sorted.end() && std::get<0>(*iter) == row && std::get<1>(*iter) <= hit.col + max_dcol; ++iter)
+        {
+          // in forward only mode, later hits connect to this one themselves, unless they are on the same cell
+          if (forward_only && std::get<2>(*iter) > i && (std::get<0>(*iter) != hit.row || std::get<1>(*iter) != hit.col))
+          {
+            continue;
+          }
+          merge(i, std::get<2>(*iter));
+        }
+      }
+    }
+  }
+
+  // cluster ids, in order of the first hit, and bounds
+  for (unsigned int i = 0; i < nhits; ++i)
+  {
+    const auto& hit = hits[i];
+    const auto root = find(i);
+    if (root == i)
+    {
+      m_labels[i] = m_bounds.size();
+      m_bounds.push_back({hit.row, hit.row, hit.col, hit.col});
+    }
+    else
+    {
+      m_labels[i] = m_labels[root];
+      auto& bounds = m_bounds[m_labels[i]];
+      bounds.row_min = std::min(bounds.row_min, hit.row);
+      bounds.row_max = std::max(bounds.row_max, hit.row);
+      bounds.col_min = std::min(bounds.col_min, hit.col);
+      bounds.col_max = std::max(bounds.col_max, hit.col);
+    }
+  }
+
+  // group hit indices by cluster, keeping the input order
+  const unsigned int nclusters = m_bounds.size();
+  m_offsets.assign(nclusters + 1, 0);
+  for (const auto& id : m_labels)
+  {
+    ++m_offsets[id + 1];
+  }
+  for (unsigned int c = 0; c < nclusters; ++c)
+  {
+    m_offsets[c + 1] += m_offsets[c];
+  }
+  m_indices.resize(nhits);
+  m_position.assign(m_offsets.begin(), m_offsets.end() - 1);
+  for (unsigned int i = 0; i < nhits; ++i)
+  {
+    m_indices[m_position[m_labels[i]]++] = i;
+  }
+
+  return nclusters;
+}
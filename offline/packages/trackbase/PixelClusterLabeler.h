@@ -0,0 +1,97 @@
+#ifndef TRACKBASE_PIXELCLUSTERLABELER_H
+#define TRACKBASE_PIXELCLUSTERLABELER_H
+
+/**
+ * @file trackbase/PixelClusterLabeler.h
+ * @brief connected component labeling of silicon pixels and strips
+ */
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief connected component labeling of silicon pixels and strips
+ *
+ * Hits are given as (row, col) in any order. Two hits are connected if their rows differ by at most
+ * max_drow and their columns by at most max_dcol. Hits are placed in a scratch grid covering the hits bounding box,
+ * and connected with a union-find, so that labeling is linear in the number of hits.
+ *
+ * Clusters are numbered in the order of their first hit, same as boost::connected_components, and
+ * the hits of a cluster keep their input order. Since connected hits are at most one row or column apart,
+ * the rows (columns) of a cluster are contiguous, and their number is given by the cluster bounds.
+ *
+ * The scratch arrays are kept from one call to the next. Use one instance per thread.
+ */
+class PixelClusterLabeler
+{
+ public:
+  //! one input hit
+  struct Hit
+  {
+    int row = 0;
+    int col = 0;
+  };
+
+  //! row and column range of one cluster
+  struct Bounds
+  {
+    int row_min = 0;
+    int row_max = 0;
+    int col_min = 0;
+    int col_max = 0;
+
+    //! number of rows
+    unsigned int nrows() const { return row_max - row_min + 1; }
+
+    //! number of columns
+    unsigned int ncols() const { return col_max - col_min + 1; }
+  };
+
+  //! label the hits. Returns the number of clusters
+  /**
+   * with forward_only, hit j is only connected to an earlier hit i if the row and column of i are
+   * those of j or above. This reproduces the INTT raw hit adjacency, which took the absolute value
+   * of an unsigned difference and only tested pairs with i < j
+   */
+  unsigned int label(const std::vector<Hit>& hits, int max_drow, int max_dcol, bool forward_only = false);
+
+  //! number of clusters found in the last call to label
+  unsigned int nclusters() const { return m_bounds.size(); }
+
+  //! cluster id of each hit
+  const std::vector<unsigned int>& labels() const { return m_labels; }
+
+  //! bounds of given cluster
+  const Bounds& bounds(unsigned int cluster) const { return m_bounds[cluster]; }
+
+  //! indices of the hits of a given cluster, in input order
+  /** returns a pointer to the first index, and sets n to the number of hits */
+  const unsigned int* hits(unsigned int cluster, std::size_t& n) const
+  {
+    n = m_offsets[cluster + 1] - m_offsets[cluster];
+    return m_indices.data() + m_offsets[cluster];
+  }
+
+ private:
+  //! union-find root, with path halving
+  unsigned int find(unsigned int i);
+
+  //! hit index + 1 in each grid cell, 0 if empty
+  std::vector<unsigned int> m_grid;
+
+  //! union-find parents
+  std::vector<unsigned int> m_parent;
+
+  //! cluster id of each hit
+  std::vector<unsigned int> m_labels;
+
+  //! cluster bounds
+  std::vector<Bounds> m_bounds;
+
+  //! hit indices, grouped by cluster
+  std::vector<unsigned int> m_offsets;
+  std::vector<unsigned int> m_indices;
+  std::vector<unsigned int> m_position;
+};
+
+#endif  // TRACKBASE_PIXELCLUSTERLABELER_H
@@ -0,0 +1,427 @@
+/**
+ * @file trackbase/TrkrClusterContainerv5.cc
+ * @brief Implementation of TrkrClusterContainerv5
+ */
+#include "TrkrClusterContainerv5.h"
+#include "TrkrCluster.h"
+#include "TrkrClusterv5.h"
+#include "TrkrDefs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+  TrkrClusterContainer::Map dummy_map;
+}
+
+//_________________________________________________________________
+/**
+ * TrkrCluster interface to one cluster of the container.
+ * It stores the cluster key rather than a pointer to the arrays,
+ * which remain valid only until the container is modified or read from file
+ */
+class TrkrClusterContainerv5::ClusterAdapter : public TrkrCluster
+{
+ public:
+  ClusterAdapter(TrkrClusterContainerv5* container, TrkrDefs::cluskey key)
+    : m_container(container)
+    , m_key(key)
+  {
+  }
+
+  void identify(std::ostream& os = std::cout) const override
+  {
+    os << "---TrkrClusterContainerv5 cluster---------------" << std::endl;
+    os << " key: " << m_key << " (rphi,z) =  (" << getLocalX() << ", " << getLocalY() << ") cm ";
+    os << " valid = " << isValid() << std::endl;
+    os << "-----------------------------------------------" << std::endl;
+  }
+
+  void Reset() override {}
+
+  int isValid() const override
+  {
+    return arrays() && !std::isnan(getLocalX()) && !std::isnan(getLocalY()) && getAdc() != 0xFFFF;
+  }
+
+  //! detached copy
+  PHObject* CloneMe() const override
+  {
+    auto cluster = new TrkrClusterv5;
+    cluster->CopyFrom(*this);
+    cluster->setPhiError(getRPhiError());
+    cluster->setZError(getZError());
+    return cluster;
+  }
+
+  //! import PHObject CopyFrom, in order to avoid clang warning
+  using PHObject::CopyFrom;
+
+  void CopyFrom(const TrkrCluster& source) override
+  {
+    if (this == &source)
+    {
+      return;
+    }
+    if (auto clusters = arrays())
+    {
+      clusters->set(index(), source);
+    }
+  }
+
+  void CopyFrom(TrkrCluster* source) override { CopyFrom(*source); }
+
+  float getPosition(int coor) const override { return coor == 0 ? getLocalX() : getLocalY(); }
+  void setPosition(int coor, float xi) override
+  {
+    if (coor == 0)
+    {
+      setLocalX(xi);
+    }
+    else
+    {
+      setLocalY(xi);
+    }
+  }
+
+  float getLocalX() const override { return get(&ClusterArrays::localX, NAN); }
+  void setLocalX(float value) override { set(&ClusterArrays::localX, value); }
+  float getLocalY() const override { return get(&ClusterArrays::localY, NAN); }
+  void setLocalY(float value) override { set(&ClusterArrays::localY, value); }
+
+  TrkrDefs::subsurfkey getSubSurfKey() const override { return get(&ClusterArrays::subSurfKey, TrkrDefs::SUBSURFKEYMAX); }
+  void setSubSurfKey(TrkrDefs::subsurfkey value) override { set(&ClusterArrays::subSurfKey, value); }
+
+  unsigned int getAdc() const override { return get<unsigned short>(&ClusterArrays::adc, 0xFFFF); }
+  void setAdc(unsigned int value) override { set<unsigned short>(&ClusterArrays::adc, value); }
+  unsigned int getMaxAdc() const override { return get<unsigned short>(&ClusterArrays::maxAdc, 0xFFFF); }
+  void setMaxAdc(uint16_t value) override { set<unsigned short>(&ClusterArrays::maxAdc, value); }
+
+  float getRPhiError() const override { return get(&ClusterArrays::phiError, NAN); }
+  float getZError() const override { return get(&ClusterArrays::zError, NAN); }
+
+  char getSize() const override { return get(&ClusterArrays::phiSize, char(0)) * get(&ClusterArrays::zSize, char(0)); }
+  float getPhiSize() const override { return get(&ClusterArrays::phiSize, char(0)); }
+  float getZSize() const override { return get(&ClusterArrays::zSize, char(0)); }
+
+  char getOverlap() const override { return get(&ClusterArrays::overlap, char(0)); }
+  void setOverlap(char value) override { set(&ClusterArrays::overlap, value); }
+  char getEdge() const override { return get(&ClusterArrays::edge, char(0)); }
+  void setEdge(char value) override { set(&ClusterArrays::edge, value); }
+
+ private:
+  //! arrays containing this cluster, nullptr if not found
+  ClusterArrays* arrays() const
+  {
+    const auto iter = m_container->m_clusmap.find(TrkrDefs::getHitSetKeyFromClusKey(m_key));
+    return (iter != m_container->m_clusmap.end() && iter->second.contains(index())) ? &iter->second : nullptr;
+  }
+
+  std::size_t index() const { return TrkrDefs::getClusIndex(m_key); }
+
+  template <class T>
+  T get(std::vector<T> ClusterArrays::*member, T default_value) const
+  {
+    const auto clusters = arrays();
+    return clusters ? (clusters->*member)[index()] : default_value;
+  }
+
+  template <class T>
+  void set(std::vector<T> ClusterArrays::*member, T value)
+  {
+    if (auto clusters = arrays())
+    {
+      (clusters->*member)[index()] = value;
+    }
+  }
+
+  TrkrClusterContainerv5* m_container = nullptr;
+  TrkrDefs::cluskey m_key = 0;
+};
+
+//_________________________________________________________________
+struct TrkrClusterContainerv5::AdapterCache
+{
+  std::mutex mutex;
+  std::unordered_map<TrkrDefs::cluskey, std::unique_ptr<ClusterAdapter>> adapters;
+};
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::ClusterArrays::resize(std::size_t size)
+{
+  localX.resize(size, NAN);
+  localY.resize(size, NAN);
+  phiError.resize(size, 0);
+  zError.resize(size, 0);
+  subSurfKey.resize(size, TrkrDefs::SUBSURFKEYMAX);
+  adc.resize(size, 0);
+  maxAdc.resize(size, 0);
+  phiSize.resize(size, 0);
+  zSize.resize(size, 0);
+  overlap.resize(size, 0);
+  edge.resize(size, 0);
+  valid.resize(size, 0);
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::ClusterArrays::set(std::size_t index, const TrkrCluster& cluster)
+{
+  localX[index] = cluster.getLocalX();
+  localY[index] = cluster.getLocalY();
+  phiError[index] = cluster.getRPhiError();
+  zError[index] = cluster.getZError();
+  subSurfKey[index] = cluster.getSubSurfKey();
+  adc[index] = static_cast<unsigned short>(cluster.getAdc());
+  maxAdc[index] = static_cast<unsigned short>(cluster.getMaxAdc());
+  phiSize[index] = static_cast<char>(cluster.getPhiSize());
+  zSize[index] = static_cast<char>(cluster.getZSize());
+  overlap[index] = cluster.getOverlap();
+  edge[index] = cluster.getEdge();
+  valid[index] = 1;
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::TrkrClusterContainerv5()
+  : m_adapters(new AdapterCache)
+{
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::~TrkrClusterContainerv5()
+{
+  delete m_adapters;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::Reset()
+{
+  // clear the maps
+  /* using swap ensures that the memory is properly de-allocated */
+  {
+    std::map<TrkrDefs::hitsetkey, ClusterArrays> empty;
+    m_clusmap.swap(empty);
+  }
+
+  // also clear temporary map
+  {
+    Map empty;
+    m_tmpmap.swap(empty);
+  }
+
+  // and adapters
+  {
+    std::lock_guard<std::mutex> lock(m_adapters->mutex);
+    m_adapters->adapters.clear();
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::identify(std::ostream& os) const
+{
+  os << "-----TrkrClusterContainerv5-----" << std::endl;
+  os << "Number of clusters: " << size() << std::endl;
+
+  for (const auto& [hitsetkey, clusters] : m_clusmap)
+  {
+    const unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+    os << "layer: " << layer << " hitsetkey: " << hitsetkey << std::endl;
+
+    for (std::size_t index = 0; index < clusters.size(); ++index)
+    {
+      if (clusters.contains(index))
+      {
+        os << " index: " << index << " (rphi,z) =  (" << clusters.localX[index] << ", " << clusters.localY[index] << ") cm"
+           << " adc: " << clusters.adc[index] << std::endl;
+      }
+    }
+  }
+
+  os << "------------------------------" << std::endl;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::removeCluster(TrkrDefs::cluskey key)
+{
+  // find relevant cluster arrays if any and invalidate corresponding cluster
+  auto iter = m_clusmap.find(TrkrDefs::getHitSetKeyFromClusKey(key));
+  if (iter != m_clusmap.end())
+  {
+    const auto index = TrkrDefs::getClusIndex(key);
+    if (index < iter->second.size())
+    {
+      iter->second.valid[index] = 0;
+    }
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::addClusterSpecifyKey(const TrkrDefs::cluskey key, TrkrCluster* newclus)
+{
+  // find relevant arrays or create them if not found
+  auto& clusters = m_clusmap[TrkrDefs::getHitSetKeyFromClusKey(key)];
+
+  // get cluster index in arrays
+  const auto index = TrkrDefs::getClusIndex(key);
+
+  if (clusters.contains(index))
+  {
+    std::cout << "TrkrClusterContainerv5::AddClusterSpecifyKey: duplicate key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+
+  if (index >= clusters.size())
+  {
+    clusters.resize(index + 1);
+  }
+  clusters.set(index, *newclus);
+
+  // the container takes ownership of the cluster. Adapters belong to their container
+  if (!dynamic_cast<ClusterAdapter*>(newclus))
+  {
+    delete newclus;
+  }
+}
+
+TrkrClusterContainerv5::ConstRange
+TrkrClusterContainerv5::getClusters() const
+{
+  std::cout << "deprecated function in TrkrClusterContainerv5, user getClusters(TrkrDefs:hitsetkey)"
+            << std::endl;
+  return std::make_pair(dummy_map.begin(), dummy_map.begin());
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::ConstRange
+TrkrClusterContainerv5::getClusters(TrkrDefs::hitsetkey hitsetkey)
+{
+  // clear temporary map
+  {
+    Map empty;
+    m_tmpmap.swap(empty);
+  }
+
+  // find relevant arrays
+  const auto iter = m_clusmap.find(hitsetkey);
+  if (iter != m_clusmap.end())
+  {
+    // copy adapters in temporary map
+    const auto& clusters = iter->second;
+    for (std::size_t index = 0; index < clusters.size(); ++index)
+    {
+      if (clusters.contains(index))
+      {
+        // generate cluster key from hitset and index
+        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+
+        // insert in map
+        m_tmpmap.insert(m_tmpmap.end(), std::make_pair(ckey, getAdapter(ckey)));
+      }
+    }
+  }
+
+  // return temporary map range
+  return std::make_pair(m_tmpmap.cbegin(), m_tmpmap.cend());
+}
+
+//_________________________________________________________________
+TrkrCluster* TrkrClusterContainerv5::findCluster(TrkrDefs::cluskey key) const
+{
+  return getClusterView(key) ? getAdapter(key) : nullptr;
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::ClusterView TrkrClusterContainerv5::getClusterView(TrkrDefs::cluskey key) const
+{
+  const auto clusters = getClusterArrays(TrkrDefs::getHitSetKeyFromClusKey(key));
+  const auto index = TrkrDefs::getClusIndex(key);
+  return (clusters && clusters->contains(index)) ? ClusterView(clusters, index) : ClusterView();
+}
+
+//_________________________________________________________________
+const TrkrClusterContainerv5::ClusterArrays* TrkrClusterContainerv5::getClusterArrays(TrkrDefs::hitsetkey hitsetkey) const
+{
+  const auto iter = m_clusmap.find(hitsetkey);
+  return (iter == m_clusmap.end()) ? nullptr : &iter->second;
+}
+
+//_________________________________________________________________
+TrkrCluster* TrkrClusterContainerv5::getAdapter(TrkrDefs::cluskey key) const
+{
+  std::lock_guard<std::mutex> lock(m_adapters->mutex);
+  auto& adapter = m_adapters->adapters[key];
+  if (!adapter)
+  {
+    adapter = std::make_unique<ClusterAdapter>(const_cast<TrkrClusterContainerv5*>(this), key);
+  }
+  return adapter.get();
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys() const
+{
+  HitSetKeyList out;
+  out.reserve(m_clusmap.size());
+  std::transform(
+      m_clusmap.begin(), m_clusmap.end(), std::back_inserter(out),
+      [](const std::pair<const TrkrDefs::hitsetkey, ClusterArrays>& pair)
+      { return pair.first; });
+  return out;
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys(const TrkrDefs::TrkrId trackerid) const
+{
+  /* copy the logic from TrkrHitSetContainerv1::getHitSets */
+  const TrkrDefs::hitsetkey keylo = TrkrDefs::getHitSetKeyLo(trackerid);
+  const TrkrDefs::hitsetkey keyhi = TrkrDefs::getHitSetKeyHi(trackerid);
+
+  // get relevant range in map
+  const auto begin = m_clusmap.lower_bound(keylo);
+  const auto end = m_clusmap.upper_bound(keyhi);
+
+  // transform to a vector
+  HitSetKeyList out;
+  out.reserve(m_clusmap.size());
+  std::transform(
+      begin, end, std::back_inserter(out),
+      [](const std::pair<const TrkrDefs::hitsetkey, ClusterArrays>& pair)
+      { return pair.first; });
+  return out;
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const
+{
+  /* copy the logic from TrkrHitSetContainerv1::getHitSets */
+  TrkrDefs::hitsetkey keylo = TrkrDefs::getHitSetKeyLo(trackerid, layer);
+  TrkrDefs::hitsetkey keyhi = TrkrDefs::getHitSetKeyHi(trackerid, layer);
+
+  // get relevant range in map
+  const auto begin = m_clusmap.lower_bound(keylo);
+  const auto end = m_clusmap.upper_bound(keyhi);
+
+  // transform to a vector
+  HitSetKeyList out;
+  out.reserve(m_clusmap.size());
+  std::transform(
+      begin, end, std::back_inserter(out),
+      [](const std::pair<const TrkrDefs::hitsetkey, ClusterArrays>& pair)
+      { return pair.first; });
+  return out;
+}
+
+//_________________________________________________________________
+unsigned int TrkrClusterContainerv5::size() const
+{
+  unsigned int size = 0;
+  for (const auto& [hitsetkey, clusters] : m_clusmap)
+  {
+    size += std::count(clusters.valid.begin(), clusters.valid.end(), 1);
+  }
+  return size;
+}
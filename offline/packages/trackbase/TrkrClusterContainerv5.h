@@ -0,0 +1,160 @@
+#ifndef TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+#define TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+
+/**
+ * @file trackbase/TrkrClusterContainerv5.h
+ * @brief Cluster container object, with cluster content stored in arrays
+ */
+
+#include "TrkrClusterContainer.h"
+#include "TrkrDefs.h"
+
+#include <phool/PHObject.h>
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+class TrkrCluster;
+
+/**
+ * @brief Cluster container object, with cluster content stored in arrays
+ *
+ * The content of each cluster (same as TrkrClusterv5) is stored in contiguous arrays,
+ * one set of arrays per hitset, indexed by the cluster index from the cluster key.
+ * No cluster object is allocated. Clusters passed to addClusterSpecifyKey are copied, then deleted.
+ *
+ * getClusterView and getClusterArrays give fast, non virtual access to the cluster content.
+ * For code that still uses TrkrCluster pointers, findCluster and getClusters return
+ * adapters owned by the container, which read and write the arrays. Creating the adapters
+ * is serialized with a mutex.
+ */
+class TrkrClusterContainerv5 : public TrkrClusterContainer
+{
+ public:
+  //! cluster content for one hitset, indexed by cluster index
+  struct ClusterArrays
+  {
+    std::vector<float> localX;
+    std::vector<float> localY;
+    std::vector<float> phiError;
+    std::vector<float> zError;
+    std::vector<TrkrDefs::subsurfkey> subSurfKey;
+    std::vector<unsigned short> adc;
+    std::vector<unsigned short> maxAdc;
+    std::vector<char> phiSize;
+    std::vector<char> zSize;
+    std::vector<char> overlap;
+    std::vector<char> edge;
+
+    //! 1 if a cluster is stored at this index
+    std::vector<char> valid;
+
+    //! number of indices, including removed or missing clusters
+    std::size_t size() const { return valid.size(); }
+
+    //! true if a cluster is stored at this index
+    bool contains(std::size_t index) const { return index < valid.size() && valid[index]; }
+
+    //! resize all arrays
+    void resize(std::size_t size);
+
+    //! copy cluster content at given index
+    void set(std::size_t index, const TrkrCluster& cluster);
+  };
+
+  //! non virtual, read only access to one cluster
+  /**
+   * only valid until the container is modified
+   */
+  class ClusterView
+  {
+   public:
+    ClusterView() = default;
+
+    ClusterView(const ClusterArrays* arrays, std::size_t index)
+      : m_arrays(arrays)
+      , m_index(index)
+    {
+    }
+
+    //! false if the cluster was not found
+    explicit operator bool() const { return m_arrays; }
+
+    float getLocalX() const { return m_arrays->localX[m_index]; }
+    float getLocalY() const { return m_arrays->localY[m_index]; }
+    float getRPhiError() const { return m_arrays->phiError[m_index]; }
+    float getZError() const { return m_arrays->zError[m_index]; }
+    TrkrDefs::subsurfkey getSubSurfKey() const { return m_arrays->subSurfKey[m_index]; }
+    unsigned int getAdc() const { return m_arrays->adc[m_index]; }
+    unsigned int getMaxAdc() const { return m_arrays->maxAdc[m_index]; }
+    float getPhiSize() const { return m_arrays->phiSize[m_index]; }
+    float getZSize() const { return m_arrays->zSize[m_index]; }
+    char getSize() const { return m_arrays->phiSize[m_index] * m_arrays->zSize[m_index]; }
+    char getOverlap() const { return m_arrays->overlap[m_index]; }
+    char getEdge() const { return m_arrays->edge[m_index]; }
+
+   private:
+    const ClusterArrays* m_arrays = nullptr;
+    std::size_t m_index = 0;
+  };
+
+  TrkrClusterContainerv5();
+
+  ~TrkrClusterContainerv5() override;
+
+  //! adapters point to this container, so it must not be copied
+  TrkrClusterContainerv5(const TrkrClusterContainerv5&) = delete;
+  TrkrClusterContainerv5& operator=(const TrkrClusterContainerv5&) = delete;
+
+  void Reset() override;
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  void addClusterSpecifyKey(const TrkrDefs::cluskey, TrkrCluster*) override;
+
+  void removeCluster(TrkrDefs::cluskey) override;
+
+  ConstRange getClusters() const override;  // deprecated
+
+  ConstRange getClusters(TrkrDefs::hitsetkey) override;
+
+  TrkrCluster* findCluster(TrkrDefs::cluskey) const override;
+
+  HitSetKeyList getHitSetKeys() const override;
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId) const override;
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId, const uint8_t /* layer */) const override;
+
+  unsigned int size(void) const override;
+
+  //! fast access to cluster content, evaluates to false if cluster is not found
+  ClusterView getClusterView(TrkrDefs::cluskey) const;
+
+  //! all clusters of a given hitset, nullptr if not found
+  const ClusterArrays* getClusterArrays(TrkrDefs::hitsetkey) const;
+
+ private:
+  //! TrkrCluster interface to the arrays
+  class ClusterAdapter;
+
+  //! adapters created so far, and mutex
+  struct AdapterCache;
+
+  //! find or create adapter for an existing cluster
+  TrkrCluster* getAdapter(TrkrDefs::cluskey) const;
+
+  //! the actual container
+  std::map<TrkrDefs::hitsetkey, ClusterArrays> m_clusmap;
+
+  //! temporary map
+  Map m_tmpmap;  //! transient. The temporary map does not get written to the output
+
+  //! adapters returned by findCluster and getClusters
+  AdapterCache* m_adapters = nullptr;  //! transient
+
+  ClassDefOverride(TrkrClusterContainerv5, 1)
+};
+
+#endif  // TRACKBASE_TRKRCLUSTERCONTAINERV5_H
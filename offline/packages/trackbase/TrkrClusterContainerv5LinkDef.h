@@ -0,0 +1,6 @@
+#ifdef __CINT__
+
+#pragma link C++ class TrkrClusterContainerv5::ClusterArrays + ;
+#pragma link C++ class TrkrClusterContainerv5 + ;
+
+#endif /* __CINT__ */
@@ -73,6 +73,16 @@ class TrkrHitSetContainer : public PHObject
     return 0;
   }
 
+  //! create TrkrHitSetv2 (flat hitkey, adc storage) in findOrAddHitSet
+  virtual void setFlatHitSets(const bool)
+  {
+  }
+
+  virtual bool flatHitSets() const
+  {
+    return false;
+  }
+
  protected:
   //! ctor
   TrkrHitSetContainer() = default;
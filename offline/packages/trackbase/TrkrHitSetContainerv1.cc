@@ -8,6 +8,7 @@
 
 #include "TrkrDefs.h"
 #include "TrkrHitSetv1.h"
+#include "TrkrHitSetv2.h"
 
 #include <cstdlib>
 
@@ -99,7 +100,16 @@ TrkrHitSetContainerv1::findOrAddHitSet(TrkrDefs::hitsetkey key)
   auto it = m_hitmap.lower_bound(key);
   if (it == m_hitmap.end() || (key < it->first))
   {
-    it = m_hitmap.insert(it, std::make_pair(key, new TrkrHitSetv1));
+    TrkrHitSet* hitset = nullptr;
+    if (m_flatHitSets)
+    {
+      hitset = new TrkrHitSetv2;
+    }
+    else
+    {
+      hitset = new TrkrHitSetv1;
+    }
+    it = m_hitmap.insert(it, std::make_pair(key, hitset));
     it->second->setHitSetKey(key);
   }
   return it;
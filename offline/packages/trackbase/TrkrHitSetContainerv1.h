@@ -55,9 +55,23 @@ class TrkrHitSetContainerv1 : public TrkrHitSetContainer
     return m_hitmap.size();
   }
 
+  //! new hitsets are TrkrHitSetv2 instead of TrkrHitSetv1. Hitsets already in the container are not changed
+  void setFlatHitSets(const bool flat) override
+  {
+    m_flatHitSets = flat;
+  }
+
+  bool flatHitSets() const override
+  {
+    return m_flatHitSets;
+  }
+
  private:
   Map m_hitmap;
 
+  //! only used when adding hitsets, not saved
+  bool m_flatHitSets = false;  //!
+
   ClassDefOverride(TrkrHitSetContainerv1, 1)
 };
 
@@ -0,0 +1,205 @@
+/**
+ * @file trackbase/TrkrHitSetv2.cc
+ * @brief Implementation of TrkrHitSetv2
+ */
+#include "TrkrHitSetv2.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>  // for exit
+#include <iostream>
+#include <utility>  // for move
+
+void TrkrHitSetv2::Reset()
+{
+  // not resetting the key as the hitset is reused in the next event
+  // when stored in a TrkrHitSetContainerv2
+
+  // clear() keeps the capacity of the flat storage
+  m_hitkeys.clear();
+  m_adcs.clear();
+
+  // handles and map nodes are kept for the next event
+  recycleHandles();
+  m_nhandles = 0;
+}
+
+void TrkrHitSetv2::recycleHandles() const
+{
+  while (!m_hits.empty())
+  {
+    m_spare_nodes.push_back(m_hits.extract(m_hits.begin()));
+  }
+}
+
+void TrkrHitSetv2::identify(std::ostream& os) const
+{
+  const unsigned int layer = TrkrDefs::getLayer(m_hitSetKey);
+  const unsigned int trkrid = TrkrDefs::getTrkrId(m_hitSetKey);
+  os
+      << "TrkrHitSetv2: "
+      << "       hitsetkey " << getHitSetKey()
+      << " TrkrId " << trkrid
+      << " layer " << layer
+      << " nhits: " << m_hitkeys.size()
+      << std::endl;
+
+  for (unsigned int i = 0; i < m_hitkeys.size(); ++i)
+  {
+    os << " hitkey " << m_hitkeys[i] << " adc " << m_adcs[i] << std::endl;
+  }
+}
+
+int TrkrHitSetv2::find(const TrkrDefs::hitkey key) const
+{
+  const auto it = std::lower_bound(m_hitkeys.begin(), m_hitkeys.end(), key);
+  if (it == m_hitkeys.end() || *it != key)
+  {
+    return -1;
+  }
+  return it - m_hitkeys.begin();
+}
+
+unsigned int TrkrHitSetv2::findOrAdd(const TrkrDefs::hitkey key)
+{
+  // hits are mostly added in increasing key order, check the end first
+  if (m_hitkeys.empty() || m_hitkeys.back() < key)
+  {
+    m_hitkeys.push_back(key);
+    m_adcs.push_back(0);
+    return m_hitkeys.size() - 1;
+  }
+
+  const auto it = std::lower_bound(m_hitkeys.begin(), m_hitkeys.end(), key);
+  const unsigned int index = it - m_hitkeys.begin();
+  if (*it != key)
+  {
+    m_hitkeys.insert(it, key);
+    m_adcs.insert(m_adcs.begin() + index, 0);
+  }
+  return index;
+}
+
+void TrkrHitSetv2::addEnergy(const TrkrDefs::hitkey key, const double edep)
+{
+  // same saturation as TrkrHitv2::addEnergy
+  unsigned short& adc = m_adcs[findOrAdd(key)];
+  const double ein = edep * TrkrDefs::EdepScaleFactor;
+  if ((double) adc + ein > (double) USHRT_MAX)
+  {
+    adc = USHRT_MAX;
+  }
+  else
+  {
+    adc += (unsigned short) (ein);
+  }
+}
+
+void TrkrHitSetv2::setAdc(const TrkrDefs::hitkey key, const unsigned int adc)
+{
+  m_adcs[findOrAdd(key)] = (adc > USHRT_MAX) ? USHRT_MAX : (unsigned short) adc;
+}
+
+unsigned int TrkrHitSetv2::getAdc(const TrkrDefs::hitkey key) const
+{
+  const int index = find(key);
+  return (index < 0) ? 0 : m_adcs[index];
+}
+
+void TrkrHitSetv2::removeHit(TrkrDefs::hitkey key)
+{
+  const int index = find(key);
+  if (index < 0)
+  {
+    identify();
+    std::cout << "TrkrHitSetv2::removeHit: deleting a nonexist key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+  m_hitkeys.erase(m_hitkeys.begin() + index);
+  m_adcs.erase(m_adcs.begin() + index);
+  releaseHandle(key);
+}
+
+void TrkrHitSetv2::releaseHandle(const TrkrDefs::hitkey key) const
+{
+  // the handle itself stays in use until Reset()
+  if (m_hits.empty())
+  {
+    return;
+  }
+  const auto it = m_hits.find(key);
+  if (it != m_hits.end())
+  {
+    m_spare_nodes.push_back(m_hits.extract(it));
+  }
+}
+
+TrkrHitSetv2::ConstIterator
+TrkrHitSetv2::addHitSpecificKey(const TrkrDefs::hitkey key, TrkrHit* hit)
+{
+  if (find(key) >= 0)
+  {
+    std::cout << "TrkrHitSetv2::AddHitSpecificKey: duplicate key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+  setAdc(key, hit->getAdc());
+  delete hit;
+  return addHandle(key);
+}
+
+TrkrHitSetv2::ConstIterator
+TrkrHitSetv2::addHandle(const TrkrDefs::hitkey key) const
+{
+  const auto it = m_hits.lower_bound(key);
+  if (it != m_hits.end() && it->first == key)
+  {
+    return it;
+  }
+  // handles modify the flat storage, as the TrkrHit returned by TrkrHitSetv1::getHit does
+  Hit* handle = nullptr;
+  if (m_nhandles < m_handles.size())
+  {
+    handle = &m_handles[m_nhandles];
+    handle->setKey(key);
+  }
+  else
+  {
+    handle = &m_handles.emplace_back(const_cast<TrkrHitSetv2*>(this), key);
+  }
+  ++m_nhandles;
+
+  if (m_spare_nodes.empty())
+  {
+    return m_hits.insert(it, std::make_pair(key, handle));
+  }
+  auto node = std::move(m_spare_nodes.back());
+  m_spare_nodes.pop_back();
+  node.key() = key;
+  node.mapped() = handle;
+  return m_hits.insert(it, std::move(node));
+}
+
+TrkrHit*
+TrkrHitSetv2::getHit(const TrkrDefs::hitkey key) const
+{
+  if (find(key) < 0)
+  {
+    return nullptr;
+  }
+  return addHandle(key)->second;
+}
+
+TrkrHitSetv2::ConstRange
+TrkrHitSetv2::getHits() const
+{
+  // m_hits only holds keys which are in the flat storage,
+  // so it is complete if the sizes match
+  if (m_hits.size() != m_hitkeys.size())
+  {
+    for (const auto& key : m_hitkeys)
+    {
+      addHandle(key);
+    }
+  }
+  return std::make_pair(m_hits.cbegin(), m_hits.cend());
+}
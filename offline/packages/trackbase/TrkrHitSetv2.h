@@ -0,0 +1,203 @@
+#ifndef TRACKBASE_TRKRHITSETV2_H
+#define TRACKBASE_TRKRHITSETV2_H
+
+/**
+ * @file trackbase/TrkrHitSetv2.h
+ * @brief Flat storage of (hitkey, adc) pairs
+ */
+#include "TrkrDefs.h"
+#include "TrkrHit.h"
+#include "TrkrHitSet.h"
+
+#include <deque>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Flat container for TrkrHit's
+ *
+ * Hits are stored as two parallel vectors of hit keys and adc values,
+ * sorted by hit key. No TrkrHit object is allocated per hit and the
+ * vectors keep their capacity on Reset(), so when used in TrkrHitSetContainerv2
+ * the storage is reused from one event to the next.
+ *
+ * The TrkrHit based interface is still available. TrkrHit objects returned
+ * by getHit() and getHits() are light weight handles which read and write the
+ * adc in the flat storage. They are created on demand only and are not saved.
+ * Handles and index map nodes are recycled on Reset(), so once the hitset has
+ * seen a typical event getHit() and getHits() do not allocate anymore. Code which
+ * loops over all hits should still use getHitKeys() and getAdcs().
+ *
+ * NOTE: addHitSpecificKey() copies the adc of the passed hit and deletes it.
+ * Use the hit from the returned iterator to modify the hit afterwards,
+ * this works for all TrkrHitSet versions.
+ */
+class TrkrHitSetv2 : public TrkrHitSet
+{
+ public:
+  TrkrHitSetv2() = default;
+
+  ~TrkrHitSetv2() override = default;
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  //! For ROOT TClonesArray end of event Operation
+  void Clear(Option_t* /*option*/ = "") override { Reset(); }
+
+  void Reset() override;
+
+  void setHitSetKey(const TrkrDefs::hitsetkey key) override
+  {
+    m_hitSetKey = key;
+  }
+
+  TrkrDefs::hitsetkey getHitSetKey() const override
+  {
+    return m_hitSetKey;
+  }
+
+  ConstIterator addHitSpecificKey(const TrkrDefs::hitkey, TrkrHit*) override;
+
+  void removeHit(TrkrDefs::hitkey) override;
+
+  TrkrHit* getHit(const TrkrDefs::hitkey) const override;
+
+  ConstRange getHits() const override;
+
+  unsigned int size() const override
+  {
+    return m_hitkeys.size();
+  }
+
+  //!@name flat access, no TrkrHit objects involved
+  //@{
+
+  //! add energy to hit, the hit is created if it does not exist yet
+  void addEnergy(const TrkrDefs::hitkey, const double edep);
+
+  //! set adc of hit, the hit is created if it does not exist yet
+  void setAdc(const TrkrDefs::hitkey, const unsigned int adc);
+
+  //! adc of hit, 0 if it does not exist
+  unsigned int getAdc(const TrkrDefs::hitkey) const;
+
+  //! true if hit exists
+  bool hasHit(const TrkrDefs::hitkey key) const
+  {
+    return find(key) >= 0;
+  }
+
+  //! sorted hit keys
+  const std::vector<TrkrDefs::hitkey>& getHitKeys() const
+  {
+    return m_hitkeys;
+  }
+
+  //! adc values, same order as getHitKeys()
+  const std::vector<unsigned short>& getAdcs() const
+  {
+    return m_adcs;
+  }
+
+  //! reserve storage for n hits
+  void reserve(const unsigned int n)
+  {
+    m_hitkeys.reserve(n);
+    m_adcs.reserve(n);
+  }
+
+  //! remove all hits for which pred(hitkey, adc) is true
+  /*!
+   * the flat storage is compacted in a single pass, use this instead of
+   * calling removeHit() in a loop, which moves the tail of the vectors for each hit
+   */
+  template <class Pred>
+  void removeHits(Pred pred)
+  {
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < m_hitkeys.size(); ++i)
+    {
+      if (pred(m_hitkeys[i], (unsigned int) m_adcs[i]))
+      {
+        releaseHandle(m_hitkeys[i]);
+        continue;
+      }
+      m_hitkeys[n] = m_hitkeys[i];
+      m_adcs[n] = m_adcs[i];
+      ++n;
+    }
+    m_hitkeys.resize(n);
+    m_adcs.resize(n);
+  }
+
+  //@}
+
+ private:
+  //! TrkrHit interface to one entry of the flat storage, not saved
+  class Hit final : public TrkrHit
+  {
+   public:
+    Hit(TrkrHitSetv2* hitset, const TrkrDefs::hitkey key)
+      : m_hitset(hitset)
+      , m_key(key)
+    {
+    }
+
+    //! reuse this handle for another hit
+    void setKey(const TrkrDefs::hitkey key) { m_key = key; }
+
+    void identify(std::ostream& os = std::cout) const override
+    {
+      os << "TrkrHitSetv2 hit with adc = " << m_hitset->getAdc(m_key) << std::endl;
+    }
+
+    void addEnergy(const double edep) override { m_hitset->addEnergy(m_key, edep); }
+    double getEnergy() override { return ((double) m_hitset->getAdc(m_key)) / TrkrDefs::EdepScaleFactor; }
+    void setAdc(const unsigned int adc) override { m_hitset->setAdc(m_key, adc); }
+    unsigned int getAdc() override { return m_hitset->getAdc(m_key); }
+
+   private:
+    TrkrHitSetv2* m_hitset = nullptr;
+    TrkrDefs::hitkey m_key = 0;
+  };
+
+  //! position of key in flat storage, -1 if not found
+  int find(const TrkrDefs::hitkey key) const;
+
+  //! position of key in flat storage, the hit is inserted with zero adc if needed
+  unsigned int findOrAdd(const TrkrDefs::hitkey key);
+
+  //! create handle for key and add it to the index map
+  ConstIterator addHandle(const TrkrDefs::hitkey key) const;
+
+  //! move the index map nodes to the spare nodes
+  void recycleHandles() const;
+
+  //! move the index map node of key, if any, to the spare nodes
+  void releaseHandle(const TrkrDefs::hitkey key) const;
+
+  /// unique key for this object
+  TrkrDefs::hitsetkey m_hitSetKey = TrkrDefs::HITSETKEYMAX;
+
+  /// sorted hit keys
+  std::vector<TrkrDefs::hitkey> m_hitkeys;
+
+  /// adc values, same order as m_hitkeys
+  std::vector<unsigned short> m_adcs;
+
+  //! handles for the TrkrHit interface, filled on demand. getHits() completes it
+  //! when its size differs from the flat storage, in particular after DST readback
+  mutable Map m_hits;  //!
+
+  //! storage of the handles, pointers stay valid until Reset().
+  //! Handles are reused after Reset(), m_nhandles are in use
+  mutable std::deque<Hit> m_handles;  //!
+  mutable unsigned int m_nhandles = 0;  //!
+
+  //! index map nodes released by Reset(), removeHit() and removeHits(), reused by addHandle()
+  mutable std::vector<Map::node_type> m_spare_nodes;  //!
+
+  ClassDefOverride(TrkrHitSetv2, 1);
+};
+
+#endif  // TRACKBASE_TRKRHITSETV2_H
@@ -73,6 +73,15 @@ class TrkrHitTruthAssoc : public PHObject
   {
   }
 
+  /**
+   * @brief Get all associations of desired hitset
+   * @param[in] hset TrkrHitSet key
+   */
+  virtual ConstRange getG4Hits(const TrkrDefs::hitsetkey /*hitsetkey*/) const
+  {
+    return ConstRange();
+  }
+
  protected:
   //! ctor
   TrkrHitTruthAssoc() = default;
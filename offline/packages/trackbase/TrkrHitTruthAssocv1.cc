@@ -86,3 +86,8 @@ void TrkrHitTruthAssocv1::getG4Hits(const TrkrDefs::hitsetkey hitsetkey, const u
                [hidx](MMap::const_reference pair)
                { return pair.second.first == hidx; });
 }
+
+TrkrHitTruthAssoc::ConstRange TrkrHitTruthAssocv1::getG4Hits(const TrkrDefs::hitsetkey hitsetkey) const
+{
+  return m_map.equal_range(hitsetkey);
+}
@@ -0,0 +1,168 @@
+// compares PixelClusterLabeler with the boost graph clustering it replaced in the
+// MVTX and INTT clusterizers, on hit sets with pp-like and Au+Au-like occupancies
+//
+// usage: testPixelClusterLabeler [number of hit sets per occupancy, default 2000]
+// prints the time per hit set for both, returns 0 if all labels are identical
+
+#include "PixelClusterLabeler.h"
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/connected_components.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+  struct Occupancy
+  {
+    std::string name;
+    int nrows;
+    int ncols;
+    int max_drow;
+    int max_dcol;
+    int nclusters;
+    int max_cluster_size;
+    int nnoise;
+  };
+
+  // clusters grown from a seed hit, plus isolated noise hits, in random order
+  std::vector<PixelClusterLabeler::Hit> make_hits(const Occupancy& occupancy, std::mt19937& rng)
+  {
+    std::vector<PixelClusterLabeler::Hit> hits;
+    std::set<std::pair<int, int>> used;
+    std::uniform_int_distribution<int> row_dist(0, occupancy.nrows - 1);
+    std::uniform_int_distribution<int> col_dist(0, occupancy.ncols - 1);
+    std::uniform_int_distribution<int> size_dist(1, occupancy.max_cluster_size);
+    for (int icluster = 0; icluster < occupancy.nclusters; icluster++)
+    {
+      std::vector<PixelClusterLabeler::Hit> cluster = {{row_dist(rng), col_dist(rng)}};
+      const int size = size_dist(rng);
+      while ((int) cluster.size() < size)
+      {
+        const auto& seed = cluster[rng() % cluster.size()];
+        const int row = std::clamp(seed.row + (int) (rng() % (2 * occupancy.max_drow + 1)) - occupancy.max_drow, 0, occupancy.nrows - 1);
+        const int col = std::clamp(seed.col + (int) (rng() % (2 * occupancy.max_dcol + 1)) - occupancy.max_dcol, 0, occupancy.ncols - 1);
+        cluster.push_back({row, col});
+      }
+      for (const auto& hit : cluster)
+      {
+        if (used.insert({hit.row, hit.col}).second)
+        {
+          hits.push_back(hit);
+        }
+      }
+    }
+    for (int inoise = 0; inoise < occupancy.nnoise; inoise++)
+    {
+      PixelClusterLabeler::Hit hit = {row_dist(rng), col_dist(rng)};
+      if (used.insert({hit.row, hit.col}).second)
+      {
+        hits.push_back(hit);
+      }
+    }
+    std::shuffle(hits.begin(), hits.end(), rng);
+    return hits;
+  }
+
+  // the clustering of the MVTX and INTT clusterizers before PixelClusterLabeler
+  std::vector<int> boost_labels(const std::vector<PixelClusterLabeler::Hit>& hits, int max_drow, int max_dcol, unsigned int& nclusters)
+  {
+    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
+    Graph G;
+    for (unsigned int i = 0; i < hits.size(); i++)
+    {
+      for (unsigned int j = i + 1; j < hits.size(); j++)
+      {
+        if (std::abs(hits[i].row - hits[j].row) <= max_drow && std::abs(hits[i].col - hits[j].col) <= max_dcol)
+        {
+          add_edge(i, j, G);
+        }
+      }
+      add_edge(i, i, G);
+    }
+    std::vector<int> component(num_vertices(G));
+    connected_components(G, &component[0]);
+
+    std::set<int> cluster_ids;
+    std::multimap<int, unsigned int> clusters;
+    for (unsigned int i = 0; i < component.size(); i++)
+    {
+      cluster_ids.insert(component[i]);
+      clusters.insert(std::make_pair(component[i], i));
+    }
+    nclusters = cluster_ids.size();
+    return component;
+  }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  const int nhitsets = (argc > 1) ? std::atoi(argv[1]) : 2000;
+
+  // MVTX chips are 512 x 1024 pixels, INTT raw hit sets are 256 strips (columns) x 1 time bin.
+  // pp: a few clusters per chip. Au+Au: central event occupancy of the inner layers, and one noisy chip
+  const std::vector<Occupancy> occupancies = {
+      {"MVTX pp", 512, 1024, 1, 1, 5, 8, 2},
+      {"MVTX Au+Au", 512, 1024, 1, 1, 150, 12, 20},
+      {"MVTX noisy chip", 512, 1024, 1, 1, 0, 1, 2000},
+      {"INTT pp", 1, 256, 0, 1, 3, 3, 1},
+      {"INTT Au+Au", 1, 256, 0, 1, 40, 4, 5}};
+
+  std::mt19937 rng(42);
+  PixelClusterLabeler labeler;
+  int ndiff = 0;
+  for (const auto& occupancy : occupancies)
+  {
+    // not all noisy chip hit sets, the boost graph is too slow
+    const int nsets = (occupancy.nnoise > 1000) ? std::max(nhitsets / 20, 1) : nhitsets;
+    std::vector<std::vector<PixelClusterLabeler::Hit>> hitsets;
+    std::size_t nhits = 0;
+    for (int iset = 0; iset < nsets; iset++)
+    {
+      hitsets.push_back(make_hits(occupancy, rng));
+      nhits += hitsets.back().size();
+    }
+
+    std::vector<std::vector<int>> reference;
+    std::vector<unsigned int> reference_nclusters(nsets, 0);
+    auto start = std::chrono::steady_clock::now();
+    for (int iset = 0; iset < nsets; iset++)
+    {
+      reference.push_back(boost_labels(hitsets[iset], occupancy.max_drow, occupancy.max_dcol, reference_nclusters[iset]));
+    }
+    const double boost_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / nsets;
+
+    std::size_t nclusters = 0;
+    start = std::chrono::steady_clock::now();
+    for (int iset = 0; iset < nsets; iset++)
+    {
+      nclusters += labeler.label(hitsets[iset], occupancy.max_drow, occupancy.max_dcol);
+    }
+    const double labeler_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / nsets;
+
+    for (int iset = 0; iset < nsets; iset++)
+    {
+      labeler.label(hitsets[iset], occupancy.max_drow, occupancy.max_dcol);
+      const auto& labels = labeler.labels();
+      if (labeler.nclusters() != reference_nclusters[iset] || !std::equal(labels.begin(), labels.end(), reference[iset].begin()))
+      {
+        ndiff++;
+      }
+    }
+
+    std::cout << occupancy.name << ": " << (double) nhits / nsets << " hits, " << (double) nclusters / nsets << " clusters per hit set"
+              << ", boost graph " << boost_time << " us, PixelClusterLabeler " << labeler_time << " us"
+              << ", speedup " << boost_time / labeler_time << std::endl;
+  }
+
+  std::cout << ndiff << " hit sets with different labels" << std::endl;
+  return (ndiff > 0) ? 1 : 0;
+}
@@ -64,6 +64,33 @@ double ALICEKF::get_Bz(double x, double y, double z) const
   return bfield[2] / tesla;
 }
 
+void ALICEKF::get_Bz(const std::vector<double>& xyz, std::vector<double>& bz) const
+{
+  const unsigned int npoints = xyz.size() / 3;
+  bz.assign(npoints, _const_field);
+  if (_use_const_field || npoints == 0)
+  {
+    return;
+  }
+  std::vector<double> points(4 * npoints);
+  for (unsigned int i = 0; i < npoints; ++i)
+  {
+    points[4 * i] = xyz[3 * i] * cm;
+    points[4 * i + 1] = xyz[3 * i + 1] * cm;
+    points[4 * i + 2] = xyz[3 * i + 2] * cm;
+    points[4 * i + 3] = 0. * cm;
+  }
+  std::vector<double> bfields(3 * npoints);
+  _B->GetFieldValues(points.data(), bfields.data(), npoints);
+  for (unsigned int i = 0; i < npoints; ++i)
+  {
+    if (fabs(xyz[3 * i + 2]) <= 105.5)
+    {
+      bz[i] = bfields[3 * i + 2] / tesla;
+    }
+  }
+}
+
 double ALICEKF::getClusterError(TrkrCluster* c, TrkrDefs::cluskey key, Acts::Vector3 global, int i, int j) const
 {
   if (_use_fixed_clus_error)
@@ -457,6 +484,23 @@ TrackSeedAliceSeedMap ALICEKF::ALICEKalmanFilter(const std::vector<keylist>& tra
   {
     std::cout << "min clusters per track: " << _min_clusters_per_track << "\n";
   }
+
+  // field at the first cluster of every chain, looked up in one batch
+  std::vector<double> first_xyz;
+  first_xyz.reserve(3 * trackSeedKeyLists.size());
+  for (const auto& chain : trackSeedKeyLists)
+  {
+    const auto iter = chain.empty() ? globalPositions.end() : globalPositions.find(chain.front());
+    if (iter == globalPositions.end())
+    {
+      first_xyz.insert(first_xyz.end(), {0., 0., 0.});
+      continue;
+    }
+    first_xyz.insert(first_xyz.end(), {iter->second(0), iter->second(1), iter->second(2)});
+  }
+  std::vector<double> first_Bz;
+  get_Bz(first_xyz, first_Bz);
+
   for (auto trackKeyChain : trackSeedKeyLists)
   {
     ++ncandidates;
@@ -545,7 +589,7 @@ TrackSeedAliceSeedMap ALICEKF::ALICEKalmanFilter(const std::vector<keylist>& tra
       continue;
     }
 
-    double init_QPt = 1. / (0.3 * R / 100. * get_Bz(x0, y0, z0));
+    double init_QPt = 1. / (0.3 * R / 100. * first_Bz[ncandidates]);
     // determine charge
     double phi_first = atan2(y0, x0);
     if (Verbosity() > 1)
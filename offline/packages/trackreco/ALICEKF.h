@@ -64,6 +64,8 @@ class ALICEKF
   void repairCovariance(Eigen::Matrix<double, 6, 6>& cov) const;
   bool checknan(double val, const std::string& msg, int num) const;
   double get_Bz(double x, double y, double z) const;
+  //! Bz at several points (x, y, z per point) with a single batched field map lookup
+  void get_Bz(const std::vector<double>& xyz, std::vector<double>& bz) const;
   void useConstBField(bool opt) { _use_const_field = opt; }
   void setConstBField(float b) { _const_field = b; }
   void useFixedClusterError(bool opt) { _use_fixed_clus_error = opt; }
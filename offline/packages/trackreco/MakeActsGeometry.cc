@@ -209,6 +209,9 @@ int MakeActsGeometry::InitRun(PHCompositeNode *topNode)
     surfMaps.m_micromegasVolumeIds.insert(surface->geometryId().volume());
   }
 
+  // flat lookup tables for the get*Surface methods
+  surfMaps.buildLookupTables();
+
   m_actsGeometry->setGeometry(trackingGeometry);
   m_actsGeometry->setSurfMaps(surfMaps);
   m_actsGeometry->set_drift_velocity(m_drift_velocity);
@@ -41,6 +41,7 @@
 #include <phool/PHNode.h>
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>
+#include <phool/PHThreadPool.h>
 #include <phool/PHTimer.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>
@@ -54,6 +55,7 @@
 #include <Acts/TrackFitting/GainMatrixSmoother.hpp>
 #include <Acts/TrackFitting/GainMatrixUpdater.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <filesystem>
 #include <iostream>
@@ -83,6 +85,8 @@ PHActsTrkFitter::PHActsTrkFitter(const std::string& name)
 {
 }
 
+PHActsTrkFitter::~PHActsTrkFitter() = default;
+
 int PHActsTrkFitter::InitRun(PHCompositeNode* topNode)
 {
   if (Verbosity() > 1)
@@ -166,6 +170,23 @@ int PHActsTrkFitter::InitRun(PHCompositeNode* topNode)
 
   _tpccellgeo = findNode::getClass<PHG4TpcCylinderGeomContainer>(topNode, "CYLINDERCELLGEOM_SVTX");
 
+  if (m_num_threads != 1 && !m_threadpool)
+  {
+    if (m_use_clustermover)
+    {
+      m_threadpool = std::make_unique<PHThreadPool>(m_num_threads);
+      if (Verbosity() > 0)
+      {
+        std::cout << PHWHERE << "fitting with " << m_threadpool->size() << " threads" << std::endl;
+      }
+    }
+    else
+    {
+      // without cluster mover the source links modify the shared transient alignment map
+      std::cout << PHWHERE << "multi threaded fit needs the cluster mover, fitting in a single thread" << std::endl;
+    }
+  }
+
   if (Verbosity() > 1)
   {
     std::cout << "Finish PHActsTrkFitter Setup" << std::endl;
@@ -294,198 +315,266 @@ void PHActsTrkFitter::loopTracks(Acts::Logging::Level logLevel)
     std::cout << " seed map size " << m_seedMap->size() << std::endl;
   }
 
-  for (auto track : *m_seedMap)
+  if (!m_threadpool)
   {
-    if (!track)
+    // serial mode, each trial fit is stored right after it is done
+    for (auto track : *m_seedMap)
     {
-      continue;
-    }
-
-    unsigned int tpcid = track->get_tpc_seed_index();
-    unsigned int siid = track->get_silicon_seed_index();
+      PHTimer trackTimer("TrackTimer");
+      trackTimer.stop();
+      trackTimer.restart();
 
-    // capture the input crossing value, and set crossing parameters
-    //==============================
-    short silicon_crossing =  SHRT_MAX;
-    auto siseed = m_siliconSeeds->get(siid);
-    if(siseed)
+      SeedFit seedfit;
+      if (!prepareSeed(track, seedfit))
       {
-	silicon_crossing = siseed->get_crossing();
+        continue;
       }
-    short crossing = silicon_crossing;
-    short int crossing_estimate = crossing;
 
-    if(m_enable_crossing_estimate)
+      for (short int ivary = -seedfit.nvary; ivary <= seedfit.nvary; ++ivary)
       {
-	crossing_estimate = track->get_crossing_estimate();  // geometric crossing estimate from matcher
-     }
-    //===============================
+        FitTrial& trial = seedfit.trials.emplace_back();
+        fitTrial(seedfit, ivary, trial);
+        storeTrial(seedfit, ivary, trial);
+      }
 
+      trackTimer.stop();
+      auto trackTime = trackTimer.get_accumulated_time();
 
-    // must have silicon seed with valid crossing if we are doing a SC calibration fit
-    if (m_fitSiliconMMs)
+      if (Verbosity() > 1)
       {
-	if( (siid == std::numeric_limits<unsigned int>::max()) || (silicon_crossing == SHRT_MAX))
-	  {
-	    continue;
-	  }
+        std::cout << "PHActsTrkFitter total single track time " << trackTime << std::endl;
       }
+    }
+    return;
+  }
 
-    // do not skip TPC only tracks, just set crossing to the nominal zero
-    if(!siseed)
+  // multi threaded mode. Seeds are fitted in parallel in blocks, then the results are stored
+  // serially in seed order, so that track ids and outputs are identical to the serial mode
+  const std::vector<TrackSeed*> seeds(m_seedMap->begin(), m_seedMap->end());
+  for (std::size_t first = 0; first < seeds.size(); first += m_seedBlockSize)
+  {
+    const std::size_t nseeds = std::min<std::size_t>(m_seedBlockSize, seeds.size() - first);
+
+    // the fit results refer to the track containers of their trial, so
+    // the SeedFit objects must not be moved once the fits are done
+    std::vector<SeedFit> seedfits(nseeds);
+    m_threadpool->parallel_for(nseeds, [&](std::size_t task, unsigned int /*worker*/)
+                               {
+      SeedFit& seedfit = seedfits[task];
+      if (!prepareSeed(seeds[first + task], seedfit))
       {
-	crossing = 0;
+        return;
       }
+      for (short int ivary = -seedfit.nvary; ivary <= seedfit.nvary; ++ivary)
+      {
+        fitTrial(seedfit, ivary, seedfit.trials.emplace_back());
+      } });
 
-    if (Verbosity() > 1)
+    for (auto& seedfit : seedfits)
     {
-      if(siseed)
-	{
-	  std::cout << "tpc and si id " << tpcid << ", " << siid << " silicon_crossing " << silicon_crossing
-		    << " crossing " << crossing << " crossing estimate " << crossing_estimate << std::endl;
-	}
+      if (seedfit.skip)
+      {
+        continue;
+      }
+      short int ivary = -seedfit.nvary;
+      for (auto& trial : seedfit.trials)
+      {
+        storeTrial(seedfit, ivary++, trial);
+      }
     }
+  }
 
-    auto tpcseed = m_tpcSeeds->get(tpcid);
+  return;
+}
+
+bool PHActsTrkFitter::prepareSeed(TrackSeed* track, SeedFit& seedfit) const
+{
+  seedfit.skip = true;
+  if (!track)
+  {
+    return false;
+  }
+  seedfit.track = track;
+
+  unsigned int tpcid = track->get_tpc_seed_index();
+  unsigned int siid = track->get_silicon_seed_index();
+  seedfit.tpcid = tpcid;
+  seedfit.siid = siid;
+
+  // capture the input crossing value, and set crossing parameters
+  //==============================
+  short silicon_crossing = SHRT_MAX;
+  auto siseed = m_siliconSeeds->get(siid);
+  if (siseed)
+  {
+    silicon_crossing = siseed->get_crossing();
+  }
+  short crossing = silicon_crossing;
+  short int crossing_estimate = crossing;
+
+  if (m_enable_crossing_estimate)
+  {
+    crossing_estimate = track->get_crossing_estimate();  // geometric crossing estimate from matcher
+  }
+  //===============================
 
-    /// Need to also check that the tpc seed wasn't removed by the ghost finder
-    if (!tpcseed)
+  // must have silicon seed with valid crossing if we are doing a SC calibration fit
+  if (m_fitSiliconMMs)
+  {
+    if ((siid == std::numeric_limits<unsigned int>::max()) || (silicon_crossing == SHRT_MAX))
     {
-      std::cout << "no tpc seed" << std::endl;
-      continue;
+      return false;
     }
+  }
+
+  // do not skip TPC only tracks, just set crossing to the nominal zero
+  if (!siseed)
+  {
+    crossing = 0;
+  }
 
-    if (Verbosity() > 0)
+  if (Verbosity() > 1)
+  {
+    if (siseed)
     {
-      if (siseed)
-      {
-        const auto si_position = TrackSeedHelper::get_xyz(siseed);
-        const auto tpc_position = TrackSeedHelper::get_xyz(tpcseed);
-        std::cout << "    silicon seed position is (x,y,z) = " << si_position.x() << "  " << si_position.y() << "  " << si_position.z() << std::endl;
-        std::cout << "    tpc seed position is (x,y,z) = " << tpc_position.x() << "  " << tpc_position.y() << "  " << tpc_position.z() << std::endl;
-      }
+      std::cout << "tpc and si id " << tpcid << ", " << siid << " silicon_crossing " << silicon_crossing
+                << " crossing " << crossing << " crossing estimate " << crossing_estimate << std::endl;
     }
+  }
+
+  auto tpcseed = m_tpcSeeds->get(tpcid);
 
-    PHTimer trackTimer("TrackTimer");
-    trackTimer.stop();
-    trackTimer.restart();
+  /// Need to also check that the tpc seed wasn't removed by the ghost finder
+  if (!tpcseed)
+  {
+    std::cout << "no tpc seed" << std::endl;
+    return false;
+  }
 
-    if (Verbosity() > 1 && siseed)
+  if (Verbosity() > 0)
+  {
+    if (siseed)
     {
-      std::cout << " m_pp_mode " << m_pp_mode << " m_enable_crossing_estimate " << m_enable_crossing_estimate
-        << " INTT crossing " << crossing << " crossing_estimate " << crossing_estimate << std::endl;
+      const auto si_position = TrackSeedHelper::get_xyz(siseed);
+      const auto tpc_position = TrackSeedHelper::get_xyz(tpcseed);
+      std::cout << "    silicon seed position is (x,y,z) = " << si_position.x() << "  " << si_position.y() << "  " << si_position.z() << std::endl;
+      std::cout << "    tpc seed position is (x,y,z) = " << tpc_position.x() << "  " << tpc_position.y() << "  " << tpc_position.z() << std::endl;
     }
+  }
 
-    short int this_crossing = crossing;
-    bool use_estimate = false;
-    short int nvary = 0;
-    std::vector<float> chisq_ndf;
-    std::vector<SvtxTrack_v4> svtx_vec;
-
-    if(m_pp_mode)
-      {
-	if (m_enable_crossing_estimate && crossing == SHRT_MAX)
-	  {
-	    // this only happens if there is a silicon seed but no assigned INTT crossing, and only in pp_mode
-	    // If there is no INTT crossing, start with the crossing_estimate value, vary up and down, fit, and choose the best chisq/ndf
-	    use_estimate = true;
-	    nvary = max_bunch_search;
-	    if (Verbosity() > 1)
-	      {
-		std::cout << " No INTT crossing: use crossing_estimate " << crossing_estimate << " with nvary " << nvary << std::endl;
-	      }
-	  }
-	else
-	  {
-	    // use INTT crossing
-	    crossing_estimate = crossing;
-	  }
-      }
-    else
-      {
-	// non pp mode, we want only crossing zero, veto others
-	if(siseed && silicon_crossing != 0)
-	  {
-	    continue;
-	  }
-	crossing_estimate = crossing;
-      }
+  if (Verbosity() > 1 && siseed)
+  {
+    std::cout << " m_pp_mode " << m_pp_mode << " m_enable_crossing_estimate " << m_enable_crossing_estimate
+              << " INTT crossing " << crossing << " crossing_estimate " << crossing_estimate << std::endl;
+  }
 
-    // Fit this track assuming either:
-    //    crossing = INTT value, if it exists (uses nvary = 0)
-    //    crossing = crossing_estimate +/- max_bunch_search, if no INTT value exists and m_enable_crossing_estimate flag is set.
+  bool use_estimate = false;
+  short int nvary = 0;
 
-    for (short int ivary = -nvary; ivary <= nvary; ++ivary)
+  if (m_pp_mode)
+  {
+    if (m_enable_crossing_estimate && crossing == SHRT_MAX)
     {
-      this_crossing = crossing_estimate + ivary;
-
+      // this only happens if there is a silicon seed but no assigned INTT crossing, and only in pp_mode
+      // If there is no INTT crossing, start with the crossing_estimate value, vary up and down, fit, and choose the best chisq/ndf
+      use_estimate = true;
+      nvary = max_bunch_search;
       if (Verbosity() > 1)
       {
-        std::cout << "   nvary " << nvary << " trial fit with ivary " << ivary << " this_crossing = " << this_crossing << std::endl;
+        std::cout << " No INTT crossing: use crossing_estimate " << crossing_estimate << " with nvary " << nvary << std::endl;
       }
+    }
+    else
+    {
+      // use INTT crossing
+      crossing_estimate = crossing;
+    }
+  }
+  else
+  {
+    // non pp mode, we want only crossing zero, veto others
+    if (siseed && silicon_crossing != 0)
+    {
+      return false;
+    }
+    crossing_estimate = crossing;
+  }
 
-      ActsTrackFittingAlgorithm::MeasurementContainer measurements;
+  // Fit this track assuming either:
+  //    crossing = INTT value, if it exists (uses nvary = 0)
+  //    crossing = crossing_estimate +/- max_bunch_search, if no INTT value exists and m_enable_crossing_estimate flag is set.
+  seedfit.siseed = siseed;
+  seedfit.tpcseed = tpcseed;
+  seedfit.use_estimate = use_estimate;
+  seedfit.nvary = nvary;
+  seedfit.crossing_estimate = crossing_estimate;
+  seedfit.skip = false;
+  return true;
+}
 
-      SourceLinkVec sourceLinks;
+void PHActsTrkFitter::fitTrial(const SeedFit& seedfit, short int ivary, FitTrial& trial)
+{
+  auto siseed = seedfit.siseed;
+  auto tpcseed = seedfit.tpcseed;
 
-      MakeSourceLinks makeSourceLinks;
-      makeSourceLinks.initialize(_tpccellgeo);
-      makeSourceLinks.setVerbosity(Verbosity());
-      makeSourceLinks.set_pp_mode(m_pp_mode);
+  short int this_crossing = seedfit.crossing_estimate + ivary;
+  trial.crossing = this_crossing;
 
-      // loop over modifiedTransformSet and replace transient elements modified for the previous track with the default transforms
-      // does nothing if m_transient_id_set is empty
-      makeSourceLinks.resetTransientTransformMap(
-        m_alignmentTransformationMapTransient,
-        m_transient_id_set,
-        m_tGeometry);
+  if (Verbosity() > 1)
+  {
+    std::cout << "   nvary " << seedfit.nvary << " trial fit with ivary " << ivary << " this_crossing = " << this_crossing << std::endl;
+  }
 
-      // make source links using cluster mover
-      if (m_use_clustermover)
-      {
-        if (siseed && !m_ignoreSilicon)
-        {
-          // silicon source links
-          sourceLinks = makeSourceLinks.getSourceLinksClusterMover(
-            siseed,
-            measurements,
-            m_clusterContainer,
-            m_tGeometry,
-            m_globalPositionWrapper,
-            this_crossing);
-        }
+  auto& measurements = trial.measurements;
+
+  SourceLinkVec sourceLinks;
 
-        // tpc source links
-        const auto tpcSourceLinks = makeSourceLinks.getSourceLinksClusterMover(
-          tpcseed,
+  MakeSourceLinks makeSourceLinks;
+  makeSourceLinks.initialize(_tpccellgeo);
+  makeSourceLinks.setVerbosity(Verbosity());
+  makeSourceLinks.set_pp_mode(m_pp_mode);
+
+  // make source links using cluster mover
+  if (m_use_clustermover)
+  {
+    if (siseed && !m_ignoreSilicon)
+    {
+      // silicon source links
+      sourceLinks = makeSourceLinks.getSourceLinksClusterMover(
+          siseed,
           measurements,
           m_clusterContainer,
           m_tGeometry,
           m_globalPositionWrapper,
           this_crossing);
+    }
 
-        // add silicon seeds
-        sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
-      }
-      else
-      {
-        if (siseed && !m_ignoreSilicon)
-        {
-          // silicon source links
-          sourceLinks = makeSourceLinks.getSourceLinks(
-            siseed,
-            measurements,
-            m_clusterContainer,
-            m_tGeometry,
-            m_globalPositionWrapper,
-            m_alignmentTransformationMapTransient,
-            m_transient_id_set,
-            this_crossing);
-        }
+    // tpc source links
+    const auto tpcSourceLinks = makeSourceLinks.getSourceLinksClusterMover(
+        tpcseed,
+        measurements,
+        m_clusterContainer,
+        m_tGeometry,
+        m_globalPositionWrapper,
+        this_crossing);
+
+    // add silicon seeds
+    sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
+  }
+  else
+  {
+    // loop over modifiedTransformSet and replace transient elements modified for the previous track with the default transforms
+    // does nothing if m_transient_id_set is empty. Only the source links without cluster mover modify the transient map
+    makeSourceLinks.resetTransientTransformMap(
+        m_alignmentTransformationMapTransient,
+        m_transient_id_set,
+        m_tGeometry);
 
-        // tpc source links
-        const auto tpcSourceLinks = makeSourceLinks.getSourceLinks(
-          tpcseed,
+    if (siseed && !m_ignoreSilicon)
+    {
+      // silicon source links
+      sourceLinks = makeSourceLinks.getSourceLinks(
+          siseed,
           measurements,
           m_clusterContainer,
           m_tGeometry,
@@ -493,261 +582,277 @@ void PHActsTrkFitter::loopTracks(Acts::Logging::Level logLevel)
           m_alignmentTransformationMapTransient,
           m_transient_id_set,
           this_crossing);
+    }
 
-        // insert silicons
-        sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
-      }
+    // tpc source links
+    const auto tpcSourceLinks = makeSourceLinks.getSourceLinks(
+        tpcseed,
+        measurements,
+        m_clusterContainer,
+        m_tGeometry,
+        m_globalPositionWrapper,
+        m_alignmentTransformationMapTransient,
+        m_transient_id_set,
+        this_crossing);
 
-      // copy transient map for this track into transient geoContext
-      m_transient_geocontext = m_alignmentTransformationMapTransient;
+    // insert silicons
+    sourceLinks.insert(sourceLinks.end(), tpcSourceLinks.begin(), tpcSourceLinks.end());
+  }
 
-      // position comes from the silicon seed, unless there is no silicon seed
-      Acts::Vector3 position(0, 0, 0);
-      if (siseed)
-      {
-        position = TrackSeedHelper::get_xyz(siseed)*Acts::UnitConstants::cm;
-      }
-      if(!siseed || !is_valid(position) || m_ignoreSilicon)
-      {
-        position = TrackSeedHelper::get_xyz(tpcseed)*Acts::UnitConstants::cm;
-      }
-      if (!is_valid(position))
-      {
-       if(Verbosity() > 4)
-        {
-          std::cout << "Invalid position of " << position.transpose() << std::endl;
-        }
-        continue;
-      }
+  // copy transient map for this track into transient geoContext
+  trial.geocontext = m_alignmentTransformationMapTransient;
 
-      if (sourceLinks.empty())
-      {
-        continue;
-      }
+  // position comes from the silicon seed, unless there is no silicon seed
+  Acts::Vector3 position(0, 0, 0);
+  if (siseed)
+  {
+    position = TrackSeedHelper::get_xyz(siseed) * Acts::UnitConstants::cm;
+  }
+  if (!siseed || !is_valid(position) || m_ignoreSilicon)
+  {
+    position = TrackSeedHelper::get_xyz(tpcseed) * Acts::UnitConstants::cm;
+  }
+  if (!is_valid(position))
+  {
+    if (Verbosity() > 4)
+    {
+      std::cout << "Invalid position of " << position.transpose() << std::endl;
+    }
+    return;
+  }
 
-      /// If using directed navigation, collect surface list to navigate
-      SurfacePtrVec surfaces;
-      if (m_fitSiliconMMs)
-      {
-        sourceLinks = getSurfaceVector(sourceLinks, surfaces);
+  if (sourceLinks.empty())
+  {
+    return;
+  }
 
-        // skip if there is no surfaces
-        if (surfaces.empty())
-        {
-          continue;
-        }
+  /// If using directed navigation, collect surface list to navigate
+  SurfacePtrVec surfaces;
+  if (m_fitSiliconMMs)
+  {
+    sourceLinks = getSurfaceVector(sourceLinks, surfaces);
 
-        // make sure micromegas are in the tracks, if required
-        if (m_useMicromegas &&
-            std::none_of(surfaces.begin(), surfaces.end(), [this](const auto& surface)
-                         { return m_tGeometry->maps().isMicromegasSurface(surface); }))
-        {
-          continue;
-        }
-      }
+    // skip if there is no surfaces
+    if (surfaces.empty())
+    {
+      return;
+    }
 
-      float px = std::numeric_limits<float>::quiet_NaN();
-      float py = std::numeric_limits<float>::quiet_NaN();
-      float pz = std::numeric_limits<float>::quiet_NaN();
-      if (m_ConstField)
-      {
-        float pt = fabs(1. / tpcseed->get_qOverR()) * (0.3 / 100) * fieldstrength;
-        float phi = tpcseed->get_phi();
-        px = pt * std::cos(phi);
-        py = pt * std::sin(phi);
-        pz = pt * std::cosh(tpcseed->get_eta()) * std::cos(tpcseed->get_theta());
-      }
-      else
-      {
-        px = tpcseed->get_px();
-        py = tpcseed->get_py();
-        pz = tpcseed->get_pz();
-      }
+    // make sure micromegas are in the tracks, if required
+    if (m_useMicromegas &&
+        std::none_of(surfaces.begin(), surfaces.end(), [this](const auto& surface)
+                     { return m_tGeometry->maps().isMicromegasSurface(surface); }))
+    {
+      return;
+    }
+  }
 
-      Acts::Vector3 momentum(px, py, pz);
-      if (!is_valid(momentum))
-      {
-        if(Verbosity() > 4)
-        {
-          std::cout << "Invalid momentum of " << momentum.transpose() << std::endl;
-        }
-        continue;
-      }
+  float px = std::numeric_limits<float>::quiet_NaN();
+  float py = std::numeric_limits<float>::quiet_NaN();
+  float pz = std::numeric_limits<float>::quiet_NaN();
+  if (m_ConstField)
+  {
+    float pt = fabs(1. / tpcseed->get_qOverR()) * (0.3 / 100) * fieldstrength;
+    float phi = tpcseed->get_phi();
+    px = pt * std::cos(phi);
+    py = pt * std::sin(phi);
+    pz = pt * std::cosh(tpcseed->get_eta()) * std::cos(tpcseed->get_theta());
+  }
+  else
+  {
+    px = tpcseed->get_px();
+    py = tpcseed->get_py();
+    pz = tpcseed->get_pz();
+  }
+
+  Acts::Vector3 momentum(px, py, pz);
+  if (!is_valid(momentum))
+  {
+    if (Verbosity() > 4)
+    {
+      std::cout << "Invalid momentum of " << momentum.transpose() << std::endl;
+    }
+    return;
+  }
 
-      auto pSurface = Acts::Surface::makeShared<Acts::PerigeeSurface>(
-          position);
+  auto pSurface = Acts::Surface::makeShared<Acts::PerigeeSurface>(
+      position);
 
-      auto actsFourPos = Acts::Vector4(position(0), position(1),
-                                       position(2),
-                                       10 * Acts::UnitConstants::ns);
-      Acts::BoundSquareMatrix cov = setDefaultCovariance();
+  auto actsFourPos = Acts::Vector4(position(0), position(1),
+                                   position(2),
+                                   10 * Acts::UnitConstants::ns);
+  Acts::BoundSquareMatrix cov = setDefaultCovariance();
 
-      int charge = tpcseed->get_charge();
+  int charge = tpcseed->get_charge();
 
-      /// Reset the track seed with the dummy covariance
-      auto seed = ActsTrackFittingAlgorithm::TrackParameters::create(
-                      pSurface,
-                      m_transient_geocontext,
-                      actsFourPos,
-                      momentum,
-                      charge / momentum.norm(),
-                      cov,
-                      Acts::ParticleHypothesis::pion())
-                      .value();
+  /// Reset the track seed with the dummy covariance
+  auto seed = ActsTrackFittingAlgorithm::TrackParameters::create(
+                  pSurface,
+                  trial.geocontext,
+                  actsFourPos,
+                  momentum,
+                  charge / momentum.norm(),
+                  cov,
+                  Acts::ParticleHypothesis::pion())
+                  .value();
 
-      if (Verbosity() > 2)
-      {
-        printTrackSeed(seed);
-      }
+  if (Verbosity() > 2)
+  {
+    printTrackSeed(seed);
+  }
 
-      /// Set host of propagator options for Acts to do e.g. material integration
-      Acts::PropagatorPlainOptions ppPlainOptions;
+  /// Set host of propagator options for Acts to do e.g. material integration
+  Acts::PropagatorPlainOptions ppPlainOptions;
 
-      auto calibptr = std::make_unique<Calibrator>();
-      CalibratorAdapter calibrator{*calibptr, measurements};
+  // calibrator and fitter options are created per fit, the fitter functions
+  // themselves are stateless so several fits can run concurrently
+  auto calibptr = std::make_unique<Calibrator>();
+  CalibratorAdapter calibrator{*calibptr, measurements};
 
-      auto magcontext = m_tGeometry->geometry().magFieldContext;
-      auto calibcontext = m_tGeometry->geometry().calibContext;
+  auto magcontext = m_tGeometry->geometry().magFieldContext;
+  auto calibcontext = m_tGeometry->geometry().calibContext;
 
-      ActsTrackFittingAlgorithm::GeneralFitterOptions
-          kfOptions{
-              m_transient_geocontext,
-              magcontext,
-              calibcontext,
-              pSurface.get(),
-              ppPlainOptions};
+  ActsTrackFittingAlgorithm::GeneralFitterOptions
+      kfOptions{
+          trial.geocontext,
+          magcontext,
+          calibcontext,
+          pSurface.get(),
+          ppPlainOptions};
 
-      PHTimer fitTimer("FitTimer");
-      fitTimer.stop();
-      fitTimer.restart();
+  PHTimer fitTimer("FitTimer");
+  fitTimer.stop();
+  fitTimer.restart();
 
-      auto trackContainer =
-          std::make_shared<Acts::VectorTrackContainer>();
-      auto trackStateContainer =
-          std::make_shared<Acts::VectorMultiTrajectory>();
-      ActsTrackFittingAlgorithm::TrackContainer
-          tracks(trackContainer, trackStateContainer);
+  trial.result.emplace(fitTrack(sourceLinks, seed, kfOptions,
+                                surfaces, calibrator, trial.tracks));
+  fitTimer.stop();
+  auto fitTime = fitTimer.get_accumulated_time();
 
-      auto result = fitTrack(sourceLinks, seed, kfOptions,
-                             surfaces, calibrator, tracks);
-      fitTimer.stop();
-      auto fitTime = fitTimer.get_accumulated_time();
+  if (Verbosity() > 1)
+  {
+    std::cout << "PHActsTrkFitter Acts fit time " << fitTime << std::endl;
+  }
+}
 
-      if (Verbosity() > 1)
+void PHActsTrkFitter::storeTrial(SeedFit& seedfit, short int ivary, FitTrial& trial)
+{
+  if (!trial.result)
+  {
+    // the trial was skipped before the fit
+    return;
+  }
+
+  auto track = seedfit.track;
+  auto siseed = seedfit.siseed;
+  auto tpcseed = seedfit.tpcseed;
+  const short int this_crossing = trial.crossing;
+  auto& result = *trial.result;
+  auto& tracks = trial.tracks;
+  auto& measurements = trial.measurements;
+
+  // the fitted track parameters are converted in the geometry context of this fit
+  m_transient_geocontext = trial.geocontext;
+
+  /// Check that the track fit result did not return an error
+  if (result.ok())
+  {
+    if (seedfit.use_estimate)  // trial variation case
+    {
+      // this is a trial variation of the crossing estimate for this track
+      // Capture the chisq/ndf so we can choose the best one after all trials
+
+      SvtxTrack_v4 newTrack;
+      newTrack.set_tpc_seed(tpcseed);
+      newTrack.set_crossing(this_crossing);
+      newTrack.set_silicon_seed(siseed);
+
+      if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
       {
-        std::cout << "PHActsTrkFitter Acts fit time " << fitTime << std::endl;
+        float chi2ndf = newTrack.get_quality();
+        seedfit.chisq_ndf.push_back(chi2ndf);
+        seedfit.svtx_vec.push_back(newTrack);
+        if (Verbosity() > 1)
+        {
+          std::cout << "   tpcid " << seedfit.tpcid << " siid " << seedfit.siid << " ivary " << ivary << " this_crossing " << this_crossing << " chi2ndf " << chi2ndf << std::endl;
+        }
       }
 
-      /// Check that the track fit result did not return an error
-      if (result.ok())
+      if (ivary != seedfit.nvary)
       {
-        if (use_estimate)  // trial variation case
+        if (Verbosity() > 3)
         {
-          // this is a trial variation of the crossing estimate for this track
-          // Capture the chisq/ndf so we can choose the best one after all trials
-
-          SvtxTrack_v4 newTrack;
-          newTrack.set_tpc_seed(tpcseed);
-          newTrack.set_crossing(this_crossing);
-          newTrack.set_silicon_seed(siseed);
-
-          if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
-          {
-            float chi2ndf = newTrack.get_quality();
-            chisq_ndf.push_back(chi2ndf);
-            svtx_vec.push_back(newTrack);
-            if (Verbosity() > 1)
-            {
-              std::cout << "   tpcid " << tpcid << " siid " << siid << " ivary " << ivary << " this_crossing " << this_crossing << " chi2ndf " << chi2ndf << std::endl;
-            }
-          }
-
-          if (ivary != nvary)
-          {
-            if(Verbosity() > 3)
-            {
-              std::cout << "Skipping track fit for trial variation" << std::endl;
-            }
-            continue;
-          }
-
-          // if we are here this is the last crossing iteration, evaluate the results
-          if (Verbosity() > 1)
-          {
-            std::cout << "Finished with trial fits, chisq_ndf size is " << chisq_ndf.size() << " chisq_ndf values are:" << std::endl;
-          }
-          float best_chisq = 1000.0;
-          short int best_ivary = 0;
-          for (unsigned int i = 0; i < chisq_ndf.size(); ++i)
-          {
-            if (chisq_ndf[i] < best_chisq)
-            {
-              best_chisq = chisq_ndf[i];
-              best_ivary = i;
-            }
-            if (Verbosity() > 1)
-            {
-              std::cout << "  trial " << i << " chisq_ndf " << chisq_ndf[i] << " best_chisq " << best_chisq << " best_ivary " << best_ivary << std::endl;
-            }
-          }
-          unsigned int trid = m_trackMap->size();
-          svtx_vec[best_ivary].set_id(trid);
-
-          m_trackMap->insertWithKey(&svtx_vec[best_ivary], trid);
+          std::cout << "Skipping track fit for trial variation" << std::endl;
         }
-        else  // case where INTT crossing is known
-        {
-          SvtxTrack_v4 newTrack;
-          newTrack.set_tpc_seed(tpcseed);
-          newTrack.set_crossing(this_crossing);
-          newTrack.set_silicon_seed(siseed);
-
-          if (m_fitSiliconMMs)
-          {
-            unsigned int trid = m_directedTrackMap->size();
-            newTrack.set_id(trid);
-
-            if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
-            {
-              m_directedTrackMap->insertWithKey(&newTrack, trid);
-            }
-          }  // end insert track for SC calib fit
-          else
-          {
-            unsigned int trid = m_trackMap->size();
-            newTrack.set_id(trid);
-
-            if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
-            {
-              m_trackMap->insertWithKey(&newTrack, trid);
-            }
-          }  // end insert track for normal fit
-        }    // end case where INTT crossing is known
+        return;
       }
-      else if (!m_fitSiliconMMs)
+
+      // if we are here this is the last crossing iteration, evaluate the results
+      const auto& chisq_ndf = seedfit.chisq_ndf;
+      if (Verbosity() > 1)
       {
-        /// Track fit failed, get rid of the track from the map
-        m_nBadFits++;
+        std::cout << "Finished with trial fits, chisq_ndf size is " << chisq_ndf.size() << " chisq_ndf values are:" << std::endl;
+      }
+      float best_chisq = 1000.0;
+      short int best_ivary = 0;
+      for (unsigned int i = 0; i < chisq_ndf.size(); ++i)
+      {
+        if (chisq_ndf[i] < best_chisq)
+        {
+          best_chisq = chisq_ndf[i];
+          best_ivary = i;
+        }
         if (Verbosity() > 1)
         {
-          std::cout << "Track fit failed for track " << m_seedMap->find(track)
-                    << " with Acts error message "
-                    << result.error() << ", " << result.error().message()
-                    << std::endl;
+          std::cout << "  trial " << i << " chisq_ndf " << chisq_ndf[i] << " best_chisq " << best_chisq << " best_ivary " << best_ivary << std::endl;
         }
-      }  // end fit failed case
-    }    // end ivary loop
+      }
+      unsigned int trid = m_trackMap->size();
+      seedfit.svtx_vec[best_ivary].set_id(trid);
 
-    trackTimer.stop();
-    auto trackTime = trackTimer.get_accumulated_time();
+      m_trackMap->insertWithKey(&seedfit.svtx_vec[best_ivary], trid);
+    }
+    else  // case where INTT crossing is known
+    {
+      SvtxTrack_v4 newTrack;
+      newTrack.set_tpc_seed(tpcseed);
+      newTrack.set_crossing(this_crossing);
+      newTrack.set_silicon_seed(siseed);
+
+      if (m_fitSiliconMMs)
+      {
+        unsigned int trid = m_directedTrackMap->size();
+        newTrack.set_id(trid);
 
+        if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
+        {
+          m_directedTrackMap->insertWithKey(&newTrack, trid);
+        }
+      }  // end insert track for SC calib fit
+      else
+      {
+        unsigned int trid = m_trackMap->size();
+        newTrack.set_id(trid);
+
+        if (getTrackFitResult(result, track, &newTrack, tracks, measurements))
+        {
+          m_trackMap->insertWithKey(&newTrack, trid);
+        }
+      }  // end insert track for normal fit
+    }    // end case where INTT crossing is known
+  }
+  else if (!m_fitSiliconMMs)
+  {
+    /// Track fit failed, get rid of the track from the map
+    m_nBadFits++;
     if (Verbosity() > 1)
     {
-      std::cout << "PHActsTrkFitter total single track time " << trackTime << std::endl;
+      std::cout << "Track fit failed for track " << m_seedMap->find(track)
+                << " with Acts error message "
+                << result.error() << ", " << result.error().message()
+                << std::endl;
     }
-  }
-
-  return;
+  }  // end fit failed case
 }
 
 bool PHActsTrkFitter::getTrackFitResult(FitResult& fitOutput,
@@ -16,10 +16,14 @@
 #include <trackbase/ActsSourceLink.h>
 #include <trackbase/ActsTrackFittingAlgorithm.h>
 
+#include <trackbase_historic/SvtxTrack_v4.h>
+
 #include <tpc/TpcGlobalPositionWrapper.h>
 
 #include <Acts/Definitions/Algebra.hpp>
 #include <Acts/EventData/VectorMultiTrajectory.hpp>
+#include <Acts/EventData/VectorTrackContainer.hpp>
+#include <Acts/Geometry/GeometryContext.hpp>
 #include <Acts/Utilities/BinnedArray.hpp>
 #include <Acts/Utilities/Logger.hpp>
 
@@ -28,8 +32,13 @@
 #include <TFile.h>
 #include <TH1.h>
 #include <TH2.h>
+
+#include <cstddef>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 class alignmentTransformationContainer;
 class ActsGeometry;
@@ -40,6 +49,7 @@ class TrackSeedContainer;
 class TrkrClusterContainer;
 class SvtxAlignmentStateMap;
 class PHG4TpcCylinderGeomContainer;
+class PHThreadPool;
 
 using SourceLink = ActsSourceLink;
 using FitResult = ActsTrackFittingAlgorithm::TrackFitterResult;
@@ -55,7 +65,7 @@ class PHActsTrkFitter : public SubsysReco
   PHActsTrkFitter(const std::string& name = "PHActsTrkFitter");
 
   /// Destructor
-  ~PHActsTrkFitter() override = default;
+  ~PHActsTrkFitter() override;
 
   /// End, write and close files
   int End(PHCompositeNode* topNode) override;
@@ -122,6 +132,10 @@ class PHActsTrkFitter : public SubsysReco
   void set_use_clustermover(bool use) { m_use_clustermover = use; }
   void ignoreLayer(int layer) { m_ignoreLayer.insert(layer); }
 
+  /// number of threads for the track fits. 1 (default) fits in the main thread,
+  /// 0 uses all hardware threads. Results are identical to the serial fit
+  void set_num_threads(unsigned int n) { m_num_threads = n; }
+
  private:
   /// Get all the nodes
   int getNodes(PHCompositeNode* topNode);
@@ -129,8 +143,57 @@ class PHActsTrkFitter : public SubsysReco
   /// Create new nodes
   int createNodes(PHCompositeNode* topNode);
 
+  /// fit of one seed for one bunch crossing hypothesis
+  struct FitTrial
+  {
+    FitTrial()
+      : tracks(std::make_shared<Acts::VectorTrackContainer>(),
+               std::make_shared<Acts::VectorMultiTrajectory>())
+    {
+    }
+    short int crossing = 0;
+    Acts::GeometryContext geocontext;
+    ActsTrackFittingAlgorithm::MeasurementContainer measurements;
+    ActsTrackFittingAlgorithm::TrackContainer tracks;
+
+    /// empty if the seed was rejected before the fit
+    std::optional<FitResult> result;
+  };
+
+  /// all crossing hypotheses of one seed
+  struct SeedFit
+  {
+    bool skip = true;
+    TrackSeed* track = nullptr;
+    TrackSeed* siseed = nullptr;
+    TrackSeed* tpcseed = nullptr;
+    unsigned int tpcid = 0;
+    unsigned int siid = 0;
+    bool use_estimate = false;
+    short int nvary = 0;
+    short int crossing_estimate = 0;
+
+    /// trials in crossing order. The fit results point to the track container
+    /// of their trial, the deque never moves them
+    std::deque<FitTrial> trials;
+
+    /// fitted trial tracks when the crossing is estimated
+    std::vector<float> chisq_ndf;
+    std::vector<SvtxTrack_v4> svtx_vec;
+  };
+
   void loopTracks(Acts::Logging::Level logLevel);
 
+  /// crossing hypotheses for a seed, returns false if the seed is not fitted
+  bool prepareSeed(TrackSeed* track, SeedFit& seedfit) const;
+
+  /// make source links and run the fit for crossing estimate + ivary.
+  /// Does not modify the node tree, so it can run in a worker thread
+  void fitTrial(const SeedFit& seedfit, short int ivary, FitTrial& trial);
+
+  /// convert a trial fit to an SvtxTrack and store it, must run in seed order
+  void storeTrial(SeedFit& seedfit, short int ivary, FitTrial& trial);
+
   /// Convert the acts track fit result to an svtx track
   void updateSvtxTrack(std::vector<Acts::MultiTrajectoryTraits::IndexType>& tips,
                        Trajectory::IndexedParameters& paramsMap,
@@ -251,6 +314,14 @@ class PHActsTrkFitter : public SubsysReco
 
   PHG4TpcCylinderGeomContainer* _tpccellgeo = nullptr;
 
+  /// worker threads for the fits, only created if m_num_threads != 1
+  std::unique_ptr<PHThreadPool> m_threadpool;
+  unsigned int m_num_threads = 1;
+
+  /// number of seeds fitted in parallel before their results are stored.
+  /// Limits the memory held by fit results
+  static constexpr std::size_t m_seedBlockSize = 512;
+
   /// Variables for doing event time execution analysis
   bool m_timeAnalysis = false;
   TFile* m_timeFile = nullptr;
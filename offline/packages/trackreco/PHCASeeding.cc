@@ -13,6 +13,7 @@
 // sPHENIX includes
 #include <fun4all/Fun4AllReturnCodes.h>
 
+#include <phool/PHThreadPool.h>
 #include <phool/PHTimer.h>  // for PHTimer
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
@@ -143,6 +144,49 @@ namespace
   /*   return std::log((norm + position.z()) / (norm - position.z())) / 2; */
   /* } */
 
+  /// true if point is inside the (phi, z) window, with the same wrapping in phi as PHCASeeding::QueryTree
+  bool in_window(const PHCASeeding::point& p, double phimin, double z_min, double phimax, double z_max)
+  {
+    using box = PHCASeeding::box;
+    using point = PHCASeeding::point;
+    bool query_both_ends = false;
+    if (phimin < 0)
+    {
+      query_both_ends = true;
+      phimin += 2 * M_PI;
+    }
+    if (phimax > 2 * M_PI)
+    {
+      query_both_ends = true;
+      phimax -= 2 * M_PI;
+    }
+    if (query_both_ends)
+    {
+      return bg::intersects(p, box(point(phimin, z_min), point(2 * M_PI, z_max))) ||
+             bg::intersects(p, box(point(0., z_min), point(phimax, z_max)));
+    }
+    return bg::intersects(p, box(point(phimin, z_min), point(phimax, z_max)));
+  }
+
+  /// clusters, search tree and links of one TPC layer, used in PHCASeeding::CreateBiLinks
+  struct SeedingLayer
+  {
+    /// clusters, without duplicates
+    std::vector<PHCASeeding::coordKey> coords;
+
+    /// search tree
+    bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>> rtree;
+
+    /// number of duplicate clusters
+    int n_duplicates = 0;
+
+    /// links from clusters in this layer to clusters in the layer below
+    std::unordered_set<PHCASeeding::keyLink> downlinks;
+
+    /// for each cluster in coords, sorted keys of the clusters it links to in the layer above
+    std::vector<PHCASeeding::keyList> uplinks;
+  };
+
   inline double breaking_angle(double x1, double y1, double z1, double x2, double y2, double z2)
   {
     double l1 = sqrt(x1 * x1 + y1 * y1 + z1 * z1);
@@ -187,6 +231,8 @@ PHCASeeding::PHCASeeding(
 {
 }
 
+PHCASeeding::~PHCASeeding() = default;
+
 int PHCASeeding::InitializeGeometry(PHCompositeNode* topNode)
 {
   // geometry
@@ -274,48 +320,102 @@ std::pair<PHCASeeding::PositionMap, PHCASeeding::keyListPerLayer> PHCASeeding::F
   return std::make_pair(cachedPositions, ckeys);
 }
 
-std::vector<PHCASeeding::coordKey> PHCASeeding::FillTree(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& _rtree, const PHCASeeding::keyList& ckeys, const PHCASeeding::PositionMap& globalPositions, const int layer)
+std::vector<PHCASeeding::coordKey> PHCASeeding::FillTree(bgi::rtree<PHCASeeding::pointKey, bgi::quadratic<16>>& _rtree, const PHCASeeding::keyList& ckeys, const PHCASeeding::PositionMap& globalPositions, int& n_dupli) const
 {
   // Fill _rtree with the clusters in ckeys; remove duplicates, and return a vector of the coordKeys
-  // Note that layer is only used for a cout statement
-  int n_dupli = 0;
-  std::vector<coordKey> coords;
-  _rtree.clear();
-  /* _rtree.reserve(ckeys.size()); */
-  for (const auto& ckey : ckeys)
+  // A cluster is a duplicate if an earlier, kept cluster is inside the +/-1e-5 (phi,z) window around it,
+  // which gives the same clusters as querying the tree before inserting each cluster.
+  // The tree is then bulk loaded with the packing algorithm, which is faster than inserting clusters one by one
+  constexpr double window = 0.00001;
+
+  // candidates for duplicates must be closer than this in phi. It is larger than the window to be safe against rounding
+  constexpr double margin = 10 * window;
+
+  const size_t nclus = ckeys.size();
+  std::vector<double> phis(nclus);
+  std::vector<double> zs(nclus);
+  std::vector<point> points(nclus);
+  for (size_t i = 0; i < nclus; ++i)
+  {
+    const auto& globalpos_d = globalPositions.at(ckeys[i]);
+    phis[i] = get_phi(globalpos_d);
+    zs[i] = globalpos_d.z();
+    points[i] = point(phis[i], zs[i]);
+  }
+
+  // sort by phi to find candidates
+  std::vector<size_t> order(nclus);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&phis](size_t a, size_t b)
+            { return phis[a] < phis[b] || (phis[a] == phis[b] && a < b); });
+  std::vector<size_t> rank(nclus);
+  for (size_t r = 0; r < nclus; ++r)
+  {
+    rank[order[r]] = r;
+  }
+
+  n_dupli = 0;
+  std::vector<bool> kept(nclus, false);
+  for (size_t i = 0; i < nclus; ++i)
   {
-    const auto& globalpos_d = globalPositions.at(ckey);
-    const double clus_phi = get_phi(globalpos_d);
-    const double clus_z = globalpos_d.z();
-    if (Verbosity() > 5)
+    const double clus_phi = phis[i];
+    const double clus_z = zs[i];
+    const auto is_duplicate_of = [&](size_t j)
     {
-      /* int layer = TrkrDefs::getLayer(ckey); */
-      std::cout << "Found cluster " << ckey << " in layer " << layer << std::endl;
+      return j < i && kept[j] && in_window(points[j], clus_phi - window, clus_z - window, clus_phi + window, clus_z + window);
+    };
+
+    bool duplicate = false;
+    for (size_t r = rank[i] + 1; !duplicate && r < nclus && phis[order[r]] - clus_phi < margin; ++r)
+    {
+      duplicate = is_duplicate_of(order[r]);
+    }
+    for (size_t r = rank[i]; !duplicate && r > 0 && clus_phi - phis[order[r - 1]] < margin; --r)
+    {
+      duplicate = is_duplicate_of(order[r - 1]);
+    }
+
+    // across 2pi
+    if (clus_phi < margin)
+    {
+      for (size_t r = nclus; !duplicate && r > 0 && phis[order[r - 1]] - 2 * M_PI - clus_phi > -margin; --r)
+      {
+        duplicate = is_duplicate_of(order[r - 1]);
+      }
+    }
+    if (clus_phi > 2 * M_PI - margin)
+    {
+      for (size_t r = 0; !duplicate && r < nclus && phis[order[r]] + 2 * M_PI - clus_phi < margin; ++r)
+      {
+        duplicate = is_duplicate_of(order[r]);
+      }
     }
-    std::vector<pointKey> testduplicate;
-    QueryTree(_rtree, clus_phi - 0.00001, clus_z - 0.00001, clus_phi + 0.00001, clus_z + 0.00001, testduplicate);
-    if (!testduplicate.empty())
+
+    if (duplicate)
     {
       ++n_dupli;
-      continue;
     }
-    coords.push_back({{static_cast<float>(clus_phi), static_cast<float>(clus_z)}, ckey});
-    t_fill->restart();
-    _rtree.insert(std::make_pair(point(clus_phi, globalpos_d.z()), ckey));
-    t_fill->stop();
-  }
-  if (Verbosity() > 5)
-  {
-    std::cout << "nhits in layer(" << layer << "): " << coords.size() << std::endl;
-  }
-  if (Verbosity() > 3)
-  {
-    std::cout << "fill time: " << t_fill->get_accumulated_time() / 1000. << " sec" << std::endl;
+    else
+    {
+      kept[i] = true;
+    }
   }
-  if (Verbosity() > 3)
+
+  std::vector<coordKey> coords;
+  std::vector<pointKey> values;
+  coords.reserve(nclus - n_dupli);
+  values.reserve(nclus - n_dupli);
+  for (size_t i = 0; i < nclus; ++i)
   {
-    std::cout << "number of duplicates : " << n_dupli << std::endl;
+    if (kept[i])
+    {
+      coords.push_back({{static_cast<float>(phis[i]), static_cast<float>(zs[i])}, ckeys[i]});
+      values.emplace_back(points[i], ckeys[i]);
+    }
   }
+
+  // packing constructor
+  _rtree = bgi::rtree<pointKey, bgi::quadratic<16>>(values.begin(), values.end());
   return coords;
 }
 
@@ -394,73 +494,73 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
   keyLinks startLinks;        // bilinks at start of chains
   keyLinkPerLayer bodyLinks;  //  bilinks to build chains
                               //
-  double cluster_find_time = 0;
-  double rtree_query_time = 0;
-  double transform_time = 0;
-  double compute_best_angle_time = 0;
-  double set_insert_time = 0;
-
-  // there are three coord_array (only the current layer is used at a time,
-  // but it is filled the same time as the _rtrees, which are used two at
-  // a time -- the prior padplane row and the next padplain row
-  std::array<std::vector<coordKey>, 3> coord_arr;
-  std::array<std::unordered_set<keyLink>, 2> previous_downlinks_arr;
-  std::array<std::unordered_set<TrkrDefs::cluskey>, 2> bottom_of_bilink_arr;
-
-  // iterate from outer to inner layers
+  // layers are processed from outer to inner
   const int inner_index = _start_layer - _FIRST_LAYER_TPC + 1;
   const int outer_index = _end_layer - _FIRST_LAYER_TPC - 2;
 
-  // fill the current and prior row coord and ttrees for the first iteration
-  int _index_above = (outer_index + 1) % 3;
-  int _index_current = (outer_index) % 3;
-  coord_arr[_index_above] = FillTree(_rtrees[_index_above], ckeys[outer_index + 1], globalPositions, outer_index + 1);
-  coord_arr[_index_current] = FillTree(_rtrees[_index_current], ckeys[outer_index], globalPositions, outer_index);
-
-  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  // run func for all layer indices in [first, last], in parallel if there is a thread pool
+  // each call only writes to its own layer, so no locking is needed
+  const auto for_each_layer = [this](int first, int last, const auto& func)
   {
-    // these lines of code will rotates through all three _rtree's in the array,
-    // where the old lower becomes the new middle, the old middle the new upper,
-    // and the old upper drops out and that _rtree is filled with the new lower
-    const unsigned int LAYER = layer_index + _FIRST_LAYER_TPC;
-    int index_above = (layer_index + 1) % 3;
-    int index_current = (layer_index) % 3;
-    int index_below = (layer_index - 1) % 3;
-
-    coord_arr[index_below] = FillTree(_rtrees[index_below], ckeys[layer_index - 1], globalPositions, layer_index - 1);
-
-    // NO DUPLICATES FOUND IN COORD_ARR
+    if (last < first)
+    {
+      return;
+    }
+    if (!m_threadpool)
+    {
+      for (int layer_index = first; layer_index <= last; ++layer_index)
+      {
+        func(layer_index);
+      }
+      return;
+    }
+    m_threadpool->parallel_for(last - first + 1, [&](size_t task, unsigned int /*worker*/)
+                               { func(first + static_cast<int>(task)); });
+  };
 
-    auto& _rtree_above = _rtrees[index_above];
-    const std::vector<coordKey>& coord = coord_arr[index_current];
-    auto& _rtree_below = _rtrees[index_below];
+  std::vector<SeedingLayer> layers(ckeys.size());
 
-    auto& curr_downlinks = previous_downlinks_arr[layer_index % 2];
-    auto& last_downlinks = previous_downlinks_arr[(layer_index + 1) % 2];
+  // fill the coords and search trees of all layers, including the layers below and above the ones with start clusters
+  for_each_layer(inner_index - 1, outer_index + 1, [&](int layer_index)
+                 {
+    auto& layer = layers[layer_index];
+    layer.coords = FillTree(layer.rtree, ckeys[layer_index], globalPositions, layer.n_duplicates); });
 
-    auto& curr_bottom_of_bilink = bottom_of_bilink_arr[layer_index % 2];
-    auto& last_bottom_of_bilink = bottom_of_bilink_arr[(layer_index + 1) % 2];
+  t_seed->stop();
+  const double fill_time = t_seed->elapsed();
+  t_seed->restart();
 
-    curr_downlinks.clear();
-    curr_bottom_of_bilink.clear();
+  if (Verbosity() > 3)
+  {
+    for (int layer_index = inner_index - 1; layer_index <= outer_index + 1; ++layer_index)
+    {
+      if (Verbosity() > 5)
+      {
+        std::cout << "nhits in layer(" << layer_index << "): " << layers[layer_index].coords.size() << std::endl;
+      }
+      std::cout << "number of duplicates : " << layers[layer_index].n_duplicates << std::endl;
+    }
+  }
 
-    // For all the clusters in coord, find nearest neighbors in the
-    // above and below layers and make links
-    // Any link to an above node which matches the same clusters
-    // on the previous iteration (to a "below node") becomes a "bilink"
-    // Check if this bilink links to a prior bilink or not
+  // For all the clusters in each layer, find nearest neighbors in the
+  // above and below layers and make links
+  // Layers are independent, and links are stored per layer
+  for_each_layer(inner_index, outer_index, [&](int layer_index)
+                 {
+    const unsigned int LAYER = layer_index + _FIRST_LAYER_TPC;
+    auto& current = layers[layer_index];
+    auto& _rtree_above = layers[layer_index + 1].rtree;
+    auto& _rtree_below = layers[layer_index - 1].rtree;
 
-    std::vector<keyLink> aboveLinks;
-    for (const auto& StartCluster : coord)
+    current.uplinks.resize(current.coords.size());
+    for (size_t icluster = 0; icluster < current.coords.size(); ++icluster)
     {
+      const auto& StartCluster = current.coords[icluster];
       double StartPhi = StartCluster.first[0];
       const auto& globalpos = globalPositions.at(StartCluster.second);
       double StartX = globalpos(0);
       double StartY = globalpos(1);
       double StartZ = globalpos(2);
-      t_seed->stop();
-      cluster_find_time += t_seed->elapsed();
-      t_seed->restart();
       LogDebug(" starting cluster:" << std::endl);
       LogDebug(" z: " << StartZ << std::endl);
       LogDebug(" phi: " << StartPhi << std::endl);
@@ -484,21 +584,15 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
                 StartZ + dZ_per_layer[LAYER + 1],
                 ClustersAbove);
 
-      t_seed->stop();
-      rtree_query_time += t_seed->elapsed();
-      t_seed->restart();
       LogDebug(" entries in below layer: " << ClustersBelow.size() << std::endl);
       LogDebug(" entries in above layer: " << ClustersAbove.size() << std::endl);
-      std::vector<std::array<double, 3>> delta_below;
-      std::vector<std::array<double, 3>> delta_above;
-      delta_below.clear();
-      delta_above.clear();
-      delta_below.resize(ClustersBelow.size());
-      delta_above.resize(ClustersAbove.size());
+
       // calculate (delta_z_, delta_phi) vector for each neighboring cluster
+      std::vector<std::array<double, 3>> delta_below(ClustersBelow.size());
+      std::vector<std::array<double, 3>> delta_above(ClustersAbove.size());
 
       std::transform(ClustersBelow.begin(), ClustersBelow.end(), delta_below.begin(),
-                     [&](pointKey BelowCandidate)
+                     [&](const pointKey& BelowCandidate)
                      {
           const auto& belowpos = globalPositions.at(BelowCandidate.second);
           return std::array<double,3>{belowpos(0)-StartX,
@@ -506,20 +600,16 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
           belowpos(2)-StartZ}; });
 
       std::transform(ClustersAbove.begin(), ClustersAbove.end(), delta_above.begin(),
-                     [&](pointKey AboveCandidate)
+                     [&](const pointKey& AboveCandidate)
                      {
           const auto& abovepos = globalPositions.at(AboveCandidate.second);
           return std::array<double,3>{abovepos(0)-StartX,
           abovepos(1)-StartY,
           abovepos(2)-StartZ}; });
-      t_seed->stop();
-      transform_time += t_seed->elapsed();
-      t_seed->restart();
 
       // find the three clusters closest to a straight line
       // (by maximizing the cos of the angle between the (delta_z_,delta_phi) vectors)
-      // double minSumLengths = 1e9;
-      std::unordered_set<TrkrDefs::cluskey> bestAboveClusters;
+      auto& bestAboveClusters = current.uplinks[icluster];
       for (size_t iAbove = 0; iAbove < delta_above.size(); ++iAbove)
       {
         for (size_t iBelow = 0; iBelow < delta_below.size(); ++iBelow)
@@ -539,10 +629,8 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
           constexpr double maxCosPlaneAngle_sq = maxCosPlaneAngle * maxCosPlaneAngle;
           if ((dot_prod < 0.) && (cos_angle_sq > maxCosPlaneAngle_sq))
           {
-            // maxCosPlaneAngle = cos(angle);
-            // minSumLengths = belowLength+aboveLength;
-            curr_downlinks.insert({StartCluster.second, ClustersBelow[iBelow].second});
-            bestAboveClusters.insert(ClustersAbove[iAbove].second);
+            current.downlinks.insert({StartCluster.second, ClustersBelow[iBelow].second});
+            bestAboveClusters.push_back(ClustersAbove[iAbove].second);
 
             // fill the tuples for plotting
             fill_tuple(_tupclus_links, 0, StartCluster.second, globalPositions.at(StartCluster.second));
@@ -555,11 +643,32 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
       // There was some old commented-out code here for allowing layers to be skipped. This
       // may be useful in the future. This chunk of code has been moved towards the
       // end fo the file under the title: "---OLD CODE 0: SKIP_LAYERS---"
-      t_seed->stop();
-      compute_best_angle_time += t_seed->elapsed();
-      t_seed->restart();
 
-      for (auto cluster : bestAboveClusters)
+      // sort, so that the order of the bilinks does not depend on the order of the tree queries
+      std::sort(bestAboveClusters.begin(), bestAboveClusters.end());
+      bestAboveClusters.erase(std::unique(bestAboveClusters.begin(), bestAboveClusters.end()), bestAboveClusters.end());
+    } });
+
+  t_seed->stop();
+  const double link_time = t_seed->elapsed();
+  t_seed->restart();
+
+  // Any link to an above node which matches the same clusters
+  // on the previous layer (to a "below node") becomes a "bilink"
+  // Check if this bilink links to a prior bilink or not
+  // This runs from outer to inner layers in a single thread, so that the chains are always the same
+  std::unordered_set<TrkrDefs::cluskey> curr_bottom_of_bilink;
+  std::unordered_set<TrkrDefs::cluskey> last_bottom_of_bilink;
+  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  {
+    const auto& current = layers[layer_index];
+    const auto& last_downlinks = layers[layer_index + 1].downlinks;
+    curr_bottom_of_bilink.clear();
+
+    for (size_t icluster = 0; icluster < current.coords.size(); ++icluster)
+    {
+      const auto& StartCluster = current.coords[icluster];
+      for (auto cluster : current.uplinks[icluster])
       {
         keyLink uplink = std::make_pair(cluster, StartCluster.second);
 
@@ -583,22 +692,17 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
         }
       }  // end loop over all up-links
     }    // end loop over start clusters
-
-    t_seed->stop();
-    set_insert_time += t_seed->elapsed();
-    t_seed->restart();
-    LogDebug(" max collinearity: " << maxCosPlaneAngle << std::endl);
-  }  // end loop over layers (to make links)
+    std::swap(curr_bottom_of_bilink, last_bottom_of_bilink);
+  }  // end loop over layers (to make bilinks)
 
   t_seed->stop();
+  const double bilink_time = t_seed->elapsed();
   if (Verbosity() > 0)
   {
     std::cout << "triplet forming time: " << t_seed->get_accumulated_time() / 1000 << " s" << std::endl;
-    std::cout << "starting cluster setup: " << cluster_find_time / 1000 << " s" << std::endl;
-    std::cout << "RTree query: " << rtree_query_time / 1000 << " s" << std::endl;
-    std::cout << "Transform: " << transform_time / 1000 << " s" << std::endl;
-    std::cout << "Compute best triplet: " << compute_best_angle_time / 1000 << " s" << std::endl;
-    std::cout << "Set insert: " << set_insert_time / 1000 << " s" << std::endl;
+    std::cout << "RTree fill: " << fill_time / 1000 << " s" << std::endl;
+    std::cout << "Link search: " << link_time / 1000 << " s" << std::endl;
+    std::cout << "Bilink forming: " << bilink_time / 1000 << " s" << std::endl;
   }
   t_seed->restart();
 
@@ -956,9 +1060,6 @@ int PHCASeeding::Setup(PHCompositeNode* topNode)  // This is called by ::InitRun
   }
 
   // timing
-  t_fill = std::make_unique<PHTimer>("t_fill");
-  t_fill->stop();
-
   t_seed = std::make_unique<PHTimer>("t_seed");
   t_seed->stop();
 
@@ -968,6 +1069,20 @@ int PHCASeeding::Setup(PHCompositeNode* topNode)  // This is called by ::InitRun
   t_makeseeds = std::make_unique<PHTimer>("t_makeseeds");
   t_makeseeds->stop();
 
+  if (m_num_threads != 1 && !m_threadpool)
+  {
+#if defined(_PHCASEEDING_CLUSTERLOG_TUPOUT_)
+    // the debugging tuples are filled while making links, and are not thread safe
+    std::cout << PHWHERE << "cluster log tuples are enabled, seeding in a single thread" << std::endl;
+#else
+    m_threadpool = std::make_unique<PHThreadPool>(m_num_threads);
+    if (Verbosity() > 0)
+    {
+      std::cout << PHWHERE << "seeding with " << m_threadpool->size() << " threads" << std::endl;
+    }
+#endif
+  }
+
   //  fcfg.set_rescale(1);
   std::unique_ptr<PHField> field_map;
   if (_use_const_field)
@@ -978,7 +1093,7 @@ int PHCASeeding::Setup(PHCompositeNode* topNode)  // This is called by ::InitRun
   else
   {
     PHFieldConfigv1 fcfg;
-    fcfg.set_field_config(PHFieldConfig::FieldConfigTypes::Field3DCartesian);
+    fcfg.set_field_config(_use_field_map_grid ? PHFieldConfig::FieldConfigTypes::kField3DCartesianGrid : PHFieldConfig::FieldConfigTypes::Field3DCartesian);
     if (std::filesystem::path(m_magField).extension() != ".root")
     {
       m_magField = CDBInterface::instance()->getUrl(m_magField);
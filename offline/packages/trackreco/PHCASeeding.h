@@ -49,6 +49,7 @@
 
 class ActsGeometry;
 class PHCompositeNode;
+class PHThreadPool;
 class PHTimer;
 class SvtxTrack_v3;
 class TpcDistortionCorrectionContainer;
@@ -98,7 +99,7 @@ class PHCASeeding : public PHTrackSeeding
       /* float cosTheta_limit = -0.8 */
   );
 
-  ~PHCASeeding() override {}
+  ~PHCASeeding() override;
   void SetSplitSeeds(bool opt = true) { _split_seeds = opt; }
   void SetLayerRange(unsigned int layer_low, unsigned int layer_up)
   {
@@ -139,11 +140,17 @@ class PHCASeeding : public PHTrackSeeding
 
   void magFieldFile(const std::string& fname) { m_magField = fname; }
   void useConstBField(bool opt) { _use_const_field = opt; }
+  //! use the dense grid field map backend instead of the TNtuple backed one
+  void useFieldMapGrid(bool opt) { _use_field_map_grid = opt; }
   void constBField(float b) { _const_field = b; }
   void useFixedClusterError(bool opt) { _use_fixed_clus_err = opt; }
   void setFixedClusterError(int i, double val) { _fixed_clus_err.at(i) = val; }
   void set_pp_mode(bool mode) { _pp_mode = mode; }
 
+  /// number of threads used to fill the search trees and find the links, layer by layer.
+  /// 1 (default) runs in the main thread, 0 uses all hardware threads. Seeds do not depend on it
+  void set_num_threads(unsigned int n) { m_num_threads = n; }
+
   void setNeonFraction(double frac) { Ne_frac = frac; };
   void setArgonFraction(double frac) { Ar_frac = frac; };
   void setCF4Fraction(double frac) { CF4_frac = frac; };
@@ -218,7 +225,7 @@ class PHCASeeding : public PHTrackSeeding
   std::pair<PositionMap, keyListPerLayer> FillGlobalPositions();
   std::pair<keyLinks, keyLinkPerLayer> CreateBiLinks(const PositionMap& globalPositions, const keyListPerLayer& ckeys);
   PHCASeeding::keyLists FollowBiLinks(const keyLinks& trackSeedPairs, const keyLinkPerLayer& bilinks, const PositionMap& globalPositions) const;
-  std::vector<coordKey> FillTree(bgi::rtree<pointKey, bgi::quadratic<16>>&, const keyList&, const PositionMap&, int layer);
+  std::vector<coordKey> FillTree(bgi::rtree<pointKey, bgi::quadratic<16>>&, const keyList&, const PositionMap&, int& n_duplicates) const;
   int FindSeedsWithMerger(const PositionMap&, const keyListPerLayer&);
 
   void QueryTree(const bgi::rtree<pointKey, bgi::quadratic<16>>& rtree, double phimin, double zmin, double phimax, double zmax, std::vector<pointKey>& returned_values) const;
@@ -252,6 +259,7 @@ class PHCASeeding : public PHTrackSeeding
   double _xy_outlier_threshold = 0.1;
   double _fieldDir = -1;
   bool _use_const_field = false;
+  bool _use_field_map_grid = false;
   bool _split_seeds = true;
   float _const_field = 1.4;
   bool _use_fixed_clus_err = false;
@@ -269,11 +277,12 @@ class PHCASeeding : public PHTrackSeeding
   std::unique_ptr<ALICEKF> fitter;
 
   std::unique_ptr<PHTimer> t_seed;
-  std::unique_ptr<PHTimer> t_fill;
   std::unique_ptr<PHTimer> t_makebilinks;
   std::unique_ptr<PHTimer> t_makeseeds;
-  /* std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, _NLAYERS_TPC> _rtrees; */
-  std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, 3> _rtrees;  // need three layers at a time
+
+  /// worker threads for the per layer steps, only created if m_num_threads != 1
+  std::unique_ptr<PHThreadPool> m_threadpool;
+  unsigned int m_num_threads = 1;
 
   double Ne_frac = 0.00;
   double Ar_frac = 0.75;
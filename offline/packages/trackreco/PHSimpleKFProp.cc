@@ -89,7 +89,7 @@ int PHSimpleKFProp::InitRun(PHCompositeNode* topNode)
 
   PHFieldConfigv1 fcfg;
 
-  fcfg.set_field_config(PHFieldConfig::FieldConfigTypes::Field3DCartesian);
+  fcfg.set_field_config(_use_field_map_grid ? PHFieldConfig::FieldConfigTypes::kField3DCartesianGrid : PHFieldConfig::FieldConfigTypes::Field3DCartesian);
   if (std::filesystem::path(m_magField).extension() != ".root")
   {
     m_magField = CDBInterface::instance()->getUrl(m_magField);
@@ -61,6 +61,8 @@ class PHSimpleKFProp : public SubsysReco
   void magFieldFile(const std::string& fname) { m_magField = fname; }
   void set_max_window(double s) { _max_dist = s; }
   void useConstBField(bool opt) { _use_const_field = opt; }
+  //! use the dense grid field map backend instead of the TNtuple backed one
+  void useFieldMapGrid(bool opt) { _use_field_map_grid = opt; }
   void setConstBField(float b) { _const_field = b; }
   void useFixedClusterError(bool opt) { _use_fixed_clus_err = opt; }
   void setFixedClusterError(int i, double val) { _fixed_clus_err.at(i) = val; }
@@ -176,6 +178,7 @@ class PHSimpleKFProp : public SubsysReco
   int _max_propagation_steps = 200;
   std::string m_magField;
   bool _use_const_field = false;
+  bool _use_field_map_grid = false;
   float _const_field = 1.4;
   bool _use_fixed_clus_err = false;
   std::array<double, 3> _fixed_clus_err = {.2, .2, .5};
@@ -34,6 +34,7 @@
 #include <cassert>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -465,19 +466,18 @@ int PHSimpleVertexFinder::GetNodes(PHCompositeNode *topNode)
 
 void PHSimpleVertexFinder::checkDCAs(SvtxTrackMap *track_map)
 {
-  // Loop over tracks and check for close DCA match with all other tracks
-  for (auto tr1_it = track_map->begin(); tr1_it != track_map->end(); ++tr1_it)
+  // select the tracks once, in track map order
+  std::vector<SvtxTrack *> tracks;
+  for (const auto &[id, track] : *track_map)
   {
-    auto id1 = tr1_it->first;
-    auto tr1 = tr1_it->second;
-    if (tr1->get_quality() > _qual_cut)
+    if (track->get_quality() > _qual_cut)
     {
       continue;
     }
     if (_require_mvtx)
     {
       unsigned int nmvtx = 0;
-      TrackSeed *siliconseed = tr1->get_silicon_seed();
+      TrackSeed *siliconseed = track->get_silicon_seed();
       if (!siliconseed)
       {
         continue;
@@ -500,57 +500,47 @@ void PHSimpleVertexFinder::checkDCAs(SvtxTrackMap *track_map)
       }
       if (Verbosity() > 3)
       {
-        std::cout << " tr1 id " << id1 << " has nmvtx at least " << nmvtx << std::endl;
+        std::cout << " track id " << id << " has nmvtx at least " << nmvtx << std::endl;
       }
     }
+    tracks.push_back(track);
+  }
 
-    // look for close DCA matches with all other such tracks
-    for (auto tr2_it = std::next(tr1_it); tr2_it != track_map->end(); ++tr2_it)
+  if (_use_all_pairs)
+  {
+    // look for close DCA matches of each track with all other such tracks
+    for (unsigned int i1 = 0; i1 < tracks.size(); ++i1)
     {
-      auto id2 = tr2_it->first;
-      auto tr2 = tr2_it->second;
-      if (tr2->get_quality() > _qual_cut)
+      for (unsigned int i2 = i1 + 1; i2 < tracks.size(); ++i2)
       {
-        continue;
-      }
-      if (_require_mvtx)
-      {
-        unsigned int nmvtx = 0;
-        TrackSeed *siliconseed = tr2->get_silicon_seed();
-        if (!siliconseed)
-        {
-          continue;
-        }
-
-        for (auto clusit = siliconseed->begin_cluster_keys(); clusit != siliconseed->end_cluster_keys(); ++clusit)
-        {
-          if (TrkrDefs::getTrkrId(*clusit) == TrkrDefs::mvtxId)
-          {
-            nmvtx++;
-          }
-          if (nmvtx >= _nmvtx_required)
-          {
-            break;
-          }
-        }
-        if (nmvtx < _nmvtx_required)
-        {
-          continue;
-        }
         if (Verbosity() > 3)
         {
-          std::cout << " tr2 id " << id2 << " has nmvtx at least " << nmvtx << std::endl;
+          std::cout << "Check DCA for tracks " << tracks[i1]->get_id() << " and  " << tracks[i2]->get_id() << std::endl;
         }
+        findDcaTwoTracks(tracks[i1], tracks[i2]);
       }
+    }
+    return;
+  }
 
-      // find DCA of these two tracks
-      if (Verbosity() > 3)
-      {
-        std::cout << "Check DCA for tracks " << id1 << " and  " << id2 << std::endl;
-      }
+  // only check pairs that can pass the dca and beam line cuts
+  std::vector<Eigen::Vector3d> points;
+  std::vector<Eigen::Vector3d> directions;
+  points.reserve(tracks.size());
+  directions.reserve(tracks.size());
+  for (const auto &track : tracks)
+  {
+    points.emplace_back(track->get_x(), track->get_y(), track->get_z());
+    directions.emplace_back(track->get_px(), track->get_py(), track->get_pz());
+  }
 
-      findDcaTwoTracks(tr1, tr2);
+  for (const auto &[i1, i2] : findCandidatePairs(points, directions))
+  {
+    if (Verbosity() > 3)
+    {
+      std::cout << "Check DCA for tracks " << tracks[i1]->get_id() << " and  " << tracks[i2]->get_id() << std::endl;
     }
+    findDcaTwoTracks(tracks[i1], tracks[i2]);
   }
 }
 
@@ -654,48 +644,82 @@ void PHSimpleVertexFinder::checkDCAsZF(SvtxTrackMap *track_map)
     cumulative_fitpars_vec.push_back(fitpars);
   }
 
-  for(unsigned int i1 = 0; i1 < cumulative_trackid_vec.size(); ++i1)
+  //  For straight line: fitpars[4] = { xyslope, y0, xzslope, z0 }
+  auto checkPair = [this, &cumulative_trackid_vec, &cumulative_fitpars_vec](unsigned int i1, unsigned int i2)
+  {
+    Eigen::Vector3d a1(0.0, cumulative_fitpars_vec[i1][1], cumulative_fitpars_vec[i1][3]);  // point on track 1 at x = 0
+    Eigen::Vector3d a2(0.0, cumulative_fitpars_vec[i2][1], cumulative_fitpars_vec[i2][3]);  // point on track 2 at x = 0
+    // direction vectors made from dy/dx = xyslope and dz/dx = xzslope
+    Eigen::Vector3d b1(1.0, cumulative_fitpars_vec[i1][0], cumulative_fitpars_vec[i1][2]);  // direction vector of track 1
+    Eigen::Vector3d b2(1.0, cumulative_fitpars_vec[i2][0], cumulative_fitpars_vec[i2][2]);  // direction vector of track 2
+
+    Eigen::Vector3d PCA1(0, 0, 0);
+    Eigen::Vector3d PCA2(0, 0, 0);
+    double dca = dcaTwoLines(a1, b1, a2, b2, PCA1, PCA2);
+
+    // check dca cut is satisfied, and that PCA is close to beam line
+    if (fabs(dca) < _active_dcacut && (fabs(PCA1.x()) < _beamline_xy_cut && fabs(PCA1.y()) < _beamline_xy_cut))
     {
-      if(cumulative_fitpars_vec[i1].size() == 0) { continue; }
+      int id1 = cumulative_trackid_vec[i1];
+      int id2 = cumulative_trackid_vec[i2];
 
-      for(unsigned int i2 = i1; i2 < cumulative_trackid_vec.size(); ++i2)
-	{
-	  if(cumulative_fitpars_vec[i2].size() == 0) { continue; }
-
-	  //  For straight line: fitpars[4] = { xyslope, y0, xzslope, z0 }
-	  Eigen::Vector3d a1(0.0, cumulative_fitpars_vec[i1][1],cumulative_fitpars_vec[i1][3]);      // point on track 1 at x = 0
-	  Eigen::Vector3d a2(0.0, cumulative_fitpars_vec[i2][1],cumulative_fitpars_vec[i2][3]);      // point on track 2 at x = 0
-	  // direction vectors made from dy/dx = xyslope and dz/dx = xzslope
-	  Eigen::Vector3d b1(1.0, cumulative_fitpars_vec[i1][0],cumulative_fitpars_vec[i1][2]);      // direction vector of track 1
-	  Eigen::Vector3d b2(1.0, cumulative_fitpars_vec[i2][0],cumulative_fitpars_vec[i2][2]);      // direction vector of track 2
-	  	  
-	  Eigen::Vector3d PCA1(0, 0, 0);
-	  Eigen::Vector3d PCA2(0, 0, 0);
-	  double dca = dcaTwoLines(a1, b1, a2, b2, PCA1, PCA2);
-
-
-	  // check dca cut is satisfied, and that PCA is close to beam line
-	  if (fabs(dca) < _active_dcacut && (fabs(PCA1.x()) < _beamline_xy_cut && fabs(PCA1.y()) < _beamline_xy_cut))
-	    {
-	      int id1 = cumulative_trackid_vec[i1];
-	      int id2 = cumulative_trackid_vec[i2];
-
-	      if (Verbosity() > 3)
-		{
-		  std::cout << " good match for tracks " << id1 << " and " << id2 << std::endl;
-		  std::cout << "    a1.x " << a1.x() << " a1.y " << a1.y() << " a1.z " << a1.z() << std::endl;
-		  std::cout << "    a2.x  " << a2.x() << " a2.y " << a2.y() << " a2.z " << a2.z() << std::endl;
-		  std::cout << "    PCA1.x() " << PCA1.x() << " PCA1.y " << PCA1.y() << " PCA1.z " << PCA1.z() << std::endl;
-		  std::cout << "    PCA2.x() " << PCA2.x() << " PCA2.y " << PCA2.y() << " PCA2.z " << PCA2.z() << std::endl;
-		  std::cout << "    dca " << dca << std::endl;
-		}
-	      
-	      // capture the results for successful matches
-	      _track_pair_map.insert(std::make_pair(id1, std::make_pair(id2, dca)));
-	      _track_pair_pca_map.insert(std::make_pair(id1, std::make_pair(id2, std::make_pair(PCA1, PCA2))));
-	    }	  	  
-	}
+      if (Verbosity() > 3)
+      {
+        std::cout << " good match for tracks " << id1 << " and " << id2 << std::endl;
+        std::cout << "    a1.x " << a1.x() << " a1.y " << a1.y() << " a1.z " << a1.z() << std::endl;
+        std::cout << "    a2.x  " << a2.x() << " a2.y " << a2.y() << " a2.z " << a2.z() << std::endl;
+        std::cout << "    PCA1.x() " << PCA1.x() << " PCA1.y " << PCA1.y() << " PCA1.z " << PCA1.z() << std::endl;
+        std::cout << "    PCA2.x() " << PCA2.x() << " PCA2.y " << PCA2.y() << " PCA2.z " << PCA2.z() << std::endl;
+        std::cout << "    dca " << dca << std::endl;
+      }
+
+      // capture the results for successful matches
+      _track_pair_map.insert(std::make_pair(id1, std::make_pair(id2, dca)));
+      _track_pair_pca_map.insert(std::make_pair(id1, std::make_pair(id2, std::make_pair(PCA1, PCA2))));
+    }
+  };
+
+  if (_use_all_pairs)
+  {
+    for (unsigned int i1 = 0; i1 < cumulative_trackid_vec.size(); ++i1)
+    {
+      if (cumulative_fitpars_vec[i1].size() == 0)
+      {
+        continue;
+      }
+
+      for (unsigned int i2 = i1; i2 < cumulative_trackid_vec.size(); ++i2)
+      {
+        if (cumulative_fitpars_vec[i2].size() == 0)
+        {
+          continue;
+        }
+        checkPair(i1, i2);
+      }
+    }
+    return;
+  }
+
+  // only check pairs of fitted tracks that can pass the dca and beam line cuts
+  std::vector<unsigned int> fitted;
+  std::vector<Eigen::Vector3d> points;
+  std::vector<Eigen::Vector3d> directions;
+  for (unsigned int i = 0; i < cumulative_trackid_vec.size(); ++i)
+  {
+    const auto &fitpars = cumulative_fitpars_vec[i];
+    if (fitpars.size() == 0)
+    {
+      continue;
     }
+    fitted.push_back(i);
+    points.emplace_back(0.0, fitpars[1], fitpars[3]);
+    directions.emplace_back(1.0, fitpars[0], fitpars[2]);
+  }
+
+  for (const auto &[i1, i2] : findCandidatePairs(points, directions))
+  {
+    checkPair(fitted[i1], fitted[i2]);
+  }
 
   return; 
 }
@@ -884,6 +908,70 @@ void PHSimpleVertexFinder::findDcaTwoTracks(SvtxTrack *tr1, SvtxTrack *tr2)
   return;
 }
 
+std::vector<std::pair<unsigned int, unsigned int>> PHSimpleVertexFinder::findCandidatePairs(const std::vector<Eigen::Vector3d> &points,
+                                                                                           const std::vector<Eigen::Vector3d> &directions)
+{
+  // A pair passes the cuts in findDcaTwoTracks only if PCA1 is within rmax of the beam line in xy,
+  // and PCA2 within |dca| of PCA1. Along a line that passes within r of the beam line, z differs from
+  // z at the point of closest approach to the beam line by at most r*|cot(theta)|, so the z of the
+  // two lines at the beam line cannot differ by more than the sum of the half widths below.
+  // Pairs whose z intervals do not overlap are skipped, which does not change the result.
+  const double rmax = std::sqrt(2.0) * _beamline_xy_cut;
+  const unsigned int ntracks = points.size();
+  std::vector<double> zmin(ntracks);
+  std::vector<double> zmax(ntracks);
+  for (unsigned int i = 0; i < ntracks; ++i)
+  {
+    const auto &a = points[i];
+    const auto &b = directions[i];
+    const double bt2 = b.x() * b.x() + b.y() * b.y();
+    const double z = a.z() - (a.x() * b.x() + a.y() * b.y()) * b.z() / bt2;
+    const double cot = std::fabs(b.z()) / std::sqrt(bt2);
+    // 1% margin for rounding
+    const double halfwidth = 1.01 * ((rmax + _active_dcacut) * cot + 0.5 * _active_dcacut);
+    if (std::isfinite(z) && std::isfinite(halfwidth))
+    {
+      zmin[i] = z - halfwidth;
+      zmax[i] = z + halfwidth;
+    }
+    else
+    {
+      // parallel to the beam line or ill defined, compare to everything
+      zmin[i] = -std::numeric_limits<double>::infinity();
+      zmax[i] = std::numeric_limits<double>::infinity();
+    }
+  }
+
+  // sweep over the intervals sorted by their lower edge
+  std::vector<unsigned int> order(ntracks);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&zmin](unsigned int i1, unsigned int i2)
+            { return zmin[i1] < zmin[i2]; });
+
+  std::vector<std::pair<unsigned int, unsigned int>> pairs;
+  for (unsigned int k1 = 0; k1 < ntracks; ++k1)
+  {
+    const unsigned int i1 = order[k1];
+    for (unsigned int k2 = k1 + 1; k2 < ntracks && zmin[order[k2]] <= zmax[i1]; ++k2)
+    {
+      const unsigned int i2 = order[k2];
+      pairs.emplace_back(std::min(i1, i2), std::max(i1, i2));
+    }
+  }
+
+  // same order as the all pairs loop, so that the track pair maps are filled identically
+  std::sort(pairs.begin(), pairs.end());
+
+  if (Verbosity() > 1)
+  {
+    std::cout << "PHSimpleVertexFinder::findCandidatePairs - tracks: " << ntracks
+              << " candidate pairs: " << pairs.size()
+              << " all pairs: " << ntracks * (ntracks - 1) / 2 << std::endl;
+  }
+
+  return pairs;
+}
+
 double PHSimpleVertexFinder::dcaTwoLines(const Eigen::Vector3d &a1, const Eigen::Vector3d &b1,
                                          const Eigen::Vector3d &a2, const Eigen::Vector3d &b2,
                                          Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2)
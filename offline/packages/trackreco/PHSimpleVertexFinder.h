@@ -17,6 +17,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <Eigen/Dense>
@@ -52,6 +53,8 @@ class PHSimpleVertexFinder : public SubsysReco
   void setTrackMapName(const std::string &name) { _track_map_name = name; }
   void setVertexMapName(const std::string &name) { _vertex_map_name = name; }
   void zeroField(const bool flag) { _zero_field = flag; }
+  // check all track pairs instead of only those close in z at the beam line, for validation
+  void setUseAllPairs(const bool flag) { _use_all_pairs = flag; }
 
  private:
   int GetNodes(PHCompositeNode *topNode);
@@ -64,6 +67,9 @@ class PHSimpleVertexFinder : public SubsysReco
   void getTrackletClusterList(TrackSeed* tracklet, std::vector<TrkrDefs::cluskey>& cluskey_vec);
   
   void findDcaTwoTracks(SvtxTrack *tr1, SvtxTrack *tr2);
+  // index pairs (i1 < i2, sorted) of the lines that can pass the dca and beam line cuts
+  std::vector<std::pair<unsigned int, unsigned int>> findCandidatePairs(const std::vector<Eigen::Vector3d> &points,
+                                                                        const std::vector<Eigen::Vector3d> &directions);
   double dcaTwoLines(const Eigen::Vector3d &p1, const Eigen::Vector3d &v1,
                      const Eigen::Vector3d &p2, const Eigen::Vector3d &v2,
                      Eigen::Vector3d &PCA1, Eigen::Vector3d &PCA2);
@@ -87,6 +93,7 @@ class PHSimpleVertexFinder : public SubsysReco
   double _outlier_cut = 0.015;
 
   bool _zero_field = false;     // fit straight lines if true
+  bool _use_all_pairs = false;  // skip the z preselection of track pairs if true
 
   std::string _track_map_name = "SvtxTrackMap";
   std::string _vertex_map_name = "SvtxVertexMap";
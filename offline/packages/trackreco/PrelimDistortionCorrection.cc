@@ -63,7 +63,7 @@ int PrelimDistortionCorrection::InitRun(PHCompositeNode* topNode)
   if (ret != Fun4AllReturnCodes::EVENT_OK) { return ret; }
 
   PHFieldConfigv1 fcfg;
-  fcfg.set_field_config(PHFieldConfig::FieldConfigTypes::Field3DCartesian);
+  fcfg.set_field_config(_use_field_map_grid ? PHFieldConfig::FieldConfigTypes::kField3DCartesianGrid : PHFieldConfig::FieldConfigTypes::Field3DCartesian);
 
   char *calibrationsroot = getenv("CALIBRATIONROOT");
   assert(calibrationsroot);
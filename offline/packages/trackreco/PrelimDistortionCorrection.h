@@ -53,6 +53,8 @@ class PrelimDistortionCorrection : public SubsysReco
   }
   void set_max_window(double s){_max_dist = s;}
   void useConstBField(bool opt){_use_const_field = opt;}
+  //! use the dense grid field map backend instead of the TNtuple backed one
+  void useFieldMapGrid(bool opt) { _use_field_map_grid = opt; }
   void setConstBField(float b) { _const_field = b; }
   void useFixedClusterError(bool opt){_use_fixed_clus_err = opt;}
   void setFixedClusterError(int i, double val){_fixed_clus_err.at(i) = val;}
@@ -112,6 +114,7 @@ class PrelimDistortionCorrection : public SubsysReco
   std::unique_ptr<ALICEKF> fitter;
 
   bool _use_const_field = false;
+  bool _use_field_map_grid = false;
   float _const_field = 1.4;
   bool _use_fixed_clus_err = false;
   std::array<double,3> _fixed_clus_err = {.1,.1,.1};
@@ -30,12 +30,28 @@
 #include <TH1.h>
 #include <TNtuple.h>
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <cstdint>
 #include <sstream>
 #include <string>
 
+namespace
+{
+  // add the 8 bit sums of src to dst, sample by sample
+  void add_sums(std::vector<unsigned int> &dst, const std::vector<unsigned int> &src)
+  {
+    const std::size_t n = std::min(dst.size(), src.size());
+    unsigned int *d = dst.data();
+    const unsigned int *s = src.data();
+    for (std::size_t i = 0; i < n; i++)
+    {
+      d[i] += (s[i] & 0xffU);
+    }
+  }
+}  // namespace
+
 // constructor
 CaloTriggerEmulator::CaloTriggerEmulator(const std::string &name)
   : SubsysReco(name)
@@ -80,21 +96,31 @@ CaloTriggerEmulator::CaloTriggerEmulator(const std::string &name)
     }
   }
 
-  for (int i = 0; i < 24576; i++)
+  // channels of the four towers of each 2x2 sum, so that primitives are built without tower key lookups
+  m_sum_channels_emcal.resize(384 * 16 * 4);
+  for (unsigned int ip = 0; ip < 384; ip++)
   {
-    unsigned int key = TowerInfoDefs::encode_emcal(i);
-    h_emcal_lut[key] = nullptr;
+    for (unsigned int isum = 0; isum < 16; isum++)
+    {
+      for (unsigned int j = 0; j < 4; j++)
+      {
+        unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::DetectorId::emcalDId, ip, isum, j);
+        m_sum_channels_emcal[(ip * 16 + isum) * 4 + j] = TowerInfoDefs::decode_emcal(key);
+      }
+    }
   }
 
-  for (int i = 0; i < 1536; i++)
+  m_sum_channels_hcal.resize(24 * 16 * 4);
+  for (unsigned int ip = 0; ip < 24; ip++)
   {
-    unsigned int key = TowerInfoDefs::encode_hcal(i);
-    h_hcalin_lut[key] = nullptr;
-  }
-  for (int i = 0; i < 1536; i++)
-  {
-    unsigned int key = TowerInfoDefs::encode_hcal(i);
-    h_hcalout_lut[key] = nullptr;
+    for (unsigned int isum = 0; isum < 16; isum++)
+    {
+      for (unsigned int j = 0; j < 4; j++)
+      {
+        unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::DetectorId::hcalDId, ip, isum, j);
+        m_sum_channels_hcal[(ip * 16 + isum) * 4 + j] = TowerInfoDefs::decode_hcal(key);
+      }
+    }
   }
 
   for (int i = 0; i < 2; i++)
@@ -469,12 +495,7 @@ int CaloTriggerEmulator::Download_Calibrations()
     {
       cdbttree_emcal->LoadCalibrations();
 
-      for (int i = 0; i < 24576; i++)
-      {
-        std::string histoname = "h_emcal_lut_" + std::to_string(i);
-        unsigned int key = TowerInfoDefs::encode_emcal(i);
-        h_emcal_lut[key] = (TH1I *) cdbttree_emcal->getHisto(histoname.c_str());
-      }
+      LoadLUT(cdbttree_emcal, "h_emcal_lut_", 24576, m_lut_emcal, m_lut_histos_emcal);
     }
   }
   if (m_do_hcalin && !m_default_lut_hcalin)
@@ -500,12 +521,7 @@ int CaloTriggerEmulator::Download_Calibrations()
     {
       cdbttree_hcalin->LoadCalibrations();
 
-      for (int i = 0; i < 1536; i++)
-      {
-        std::string histoname = "h_hcalin_lut_" + std::to_string(i);
-        unsigned int key = TowerInfoDefs::encode_hcal(i);
-        h_hcalin_lut[key] = (TH1I *) cdbttree_hcalin->getHisto(histoname.c_str());
-      }
+      LoadLUT(cdbttree_hcalin, "h_hcalin_lut_", 1536, m_lut_hcalin, m_lut_histos_hcalin);
     }
   }
   if (m_do_hcalout && !m_default_lut_hcalout)
@@ -531,16 +547,40 @@ int CaloTriggerEmulator::Download_Calibrations()
     {
       cdbttree_hcalout->LoadCalibrations();
 
-      for (int i = 0; i < 1536; i++)
-      {
-        std::string histoname = "h_hcalout_lut_" + std::to_string(i);
-        unsigned int key = TowerInfoDefs::encode_hcal(i);
-        h_hcalout_lut[key] = (TH1I *) cdbttree_hcalout->getHisto(histoname.c_str());
-      }
+      LoadLUT(cdbttree_hcalout, "h_hcalout_lut_", 1536, m_lut_hcalout, m_lut_histos_hcalout);
     }
   }
   return 0;
 }
+
+void CaloTriggerEmulator::LoadLUT(CDBHistos *cdbhistos, const std::string &prefix, unsigned int nchannels, std::vector<uint16_t> &lut, std::vector<TH1 *> &lut_histos)
+{
+  // convert the histograms once, so that the LUT output is a plain array access.
+  // Channels with no histogram use the default table
+  lut.resize(nchannels * 1024);
+  lut_histos.assign(nchannels, nullptr);
+  unsigned int nmissing = 0;
+  for (unsigned int i = 0; i < nchannels; i++)
+  {
+    std::string histoname = prefix + std::to_string(i);
+    TH1 *h_lut = cdbhistos->getHisto(histoname);
+    lut_histos[i] = h_lut;
+    if (!h_lut)
+    {
+      nmissing++;
+    }
+    uint16_t *lut_row = &lut[i * 1024];
+    for (unsigned int j = 0; j < 1024; j++)
+    {
+      lut_row[j] = (h_lut ? ((unsigned int) h_lut->GetBinContent(j + 1)) : m_l1_adc_table[j]) & 0x3ffU;
+    }
+  }
+  if (nmissing)
+  {
+    std::cout << PHWHERE << " " << nmissing << " of " << nchannels << " channels have no " << prefix << " histogram, using the default table for them" << std::endl;
+  }
+}
+
 // process event procedure
 int CaloTriggerEmulator::process_event(PHCompositeNode *topNode)
 {
@@ -578,6 +618,12 @@ int CaloTriggerEmulator::process_event(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::EVENT_OK;
   }
 
+  // build the event again through the LUT histograms and compare
+  if (m_validate)
+  {
+    validate_event();
+  }
+
   m_nevent++;
 
   if (Verbosity() >= 2)
@@ -616,6 +662,21 @@ int CaloTriggerEmulator::process_waveforms()
     sample_end = m_trig_sample + 1;
   }
 
+  // one row of samples per channel, set to 0 for channels with no waveform
+  m_peak_nsamples = sample_end - sample_start;
+  if (m_do_emcal)
+  {
+    m_peak_sub_ped_emcal.assign(24576 * m_peak_nsamples, 0);
+  }
+  if (m_do_hcalout)
+  {
+    m_peak_sub_ped_hcalout.assign(1536 * m_peak_nsamples, 0);
+  }
+  if (m_do_hcalin)
+  {
+    m_peak_sub_ped_hcalin.assign(1536 * m_peak_nsamples, 0);
+  }
+
   if (m_do_emcal)
   {
     if (Verbosity())
@@ -626,48 +687,7 @@ int CaloTriggerEmulator::process_waveforms()
     {
       return Fun4AllReturnCodes::EVENT_OK;
     }
-    // for each waveform, clauclate the peak - pedestal given the sub-delay setting
-    for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_emcal->size(); iwave++)
-    {
-      std::vector<unsigned int> v_peak_sub_ped;
-      unsigned int peak_sub_ped = 0;
-      TowerInfo *tower = m_waveforms_emcal->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-      if (tower->get_nsample() == 2)
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
-      }
-      else
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = tower->get_waveform_value(i);
-          if (m_use_max)
-          {
-            int16_t max1 = std::max(tower->get_waveform_value(i), tower->get_waveform_value(i + 1));
-            maxim = std::max(max1, tower->get_waveform_value(i + 2));
-          }
-          int subtraction = maxim - tower->get_waveform_value((i - m_trig_sub_delay > 0 ? i - m_trig_sub_delay : 0));
-          // if negative, set to 0
-          if (subtraction < 0)
-          {
-            subtraction = 0;
-          }
-          peak_sub_ped = (((unsigned int) subtraction) & 0x3fffU);
-          if (Verbosity() >= 10 && peak_sub_ped > 16)
-          {
-            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: emcal peak " << iwave << " = " << peak_sub_ped << std::endl;
-          }
-
-          v_peak_sub_ped.push_back(peak_sub_ped);
-        }
-      }
-      // save in global.
-      m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
-    }
+    fill_peak_sub_ped(m_waveforms_emcal, 24576, sample_start, sample_end, "emcal", m_peak_sub_ped_emcal);
   }
   if (m_do_hcalout)
   {
@@ -675,60 +695,11 @@ int CaloTriggerEmulator::process_waveforms()
     {
       std::cout << __FILE__ << "::" << __FUNCTION__ << ":: ohcal" << std::endl;
     }
-    unsigned int peak_sub_ped;
-
-    std::vector<int> wave;
-    // for each waveform, clauclate the peak - pedestal given the sub-delay setting
     if (!m_waveforms_hcalout->size())
     {
       return Fun4AllReturnCodes::EVENT_OK;
     }
-
-    for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_hcalout->size(); iwave++)
-    {
-      std::vector<unsigned int> v_peak_sub_ped;
-      peak_sub_ped = 0;
-      TowerInfo *tower = m_waveforms_hcalout->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-      if (tower->get_nsample() == 2)
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
-      }
-      else
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          unsigned int subtraction = 0;
-          int16_t maxim = tower->get_waveform_value(i);
-          if (m_use_max)
-          {
-            int16_t max1 = std::max(tower->get_waveform_value(i), tower->get_waveform_value(i + 1));
-            maxim = std::max(max1, tower->get_waveform_value(i + 2));
-          }
-          if (maxim - tower->get_waveform_value((i - m_trig_sub_delay > 0 ? i - m_trig_sub_delay : 0)) > 0)
-          {
-            subtraction = maxim - tower->get_waveform_value((i - m_trig_sub_delay > 0 ? i - m_trig_sub_delay : 0));
-          }
-          else
-          {
-            subtraction = 0;
-          }
-
-          peak_sub_ped = (((unsigned int) subtraction) & 0x3fffU);
-          if (Verbosity() >= 10 && peak_sub_ped > 16)
-          {
-            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalout peak " << iwave << " = " << peak_sub_ped << std::endl;
-          }
-
-          v_peak_sub_ped.push_back(peak_sub_ped);
-        }
-      }
-      // save in global.
-      m_peak_sub_ped_hcalout[key] = v_peak_sub_ped;
-    }
+    fill_peak_sub_ped(m_waveforms_hcalout, 1536, sample_start, sample_end, "hcalout", m_peak_sub_ped_hcalout);
   }
   if (m_do_hcalin)
   {
@@ -740,92 +711,295 @@ int CaloTriggerEmulator::process_waveforms()
     {
       return Fun4AllReturnCodes::EVENT_OK;
     }
-    if (Verbosity())
+    fill_peak_sub_ped(m_waveforms_hcalin, 1536, sample_start, sample_end, "hcalin", m_peak_sub_ped_hcalin);
+  }
+
+  if (m_do_mbd)
+  {
+    if (!m_waveforms_mbd->size())
     {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << ":: ihcal" << std::endl;
+      return Fun4AllReturnCodes::EVENT_OK;
     }
-    unsigned int peak_sub_ped;
 
-    std::vector<unsigned int> wave;
+    // 4 boards of 64 channels
+    unsigned int nwaves = m_waveforms_mbd->size();
+    m_peak_sub_ped_mbd.assign(std::max(nwaves, 256U) * m_peak_nsamples, 0);
 
     // for each waveform, clauclate the peak - pedestal given the sub-delay setting
-    for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_hcalin->size(); iwave++)
+    for (unsigned int iwave = 0; iwave < nwaves; iwave++)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
-      peak_sub_ped = 0;
-      TowerInfo *tower = m_waveforms_hcalin->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-
-      if (tower->get_nsample() == 2)
+      uint16_t *peak_sub_ped = &m_peak_sub_ped_mbd[iwave * m_peak_nsamples];
+      TowerInfo *tower = m_waveforms_mbd->get_tower_at_channel(iwave);
+      for (int i = sample_start; i < sample_end; i++)
       {
-        for (int i = sample_start; i < sample_end; i++)
+        int subtraction = tower->get_waveform_value(i) - tower->get_waveform_value((i - i % 6 - 6 + m_trig_sub_delay > 0 ? i - i % 6 - 6 + m_trig_sub_delay : 0));
+
+        if (subtraction < 0)
         {
-          v_peak_sub_ped.push_back(0);
+          subtraction = 0;
         }
+
+        peak_sub_ped[i - sample_start] = (((unsigned int) subtraction) & 0x3fffU);
       }
-      else
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = tower->get_waveform_value(i);
-          if (m_use_max)
-          {
-            int16_t max1 = std::max(tower->get_waveform_value(i), tower->get_waveform_value(i + 1));
-            maxim = std::max(max1, tower->get_waveform_value(i + 2));
-          }
+    }
+  }
 
-          int subtraction = maxim - tower->get_waveform_value((i - m_trig_sub_delay > 0 ? i - m_trig_sub_delay : 0));
+  return Fun4AllReturnCodes::EVENT_OK;
+}
 
-          if (subtraction < 0)
-          {
-            subtraction = 0;
-          }
+void CaloTriggerEmulator::fill_peak_sub_ped(TowerInfoContainer *waveforms, unsigned int nchannels, int sample_start, int sample_end, const std::string &name, std::vector<uint16_t> &peak_sub_ped)
+{
+  // for each waveform, clauclate the peak - pedestal given the sub-delay setting
+  unsigned int nwaves = std::min(nchannels, (unsigned int) waveforms->size());
+  for (unsigned int iwave = 0; iwave < nwaves; iwave++)
+  {
+    TowerInfo *tower = waveforms->get_tower_at_channel(iwave);
 
-          peak_sub_ped = (((unsigned int) subtraction) & 0x3fffU);
-          if (Verbosity() >= 10 && peak_sub_ped > 16)
-          {
-            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalin peak " << iwave << " = " << peak_sub_ped << std::endl;
-          }
+    // no waveform, leave the samples at 0
+    if (tower->get_nsample() == 2)
+    {
+      continue;
+    }
 
-          v_peak_sub_ped.push_back(peak_sub_ped);
-        }
+    uint16_t *channel_peak_sub_ped = &peak_sub_ped[iwave * m_peak_nsamples];
+    for (int i = sample_start; i < sample_end; i++)
+    {
+      int16_t maxim = tower->get_waveform_value(i);
+      if (m_use_max)
+      {
+        int16_t max1 = std::max(tower->get_waveform_value(i), tower->get_waveform_value(i + 1));
+        maxim = std::max(max1, tower->get_waveform_value(i + 2));
+      }
+      int subtraction = maxim - tower->get_waveform_value((i - m_trig_sub_delay > 0 ? i - m_trig_sub_delay : 0));
+      // if negative, set to 0
+      if (subtraction < 0)
+      {
+        subtraction = 0;
+      }
+      unsigned int peak = (((unsigned int) subtraction) & 0x3fffU);
+      if (Verbosity() >= 10 && peak > 16)
+      {
+        std::cout << __FILE__ << "::" << __FUNCTION__ << ":: " << name << " peak " << iwave << " = " << peak << std::endl;
       }
-      // save in global.
-      m_peak_sub_ped_hcalin[key] = v_peak_sub_ped;
+
+      channel_peak_sub_ped[i - sample_start] = peak;
     }
   }
+}
 
-  if (m_do_mbd)
+void CaloTriggerEmulator::sum_lut_outputs(const unsigned int *channels, const std::vector<uint16_t> &peak_sub_ped, const std::vector<uint16_t> &lut, bool default_lut, int nsample)
+{
+  m_temp_sum.assign(nsample, 0);
+  unsigned int *temp_sum = m_temp_sum.data();
+  for (int j = 0; j < 4; j++)
   {
-    if (!m_waveforms_mbd->size())
+    const uint16_t *channel_peak_sub_ped = &peak_sub_ped[channels[j] * m_peak_nsamples];
+
+    // pass upper 10 bits through the LUT, keep the upper 8 bits of the output
+    const uint16_t *lut_row = default_lut ? nullptr : &lut[channels[j] * 1024];
+    if (lut_row)
     {
-      return Fun4AllReturnCodes::EVENT_OK;
+      for (int is = 0; is < nsample; is++)
+      {
+        temp_sum[is] += ((lut_row[(channel_peak_sub_ped[is] >> 4U) & 0x3ffU] >> 2U) & 0xffU);
+      }
     }
+    else
+    {
+      for (int is = 0; is < nsample; is++)
+      {
+        temp_sum[is] += ((m_l1_adc_table[(channel_peak_sub_ped[is] >> 4U) & 0x3ffU] >> 2U) & 0xffU);
+      }
+    }
+  }
+}
 
-    // for each waveform, clauclate the peak - pedestal given the sub-delay setting
-    for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_mbd->size(); iwave++)
+void CaloTriggerEmulator::validate_event()
+{
+  // the MBD trigger does not use the LUTs
+  if (m_triggerid == TriggerDefs::TriggerId::mbdTId)
+  {
+    return;
+  }
+
+  SumSnapshot flat_sums;
+  snapshot_sums(flat_sums);
+
+  // clear what this event has filled and run the trigger again from the reference 2x2 sums
+  for (TriggerPrimitiveContainer *primitives : {m_primitives, m_primitives_emcal, m_primitives_hcalin, m_primitives_hcalout, m_primitives_emcal_ll1, m_primitives_hcal_ll1})
+  {
+    if (primitives)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
-      unsigned int peak_sub_ped = 0;
-      TowerInfo *tower = m_waveforms_mbd->get_tower_at_channel(iwave);
-      for (int i = sample_start; i < sample_end; i++)
+      primitives->Reset();
+    }
+  }
+  m_ll1out->Reset();
+
+  int npassed = m_npassed;
+  if (m_do_emcal)
+  {
+    process_primitives_reference(m_waveforms_emcal, m_primitives_emcal, TriggerDefs::DetectorId::emcalDId, m_lut_histos_emcal, m_default_lut_emcal);
+  }
+  if (m_do_hcalout)
+  {
+    process_primitives_reference(m_waveforms_hcalout, m_primitives_hcalout, TriggerDefs::DetectorId::hcaloutDId, m_lut_histos_hcalout, m_default_lut_hcalout);
+  }
+  if (m_do_hcalin)
+  {
+    process_primitives_reference(m_waveforms_hcalin, m_primitives_hcalin, TriggerDefs::DetectorId::hcalinDId, m_lut_histos_hcalin, m_default_lut_hcalin);
+  }
+  if (!process_organizer())
+  {
+    process_trigger();
+  }
+  m_npassed = npassed;
+
+  SumSnapshot reference_sums;
+  snapshot_sums(reference_sums);
+
+  m_validation_nevents++;
+  for (const auto &reference : reference_sums)
+  {
+    m_validation_nsums[reference.first.first]++;
+    auto flat = flat_sums.find(reference.first);
+    if (flat == flat_sums.end() || flat->second != reference.second)
+    {
+      m_validation_mismatches[reference.first.first]++;
+      if (Verbosity())
       {
-        int subtraction = tower->get_waveform_value(i) - tower->get_waveform_value((i - i % 6 - 6 + m_trig_sub_delay > 0 ? i - i % 6 - 6 + m_trig_sub_delay : 0));
+        std::cout << PHWHERE << " event " << m_nevent << ": " << reference.first.first << " 0x" << std::hex << reference.first.second << std::dec
+                  << " differs between the LUT histograms and the flat LUT tables" << std::endl;
+      }
+    }
+  }
+  for (const auto &flat : flat_sums)
+  {
+    if (reference_sums.find(flat.first) == reference_sums.end())
+    {
+      m_validation_nsums[flat.first.first]++;
+      m_validation_mismatches[flat.first.first]++;
+      if (Verbosity())
+      {
+        std::cout << PHWHERE << " event " << m_nevent << ": " << flat.first.first << " 0x" << std::hex << flat.first.second << std::dec
+                  << " only made with the flat LUT tables" << std::endl;
+      }
+    }
+  }
+}
 
-        if (subtraction < 0)
+void CaloTriggerEmulator::process_primitives_reference(TowerInfoContainer *waveforms, TriggerPrimitiveContainer *primitives, TriggerDefs::DetectorId detid, const std::vector<TH1 *> &lut_histos, bool default_lut)
+{
+  int sample_start = 1;
+  int sample_end = m_nsamples;
+  if (m_trig_sample > 0)
+  {
+    sample_start = m_trig_sample;
+    sample_end = m_trig_sample + 1;
+  }
+  int nsample = sample_end - sample_start;
+
+  bool emcal = (detid == TriggerDefs::DetectorId::emcalDId);
+
+  // peak minus pedestal of each tower, keyed by the tower key
+  std::map<unsigned int, std::vector<unsigned int>> peak_sub_ped;
+  for (unsigned int iwave = 0; iwave < (unsigned int) waveforms->size(); iwave++)
+  {
+    TowerInfo *tower = waveforms->get_tower_at_channel(iwave);
+    unsigned int key = (emcal ? TowerInfoDefs::encode_emcal(iwave) : TowerInfoDefs::encode_hcal(iwave));
+    std::vector<unsigned int> &v_peak_sub_ped = peak_sub_ped[key];
+    for (int i = sample_start; i < sample_end; i++)
+    {
+      int subtraction = 0;
+      if (tower->get_nsample() != 2)
+      {
+        int16_t maxim = tower->get_waveform_value(i);
+        if (m_use_max)
         {
-          subtraction = 0;
+          maxim = std::max({tower->get_waveform_value(i), tower->get_waveform_value(i + 1), tower->get_waveform_value(i + 2)});
         }
+        subtraction = std::max(maxim - tower->get_waveform_value((i - m_trig_sub_delay > 0 ? i - m_trig_sub_delay : 0)), 0);
+      }
+      v_peak_sub_ped.push_back(((unsigned int) subtraction) & 0x3fffU);
+    }
+  }
 
-        peak_sub_ped = (((unsigned int) subtraction) & 0x3fffU);
-        v_peak_sub_ped.push_back(peak_sub_ped);
+  std::string detector = (emcal ? "EMCAL" : (detid == TriggerDefs::DetectorId::hcalinDId ? "HCALIN" : "HCALOUT"));
+  TriggerDefs::DetectorId tower_detid = (emcal ? TriggerDefs::DetectorId::emcalDId : TriggerDefs::DetectorId::hcalDId);
+  unsigned int sum_mask = (detid == TriggerDefs::DetectorId::hcalinDId ? 0xfffU : 0x3ffU);
+
+  for (int ip = 0; ip < m_prim_map[detid]; ip++)
+  {
+    TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId(detector), TriggerDefs::GetPrimitiveId(detector), ip);
+    TriggerPrimitive *primitive = primitives->get_primitive_at_key(primkey);
+    bool mask = CheckFiberMasks(primkey);
+    for (int isum = 0; isum < m_n_sums; isum++)
+    {
+      TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId(detector), TriggerDefs::GetPrimitiveId(detector), ip, isum);
+      std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
+      t_sum->clear();
+
+      // a masked emcal channel masks its sum, a masked hcal channel also masks the following sums of the primitive
+      bool mask_channel = mask || CheckChannelMasks(sumkey);
+      if (!emcal)
+      {
+        mask = mask_channel;
+      }
+      for (int is = 0; is < nsample; is++)
+      {
+        unsigned int temp_sum = 0;
+        for (int j = 0; j < 4 && !mask_channel; j++)
+        {
+          unsigned int key = TriggerDefs::GetTowerInfoKey(tower_detid, ip, isum, j);
+          auto peak = peak_sub_ped.find(key);
+          unsigned int lut_input = (peak == peak_sub_ped.end() ? 0 : (peak->second.at(is) >> 4U) & 0x3ffU);
+          unsigned int channel = (emcal ? TowerInfoDefs::decode_emcal(key) : TowerInfoDefs::decode_hcal(key));
+          TH1 *h_lut = ((default_lut || channel >= lut_histos.size()) ? nullptr : lut_histos[channel]);
+          unsigned int lut_output = (h_lut ? (((unsigned int) h_lut->GetBinContent(lut_input + 1)) & 0x3ffU) : m_l1_adc_table[lut_input]);
+          temp_sum += ((lut_output >> 2U) & 0xffU);
+        }
+        t_sum->push_back(((temp_sum & sum_mask) >> 2U) & 0xffU);
       }
-      // save in global.
-      m_peak_sub_ped_mbd[iwave] = v_peak_sub_ped;
     }
   }
+}
 
-  return Fun4AllReturnCodes::EVENT_OK;
+void CaloTriggerEmulator::snapshot_sums(SumSnapshot &snapshot)
+{
+  std::pair<std::string, TriggerPrimitiveContainer *> containers[] = {
+      {"2x2 EMCAL", m_primitives_emcal},
+      {"2x2 HCALIN", m_primitives_hcalin},
+      {"2x2 HCALOUT", m_primitives_hcalout},
+      {"8x8 EMCAL", m_primitives_emcal_ll1},
+      {"8x8 HCAL", m_primitives_hcal_ll1},
+      {"LL1 " + m_trigger, m_primitives}};
+
+  for (auto &container : containers)
+  {
+    if (!container.second)
+    {
+      continue;
+    }
+    TriggerPrimitiveContainer::Range range = container.second->getTriggerPrimitives();
+    for (TriggerPrimitiveContainer::Iter iter = range.first; iter != range.second; ++iter)
+    {
+      TriggerPrimitive::Range sumrange = iter->second->getSums();
+      for (TriggerPrimitive::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
+      {
+        snapshot[std::make_pair(container.first, siter->first)] = *siter->second;
+      }
+    }
+  }
+
+  // the trigger words hold the jet patch sums
+  if (m_triggerid == TriggerDefs::TriggerId::jetTId)
+  {
+    LL1Out::Range range = m_ll1out->getTriggerWords();
+    for (LL1Out::Iter iter = range.first; iter != range.second; ++iter)
+    {
+      snapshot[std::make_pair("jet patch", iter->first)] = *iter->second;
+    }
+  }
+  snapshot[std::make_pair("trigger bits", 0)] = *m_ll1out->GetTriggerBits();
 }
 
 // procedure to process the peak - pedestal into primitives.
@@ -858,7 +1032,6 @@ int CaloTriggerEmulator::process_primitives()
     m_n_primitives = m_prim_map[TriggerDefs::DetectorId::emcalDId];
     for (i = 0; i < m_n_primitives; i++, ip++)
     {
-      unsigned int tmp = 0;
       // get the primitive key of what we are making, in order of the packet ID and channel number
       TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("EMCAL"), ip);
 
@@ -879,35 +1052,22 @@ int CaloTriggerEmulator::process_primitives()
 
         // check to mask channel (if fiber masked, automatically mask the channel)
         bool mask_channel = mask || CheckChannelMasks(sumkey);
-        for (int is = 0; is < nsample; is++)
+
+        // if masked, just fill with 0s
+        if (mask_channel)
         {
-          sum = 0;
-          unsigned int temp_sum = 0;
+          t_sum->insert(t_sum->end(), nsample, 0);
+          continue;
+        }
 
-          // if masked, just fill with 0s
-          if (!mask_channel)
+        // sum the 4 towers for all samples at once
+        sum_lut_outputs(&m_sum_channels_emcal[(ip * 16 + isum) * 4], m_peak_sub_ped_emcal, m_lut_emcal, m_default_lut_emcal, nsample);
+        for (int is = 0; is < nsample; is++)
+        {
+          sum = ((m_temp_sum[is] & 0x3ffU) >> 2U) & 0xffU;
+          if (Verbosity() >= 10 && sum >= 1)
           {
-            for (int j = 0; j < 4; j++)
-            {
-              // unsigned int iwave = 64*ip + isum*4 + j;
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("EMCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_emcal[key].at(is) >> 4U) & 0x3ffU;
-              if (m_default_lut_emcal)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_emcal_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0xffU);
-            }
-            sum = ((temp_sum & 0x3ffU) >> 2U) & 0xffU;
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: emcal sum " << sumkey << " = " << sum << std::endl;
-            }
+            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: emcal sum " << sumkey << " = " << sum << std::endl;
           }
           t_sum->push_back(sum);
         }
@@ -936,33 +1096,20 @@ int CaloTriggerEmulator::process_primitives()
         TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALOUT"), TriggerDefs::GetPrimitiveId("HCALOUT"), ip, isum);
         std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
         mask |= CheckChannelMasks(sumkey);
+        if (mask)
+        {
+          t_sum->insert(t_sum->end(), nsample, 0);
+          continue;
+        }
+
+        // sum the 4 towers for all samples at once
+        sum_lut_outputs(&m_sum_channels_hcal[(ip * 16 + isum) * 4], m_peak_sub_ped_hcalout, m_lut_hcalout, m_default_lut_hcalout, nsample);
         for (int is = 0; is < nsample; is++)
         {
-          sum = 0;
-          unsigned int temp_sum = 0;
-          if (!mask)
+          sum = ((m_temp_sum[is] & 0x3ffU) >> 2U) & 0xffU;
+          if (Verbosity() >= 10 && sum >= 1)
           {
-            for (int j = 0; j < 4; j++)
-            {
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("HCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_hcalout[key].at(is) >> 4U) & 0x3ffU;
-              unsigned int tmp = 0;
-              if (m_default_lut_hcalout)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_hcalout_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0xffU);
-            }
-            sum = ((temp_sum & 0x3ffU) >> 2U) & 0xffU;
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalout sum " << sumkey << " = " << sum << std::endl;
-            }
+            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalout sum " << sumkey << " = " << sum << std::endl;
           }
           t_sum->push_back(sum);
         }
@@ -991,33 +1138,20 @@ int CaloTriggerEmulator::process_primitives()
         TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALIN"), TriggerDefs::GetPrimitiveId("HCALIN"), ip, isum);
         std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
         mask |= CheckChannelMasks(sumkey);
+        if (mask)
+        {
+          t_sum->insert(t_sum->end(), nsample, 0);
+          continue;
+        }
+
+        // sum the 4 towers for all samples at once
+        sum_lut_outputs(&m_sum_channels_hcal[(ip * 16 + isum) * 4], m_peak_sub_ped_hcalin, m_lut_hcalin, m_default_lut_hcalin, nsample);
         for (int is = 0; is < nsample; is++)
         {
-          sum = 0;
-          unsigned int temp_sum = 0;
-          if (!mask)
+          sum = ((m_temp_sum[is] & 0xfffU) >> 2U) & 0xffU;
+          if (Verbosity() >= 10 && sum >= 1)
           {
-            for (int j = 0; j < 4; j++)
-            {
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("HCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_hcalin[key].at(is) >> 4U) & 0x3ffU;
-              unsigned int tmp = 0;
-              if (m_default_lut_hcalin)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_hcalin_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0x3ffU);
-            }
-            sum = ((temp_sum & 0xfffU) >> 2U) & 0xffU;
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalin sum " << sumkey << " = " << sum << std::endl;
-            }
+            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalin sum " << sumkey << " = " << sum << std::endl;
           }
           t_sum->push_back(sum);
         }
@@ -1067,7 +1201,7 @@ int CaloTriggerEmulator::process_primitives()
           for (int j = 0; j < 8; j++)
           {
             // pass upper 10 bits of charge to get 10 bit LUt outcome
-            tmp = m_l1_adc_table[m_peak_sub_ped_mbd[i * 64 + 8 + isec * 16 + j].at(is) >> 4U];
+            tmp = m_l1_adc_table[m_peak_sub_ped_mbd[(i * 64 + 8 + isec * 16 + j) * m_peak_nsamples + is] >> 4U];
 
             // put upper 3 bits of the 10 bits into slewing correction later
             qadd[isec * 8 + j] = (tmp & 0x380U) >> 7U;
@@ -1084,7 +1218,7 @@ int CaloTriggerEmulator::process_primitives()
           for (int j = 0; j < 8; j++)
           {
             // upper 10 bits go through the LUT
-            tmp = m_l1_adc_table[m_peak_sub_ped_mbd[i * 64 + isec * 16 + j].at(is) >> 4U];
+            tmp = m_l1_adc_table[m_peak_sub_ped_mbd[(i * 64 + isec * 16 + j) * m_peak_nsamples + is] >> 4U];
 
             // high bit is the hit bit
             m_trig_nhit += (tmp & 0x200U) >> 9U;
@@ -1210,12 +1344,7 @@ int CaloTriggerEmulator::process_organizer()
           {
             continue;
           }
-          int i = 0;
-          for (unsigned int &it_s : *(*iter_sum).second)
-          {
-            t_sum->at(i) += (it_s & 0xffU);
-            i++;
-          }
+          add_sums(*t_sum, *iter_sum->second);
         }
 
         // bit shift by 16 (divide by the 16 towers) to get an 8 bit energy sum.
@@ -1275,7 +1404,6 @@ int CaloTriggerEmulator::process_organizer()
             uint16_t sumphi = TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumPhiId(sumkey);
             uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumEtaId(sumkey);
 
-            int i = 0;
             if (CheckChannelMasks(sumkey))
             {
               continue;
@@ -1291,12 +1419,7 @@ int CaloTriggerEmulator::process_organizer()
 
             // add to primitive previously made the sum of the 8x8 non-overlapping sum.
             std::vector<unsigned int> *t_sum = m_primitives_hcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
-
-            for (unsigned int &it_s : *(*iter_sum).second)
-            {
-              t_sum->at(i) += (it_s & 0xffU);
-              i++;
-            }
+            add_sums(*t_sum, *iter_sum->second);
           }
         }
       }
@@ -1333,8 +1456,6 @@ int CaloTriggerEmulator::process_organizer()
             //		      uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey)*4 + TriggerDefs::getSumEtaId(sumkey);
             uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumEtaId(sumkey);
 
-            int i = 0;
-
             if (CheckChannelMasks(sumkey))
             {
               continue;
@@ -1348,11 +1469,7 @@ int CaloTriggerEmulator::process_organizer()
             TriggerDefs::TriggerPrimKey jet_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
 
             std::vector<unsigned int> *t_sum = m_primitives_hcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
-            for (unsigned int &it_s : *(*iter_sum).second)
-            {
-              t_sum->at(i) += ((it_s) &0xffU);
-              i++;
-            }
+            add_sums(*t_sum, *iter_sum->second);
           }
         }
       }
@@ -1406,14 +1523,18 @@ int CaloTriggerEmulator::process_organizer()
           TriggerDefs::TriggerSumKey hcal_skey = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey), TriggerDefs::getSumLocId(jet_skey));
           TriggerDefs::TriggerSumKey emcal_skey = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey), TriggerDefs::getSumLocId(jet_skey));
 
-          int i = 0;
-          for (unsigned int &it_s : *(*iter_sum).second)
-          {
-            unsigned int sum_hcal = m_primitives_hcal_ll1->get_primitive_at_key(hcal_pkey)->get_sum_at_key(hcal_skey)->at(i);
-            unsigned int sum_emcal = m_primitives_emcal_ll1->get_primitive_at_key(emcal_pkey)->get_sum_at_key(emcal_skey)->at(i);
+          const std::vector<unsigned int> &sums_hcal = *m_primitives_hcal_ll1->get_primitive_at_key(hcal_pkey)->get_sum_at_key(hcal_skey);
+          const std::vector<unsigned int> &sums_emcal = *m_primitives_emcal_ll1->get_primitive_at_key(emcal_pkey)->get_sum_at_key(emcal_skey);
 
-            it_s = ((sum_hcal + sum_emcal) >> 1U);
-            i++;
+          std::vector<unsigned int> &sums = *iter_sum->second;
+          if (sums.size() > sums_hcal.size() || sums.size() > sums_emcal.size())
+          {
+            std::cout << PHWHERE << " inconsistent number of samples in jet sums" << std::endl;
+            return Fun4AllReturnCodes::ABORTEVENT;
+          }
+          for (std::size_t i = 0; i < sums.size(); i++)
+          {
+            sums[i] = ((sums_hcal[i] + sums_emcal[i]) >> 1U);
           }
         }
       }
@@ -1470,58 +1591,65 @@ int CaloTriggerEmulator::process_organizer()
         }
         TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("PAIR"), primlocid, isum);
         std::vector<unsigned int> *t_sum = primitive_photon->get_sum_at_key(sumkey);
-        ;
-        for (int is = 0; is < nsample; is++)
+
+        // the four 2x2 sums of the 4x4 window, looked up once for all samples
+        const std::vector<unsigned int> *window[4];
+
+        temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum);
+        window[0] = primitive->get_sum_at_key(temp_sum_key);
+        if (right_edge)
         {
-          unsigned int sum = 0;
+          temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1);
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1, (isum / 4) * 4);
+          window[1] = m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key);
+        }
+        else
+        {
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum + 1);
+          window[1] = primitive->get_sum_at_key(temp_sum_key);
+        }
+        if (top_edge)
+        {
+          temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid);
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid, isum % 4);
+          window[2] = m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key);
+        }
+        else
+        {
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum + 4);
+          window[2] = primitive->get_sum_at_key(temp_sum_key);
+        }
 
-          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum);
-          sum += (primitive->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          if (right_edge)
-          {
-            temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1);
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1, (isum / 4) * 4);
-            sum += (m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          }
-          else
-          {
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum + 1);
-            sum += (primitive->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          }
-          if (top_edge)
-          {
-            temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid);
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid, isum % 4);
-            sum += (m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          }
-          else
-          {
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum + 4);
-            sum += (primitive->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          }
+        if (top_edge && right_edge)
+        {
+          temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid + 1);
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid + 1, 0);
+          window[3] = m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key);
+        }
+        else if (top_edge)
+        {
+          temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid);
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid, isum % 4 + 1);
+          window[3] = m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key);
+        }
+        else if (right_edge)
+        {
+          temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1);
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1, (isum / 4 + 1) * 4);
+          window[3] = m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key);
+        }
+        else
+        {
+          temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum + 5);
+          window[3] = primitive->get_sum_at_key(temp_sum_key);
+        }
 
-          if (top_edge && right_edge)
-          {
-            temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid + 1);
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid + 1, 0);
-            sum += (m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          }
-          else if (top_edge)
-          {
-            temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid);
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, topedge_primlocid, isum % 4 + 1);
-            sum += (m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          }
-          else if (right_edge)
-          {
-            temp_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1);
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid + 1, (isum / 4 + 1) * 4);
-            sum += (m_primitives_emcal->get_primitive_at_key(temp_prim_key)->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
-          }
-          else
+        for (int is = 0; is < nsample; is++)
+        {
+          unsigned int sum = 0;
+          for (const auto *window_sum : window)
           {
-            temp_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::DetectorId::emcalDId, TriggerDefs::PrimitiveId::calPId, primlocid, isum + 5);
-            sum += (primitive->get_sum_at_key(temp_sum_key)->at(is) & 0xffU);
+            sum += (window_sum->at(is) & 0xffU);
           }
 
           sum = (sum >> 2U);
@@ -1659,17 +1787,8 @@ int CaloTriggerEmulator::process_trigger()
   {
     // Make the jet primitives
 
-    std::vector<unsigned int> jet_map[32][9]{};
-    for (auto &ie : jet_map)
-    {
-      for (auto &ip : ie)
-      {
-        for (int is = 0; is < nsample; is++)
-        {
-          ip.push_back(0);
-        }
-      }
-    }
+    // 32 x 9 jet patches, one row of samples per patch
+    m_jet_map.assign(32 * 9 * nsample, 0);
 
     if (!m_primitives)
     {
@@ -1691,20 +1810,28 @@ int CaloTriggerEmulator::process_trigger()
       {
         TriggerDefs::TriggerSumKey sumkey = (*iter_sum).first;
 
-        int i = 0;
         int sum_phi = static_cast<int>(TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 2 + TriggerDefs::getSumPhiId(sumkey));
         int sum_eta = static_cast<int>(TriggerDefs::getSumEtaId(sumkey));
-        for (unsigned int &it_s : *(*iter_sum).second)
+
+        const std::vector<unsigned int> &sums = *iter_sum->second;
+        if (sums.size() > (std::size_t) nsample)
+        {
+          std::cout << PHWHERE << " inconsistent number of samples in jet sums" << std::endl;
+          return Fun4AllReturnCodes::ABORTEVENT;
+        }
+
+        // add the sum to all the 4x4 jet patches that contain it
+        for (int ijeta = (sum_eta <= 3 ? 0 : sum_eta - 3); ijeta <= (sum_eta > 8 ? 8 : sum_eta); ijeta++)
         {
-          for (int ijeta = (sum_eta <= 3 ? 0 : sum_eta - 3); ijeta <= (sum_eta > 8 ? 8 : sum_eta); ijeta++)
+          for (int ijphi = sum_phi - 3; ijphi <= sum_phi; ijphi++)
           {
-            for (int ijphi = sum_phi - 3; ijphi <= sum_phi; ijphi++)
+            int iphi = (ijphi < 0 ? 32 + ijphi : ijphi);
+            unsigned int *jet_sums = &m_jet_map[(iphi * 9 + ijeta) * nsample];
+            for (std::size_t is = 0; is < sums.size(); is++)
             {
-              int iphi = (ijphi < 0 ? 32 + ijphi : ijphi);
-              jet_map[iphi][ijeta].at(i) += it_s;
+              jet_sums[is] += sums[is];
             }
           }
-          i++;
         }
       }
     }
@@ -1714,12 +1841,13 @@ int CaloTriggerEmulator::process_trigger()
     {
       for (int ijeta = 0; ijeta < 9; ijeta++)
       {
+        const unsigned int *jet_sums = &m_jet_map[(ijphi * 9 + ijeta) * nsample];
         unsigned int sk = ((unsigned int) ijphi & 0xffffU) + (((unsigned int) ijeta & 0xffffU) << 16U);
         std::vector<unsigned int> *sum = m_ll1out->get_word(sk);
         for (int is = 0; is < nsample; is++)
         {
-          sum->push_back(jet_map[ijphi][ijeta].at(is));
-          unsigned int bit = getBits(jet_map[ijphi][ijeta].at(is));
+          sum->push_back(jet_sums[is]);
+          unsigned int bit = getBits(jet_sums[is]);
           if (bit)
           {
             m_ll1out->addTriggeredSum(sk);
@@ -2431,6 +2559,17 @@ int CaloTriggerEmulator::End(PHCompositeNode * /*topNode*/)
   std::cout << "Total passed: " << m_npassed << "/" << m_nevent << std::endl;
   std::cout << "------------------------" << std::endl;
 
+  if (m_validate)
+  {
+    std::cout << m_trigger << " trigger, LUT histograms vs flat LUT tables in " << m_validation_nevents << " events:" << std::endl;
+    for (const auto &nsums : m_validation_nsums)
+    {
+      std::cout << "  " << nsums.first << ": " << m_validation_mismatches[nsums.first] << " of " << nsums.second << " sums differ" << std::endl;
+    }
+    std::cout << "  total: " << getValidationMismatches() << " mismatches" << std::endl;
+    std::cout << "------------------------" << std::endl;
+  }
+
   return 0;
 }
 
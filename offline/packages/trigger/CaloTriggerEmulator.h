@@ -8,6 +8,8 @@
 
 #include <cstdint>
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 // Forward declarations
@@ -86,6 +88,19 @@ class CaloTriggerEmulator : public SubsysReco
   void useHCALINDefaultLUT(bool def) { m_default_lut_hcalin = def; }
   void useHCALOUTDefaultLUT(bool def) { m_default_lut_hcalout = def; }
 
+  //! also build every event through the LUT histograms and the per tower peak finding,
+  //! and count the 2x2, 8x8, pair and jet sums that differ from the flat LUT tables
+  void setValidation(bool validate) { m_validate = validate; }
+  unsigned int getValidationMismatches() const
+  {
+    unsigned int nmismatches = 0;
+    for (const auto &mismatches : m_validation_mismatches)
+    {
+      nmismatches += mismatches.second;
+    }
+    return nmismatches;
+  }
+
   void setTriggerSample(int s) { m_trig_sample = s; }
   void setTriggerDelay(int d) { m_trig_sub_delay = d + 1; }
 
@@ -112,6 +127,25 @@ class CaloTriggerEmulator : public SubsysReco
   void identify();
 
  private:
+  //! copy the LUT histograms of one detector into a flat table, one row of 1024 entries per channel
+  void LoadLUT(CDBHistos *cdbhistos, const std::string &prefix, unsigned int nchannels, std::vector<uint16_t> &lut, std::vector<TH1 *> &lut_histos);
+
+  //! peak minus pedestal of each channel and sample, from the waveforms of one detector
+  void fill_peak_sub_ped(TowerInfoContainer *waveforms, unsigned int nchannels, int sample_start, int sample_end, const std::string &name, std::vector<uint16_t> &peak_sub_ped);
+
+  //! sum of the LUT outputs of the four channels of a 2x2 sum, for each sample, into m_temp_sum
+  void sum_lut_outputs(const unsigned int *channels, const std::vector<uint16_t> &peak_sub_ped, const std::vector<uint16_t> &lut, bool default_lut, int nsample);
+
+  //! validation: rebuild the event from the reference 2x2 sums and compare with the flat tables
+  void validate_event();
+
+  //! validation: 2x2 sums of one detector through the LUT histograms, as before the flat tables
+  void process_primitives_reference(TowerInfoContainer *waveforms, TriggerPrimitiveContainer *primitives, TriggerDefs::DetectorId detid, const std::vector<TH1 *> &lut_histos, bool default_lut);
+
+  //! validation: copy of all sums and trigger words of the event, keyed by (sum type, key)
+  typedef std::map<std::pair<std::string, unsigned int>, std::vector<unsigned int>> SumSnapshot;
+  void snapshot_sums(SumSnapshot &snapshot);
+
   std::string m_ll1_nodename;
   std::string m_prim_nodename;
   std::string m_waveform_nodename;
@@ -165,9 +199,19 @@ class CaloTriggerEmulator : public SubsysReco
   unsigned int m_l1_slewing_table[4096]{};
   unsigned int m_l1_hcal_table[4096]{};
 
-  std::map<unsigned int, TH1 *> h_emcal_lut;
-  std::map<unsigned int, TH1 *> h_hcalin_lut;
-  std::map<unsigned int, TH1 *> h_hcalout_lut;
+  //! LUT outputs, indexed by channel * 1024 + LUT input
+  std::vector<uint16_t> m_lut_emcal;
+  std::vector<uint16_t> m_lut_hcalin;
+  std::vector<uint16_t> m_lut_hcalout;
+
+  //! LUT histograms per channel, used by the validation (nullptr if missing)
+  std::vector<TH1 *> m_lut_histos_emcal;
+  std::vector<TH1 *> m_lut_histos_hcalin;
+  std::vector<TH1 *> m_lut_histos_hcalout;
+
+  //! channels of the four towers of each 2x2 sum, indexed by (primitive * 16 + sum) * 4 + tower
+  std::vector<unsigned int> m_sum_channels_emcal;
+  std::vector<unsigned int> m_sum_channels_hcal;
 
   CDBHistos *cdbttree_emcal{nullptr};
   CDBHistos *cdbttree_hcalin{nullptr};
@@ -203,10 +247,22 @@ class CaloTriggerEmulator : public SubsysReco
 
   unsigned int m_nhit1, m_nhit2, m_timediff1, m_timediff2, m_timediff3;
 
-  std::map<unsigned int, std::vector<unsigned int>> m_peak_sub_ped_emcal;
-  std::map<unsigned int, std::vector<unsigned int>> m_peak_sub_ped_mbd;
-  std::map<unsigned int, std::vector<unsigned int>> m_peak_sub_ped_hcalin;
-  std::map<unsigned int, std::vector<unsigned int>> m_peak_sub_ped_hcalout;
+  //! peak minus pedestal, indexed by channel * m_peak_nsamples + sample
+  std::vector<uint16_t> m_peak_sub_ped_emcal;
+  std::vector<uint16_t> m_peak_sub_ped_mbd;
+  std::vector<uint16_t> m_peak_sub_ped_hcalin;
+  std::vector<uint16_t> m_peak_sub_ped_hcalout;
+  int m_peak_nsamples{0};
+
+  //! per sample work buffers
+  std::vector<unsigned int> m_temp_sum;
+  std::vector<unsigned int> m_jet_map;
+
+  //! validation counters
+  bool m_validate{false};
+  int m_validation_nevents{0};
+  std::map<std::string, unsigned int> m_validation_nsums;
+  std::map<std::string, unsigned int> m_validation_mismatches;
 
   //! Verbosity.
   int m_nevent{0};
@@ -130,6 +130,7 @@ int PHG4CylinderSubsystem::InitRunSubsystem(PHCompositeNode *topNode)
     geo->AddLayerGeom(GetLayer(), mygeom);
     auto *tmp = new PHG4CylinderSteppingAction(this, m_Detector, GetParams());
     tmp->HitNodeName(nodename);
+    m_HitNodeName = nodename;
     m_SteppingAction = tmp;
   }
   else if (GetParams()->get_int_param("blackhole"))
@@ -155,6 +156,19 @@ int PHG4CylinderSubsystem::process_event(PHCompositeNode *topNode)
   return 0;
 }
 
+//_______________________________________________________________________
+void PHG4CylinderSubsystem::CreateWorkerActions(PHG4WorkerActions &actions)
+{
+  // same setup as the stepping action created in InitRunSubsystem()
+  if (m_SteppingAction)
+  {
+    auto *steppingaction = new PHG4CylinderSteppingAction(this, m_Detector, GetParams());
+    steppingaction->HitNodeName(m_HitNodeName);
+    steppingaction->SaveAllHits(m_SaveAllHitsFlag);
+    actions.stepping_action = steppingaction;
+  }
+}
+
 void PHG4CylinderSubsystem::SetDefaultParameters()
 {
   set_default_double_param("length", NAN);
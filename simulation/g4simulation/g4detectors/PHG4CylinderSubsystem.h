@@ -45,6 +45,10 @@ class PHG4CylinderSubsystem : public PHG4DetectorSubsystem
   PHG4Detector* GetDetector(void) const override;
   PHG4SteppingAction* GetSteppingAction(void) const override { return m_SteppingAction; }
 
+  //! multi threaded running
+  bool SupportsWorkerThreads() const override { return true; }
+  void CreateWorkerActions(PHG4WorkerActions& actions) override;
+
   PHG4DisplayAction* GetDisplayAction() const override { return m_DisplayAction; }
   void set_color(const double red, const double green, const double blue, const double alpha = 1.)
   {
@@ -79,6 +83,7 @@ class PHG4CylinderSubsystem : public PHG4DetectorSubsystem
   PHG4DisplayAction* m_DisplayAction{nullptr};
 
   bool m_SaveAllHitsFlag = false;
+  std::string m_HitNodeName;
   //! Color setting if we want to override the default
   std::array<double, 4> m_ColorArray{};
 };
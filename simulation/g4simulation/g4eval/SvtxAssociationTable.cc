@@ -0,0 +1,357 @@
+#include "SvtxAssociationTable.h"
+
+#include <trackbase/TrkrClusterContainer.h>
+#include <trackbase/TrkrClusterHitAssoc.h>
+#include <trackbase/TrkrDefs.h>
+#include <trackbase/TrkrHitTruthAssoc.h>
+
+#include <g4main/PHG4Hit.h>
+#include <g4main/PHG4HitContainer.h>
+#include <g4main/PHG4Particle.h>
+#include <g4main/PHG4TruthInfoContainer.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace
+{
+  // sort objects with given comparison, and store the new index of each object in remap
+  template <class T, class Compare>
+  void sort_objects(std::vector<T>& objects, Compare compare, std::vector<unsigned int>& order, std::vector<unsigned int>& remap)
+  {
+    order.resize(objects.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&objects, &compare](unsigned int a, unsigned int b)
+              { return compare(objects[a], objects[b]); });
+
+    remap.resize(objects.size());
+    std::vector<T> sorted;
+    sorted.reserve(objects.size());
+    for (unsigned int i = 0; i < order.size(); ++i)
+    {
+      remap[order[i]] = i;
+      sorted.push_back(objects[order[i]]);
+    }
+    objects.swap(sorted);
+  }
+}  // namespace
+
+void SvtxAssociationTable::LinkTable::fill(unsigned int nsources, std::vector<Triplet>& triplets)
+{
+  // stable sort, so that merged weights are summed in the order of the triplets
+  std::stable_sort(triplets.begin(), triplets.end(), [](const Triplet& a, const Triplet& b)
+                   { return a.source < b.source || (a.source == b.source && a.target < b.target); });
+
+  _offsets.assign(nsources + 1, 0);
+  _links.clear();
+  const Triplet* previous = nullptr;
+  for (const auto& triplet : triplets)
+  {
+    if (previous && previous->source == triplet.source && previous->target == triplet.target)
+    {
+      _links.back().weight += triplet.weight;
+    }
+    else
+    {
+      _links.push_back({triplet.target, triplet.weight});
+      ++_offsets[triplet.source + 1];
+    }
+    previous = &triplet;
+  }
+  std::partial_sum(_offsets.begin(), _offsets.end(), _offsets.begin());
+}
+
+void SvtxAssociationTable::LinkTable::fill_transposed(unsigned int nsources, const LinkTable& table, std::vector<Triplet>& triplets)
+{
+  triplets.clear();
+  for (unsigned int source = 0; source + 1 < table._offsets.size(); ++source)
+  {
+    for (const auto& link : table.row(source))
+    {
+      triplets.push_back({link.index, source, link.weight});
+    }
+  }
+  fill(nsources, triplets);
+}
+
+void SvtxAssociationTable::clear()
+{
+  _has_truth = false;
+  _has_tracks = false;
+
+  _clusters.clear();
+  _g4hits.clear();
+  _particles.clear();
+  _tracks.clear();
+
+  _cluster_index.clear();
+  _g4hit_index.clear();
+  _particle_index.clear();
+  _track_index.clear();
+
+  _track_triplets.clear();
+}
+
+void SvtxAssociationTable::fill_truth(TrkrClusterContainer* clustermap,
+                                      TrkrClusterHitAssoc* cluster_hit_map,
+                                      TrkrHitTruthAssoc* hit_truth_map,
+                                      PHG4HitContainer* g4hits_tpc,
+                                      PHG4HitContainer* g4hits_intt,
+                                      PHG4HitContainer* g4hits_mvtx,
+                                      PHG4HitContainer* g4hits_mms,
+                                      PHG4TruthInfoContainer* truthinfo)
+{
+  _clusters.clear();
+  _g4hits.clear();
+  _particles.clear();
+  _cluster_index.clear();
+  _g4hit_index.clear();
+  _particle_index.clear();
+
+  // cluster -> g4hit links, from the cluster hits and the hit truth association
+  _triplets.clear();
+  for (const auto& hitsetkey : clustermap->getHitSetKeys())
+  {
+    PHG4HitContainer* g4hits = nullptr;
+    switch (TrkrDefs::getTrkrId(hitsetkey))
+    {
+    case TrkrDefs::tpcId:
+      g4hits = g4hits_tpc;
+      break;
+    case TrkrDefs::inttId:
+      g4hits = g4hits_intt;
+      break;
+    case TrkrDefs::mvtxId:
+      g4hits = g4hits_mvtx;
+      break;
+    case TrkrDefs::micromegasId:
+      g4hits = g4hits_mms;
+      break;
+    default:
+      break;
+    }
+
+    // g4hit keys of each hit in this hitset, sorted by hit key
+    _hit_g4hits.clear();
+    if (g4hits && hit_truth_map)
+    {
+      const auto assoc_range = hit_truth_map->getG4Hits(hitsetkey);
+      for (auto iter = assoc_range.first; iter != assoc_range.second; ++iter)
+      {
+        _hit_g4hits.push_back(iter->second);
+      }
+      std::sort(_hit_g4hits.begin(), _hit_g4hits.end());
+    }
+
+    const auto cluster_range = clustermap->getClusters(hitsetkey);
+    for (auto iter = cluster_range.first; iter != cluster_range.second; ++iter)
+    {
+      const TrkrDefs::cluskey cluster_key = iter->first;
+      const unsigned int cluster = _clusters.size();
+      _clusters.push_back(cluster_key);
+
+      if (_hit_g4hits.empty() || !cluster_hit_map)
+      {
+        continue;
+      }
+
+      // g4hits of all the cluster hits, each counted once
+      _g4hit_keys.clear();
+      const auto hit_range = cluster_hit_map->getHits(cluster_key);
+      for (auto hititer = hit_range.first; hititer != hit_range.second; ++hititer)
+      {
+        const TrkrDefs::hitkey hitkey = hititer->second;
+        for (auto g4iter = std::lower_bound(_hit_g4hits.begin(), _hit_g4hits.end(), std::make_pair(hitkey, PHG4HitDefs::keytype(0)));
+             g4iter != _hit_g4hits.end() && g4iter->first == hitkey; ++g4iter)
+        {
+          _g4hit_keys.push_back(g4iter->second);
+        }
+      }
+      std::sort(_g4hit_keys.begin(), _g4hit_keys.end());
+      _g4hit_keys.erase(std::unique(_g4hit_keys.begin(), _g4hit_keys.end()), _g4hit_keys.end());
+
+      for (const auto& g4hitkey : _g4hit_keys)
+      {
+        PHG4Hit* g4hit = g4hits->findHit(g4hitkey);
+        if (!g4hit)
+        {
+          continue;
+        }
+        const auto [g4hit_iter, inserted] = _g4hit_index.try_emplace(g4hit, _g4hits.size());
+        if (inserted)
+        {
+          _g4hits.push_back(g4hit);
+        }
+        _triplets.push_back({cluster, g4hit_iter->second, g4hit->get_edep()});
+      }
+    }
+  }
+
+  // order clusters by key and g4hits by pointer
+  sort_objects(_clusters, std::less<TrkrDefs::cluskey>(), _order, _remap);
+  for (auto& triplet : _triplets)
+  {
+    triplet.source = _remap[triplet.source];
+  }
+  sort_objects(_g4hits, std::less<PHG4Hit*>(), _order, _remap);
+  for (auto& triplet : _triplets)
+  {
+    triplet.target = _remap[triplet.target];
+  }
+
+  for (unsigned int i = 0; i < _clusters.size(); ++i)
+  {
+    _cluster_index[_clusters[i]] = i;
+  }
+  for (unsigned int i = 0; i < _g4hits.size(); ++i)
+  {
+    _g4hit_index[_g4hits[i]] = i;
+  }
+
+  _cluster_g4hits.fill(_clusters.size(), _triplets);
+  _g4hit_clusters.fill_transposed(_g4hits.size(), _cluster_g4hits, _triplets);
+
+  // cluster -> particle links. The energy of each particle is summed in the g4hit order
+  _triplets.clear();
+  for (unsigned int cluster = 0; cluster < _clusters.size(); ++cluster)
+  {
+    for (const auto& link : _cluster_g4hits.row(cluster))
+    {
+      const int track_id = _g4hits[link.index]->get_trkid();
+      const auto [particle_iter, inserted] = _particle_index.try_emplace(track_id, _particles.size());
+      if (inserted)
+      {
+        _particles.emplace_back(track_id, truthinfo ? truthinfo->GetParticle(track_id) : nullptr);
+      }
+      _triplets.push_back({cluster, particle_iter->second, link.weight});
+    }
+  }
+
+  // order particles by pointer
+  sort_objects(_particles, [](const std::pair<int, PHG4Particle*>& a, const std::pair<int, PHG4Particle*>& b)
+               { return std::less<PHG4Particle*>()(a.second, b.second) || (a.second == b.second && a.first < b.first); },
+               _order, _remap);
+  for (auto& triplet : _triplets)
+  {
+    triplet.target = _remap[triplet.target];
+  }
+  for (unsigned int i = 0; i < _particles.size(); ++i)
+  {
+    _particle_index[_particles[i].first] = i;
+  }
+
+  _cluster_particles.fill(_clusters.size(), _triplets);
+  _particle_clusters.fill_transposed(_particles.size(), _cluster_particles, _triplets);
+
+  _has_truth = true;
+}
+
+void SvtxAssociationTable::add_track(SvtxTrack* track, const std::vector<TrkrDefs::cluskey>& cluster_keys)
+{
+  const unsigned int index = _tracks.size();
+  _tracks.emplace_back(track, cluster_keys.size());
+  for (const auto& cluster_key : cluster_keys)
+  {
+    unsigned int cluster = 0;
+    if (find_cluster(cluster_key, cluster))
+    {
+      _track_triplets.push_back({index, cluster, 1});
+    }
+  }
+}
+
+void SvtxAssociationTable::fill_tracks()
+{
+  // order tracks by pointer
+  sort_objects(_tracks, [](const std::pair<SvtxTrack*, unsigned int>& a, const std::pair<SvtxTrack*, unsigned int>& b)
+               { return std::less<SvtxTrack*>()(a.first, b.first); },
+               _order, _remap);
+  for (auto& triplet : _track_triplets)
+  {
+    triplet.source = _remap[triplet.source];
+  }
+  _track_index.clear();
+  for (unsigned int i = 0; i < _tracks.size(); ++i)
+  {
+    _track_index[_tracks[i].first] = i;
+  }
+
+  _track_clusters.fill(_tracks.size(), _track_triplets);
+  _cluster_tracks.fill_transposed(_clusters.size(), _track_clusters, _triplets);
+
+  // track -> particle links, weighted by the number of track clusters
+  _triplets.clear();
+  for (unsigned int track = 0; track < _tracks.size(); ++track)
+  {
+    for (const auto& cluster_link : _track_clusters.row(track))
+    {
+      for (const auto& particle_link : _cluster_particles.row(cluster_link.index))
+      {
+        _triplets.push_back({track, particle_link.index, cluster_link.weight});
+      }
+    }
+  }
+  _track_particles.fill(_tracks.size(), _triplets);
+  _particle_tracks.fill_transposed(_particles.size(), _track_particles, _triplets);
+
+  _track_triplets.clear();
+  _has_tracks = true;
+}
+
+bool SvtxAssociationTable::find_cluster(TrkrDefs::cluskey cluster_key, unsigned int& index) const
+{
+  const auto iter = _cluster_index.find(cluster_key);
+  if (iter == _cluster_index.end())
+  {
+    return false;
+  }
+  index = iter->second;
+  return true;
+}
+
+bool SvtxAssociationTable::find_g4hit(PHG4Hit* g4hit, unsigned int& index) const
+{
+  const auto iter = _g4hit_index.find(g4hit);
+  if (iter == _g4hit_index.end())
+  {
+    return false;
+  }
+  index = iter->second;
+  return true;
+}
+
+bool SvtxAssociationTable::find_particle(int track_id, unsigned int& index) const
+{
+  const auto iter = _particle_index.find(track_id);
+  if (iter == _particle_index.end())
+  {
+    return false;
+  }
+  index = iter->second;
+  return true;
+}
+
+bool SvtxAssociationTable::find_track(SvtxTrack* track, unsigned int& index) const
+{
+  const auto iter = _track_index.find(track);
+  if (iter == _track_index.end())
+  {
+    return false;
+  }
+  index = iter->second;
+  return true;
+}
+
+const SvtxAssociationTable::Link* SvtxAssociationTable::find_link(const LinkRange& links, unsigned int index)
+{
+  const auto iter = std::lower_bound(links.begin(), links.end(), index, [](const Link& link, unsigned int value)
+                                     { return link.index < value; });
+  return (iter != links.end() && iter->index == index) ? iter : nullptr;
+}
+
+float SvtxAssociationTable::get_weight(const LinkRange& links, unsigned int index)
+{
+  const Link* link = find_link(links, index);
+  return link ? link->weight : 0;
+}
@@ -0,0 +1,180 @@
+#ifndef G4EVAL_SVTXASSOCIATIONTABLE_H
+#define G4EVAL_SVTXASSOCIATIONTABLE_H
+
+#include <trackbase/TrkrDefs.h>
+
+#include <g4main/PHG4HitDefs.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class PHG4Hit;
+class PHG4HitContainer;
+class PHG4Particle;
+class PHG4TruthInfoContainer;
+class SvtxTrack;
+class TrkrClusterContainer;
+class TrkrClusterHitAssoc;
+class TrkrHitTruthAssoc;
+
+// Event level truth <-> reco association table for the Svtx evaluators
+//
+// Clusters, g4hits, truth particles and tracks are given a dense index, and the links between them are stored
+// in both directions as flat tables (compressed sparse rows), with a weight per link:
+//  - cluster <-> g4hit: g4hit energy deposition,
+//  - cluster <-> particle: sum of the energy deposited by the particle in the cluster,
+//  - track <-> cluster: number of times the cluster is used by the track,
+//  - track <-> particle: number of track clusters the particle contributes to.
+//
+// The truth part is filled in one pass over the clusters, the cluster-hit association
+// and the hit-truth association, and the track part in one pass over the track cluster lists.
+// Indices are assigned so that the links of a given row are ordered as the corresponding
+// std::set of pointers (or keys) returned by the evaluators.
+class SvtxAssociationTable
+{
+ public:
+  // one link, to the object with given index
+  struct Link
+  {
+    unsigned int index = 0;
+    float weight = 0;
+  };
+
+  // links of one row
+  class LinkRange
+  {
+   public:
+    LinkRange(const Link* first, const Link* last)
+      : _first(first)
+      , _last(last)
+    {
+    }
+    const Link* begin() const { return _first; }
+    const Link* end() const { return _last; }
+    bool empty() const { return _first == _last; }
+
+   private:
+    const Link* _first = nullptr;
+    const Link* _last = nullptr;
+  };
+
+  // reset, keeping the allocated memory
+  void clear();
+
+  // fill cluster, g4hit and particle associations
+  void fill_truth(TrkrClusterContainer* clustermap,
+                  TrkrClusterHitAssoc* cluster_hit_map,
+                  TrkrHitTruthAssoc* hit_truth_map,
+                  PHG4HitContainer* g4hits_tpc,
+                  PHG4HitContainer* g4hits_intt,
+                  PHG4HitContainer* g4hits_mvtx,
+                  PHG4HitContainer* g4hits_mms,
+                  PHG4TruthInfoContainer* truthinfo);
+  bool has_truth() const { return _has_truth; }
+
+  // add one track and its clusters, once the truth associations are filled.
+  // Clusters that are not in the table are counted, but not linked
+  void add_track(SvtxTrack* track, const std::vector<TrkrDefs::cluskey>& cluster_keys);
+
+  // fill track associations from the tracks added so far
+  void fill_tracks();
+  bool has_tracks() const { return _has_tracks; }
+
+  // index lookup, return false if the object is not in the table
+  bool find_cluster(TrkrDefs::cluskey cluster_key, unsigned int& index) const;
+  bool find_g4hit(PHG4Hit* g4hit, unsigned int& index) const;
+  bool find_particle(int track_id, unsigned int& index) const;
+  bool find_track(SvtxTrack* track, unsigned int& index) const;
+
+  // objects from index
+  TrkrDefs::cluskey get_cluster_key(unsigned int index) const { return _clusters[index]; }
+  PHG4Hit* get_g4hit(unsigned int index) const { return _g4hits[index]; }
+  PHG4Particle* get_particle(unsigned int index) const { return _particles[index].second; }
+  int get_particle_id(unsigned int index) const { return _particles[index].first; }
+  SvtxTrack* get_track(unsigned int index) const { return _tracks[index].first; }
+
+  // number of clusters of given track, counting duplicates
+  unsigned int get_track_nclusters(unsigned int index) const { return _tracks[index].second; }
+
+  // associations
+  LinkRange g4hits_from_cluster(unsigned int cluster) const { return _cluster_g4hits.row(cluster); }
+  LinkRange clusters_from_g4hit(unsigned int g4hit) const { return _g4hit_clusters.row(g4hit); }
+  LinkRange particles_from_cluster(unsigned int cluster) const { return _cluster_particles.row(cluster); }
+  LinkRange clusters_from_particle(unsigned int particle) const { return _particle_clusters.row(particle); }
+  LinkRange clusters_from_track(unsigned int track) const { return _track_clusters.row(track); }
+  LinkRange tracks_from_cluster(unsigned int cluster) const { return _cluster_tracks.row(cluster); }
+  LinkRange particles_from_track(unsigned int track) const { return _track_particles.row(track); }
+  LinkRange tracks_from_particle(unsigned int particle) const { return _particle_tracks.row(particle); }
+
+  // link to the object with given index, nullptr if not linked
+  static const Link* find_link(const LinkRange& links, unsigned int index);
+
+  // weight of the link to the object with given index, 0 if not linked
+  static float get_weight(const LinkRange& links, unsigned int index);
+
+ private:
+  // source, target and weight of one link, used to fill the tables
+  struct Triplet
+  {
+    unsigned int source = 0;
+    unsigned int target = 0;
+    float weight = 0;
+  };
+
+  // links in compressed sparse row format
+  class LinkTable
+  {
+   public:
+    // fill from unordered triplets. Links with same source and target are merged, summing their weights
+    // in the order of the triplets
+    void fill(unsigned int nsources, std::vector<Triplet>& triplets);
+
+    // fill the transposed of given table
+    void fill_transposed(unsigned int nsources, const LinkTable& table, std::vector<Triplet>& triplets);
+
+    LinkRange row(unsigned int source) const
+    {
+      return {_links.data() + _offsets[source], _links.data() + _offsets[source + 1]};
+    }
+
+   private:
+    std::vector<unsigned int> _offsets;
+    std::vector<Link> _links;
+  };
+
+  bool _has_truth = false;
+  bool _has_tracks = false;
+
+  // indexed objects
+  std::vector<TrkrDefs::cluskey> _clusters;
+  std::vector<PHG4Hit*> _g4hits;
+  std::vector<std::pair<int, PHG4Particle*>> _particles;
+  std::vector<std::pair<SvtxTrack*, unsigned int>> _tracks;
+
+  // object to index
+  std::unordered_map<TrkrDefs::cluskey, unsigned int> _cluster_index;
+  std::unordered_map<PHG4Hit*, unsigned int> _g4hit_index;
+  std::unordered_map<int, unsigned int> _particle_index;
+  std::unordered_map<SvtxTrack*, unsigned int> _track_index;
+
+  // association tables
+  LinkTable _cluster_g4hits;
+  LinkTable _g4hit_clusters;
+  LinkTable _cluster_particles;
+  LinkTable _particle_clusters;
+  LinkTable _track_clusters;
+  LinkTable _cluster_tracks;
+  LinkTable _track_particles;
+  LinkTable _particle_tracks;
+
+  // work buffers
+  std::vector<Triplet> _triplets;
+  std::vector<Triplet> _track_triplets;
+  std::vector<std::pair<TrkrDefs::hitkey, PHG4HitDefs::keytype>> _hit_g4hits;
+  std::vector<PHG4HitDefs::keytype> _g4hit_keys;
+  std::vector<unsigned int> _order;
+  std::vector<unsigned int> _remap;
+};
+
+#endif  // G4EVAL_SVTXASSOCIATIONTABLE_H
@@ -18,7 +18,6 @@
 #include <g4main/PHG4TruthInfoContainer.h>
 #include <g4main/PHG4VtxPoint.h>
 
-#include <phool/PHTimer.h>
 #include <phool/getClass.h>
 
 #include <TVector3.h>
@@ -49,18 +48,10 @@ SvtxClusterEval::~SvtxClusterEval()
 
 void SvtxClusterEval::next_event(PHCompositeNode* topNode)
 {
-  _cache_all_truth_hits.clear();
+  _assoc_table.clear();
   _cache_all_truth_clusters.clear();
-  _cache_max_truth_hit_by_energy.clear();
   _cache_max_truth_cluster_by_energy.clear();
-  _cache_all_truth_particles.clear();
-  _cache_max_truth_particle_by_energy.clear();
   _cache_max_truth_particle_by_cluster_energy.clear();
-  _cache_all_clusters_from_particle.clear();
-  _cache_all_clusters_from_g4hit.clear();
-  _cache_best_cluster_from_g4hit.clear();
-  _cache_get_energy_contribution_g4particle.clear();
-  _cache_get_energy_contribution_g4hit.clear();
   _cache_best_cluster_from_gtrackid_layer.clear();
   _clusters_per_layer.clear();
   //  _g4hits_per_layer.clear();
@@ -343,18 +334,18 @@ std::set<PHG4Hit*> SvtxClusterEval::all_truth_hits(TrkrDefs::cluskey cluster_key
     return std::set<PHG4Hit*>();
   }
 
-  if (_do_cache)
+  std::set<PHG4Hit*> truth_hits;
+
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
   {
-    std::map<TrkrDefs::cluskey, std::set<PHG4Hit*>>::iterator iter =
-        _cache_all_truth_hits.find(cluster_key);
-    if (iter != _cache_all_truth_hits.end())
+    for (const auto& link : _assoc_table.g4hits_from_cluster(cluster))
     {
-      return iter->second;
+      truth_hits.insert(truth_hits.end(), _assoc_table.get_g4hit(link.index));
     }
+    return truth_hits;
   }
 
-  std::set<PHG4Hit*> truth_hits;
-
   // get all truth hits for this cluster
   //_cluster_hit_map->identify();
   std::pair<std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator, std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator>
@@ -403,11 +394,6 @@ std::set<PHG4Hit*> SvtxClusterEval::all_truth_hits(TrkrDefs::cluskey cluster_key
     }  // end loop over g4hits associated with hitsetkey and hitkey
   }    // end loop over hits associated with cluskey
 
-  if (_do_cache)
-  {
-    _cache_all_truth_hits.insert(std::make_pair(cluster_key, truth_hits));
-  }
-
   return truth_hits;
 }
 
@@ -747,19 +733,24 @@ PHG4Hit* SvtxClusterEval::max_truth_hit_by_energy(TrkrDefs::cluskey cluster_key)
     return nullptr;
   }
 
-  if (_do_cache)
+  PHG4Hit* max_hit = nullptr;
+  float max_e = FLT_MAX * -1.0;
+
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
   {
-    std::map<TrkrDefs::cluskey, PHG4Hit*>::iterator iter =
-        _cache_max_truth_hit_by_energy.find(cluster_key);
-    if (iter != _cache_max_truth_hit_by_energy.end())
+    for (const auto& link : _assoc_table.g4hits_from_cluster(cluster))
     {
-      return iter->second;
+      if (link.weight > max_e)
+      {
+        max_e = link.weight;
+        max_hit = _assoc_table.get_g4hit(link.index);
+      }
     }
+    return max_hit;
   }
 
   std::set<PHG4Hit*> hits = all_truth_hits(cluster_key);
-  PHG4Hit* max_hit = nullptr;
-  float max_e = FLT_MAX * -1.0;
   for (auto hit : hits)
   {
     if (hit->get_edep() > max_e)
@@ -769,11 +760,6 @@ PHG4Hit* SvtxClusterEval::max_truth_hit_by_energy(TrkrDefs::cluskey cluster_key)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_max_truth_hit_by_energy.insert(std::make_pair(cluster_key, max_hit));
-  }
-
   return max_hit;
 }
 
@@ -785,18 +771,29 @@ std::set<PHG4Particle*> SvtxClusterEval::all_truth_particles(TrkrDefs::cluskey c
     return std::set<PHG4Particle*>();
   }
 
-  if (_do_cache)
+  std::set<PHG4Particle*> truth_particles;
+
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
   {
-    std::map<TrkrDefs::cluskey, std::set<PHG4Particle*>>::iterator iter =
-        _cache_all_truth_particles.find(cluster_key);
-    if (iter != _cache_all_truth_particles.end())
+    for (const auto& link : _assoc_table.particles_from_cluster(cluster))
     {
-      return iter->second;
+      PHG4Particle* particle = _assoc_table.get_particle(link.index);
+      if (_strict)
+      {
+        assert(particle);
+      }
+      else if (!particle)
+      {
+        ++_errors;
+        continue;
+      }
+
+      truth_particles.insert(truth_particles.end(), particle);
     }
+    return truth_particles;
   }
 
-  std::set<PHG4Particle*> truth_particles;
-
   std::set<PHG4Hit*> g4hits = all_truth_hits(cluster_key);
 
   for (auto hit : g4hits)
@@ -817,11 +814,6 @@ std::set<PHG4Particle*> SvtxClusterEval::all_truth_particles(TrkrDefs::cluskey c
     truth_particles.insert(particle);
   }
 
-  if (_do_cache)
-  {
-    _cache_all_truth_particles.insert(std::make_pair(cluster_key, truth_particles));
-  }
-
   return truth_particles;
 }
 
@@ -886,20 +878,26 @@ PHG4Particle* SvtxClusterEval::max_truth_particle_by_energy(TrkrDefs::cluskey cl
     return nullptr;
   }
 
-  if (_do_cache)
+  // loop over all particles associated with this cluster and
+  // get the energy contribution for each one, record the max
+  PHG4Particle* max_particle = nullptr;
+  float max_e = FLT_MAX * -1.0;
+
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
   {
-    std::map<TrkrDefs::cluskey, PHG4Particle*>::iterator iter =
-        _cache_max_truth_particle_by_energy.find(cluster_key);
-    if (iter != _cache_max_truth_particle_by_energy.end())
+    for (const auto& link : _assoc_table.particles_from_cluster(cluster))
     {
-      return iter->second;
+      PHG4Particle* particle = _assoc_table.get_particle(link.index);
+      if (particle && link.weight > max_e)
+      {
+        max_e = link.weight;
+        max_particle = particle;
+      }
     }
+    return max_particle;
   }
 
-  // loop over all particles associated with this cluster and
-  // get the energy contribution for each one, record the max
-  PHG4Particle* max_particle = nullptr;
-  float max_e = FLT_MAX * -1.0;
   std::set<PHG4Particle*> particles = all_truth_particles(cluster_key);
   for (auto particle : particles)
   {
@@ -911,11 +909,6 @@ PHG4Particle* SvtxClusterEval::max_truth_particle_by_energy(TrkrDefs::cluskey cl
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_max_truth_particle_by_energy.insert(std::make_pair(cluster_key, max_particle));
-  }
-
   return max_particle;
 }
 
@@ -936,33 +929,22 @@ std::set<TrkrDefs::cluskey> SvtxClusterEval::all_clusters_from(PHG4Particle* tru
     ++_errors;
     return std::set<TrkrDefs::cluskey>();
   }
-  // check if cache is filled, if not fill it.
-  //   if(_cache_all_clusters_from_particle.count(truthparticle)==0){
-  if (_cache_all_clusters_from_particle.empty())
-  {
-    FillRecoClusterFromG4HitCache();
-  }
+
+  std::set<TrkrDefs::cluskey> clusters;
 
   if (_do_cache)
   {
-    std::map<PHG4Particle*, std::set<TrkrDefs::cluskey>>::iterator iter =
-        _cache_all_clusters_from_particle.find(truthparticle);
-    if (iter != _cache_all_clusters_from_particle.end())
+    unsigned int particle = 0;
+    if (get_association_table()->find_particle(truthparticle->get_track_id(), particle))
     {
-      return iter->second;
+      for (const auto& link : _assoc_table.clusters_from_particle(particle))
+      {
+        clusters.insert(clusters.end(), _assoc_table.get_cluster_key(link.index));
+      }
     }
+    return clusters;
   }
-  std::set<TrkrDefs::cluskey> clusters;
-  return clusters;
-}
-
-void SvtxClusterEval::FillRecoClusterFromG4HitCache()
-{
-  auto Mytimer = std::make_unique<PHTimer>("ReCl_timer");
-  Mytimer->stop();
-  Mytimer->restart();
 
-  std::multimap<PHG4Particle*, TrkrDefs::cluskey> temp_clusters_from_particles;
   // loop over all the clusters
   for (const auto& hitsetkey : _clustermap->getHitSetKeys())
   {
@@ -970,34 +952,14 @@ void SvtxClusterEval::FillRecoClusterFromG4HitCache()
     for (auto iter = range.first; iter != range.second; ++iter)
     {
       TrkrDefs::cluskey cluster_key = iter->first;
-
-      // loop over all truth particles connected to this cluster
-      std::set<PHG4Particle*> particles = all_truth_particles(cluster_key);
-      for (auto candidate : particles)
+      if (all_truth_particles(cluster_key).count(truthparticle))
       {
-        temp_clusters_from_particles.insert(std::make_pair(candidate, cluster_key));
+        clusters.insert(clusters.end(), cluster_key);
       }
     }
   }
-  // Loop over particles and fill cache
-  PHG4TruthInfoContainer::ConstRange range = _truthinfo->GetParticleRange();
-  for (PHG4TruthInfoContainer::ConstIterator iter = range.first;
-       iter != range.second; ++iter)
-  {
-    PHG4Particle* g4particle = iter->second;
-    std::set<TrkrDefs::cluskey> clusters;
-    std::multimap<PHG4Particle*, TrkrDefs::cluskey>::const_iterator lower_bound = temp_clusters_from_particles.lower_bound(g4particle);
-    std::multimap<PHG4Particle*, TrkrDefs::cluskey>::const_iterator upper_bound = temp_clusters_from_particles.upper_bound(g4particle);
-    std::multimap<PHG4Particle*, TrkrDefs::cluskey>::const_iterator cfp_iter;
-    for (cfp_iter = lower_bound; cfp_iter != upper_bound; ++cfp_iter)
-    {
-      TrkrDefs::cluskey cluster_key = cfp_iter->second;
-      clusters.insert(cluster_key);
-    }
-    _cache_all_clusters_from_particle.insert(std::make_pair(g4particle, clusters));
-  }
 
-  Mytimer->stop();
+  return clusters;
 }
 
 std::set<TrkrDefs::cluskey> SvtxClusterEval::all_clusters_from(PHG4Hit* truthhit)
@@ -1018,107 +980,37 @@ std::set<TrkrDefs::cluskey> SvtxClusterEval::all_clusters_from(PHG4Hit* truthhit
     return std::set<TrkrDefs::cluskey>();
   }
 
-  // one time, fill cache of g4hit/cluster pairs
-  if (_cache_all_clusters_from_g4hit.size() == 0)
-  {
-    // make a map of truthhit, cluster_key inside this loop
-    std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey> truth_cluster_map;
-    std::set<PHG4HitDefs::keytype> all_g4hits_set;
-    std::map<PHG4HitDefs::keytype, PHG4Hit*> all_g4hits_map;
+  // get the clusters
+  std::set<TrkrDefs::cluskey> clusters;
 
-    // get all reco clusters
-    if (_verbosity > 1)
+  if (_do_cache)
+  {
+    unsigned int g4hit = 0;
+    if (get_association_table()->find_g4hit(truthhit, g4hit))
     {
-      std::cout << "all_clusters_from_g4hit: list all reco clusters " << std::endl;
+      for (const auto& link : _assoc_table.clusters_from_g4hit(g4hit))
+      {
+        clusters.insert(clusters.end(), _assoc_table.get_cluster_key(link.index));
+      }
+      return clusters;
     }
-
+  }
+  else
+  {
+    // loop over all the clusters
     for (const auto& hitsetkey : _clustermap->getHitSetKeys())
     {
       auto range = _clustermap->getClusters(hitsetkey);
       for (auto iter = range.first; iter != range.second; ++iter)
       {
         TrkrDefs::cluskey cluster_key = iter->first;
-        int layer = TrkrDefs::getLayer(cluster_key);
-        TrkrCluster* clus = iter->second;
-        if (_verbosity > 1)
-        {
-          std::cout << " layer " << layer << " cluster_key " << cluster_key << " adc " << clus->getAdc()
-                    << " localx " << clus->getLocalX()
-                    << " localy " << clus->getLocalY()
-                    << std::endl;
-          std::cout << "  associated hits:";
-          std::pair<std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator, std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator>
-              hitrange = _cluster_hit_map->getHits(cluster_key);  // returns range of pairs {cluster key, hit key} for this cluskey
-          for (std::multimap<TrkrDefs::cluskey, TrkrDefs::hitkey>::const_iterator
-                   clushititer = hitrange.first;
-               clushititer != hitrange.second; ++clushititer)
-          {
-            TrkrDefs::hitkey hitkey = clushititer->second;
-            std::cout << " " << hitkey;
-          }
-          std::cout << std::endl;
-        }
-
-        // the returned truth hits were obtained from TrkrAssoc maps
-        std::set<PHG4Hit*> hits = all_truth_hits(cluster_key);
-        for (auto candidate : hits)
-        {
-          PHG4HitDefs::keytype g4hit_key = candidate->get_hit_id();
-
-          if (_verbosity > 5)
-          {
-            int gtrackID = candidate->get_trkid();
-            std::cout << "   adding cluster with cluster_key " << cluster_key << " g4hit with g4hit_key " << g4hit_key
-                      << " gtrackID " << gtrackID
-                      << std::endl;
-          }
-
-          all_g4hits_set.insert(g4hit_key);
-          all_g4hits_map.insert(std::make_pair(g4hit_key, candidate));
-
-          truth_cluster_map.insert(std::make_pair(g4hit_key, cluster_key));
-        }
-      }
-    }
-
-    // now fill the cache
-    // loop over all entries in all_g4hits
-    for (unsigned long long g4hit_key : all_g4hits_set)
-    {
-      if (_verbosity > 5)
-      {
-        std::cout << " associations for g4hit_key " << g4hit_key << std::endl;
-      }
-
-      std::map<PHG4HitDefs::keytype, PHG4Hit*>::iterator it = all_g4hits_map.find(g4hit_key);
-      PHG4Hit* g4hit = it->second;
-
-      std::set<TrkrDefs::cluskey> assoc_clusters;
-
-      std::pair<std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey>::iterator,
-                std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey>::iterator>
-          ret = truth_cluster_map.equal_range(g4hit_key);
-      for (std::multimap<PHG4HitDefs::keytype, TrkrDefs::cluskey>::iterator jter = ret.first; jter != ret.second; ++jter)
-      {
-        assoc_clusters.insert(jter->second);
-
-        if (_verbosity > 5)
+        if (all_truth_hits(cluster_key).count(truthhit))
         {
-          std::cout << "             g4hit_key " << g4hit_key << " associated with cluster_key " << jter->second << std::endl;
+          clusters.insert(clusters.end(), cluster_key);
         }
       }
-      // done with this g4hit
-      _cache_all_clusters_from_g4hit.insert(std::make_pair(g4hit, assoc_clusters));
     }
-  }
-
-  // get the clusters
-  std::set<TrkrDefs::cluskey> clusters;
-  std::map<PHG4Hit*, std::set<TrkrDefs::cluskey>>::iterator iter =
-      _cache_all_clusters_from_g4hit.find(truthhit);
-  if (iter != _cache_all_clusters_from_g4hit.end())
-  {
-    return iter->second;
+    return clusters;
   }
 
   if (_clusters_per_layer.size() == 0)
@@ -1223,18 +1115,23 @@ TrkrDefs::cluskey SvtxClusterEval::best_cluster_from(PHG4Hit* truthhit)
     return 0;
   }
 
-  if (_do_cache)
+  TrkrDefs::cluskey best_cluster = 0;
+  float best_energy = 0.0;
+
+  unsigned int g4hit = 0;
+  if (_do_cache && get_association_table()->find_g4hit(truthhit, g4hit))
   {
-    std::map<PHG4Hit*, TrkrDefs::cluskey>::iterator iter =
-        _cache_best_cluster_from_g4hit.find(truthhit);
-    if (iter != _cache_best_cluster_from_g4hit.end())
+    for (const auto& link : _assoc_table.clusters_from_g4hit(g4hit))
     {
-      return iter->second;
+      if (link.weight > best_energy)
+      {
+        best_cluster = _assoc_table.get_cluster_key(link.index);
+        best_energy = link.weight;
+      }
     }
+    return best_cluster;
   }
 
-  TrkrDefs::cluskey best_cluster = 0;
-  float best_energy = 0.0;
   std::set<TrkrDefs::cluskey> clusters = all_clusters_from(truthhit);
   for (unsigned long cluster_key : clusters)
   {
@@ -1246,11 +1143,6 @@ TrkrDefs::cluskey SvtxClusterEval::best_cluster_from(PHG4Hit* truthhit)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_best_cluster_from_g4hit.insert(std::make_pair(truthhit, best_cluster));
-  }
-
   return best_cluster;
 }
 
@@ -1277,14 +1169,15 @@ float SvtxClusterEval::get_energy_contribution(TrkrDefs::cluskey cluster_key, PH
     return NAN;
   }
 
-  if (_do_cache)
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
   {
-    std::map<std::pair<TrkrDefs::cluskey, PHG4Particle*>, float>::iterator iter =
-        _cache_get_energy_contribution_g4particle.find(std::make_pair(cluster_key, particle));
-    if (iter != _cache_get_energy_contribution_g4particle.end())
+    unsigned int index = 0;
+    if (!_assoc_table.find_particle(particle->get_track_id(), index))
     {
-      return iter->second;
+      return 0.0;
     }
+    return SvtxAssociationTable::get_weight(_assoc_table.particles_from_cluster(cluster), index);
   }
 
   float energy = 0.0;
@@ -1297,11 +1190,6 @@ float SvtxClusterEval::get_energy_contribution(TrkrDefs::cluskey cluster_key, PH
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_get_energy_contribution_g4particle.insert(std::make_pair(std::make_pair(cluster_key, particle), energy));
-  }
-
   return energy;
 }
 
@@ -1324,17 +1212,24 @@ float SvtxClusterEval::get_energy_contribution(TrkrDefs::cluskey cluster_key, PH
     return NAN;
   }
 
-  if ((_do_cache) &&
-      (_cache_get_energy_contribution_g4hit.find(std::make_pair(cluster_key, g4hit)) !=
-       _cache_get_energy_contribution_g4hit.end()))
-  {
-    return _cache_get_energy_contribution_g4hit[std::make_pair(cluster_key, g4hit)];
-  }
-
   // this is a fairly simple existance check right now, but might be more
   // complex in the future, so this is here mostly as future-proofing.
 
   float energy = 0.0;
+
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
+  {
+    for (const auto& link : _assoc_table.g4hits_from_cluster(cluster))
+    {
+      if (_assoc_table.get_g4hit(link.index)->get_hit_id() == g4hit->get_hit_id())
+      {
+        energy += link.weight;
+      }
+    }
+    return energy;
+  }
+
   std::set<PHG4Hit*> g4hits = all_truth_hits(cluster_key);
   for (auto candidate : g4hits)
   {
@@ -1345,11 +1240,6 @@ float SvtxClusterEval::get_energy_contribution(TrkrDefs::cluskey cluster_key, PH
     energy += candidate->get_edep();
   }
 
-  if (_do_cache)
-  {
-    _cache_get_energy_contribution_g4hit.insert(std::make_pair(std::make_pair(cluster_key, g4hit), energy));
-  }
-
   return energy;
 }
 
@@ -1,6 +1,7 @@
 #ifndef G4EVAL_SVTXCLUSTEREVAL_H
 #define G4EVAL_SVTXCLUSTEREVAL_H
 
+#include "SvtxAssociationTable.h"
 #include "SvtxHitEval.h"
 
 #include <trackbase/ActsGeometry.h>
@@ -53,6 +54,16 @@ class SvtxClusterEval
   SvtxHitEval* get_hit_eval() { return &_hiteval; }
   SvtxTruthEval* get_truth_eval() { return _hiteval.get_truth_eval(); }
 
+  // event level truth association table, filled on first use
+  SvtxAssociationTable* get_association_table()
+  {
+    if (!_assoc_table.has_truth())
+    {
+      _assoc_table.fill_truth(_clustermap, _cluster_hit_map, _hit_truth_map, _g4hits_tpc, _g4hits_intt, _g4hits_mvtx, _g4hits_mms, _truthinfo);
+    }
+    return &_assoc_table;
+  }
+
   // backtrace through to PHG4Hits
   std::set<PHG4Hit*> all_truth_hits(TrkrDefs::cluskey cluster);
   PHG4Hit* max_truth_hit_by_energy(TrkrDefs::cluskey);
@@ -71,11 +82,14 @@ class SvtxClusterEval
   PHG4Particle* max_truth_particle_by_cluster_energy(TrkrDefs::cluskey);
 
   // forwardtrace through to SvtxClusters
+  // with caching, these are looked up in the association table, and truth hits or particles
+  // missing from the node tree are not counted as errors. Without caching, all clusters
+  // are backtraced on each call, and errors are counted by the backtrace
   std::set<TrkrDefs::cluskey> all_clusters_from(PHG4Particle* truthparticle);
   std::set<TrkrDefs::cluskey> all_clusters_from(PHG4Hit* truthhit);
   TrkrDefs::cluskey best_cluster_from(PHG4Hit* truthhit);
   TrkrDefs::cluskey best_cluster_by_nhit(int gid, int layer);
-  void FillRecoClusterFromG4HitCache();
+
   // overlap calculations
   float get_energy_contribution(TrkrDefs::cluskey cluster_key, PHG4Particle* truthparticle);
   float get_energy_contribution(TrkrDefs::cluskey cluster_key, PHG4Hit* truthhit);
@@ -113,19 +127,11 @@ class SvtxClusterEval
   Acts::Vector3 getGlobalPosition(TrkrDefs::cluskey cluster_key, TrkrCluster* cluster);
 
   bool _do_cache = true;
-  std::map<TrkrDefs::cluskey, std::set<PHG4Hit*>> _cache_all_truth_hits;
+  SvtxAssociationTable _assoc_table;
   std::map<TrkrDefs::cluskey, std::map<TrkrDefs::cluskey, std::shared_ptr<TrkrCluster>>> _cache_all_truth_clusters;
-  std::map<TrkrDefs::cluskey, PHG4Hit*> _cache_max_truth_hit_by_energy;
   std::map<TrkrDefs::cluskey, std::pair<TrkrDefs::cluskey, std::shared_ptr<TrkrCluster>>> _cache_max_truth_cluster_by_energy;
-  std::map<TrkrDefs::cluskey, std::set<PHG4Particle*>> _cache_all_truth_particles;
-  std::map<TrkrDefs::cluskey, PHG4Particle*> _cache_max_truth_particle_by_energy;
   std::map<TrkrDefs::cluskey, PHG4Particle*> _cache_max_truth_particle_by_cluster_energy;
-  std::map<PHG4Particle*, std::set<TrkrDefs::cluskey>> _cache_all_clusters_from_particle;
-  std::map<PHG4Hit*, std::set<TrkrDefs::cluskey>> _cache_all_clusters_from_g4hit;
-  std::map<PHG4Hit*, TrkrDefs::cluskey> _cache_best_cluster_from_g4hit;
   std::map<std::pair<int, int>, TrkrDefs::cluskey> _cache_best_cluster_from_gtrackid_layer;
-  std::map<std::pair<TrkrDefs::cluskey, PHG4Particle*>, float> _cache_get_energy_contribution_g4particle;
-  std::map<std::pair<TrkrDefs::cluskey, PHG4Hit*>, float> _cache_get_energy_contribution_g4hit;
   std::map<std::shared_ptr<TrkrCluster>, std::pair<TrkrDefs::cluskey, TrkrCluster*>> _cache_reco_cluster_from_truth_cluster;
 
   // measured for low occupancy events, all in cm
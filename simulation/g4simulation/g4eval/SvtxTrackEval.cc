@@ -42,15 +42,7 @@ SvtxTrackEval::~SvtxTrackEval()
 void SvtxTrackEval::next_event(PHCompositeNode* topNode)
 {
   _cache_all_truth_hits.clear();
-  _cache_all_truth_particles.clear();
-  _cache_max_truth_particle_by_nclusters.clear();
-  _cache_all_tracks_from_particle.clear();
-  _cache_best_track_from_particle.clear();
-  _cache_all_tracks_from_g4hit.clear();
-  _cache_all_tracks_from_cluster.clear();
-  _cache_best_track_from_cluster.clear();
   _cache_get_nclusters_contribution.clear();
-  _cache_get_nclusters_contribution_by_layer.clear();
   _cache_get_nwrongclusters_contribution.clear();
   _clustereval.next_event(topNode);
 
@@ -148,24 +140,35 @@ std::set<PHG4Particle*> SvtxTrackEval::all_truth_particles(SvtxTrack* track)
     return returnset;
   }
 
-  if (_do_cache)
-  {
-    std::map<SvtxTrack*, std::set<PHG4Particle*> >::iterator iter =
-        _cache_all_truth_particles.find(track);
-    if (iter != _cache_all_truth_particles.end())
-    {
-      return iter->second;
-    }
-  }
   std::set<PHG4Particle*> truth_particles;
   SvtxTrack_FastSim* fastsim_track = dynamic_cast<SvtxTrack_FastSim*>(track);
 
+  unsigned int index = 0;
   if (fastsim_track)
   {
     // exception for fast sim track
     unsigned int track_id = fastsim_track->get_truth_track_id();
     truth_particles.insert(get_truth_eval()->get_particle(track_id));
   }
+  else if (_do_cache && get_association_table()->find_track(track, index))
+  {
+    SvtxAssociationTable* table = get_association_table();
+    for (const auto& link : table->particles_from_track(index))
+    {
+      PHG4Particle* particle = table->get_particle(link.index);
+      if (_strict)
+      {
+        assert(particle);
+      }
+      else if (!particle)
+      {
+        ++_errors;
+        continue;
+      }
+
+      truth_particles.insert(truth_particles.end(), particle);
+    }
+  }
   else
   {
     // loop over all clusters...
@@ -191,11 +194,6 @@ std::set<PHG4Particle*> SvtxTrackEval::all_truth_particles(SvtxTrack* track)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_all_truth_particles.insert(std::make_pair(track, truth_particles));
-  }
-
   return truth_particles;
 }
 
@@ -230,30 +228,36 @@ PHG4Particle* SvtxTrackEval::max_truth_particle_by_nclusters(SvtxTrack* track)
     return _truthinfo->GetParticle(bestpart);
   }
 
-  if (_do_cache)
-  {
-    std::map<SvtxTrack*, PHG4Particle*>::iterator iter =
-        _cache_max_truth_particle_by_nclusters.find(track);
-    if (iter != _cache_max_truth_particle_by_nclusters.end())
-    {
-      return iter->second;
-    }
-  }
-
-  std::set<PHG4Particle*> particles = all_truth_particles(track);
   PHG4Particle* max_particle = nullptr;
 
   SvtxTrack_FastSim* fastsim_track = dynamic_cast<SvtxTrack_FastSim*>(track);
+  unsigned int index = 0;
   if (fastsim_track)
   {
     // exception for fast sim track
     unsigned int track_id = fastsim_track->get_truth_track_id();
     max_particle = get_truth_eval()->get_particle(track_id);
   }
+  else if (_do_cache && get_association_table()->find_track(track, index))
+  {
+    // link weight is the number of track clusters from the particle
+    SvtxAssociationTable* table = get_association_table();
+    float max_nclusters = 0;
+    for (const auto& link : table->particles_from_track(index))
+    {
+      PHG4Particle* candidate = table->get_particle(link.index);
+      if (candidate && link.weight > max_nclusters)
+      {
+        max_nclusters = link.weight;
+        max_particle = candidate;
+      }
+    }
+  }
   else
   {
     unsigned int max_nclusters = 0;
 
+    std::set<PHG4Particle*> particles = all_truth_particles(track);
     for (auto candidate : particles)
     {
       unsigned int nclusters = get_nclusters_contribution(track, candidate);
@@ -265,11 +269,6 @@ PHG4Particle* SvtxTrackEval::max_truth_particle_by_nclusters(SvtxTrack* track)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_max_truth_particle_by_nclusters.insert(std::make_pair(track, max_particle));
-  }
-
   return max_particle;
 }
 
@@ -308,12 +307,7 @@ std::set<SvtxTrack*> SvtxTrackEval::all_tracks_from(PHG4Particle* truthparticle)
 
   if (_do_cache)
   {
-    std::map<PHG4Particle*, std::set<SvtxTrack*> >::iterator iter =
-        _cache_all_tracks_from_particle.find(truthparticle);
-    if (iter != _cache_all_tracks_from_particle.end())
-    {
-      return iter->second;
-    }
+    return tracks_from_trkid(truthparticle->get_track_id());
   }
 
   std::set<SvtxTrack*> tracks;
@@ -348,11 +342,6 @@ std::set<SvtxTrack*> SvtxTrackEval::all_tracks_from(PHG4Particle* truthparticle)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_all_tracks_from_particle.insert(std::make_pair(truthparticle, tracks));
-  }
-
   return tracks;
 }
 
@@ -376,12 +365,7 @@ std::set<SvtxTrack*> SvtxTrackEval::all_tracks_from(PHG4Hit* truthhit)
 
   if (_do_cache)
   {
-    std::map<PHG4Hit*, std::set<SvtxTrack*> >::iterator iter =
-        _cache_all_tracks_from_g4hit.find(truthhit);
-    if (iter != _cache_all_tracks_from_g4hit.end())
-    {
-      return iter->second;
-    }
+    return tracks_from_trkid(truthhit->get_trkid());
   }
 
   std::set<SvtxTrack*> tracks;
@@ -417,11 +401,6 @@ std::set<SvtxTrack*> SvtxTrackEval::all_tracks_from(PHG4Hit* truthhit)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_all_tracks_from_g4hit.insert(std::make_pair(truthhit, tracks));
-  }
-
   return tracks;
 }
 
@@ -458,18 +437,29 @@ SvtxTrack* SvtxTrackEval::best_track_from(PHG4Particle* truthparticle)
     return _trackmap->get(bestpart);
   }
 
+  SvtxTrack* best_track = nullptr;
+  unsigned int best_count = 0;
+
   if (_do_cache)
   {
-    std::map<PHG4Particle*, SvtxTrack*>::iterator iter =
-        _cache_best_track_from_particle.find(truthparticle);
-    if (iter != _cache_best_track_from_particle.end())
+    // link weight is the number of track clusters from the particle
+    SvtxAssociationTable* table = get_association_table();
+    unsigned int index = 0;
+    if (table->find_particle(truthparticle->get_track_id(), index))
     {
-      return iter->second;
+      for (const auto& link : table->tracks_from_particle(index))
+      {
+        const unsigned int count = link.weight;
+        if (count > best_count)
+        {
+          best_track = table->get_track(link.index);
+          best_count = count;
+        }
+      }
     }
+    return best_track;
   }
 
-  SvtxTrack* best_track = nullptr;
-  unsigned int best_count = 0;
   std::set<SvtxTrack*> tracks = all_tracks_from(truthparticle);
   for (auto track : tracks)
   {
@@ -481,62 +471,9 @@ SvtxTrack* SvtxTrackEval::best_track_from(PHG4Particle* truthparticle)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_best_track_from_particle.insert(std::make_pair(truthparticle, best_track));
-  }
-
   return best_track;
 }
 
-void SvtxTrackEval::create_cache_track_from_cluster()
-{
-  if (!has_node_pointers())
-  {
-    ++_errors;
-    return;
-  }
-
-  // loop over all SvtxTracks
-  for (auto& iter : *_trackmap)
-  {
-    SvtxTrack* track = iter.second;
-    std::vector<TrkrDefs::cluskey> cluster_keys = get_track_ckeys(track);
-
-    // loop over all clusters
-    for (const auto& candidate_key : cluster_keys)
-    {
-      // unsigned int cluster_layer = TrkrDefs::getLayer(candidate_key);
-      //      if (_strict)
-      //      {
-      //        assert(candidate_key);
-      //      }
-      //      else if (!candidate_key)
-      //      {
-      //        ++_errors;
-      //        continue;
-      //      }
-
-      // check if cluster has an entry in cache
-      std::map<TrkrDefs::cluskey, std::set<SvtxTrack*> >::iterator cliter =
-          _cache_all_tracks_from_cluster.find(candidate_key);
-      if (cliter != _cache_all_tracks_from_cluster.end())
-      {                                // got entry
-        cliter->second.insert(track);  // add track to list;
-      }
-      else
-      {
-        std::set<SvtxTrack*> tracks;
-        tracks.insert(track);
-        _cache_all_tracks_from_cluster.insert(std::make_pair(candidate_key, tracks));
-      }
-    }
-  }
-  _cache_track_from_cluster_exists = true;
-
-  return;
-}
-
 std::set<SvtxTrack*> SvtxTrackEval::all_tracks_from(TrkrDefs::cluskey cluster_key)
 {
   if (!has_node_pointers())
@@ -557,22 +494,15 @@ std::set<SvtxTrack*> SvtxTrackEval::all_tracks_from(TrkrDefs::cluskey cluster_ke
 
   std::set<SvtxTrack*> tracks;
 
-  if (_do_cache)
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
   {
-    if (_cache_track_from_cluster_exists == false)
-    {
-      create_cache_track_from_cluster();
-    }
-    std::map<TrkrDefs::cluskey, std::set<SvtxTrack*> >::iterator iter =
-        _cache_all_tracks_from_cluster.find(cluster_key);
-    if (iter != _cache_all_tracks_from_cluster.end())
+    SvtxAssociationTable* table = get_association_table();
+    for (const auto& link : table->tracks_from_cluster(cluster))
     {
-      return iter->second;
-    }
-    else
-    {
-      return tracks;
+      tracks.insert(tracks.end(), table->get_track(link.index));
     }
+    return tracks;
   }
 
   // loop over all SvtxTracks
@@ -601,11 +531,6 @@ std::set<SvtxTrack*> SvtxTrackEval::all_tracks_from(TrkrDefs::cluskey cluster_ke
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_all_tracks_from_cluster.insert(std::make_pair(cluster_key, tracks));
-  }
-
   return tracks;
 }
 
@@ -627,16 +552,6 @@ SvtxTrack* SvtxTrackEval::best_track_from(TrkrDefs::cluskey cluster_key)
   //    return nullptr;
   //  }
 
-  if (_do_cache)
-  {
-    std::map<TrkrDefs::cluskey, SvtxTrack*>::iterator iter =
-        _cache_best_track_from_cluster.find(cluster_key);
-    if (iter != _cache_best_track_from_cluster.end())
-    {
-      return iter->second;
-    }
-  }
-
   SvtxTrack* best_track = nullptr;
   float best_quality = FLT_MAX;
 
@@ -651,10 +566,6 @@ SvtxTrack* SvtxTrackEval::best_track_from(TrkrDefs::cluskey cluster_key)
     }
   }
 
-  if (_do_cache)
-  {
-    _cache_best_track_from_cluster.insert(std::make_pair(cluster_key, best_track));
-  }
   return best_track;
 }
 
@@ -766,18 +677,11 @@ void SvtxTrackEval::calc_cluster_contribution(SvtxTrack* track, PHG4Particle* pa
     //      ++_errors;
     //      continue;
     //    }
-    int matched = 0;
-    // loop over all particles
-    std::set<PHG4Particle*> particles = _clustereval.all_truth_particles(cluster_key);
-    for (auto candidate : particles)
+    if (is_cluster_from(cluster_key, particle))
     {
-      if (get_truth_eval()->are_same_particle(candidate, particle))
-      {
-        ++nclusters;
-        matched = 1;
-      }
+      ++nclusters;
     }
-    if (matched == 0)
+    else
     {
       nwrong++;
     }
@@ -808,16 +712,6 @@ unsigned int SvtxTrackEval::get_nclusters_contribution_by_layer(SvtxTrack* track
     return 0;
   }
 
-  if (_do_cache)
-  {
-    std::map<std::pair<SvtxTrack*, PHG4Particle*>, unsigned int>::iterator iter =
-        _cache_get_nclusters_contribution_by_layer.find(std::make_pair(track, particle));
-    if (iter != _cache_get_nclusters_contribution_by_layer.end())
-    {
-      return iter->second;
-    }
-  }
-
   unsigned int nclusters_by_layer = 0;
   int layer_occupied[100];
   for (int& i : layer_occupied)
@@ -841,15 +735,9 @@ unsigned int SvtxTrackEval::get_nclusters_contribution_by_layer(SvtxTrack* track
     //      continue;
     //    }
 
-    // loop over all particles
-    std::set<PHG4Particle*> particles = _clustereval.all_truth_particles(cluster_key);
-
-    for (auto candidate : particles)
+    if (is_cluster_from(cluster_key, particle))
     {
-      if (get_truth_eval()->are_same_particle(candidate, particle))
-      {
-        layer_occupied[cluster_layer]++;
-      }
+      layer_occupied[cluster_layer]++;
     }
   }
   for (int i : layer_occupied)
@@ -859,10 +747,6 @@ unsigned int SvtxTrackEval::get_nclusters_contribution_by_layer(SvtxTrack* track
       nclusters_by_layer++;
     }
   }
-  if (_do_cache)
-  {
-    _cache_get_nclusters_contribution_by_layer.insert(std::make_pair(std::make_pair(track, particle), nclusters_by_layer));
-  }
 
   return nclusters_by_layer;
 }
@@ -921,22 +805,15 @@ std::pair<unsigned int, unsigned int> SvtxTrackEval::get_layer_range_contributio
     //      continue;
     //    }
 
-    // loop over all particles
-    std::set<PHG4Particle*> particles = _clustereval.all_truth_particles(cluster_key);
-    int matched = 0;
-    for (auto candidate : particles)
+    if (is_cluster_from(cluster_key, particle))
     {
-      if (get_truth_eval()->are_same_particle(candidate, particle))
-      {
-        //	nmatches |= (0x3FFFFFFF & (0x1 << cluster_layer));
-        layers[cluster_layer - start_layer] = 1;
-	matched = 1;
-      }
+      //	nmatches |= (0x3FFFFFFF & (0x1 << cluster_layer));
+      layers[cluster_layer - start_layer] = 1;
+    }
+    else
+    {
+      layers_wrong[cluster_layer - start_layer] = 1;
     }
-    if(matched == 0)
-      {
-	layers_wrong[cluster_layer - start_layer] = 1;
-      }
   }
   for (unsigned int i = 0; i < nlayers; i++)
   {
@@ -954,6 +831,61 @@ std::pair<unsigned int, unsigned int> SvtxTrackEval::get_layer_range_contributio
   return std::make_pair(nmatches,nwrong);
 }
 
+SvtxAssociationTable* SvtxTrackEval::get_association_table()
+{
+  SvtxAssociationTable* table = _clustereval.get_association_table();
+  if (!table->has_tracks())
+  {
+    // one pass over all tracks, filling the track to cluster and track to particle links
+    for (const auto& [key, track] : *_trackmap)
+    {
+      table->add_track(track, get_track_ckeys(track));
+    }
+    table->fill_tracks();
+  }
+  return table;
+}
+
+std::set<SvtxTrack*> SvtxTrackEval::tracks_from_trkid(int trkid)
+{
+  std::set<SvtxTrack*> tracks;
+
+  SvtxAssociationTable* table = get_association_table();
+  unsigned int index = 0;
+  if (table->find_particle(trkid, index))
+  {
+    for (const auto& link : table->tracks_from_particle(index))
+    {
+      tracks.insert(tracks.end(), table->get_track(link.index));
+    }
+  }
+
+  return tracks;
+}
+
+bool SvtxTrackEval::is_cluster_from(TrkrDefs::cluskey cluster_key, PHG4Particle* particle)
+{
+  unsigned int cluster = 0;
+  if (_do_cache && get_association_table()->find_cluster(cluster_key, cluster))
+  {
+    SvtxAssociationTable* table = get_association_table();
+    unsigned int index = 0;
+    return table->find_particle(particle->get_track_id(), index) &&
+           SvtxAssociationTable::find_link(table->particles_from_cluster(cluster), index);
+  }
+
+  // loop over all particles
+  std::set<PHG4Particle*> particles = _clustereval.all_truth_particles(cluster_key);
+  for (auto candidate : particles)
+  {
+    if (get_truth_eval()->are_same_particle(candidate, particle))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 void SvtxTrackEval::get_node_pointers(PHCompositeNode* topNode)
 {
   // need things off of the DST...
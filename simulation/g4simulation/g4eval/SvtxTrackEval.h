@@ -64,7 +64,6 @@ class SvtxTrackEval
   std::set<SvtxTrack*> all_tracks_from(PHG4Hit* truthhit);
   std::set<SvtxTrack*> all_tracks_from(TrkrDefs::cluskey cluster_key);
   SvtxTrack* best_track_from(TrkrDefs::cluskey cluster_key);
-  void create_cache_track_from_cluster();
 
   // overlap calculations
   void calc_cluster_contribution(SvtxTrack* svtxtrack, PHG4Particle* truthparticle);
@@ -82,6 +81,15 @@ class SvtxTrackEval
 
   std::vector<TrkrDefs::cluskey> get_track_ckeys(SvtxTrack* track);
 
+  // cluster association table, with the tracks of the current event
+  SvtxAssociationTable* get_association_table();
+
+  // all tracks with at least one cluster from given truth track id
+  std::set<SvtxTrack*> tracks_from_trkid(int trkid);
+
+  // true if given particle contributes to given cluster
+  bool is_cluster_from(TrkrDefs::cluskey cluster_key, PHG4Particle* particle);
+
   SvtxClusterEval _clustereval;
   SvtxTrackMap* _trackmap = nullptr;
   PHG4TruthInfoContainer* _truthinfo = nullptr;
@@ -93,17 +101,8 @@ class SvtxTrackEval
   unsigned int _errors = 0;
 
   bool _do_cache = true;
-  bool _cache_track_from_cluster_exists = false;
   std::map<SvtxTrack*, std::set<PHG4Hit*> > _cache_all_truth_hits;
-  std::map<SvtxTrack*, std::set<PHG4Particle*> > _cache_all_truth_particles;
-  std::map<SvtxTrack*, PHG4Particle*> _cache_max_truth_particle_by_nclusters;
-  std::map<PHG4Particle*, std::set<SvtxTrack*> > _cache_all_tracks_from_particle;
-  std::map<PHG4Particle*, SvtxTrack*> _cache_best_track_from_particle;
-  std::map<PHG4Hit*, std::set<SvtxTrack*> > _cache_all_tracks_from_g4hit;
-  std::map<TrkrDefs::cluskey, std::set<SvtxTrack*> > _cache_all_tracks_from_cluster;
-  std::map<TrkrDefs::cluskey, SvtxTrack*> _cache_best_track_from_cluster;
   std::map<std::pair<SvtxTrack*, PHG4Particle*>, unsigned int> _cache_get_nclusters_contribution;
-  std::map<std::pair<SvtxTrack*, PHG4Particle*>, unsigned int> _cache_get_nclusters_contribution_by_layer;
   std::map<std::pair<SvtxTrack*, PHG4Particle*>, unsigned int> _cache_get_nwrongclusters_contribution;
   std::string m_TrackNodeName = "SvtxTrackMap";
 };
@@ -12,6 +12,7 @@
 #include <trackbase/TrkrHit.h>  // for TrkrHit
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitTruthAssoc.h>
 
 #include <phparameter/PHParameterInterface.h>  // for PHParameterInterface
@@ -219,16 +220,13 @@ void PHG4InttDigitizer::DigitizeLadderCells(PHCompositeNode *topNode)
     }
     // get all of the hits from this hitset
     TrkrHitSet *hitset = hitset_iter->second;
-    TrkrHitSet::ConstRange hit_range = hitset->getHits();
     std::set<TrkrDefs::hitkey> dead_hits;  // hits on dead channel
-    for (TrkrHitSet::ConstIterator hit_iter = hit_range.first;
-         hit_iter != hit_range.second;
-         ++hit_iter)
+
+    // dac of one hit, -1 for hits on dead channels which are removed below
+    auto digitize = [&](const TrkrDefs::hitkey hitkey, const double energy)
     {
       ++m_nCells;
 
-      TrkrHit *hit = hit_iter->second;
-      TrkrDefs::hitkey hitkey = hit_iter->first;
       int strip_col = InttDefs::getCol(hitkey);  // strip z index
       int strip_row = InttDefs::getRow(hitkey);  // strip phi index
 
@@ -246,12 +244,11 @@ void PHG4InttDigitizer::DigitizeLadderCells(PHCompositeNode *topNode)
 
           if (Verbosity() >= VERBOSITY_MORE)
           {
-            std::cout << "PHG4InttDigitizer::DigitizeLadderCells - dead strip at layer " << layer << ": ";
-            hit->identify();
+            std::cout << "PHG4InttDigitizer::DigitizeLadderCells - dead strip at layer " << layer << ": hitkey " << hitkey << std::endl;
           }
 
-          dead_hits.insert(hit_iter->first);  // store hitkey of dead channels to be remove later
-          continue;
+          dead_hits.insert(hitkey);  // store hitkey of dead channels to be remove later
+          return -1;
         }
       }  //    if (deadmap)
 
@@ -272,7 +269,7 @@ void PHG4InttDigitizer::DigitizeLadderCells(PHCompositeNode *topNode)
       //      if (adc == -1) adc = 0;
 
       double k = 85.7 / (TrkrDefs::InttEnergyScaleup * (double) mip_e);
-      double E = hit->getEnergy() * k;  // keV
+      double E = energy * k;  // keV
 
       double gain = 100.0;
       double offset = 280.0;
@@ -313,7 +310,6 @@ void PHG4InttDigitizer::DigitizeLadderCells(PHCompositeNode *topNode)
         v_dac = 210;
       }
 
-      hit->setAdc(v_dac);
       /*
             std::cout<<"Digitizer:: getEnergy = "<<hit->getEnergy()<<std::endl;
             std::cout<<"Digitizer:: Energy = "<<E<<std::endl;
@@ -333,18 +329,60 @@ void PHG4InttDigitizer::DigitizeLadderCells(PHCompositeNode *topNode)
       if (Verbosity() > 2)
       {
         std::cout << "PHG4InttDigitizer: found hit with layer " << layer << " ladder_z " << ladder_z << " ladder_phi " << ladder_phi
-                  << " strip_col " << strip_col << " strip_row " << strip_row << " adc " << hit->getAdc() << std::endl;
+                  << " strip_col " << strip_col << " strip_row " << strip_row << " adc " << (unsigned int) v_dac << std::endl;
       }
-    }  // end loop over hits in this hitset
+      return (int) v_dac;
+    };
+
+    TrkrHitSetv2 *flat = dynamic_cast<TrkrHitSetv2 *>(hitset);
+    if (flat)
+    {
+      // the adc is replaced in place, hit keys do not change
+      const auto &hitkeys = flat->getHitKeys();
+      const auto &adcs = flat->getAdcs();
+      for (unsigned int i = 0; i < hitkeys.size(); ++i)
+      {
+        const int dac = digitize(hitkeys[i], (double) adcs[i] / TrkrDefs::EdepScaleFactor);
+        if (dac >= 0)
+        {
+          flat->setAdc(hitkeys[i], dac);
+        }
+      }
+    }
+    else
+    {
+      TrkrHitSet::ConstRange hit_range = hitset->getHits();
+      for (TrkrHitSet::ConstIterator hit_iter = hit_range.first;
+           hit_iter != hit_range.second;
+           ++hit_iter)
+      {
+        TrkrHit *hit = hit_iter->second;
+        const int dac = digitize(hit_iter->first, hit->getEnergy());
+        if (dac >= 0)
+        {
+          hit->setAdc(dac);
+        }
+      }  // end loop over hits in this hitset
+    }
 
     // remove hits on dead channel in TRKR_HITSET and TRKR_HITTRUTHASSOC
+    // flat hitsets are compacted in one pass
+    if (flat && !dead_hits.empty())
+    {
+      flat->removeHits([&dead_hits](const TrkrDefs::hitkey key, const unsigned int /*adc*/)
+                       { return dead_hits.count(key) > 0; });
+    }
+
     for (const auto &key : dead_hits)
     {
       if (Verbosity() > 2)
       {
         std::cout << " PHG4InttDigitizer: remove hit with key: " << key << std::endl;
       }
-      hitset->removeHit(key);
+      if (!flat)
+      {
+        hitset->removeHit(key);
+      }
 
       if (hittruthassoc)
       {
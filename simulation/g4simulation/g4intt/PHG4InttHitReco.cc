@@ -18,6 +18,7 @@
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
 #include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitTruthAssoc.h>
 #include <trackbase/TrkrHitTruthAssocv1.h>
 #include <trackbase/TrkrHitv2.h>  // for TrkrHit
@@ -145,6 +146,10 @@ int PHG4InttHitReco::InitRun(PHCompositeNode *topNode)
     PHIODataNode<PHObject> *newNode = new PHIODataNode<PHObject>(hitsetcontainer, "TRKR_HITSET", "PHObject");
     DetNode->addNode(newNode);
   }
+  if (m_flat_hitsets)
+  {
+    hitsetcontainer->setFlatHitSets(true);
+  }
 
   auto hittruthassoc = findNode::getClass<TrkrHitTruthAssoc>(topNode, "TRKR_HITTRUTHASSOC");
   if (!hittruthassoc)
@@ -571,28 +576,35 @@ int PHG4InttHitReco::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      TrkrHit *hit = hitsetit->second->getHit(hitkey);
-      if (!hit)
-      {
-        // Otherwise, create a new one
-        hit = new TrkrHitv2();
-        hitsetit->second->addHitSpecificKey(hitkey, hit);
-      }
-
       // Either way, add the energy to it
       if (Verbosity() > 2)
       {
         std::cout << "add energy " << venergy[i1].first << " to intthit " << std::endl;
       }
 
-      hit->addEnergy(hit_energy);
+      if (auto flat = dynamic_cast<TrkrHitSetv2 *>(hitsetit->second))
+      {
+        // flat hitsets create the hit if needed and add the energy in place
+        flat->addEnergy(hitkey, hit_energy);
+      }
+      else
+      {
+        TrkrHit *hit = hitsetit->second->getHit(hitkey);
+        if (!hit)
+        {
+          // Otherwise, create a new one
+          hit = new TrkrHitv2();
+          hit = hitsetit->second->addHitSpecificKey(hitkey, hit)->second;
+        }
+        hit->addEnergy(hit_energy);
+      }
 
       // Add this hit to the association map
       hittruthassoc->addAssoc(hitsetkey, hitkey, hiter->first);
 
       if (Verbosity() > 2)
       {
-        std::cout << "PHG4InttHitReco: added hit wirh hitsetkey " << hitsetkey << " hitkey " << hitkey << " g4hitkey " << hiter->first << " energy " << hit->getEnergy() << std::endl;
+        std::cout << "PHG4InttHitReco: added hit wirh hitsetkey " << hitsetkey << " hitkey " << hitkey << " g4hitkey " << hiter->first << " energy " << hitsetit->second->getHit(hitkey)->getEnergy() << std::endl;
       }
     }
   }  // end loop over g4hits
@@ -706,7 +718,7 @@ void PHG4InttHitReco::addtruthhitset(
   {
     // create a new one
     hit = new TrkrHitv2();
-    hitsetit->second->addHitSpecificKey(hitkey, hit);
+    hit = hitsetit->second->addHitSpecificKey(hitkey, hit)->second;
   }
   // Either way, add the energy to it  -- adc values will be added at digitization
   hit->addEnergy(neffelectrons);
@@ -45,6 +45,9 @@ class PHG4InttHitReco : public SubsysReco, public PHParameterInterface
 
   void setLocalHotStripMaskFile(const std::string& name) { m_localHotStripFileName = name; }
 
+  //! store the hits in TrkrHitSetv2 (flat hitkey, adc vectors) instead of one TrkrHitv2 per hit
+  void set_flat_hitsets(bool b) { m_flat_hitsets = b; }
+
  protected:
   std::string m_Detector = "INTT";
   std::string m_HitNodeName;
@@ -55,6 +58,8 @@ class PHG4InttHitReco : public SubsysReco, public PHParameterInterface
   double m_Tmax;
   double m_crossingPeriod;
 
+  bool m_flat_hitsets = false;
+
   gsl_vector* m_LocalOutVec = nullptr;
   gsl_vector* m_PathVec = nullptr;
   gsl_vector* m_SegmentVec = nullptr;
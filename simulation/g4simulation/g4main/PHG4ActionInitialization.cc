@@ -0,0 +1,182 @@
+#include "PHG4ActionInitialization.h"
+
+#include "PHG4EventAction.h"
+#include "PHG4PhenixEventAction.h"
+#include "PHG4PhenixStackingAction.h"
+#include "PHG4PhenixSteppingAction.h"
+#include "PHG4PhenixTrackingAction.h"
+#include "PHG4PrimaryGeneratorAction.h"
+#include "PHG4StackingAction.h"
+#include "PHG4SteppingAction.h"
+#include "PHG4SubEventMerger.h"
+#include "PHG4Subsystem.h"
+#include "PHG4TrackingAction.h"
+
+#include <phool/PHCompositeNode.h>
+
+#include <Geant4/G4Event.hh>
+#include <Geant4/G4EventManager.hh>
+
+#include <mutex>
+#include <vector>
+
+class G4TrackingManager;
+
+namespace
+{
+  //! primary generator of a worker thread, picks up the current input event
+  class PHG4WorkerPrimaryGeneratorAction : public PHG4PrimaryGeneratorAction
+  {
+   public:
+    explicit PHG4WorkerPrimaryGeneratorAction(const PHG4ActionInitialization *init)
+      : m_Init(init)
+    {
+    }
+
+    void GeneratePrimaries(G4Event *anEvent) override
+    {
+      SetInEvent(m_Init->GetInEvent());
+      SetSubEvents(m_Init->GetNumSubEvents());
+      PHG4PrimaryGeneratorAction::GeneratePrimaries(anEvent);
+    }
+
+   private:
+    const PHG4ActionInitialization *m_Init = nullptr;
+  };
+
+  //! event action of a worker thread
+  /*!
+   * creates the node tree of the sub event and passes it to the subsystem
+   * actions of this thread (which is what the subsystems process_event()
+   * does in sequential running), hands it over to the merger at the end
+   */
+  class PHG4WorkerEventAction : public PHG4PhenixEventAction
+  {
+   public:
+    explicit PHG4WorkerEventAction(PHG4SubEventMerger *merger)
+      : m_SubEventMerger(merger)
+    {
+    }
+
+    ~PHG4WorkerEventAction() override
+    {
+      delete m_TopNode;
+    }
+
+    //! register the actions of one subsystem, they are owned by the composite actions
+    void AddWorkerActions(const PHG4WorkerActions &actions)
+    {
+      m_WorkerActions.push_back(actions);
+    }
+
+    void BeginOfEventAction(const G4Event *event) override
+    {
+      delete m_TopNode;
+      m_TopNode = m_SubEventMerger->create_subevent_nodes();
+      for (const PHG4WorkerActions &actions : m_WorkerActions)
+      {
+        if (actions.event_action)
+        {
+          actions.event_action->SetInterfacePointers(m_TopNode);
+        }
+        if (actions.tracking_action)
+        {
+          actions.tracking_action->SetInterfacePointers(m_TopNode);
+        }
+        if (actions.stepping_action)
+        {
+          actions.stepping_action->SetInterfacePointers(m_TopNode);
+        }
+        if (actions.stacking_action)
+        {
+          actions.stacking_action->SetInterfacePointers(m_TopNode);
+        }
+      }
+      PHG4PhenixEventAction::BeginOfEventAction(event);
+    }
+
+    void EndOfEventAction(const G4Event *event) override
+    {
+      PHG4PhenixEventAction::EndOfEventAction(event);
+      // same order as PHG4TruthSubsystem::ResetEvent()
+      for (const PHG4WorkerActions &actions : m_WorkerActions)
+      {
+        if (actions.tracking_action)
+        {
+          actions.tracking_action->ResetEvent(m_TopNode);
+        }
+        if (actions.event_action)
+        {
+          actions.event_action->ResetEvent(m_TopNode);
+        }
+      }
+      m_SubEventMerger->set_subevent(event->GetEventID(), m_TopNode);
+      m_TopNode = nullptr;
+    }
+
+   private:
+    PHG4SubEventMerger *m_SubEventMerger = nullptr;
+    std::vector<PHG4WorkerActions> m_WorkerActions;
+    PHCompositeNode *m_TopNode = nullptr;
+  };
+
+}  // namespace
+
+//_________________________________________________________________
+PHG4ActionInitialization::PHG4ActionInitialization(const std::list<PHG4Subsystem *> &subsystems, PHG4SubEventMerger *merger, const bool disable_user_actions)
+  : m_SubsystemList(subsystems)
+  , m_SubEventMerger(merger)
+  , m_DisableUserActions(disable_user_actions)
+{
+}
+
+//_________________________________________________________________
+void PHG4ActionInitialization::Build() const
+{
+  // the subsystems and the action constructors (e.g. the PHTimeServer
+  // timer of the event action) are not written for concurrent use,
+  // build the actions of one thread at a time
+  static std::mutex build_mutex;
+  std::lock_guard<std::mutex> lock(build_mutex);
+
+  SetUserAction(new PHG4WorkerPrimaryGeneratorAction(this));
+  if (m_DisableUserActions)
+  {
+    return;
+  }
+
+  // same order as in PHG4Reco::InitRun()
+  PHG4WorkerEventAction *eventaction = new PHG4WorkerEventAction(m_SubEventMerger);
+  PHG4PhenixStackingAction *stackingaction = new PHG4PhenixStackingAction();
+  PHG4PhenixSteppingAction *steppingaction = new PHG4PhenixSteppingAction();
+  PHG4PhenixTrackingAction *trackingaction = new PHG4PhenixTrackingAction();
+  G4TrackingManager *trackingManager = G4EventManager::GetEventManager()->GetTrackingManager();
+  for (PHG4Subsystem *g4sub : m_SubsystemList)
+  {
+    PHG4WorkerActions actions;
+    g4sub->CreateWorkerActions(actions);
+    if (actions.event_action)
+    {
+      eventaction->AddAction(actions.event_action);
+    }
+    if (actions.stacking_action)
+    {
+      stackingaction->AddAction(actions.stacking_action);
+    }
+    if (actions.stepping_action)
+    {
+      steppingaction->AddAction(actions.stepping_action);
+    }
+    if (actions.tracking_action)
+    {
+      trackingaction->AddAction(actions.tracking_action);
+      // make tracking manager accessible within user tracking action
+      actions.tracking_action->SetTrackingManagerPointer(trackingManager);
+    }
+    eventaction->AddWorkerActions(actions);
+  }
+  SetUserAction(eventaction);
+  SetUserAction(stackingaction);
+  SetUserAction(steppingaction);
+  SetUserAction(trackingaction);
+}
@@ -0,0 +1,62 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4ACTIONINITIALIZATION_H
+#define G4MAIN_PHG4ACTIONINITIALIZATION_H
+
+#include <Geant4/G4VUserActionInitialization.hh>
+
+#include <list>
+
+class PHG4InEvent;
+class PHG4Subsystem;
+class PHG4SubEventMerger;
+
+//! creates the user actions of the geant worker threads in multi threaded running (PHG4Reco::set_threads())
+/*!
+ * Every worker thread gets its own primary generator which passes only its share
+ * of the PHG4INEVENT primaries to geant (PHG4PrimaryGeneratorAction::SetSubEvents())
+ * and its own event, stepping, tracking and stacking actions created by the
+ * subsystems (PHG4Subsystem::CreateWorkerActions()). For every sub event these
+ * actions fill a private node tree which is handed to the PHG4SubEventMerger
+ * at the end of the sub event.
+ */
+class PHG4ActionInitialization : public G4VUserActionInitialization
+{
+ public:
+  //! constructor
+  PHG4ActionInitialization(const std::list<PHG4Subsystem *> &subsystems, PHG4SubEventMerger *merger, const bool disable_user_actions);
+
+  //! destructor
+  ~PHG4ActionInitialization() override = default;
+
+  //! called by geant for every worker thread
+  void Build() const override;
+
+  //! set input event and number of sub events before the next BeamOn(), on the master thread
+  void SetInEvent(PHG4InEvent *ineve, const int nsubevents)
+  {
+    m_InEvent = ineve;
+    m_NumSubEvents = nsubevents;
+  }
+
+  PHG4InEvent *GetInEvent() const { return m_InEvent; }
+  int GetNumSubEvents() const { return m_NumSubEvents; }
+
+ private:
+  //! list of subsystems
+  std::list<PHG4Subsystem *> m_SubsystemList;
+
+  //! receives the sub event node trees
+  PHG4SubEventMerger *m_SubEventMerger = nullptr;
+
+  //! input event of the current event
+  PHG4InEvent *m_InEvent = nullptr;
+
+  //! number of sub events of the current event
+  int m_NumSubEvents = 1;
+
+  //! only create the primary generator
+  bool m_DisableUserActions = false;
+};
+
+#endif
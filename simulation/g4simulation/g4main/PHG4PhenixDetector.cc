@@ -1,5 +1,6 @@
 #include "PHG4PhenixDetector.h"
 
+#include "G4TBMagneticFieldSetup.hh"
 #include "PHG4Detector.h"
 #include "PHG4DisplayAction.h"  // for PHG4DisplayAction
 #include "PHG4PhenixDisplayAction.h"
@@ -8,6 +9,7 @@
 
 #include <phool/recoConsts.h>
 
+#include <Geant4/G4AutoDelete.hh>
 #include <Geant4/G4Box.hh>
 #include <Geant4/G4GeometryManager.hh>
 #include <Geant4/G4LogicalVolume.hh>  // for G4LogicalVolume
@@ -21,6 +23,7 @@
 #include <Geant4/G4String.hh>  // for G4String
 #include <Geant4/G4SystemOfUnits.hh>
 #include <Geant4/G4ThreeVector.hh>  // for G4ThreeVector
+#include <Geant4/G4Threading.hh>
 #include <Geant4/G4Tubs.hh>
 #include <Geant4/G4VSolid.hh>  // for G4GeometryType, G4VSolid
 
@@ -131,3 +134,14 @@ G4VPhysicalVolume *PHG4PhenixDetector::Construct()
 
   return physiWorld;
 }
+
+//_______________________________________________________________________________________________
+void PHG4PhenixDetector::ConstructSDandField()
+{
+  // the field of the master thread is set up in PHG4Reco::InitField(), every
+  // worker thread needs its own field manager and stepper for the shared field map
+  if (m_WorkerField && G4Threading::IsWorkerThread())
+  {
+    G4AutoDelete::Register(new G4TBMagneticFieldSetup(m_WorkerField));
+  }
+}
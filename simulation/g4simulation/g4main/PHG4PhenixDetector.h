@@ -11,6 +11,7 @@
 
 class G4LogicalVolume;
 class G4VPhysicalVolume;
+class PHField;
 class PHG4Detector;
 class PHG4PhenixDisplayAction;
 class PHG4Reco;
@@ -37,6 +38,9 @@ class PHG4PhenixDetector : public G4VUserDetectorConstruction
   //! this is called by geant to actually construct all detectors
   G4VPhysicalVolume* Construct() override;
 
+  //! this is called by geant for every thread, sets up the magnetic field of the worker threads
+  void ConstructSDandField() override;
+
   G4double GetWorldSizeX() const { return WorldSizeX; }
 
   G4double GetWorldSizeY() const { return WorldSizeY; }
@@ -50,6 +54,9 @@ class PHG4PhenixDetector : public G4VUserDetectorConstruction
   void SetWorldMaterial(const std::string& s) { worldmaterial = s; }
   G4VPhysicalVolume* GetPhysicalVolume(void) { return physiWorld; }
 
+  //! field map shared by the worker threads in multi threaded running
+  void SetWorkerField(PHField* field) { m_WorkerField = field; }
+
  private:
   PHG4PhenixDisplayAction* m_DisplayAction;
 
@@ -66,6 +73,7 @@ class PHG4PhenixDetector : public G4VUserDetectorConstruction
   G4double WorldSizeZ;
   std::string worldshape;
   std::string worldmaterial;
+  PHField* m_WorkerField = nullptr;
 };
 
 #endif  // G4MAIN_PHG4PHENIXDETECTOR_H
@@ -21,6 +21,7 @@
 #include <cmath>  // for sqrt
 #include <cstdlib>
 #include <iostream>
+#include <iterator>  // for distance
 #include <map>
 #include <string>   // for operator<<
 #include <utility>  // for pair
@@ -37,6 +38,15 @@ void PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   multimap<int, PHG4Particle*>::const_iterator particle_iter;
   std::pair<std::map<int, PHG4VtxPoint*>::const_iterator, std::map<int, PHG4VtxPoint*>::const_iterator> vtxbegin_end = inEvent->GetVertices();
 
+  // for sub events the primaries are enumerated in vertex order, primary i
+  // of n goes into sub event i * m_NumSubEvents / n
+  long nparticles = 0;
+  long iparticle = 0;
+  if (m_NumSubEvents > 1)
+  {
+    pair<multimap<int, PHG4Particle*>::const_iterator, multimap<int, PHG4Particle*>::const_iterator> allparticles = inEvent->GetParticles();
+    nparticles = distance(allparticles.first, allparticles.second);
+  }
   for (vtxiter = vtxbegin_end.first; vtxiter != vtxbegin_end.second; ++vtxiter)
   {
     //       cout << "vtx number: " << vtxiter->first << endl;
@@ -47,6 +57,10 @@ void PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
     pair<multimap<int, PHG4Particle*>::const_iterator, multimap<int, PHG4Particle*>::const_iterator> particlebegin_end = inEvent->GetParticles(vtxiter->first);
     for (particle_iter = particlebegin_end.first; particle_iter != particlebegin_end.second; ++particle_iter)
     {
+      if (m_NumSubEvents > 1 && (iparticle++) * m_NumSubEvents / nparticles != anEvent->GetEventID())
+      {
+        continue;
+      }
       // cout << "PHG4PrimaryGeneratorAction: dealing with" << endl;
       //  (particle_iter->second)->identify();
 
@@ -160,6 +174,12 @@ void PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
       }
     }
     //      vertex->Print();
+    if (m_NumSubEvents > 1 && vertex->GetNumberOfParticle() == 0)
+    {
+      // no primaries of this vertex in this sub event
+      delete vertex;
+      continue;
+    }
     anEvent->AddPrimaryVertex(vertex);
   }
   return;
@@ -29,6 +29,10 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     inEvent = inevt;
   }
 
+  //! split the primaries into n sub events (multi threaded running), the
+  //! geant event id selects which sub event is passed to geant
+  void SetSubEvents(const int n) { m_NumSubEvents = n; }
+
   //! Set/Get verbosity
   void Verbosity(const int val) { verbosity = val; }
   int Verbosity() const { return verbosity; }
@@ -39,6 +43,9 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
  private:
   //! temporary pointer to input event on node tree
   PHG4InEvent* inEvent;
+
+  //! number of sub events
+  int m_NumSubEvents = 1;
 };
 
 #endif  // PHG4PrimaryGeneratorAction_H__
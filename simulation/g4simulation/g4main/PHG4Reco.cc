@@ -2,6 +2,7 @@
 
 #include "Fun4AllMessenger.h"
 #include "G4TBMagneticFieldSetup.hh"
+#include "PHG4ActionInitialization.h"
 #include "PHG4DisplayAction.h"
 #include "PHG4InEvent.h"
 #include "PHG4PhenixDetector.h"
@@ -11,6 +12,7 @@
 #include "PHG4PhenixSteppingAction.h"
 #include "PHG4PhenixTrackingAction.h"
 #include "PHG4PrimaryGeneratorAction.h"
+#include "PHG4SubEventMerger.h"
 #include "PHG4Subsystem.h"
 #include "PHG4TrackingAction.h"
 #include "PHG4UIsession.h"
@@ -46,6 +48,7 @@
 #include <phool/phool.h>  // for PHWHERE
 #include <phool/recoConsts.h>
 
+#include <TROOT.h>
 #include <TSystem.h>  // for TSystem, gSystem
 
 #include <CLHEP/Random/Random.h>
@@ -79,11 +82,19 @@
 #include <Geant4/G4UImanager.hh>
 #include <Geant4/G4UImessenger.hh>          // for G4UImessenger
 #include <Geant4/G4VModularPhysicsList.hh>  // for G4VModularPhysicsList
+#include <Geant4/G4VPhysicsConstructor.hh>
 #include <Geant4/G4Version.hh>
 #include <Geant4/G4VisExecutive.hh>
 #include <Geant4/G4VisManager.hh>  // for G4VisManager
 #include <Geant4/Randomize.hh>     // for G4Random
 
+#ifdef G4MULTITHREADED
+#include <Geant4/G4MTRunManager.hh>
+#if G4VERSION_NUMBER >= 1100
+#include <Geant4/G4TaskRunManager.hh>
+#endif
+#endif
+
 // physics lists
 #include <Geant4/FTFP_BERT.hh>
 #include <Geant4/FTFP_BERT_HP.hh>
@@ -96,11 +107,13 @@
 #include <Geant4/QGSP_INCLXX.hh>
 #include <Geant4/QGSP_INCLXX_HP.hh>
 
+#include <algorithm>  // for max, min
 #include <cassert>
 #include <cstdlib>
 #include <exception>  // for exception
 #include <filesystem>
 #include <iostream>   // for operator<<, endl
+#include <iterator>   // for distance
 #include <memory>
 
 class G4EmSaturation;
@@ -111,6 +124,27 @@ class PHG4EventAction;
 class PHG4StackingAction;
 class PHG4SteppingAction;
 
+namespace
+{
+  //! adds the PHG4Reco optical processes for every geant thread in multi threaded running
+  class PHG4OpticalProcessConstructor : public G4VPhysicsConstructor
+  {
+   public:
+    explicit PHG4OpticalProcessConstructor(PHG4Reco *reco)
+      : G4VPhysicsConstructor("PHG4OpticalProcesses")
+      , m_Reco(reco)
+    {
+    }
+
+    void ConstructParticle() override {}
+
+    void ConstructProcess() override { m_Reco->AddOpticalProcesses(); }
+
+   private:
+    PHG4Reco *m_Reco = nullptr;
+  };
+}  // namespace
+
 //_________________________________________________________________
 PHG4Reco::PHG4Reco(const std::string &name)
   : SubsysReco(name)
@@ -125,7 +159,13 @@ PHG4Reco::~PHG4Reco()
   // one can delete null pointer (it results in a nop), so checking if
   // they are non zero is not needed
   delete m_Field;
+  // the worker threads have their own generators, this one is not owned by the run manager
+  if (m_ActionInitialization)
+  {
+    delete m_GeneratorAction;
+  }
   delete m_RunManager;
+  delete m_SubEventMerger;
   delete m_UISession;
   delete m_VisManager;
   delete m_Fun4AllMessenger;
@@ -163,7 +203,41 @@ int PHG4Reco::Init(PHCompositeNode *topNode)
     uimanager->SetCoutDestination(m_UISession);
   }
 
-  m_RunManager = new G4RunManager();
+  if (m_NumThreads > 0)
+  {
+#ifdef G4MULTITHREADED
+    // the worker threads create root objects (the node trees of the sub events)
+    ROOT::EnableThreadSafety();
+    G4MTRunManager *mtrunmanager = nullptr;
+    if (m_UseTaskRunManager)
+    {
+#if G4VERSION_NUMBER >= 1100
+      mtrunmanager = new G4TaskRunManager();
+#else
+      std::cout << PHWHERE << " G4TaskRunManager needs Geant4 11 or newer" << std::endl;
+      gSystem->Exit(1);
+      exit(1);
+#endif
+    }
+    else
+    {
+      mtrunmanager = new G4MTRunManager();
+    }
+    mtrunmanager->SetNumberOfThreads(m_NumThreads);
+    // sub events are handed out one by one
+    mtrunmanager->SetEventModulo(1);
+    m_RunManager = mtrunmanager;
+#else
+    std::cout << PHWHERE << " Geant4 was built without multi threading support, cannot run with "
+              << m_NumThreads << " threads" << std::endl;
+    gSystem->Exit(1);
+    exit(1);
+#endif
+  }
+  else
+  {
+    m_RunManager = new G4RunManager();
+  }
 
   DefineMaterials();
   // create physics processes
@@ -251,6 +325,11 @@ int PHG4Reco::Init(PHCompositeNode *topNode)
   }
 
   myphysicslist->RegisterPhysics(new G4StepLimiterPhysics());
+  if (m_NumThreads > 0)
+  {
+    // processes added after the initialization do not make it to the worker threads
+    myphysicslist->RegisterPhysics(new PHG4OpticalProcessConstructor(this));
+  }
   // initialize cuts so we can ask the world region for it's default
   // cuts to propagate them to other regions in DefineRegions()
   myphysicslist->SetCutsWithDefault();
@@ -316,6 +395,25 @@ int PHG4Reco::InitField(PHCompositeNode *topNode)
 
   m_Field = new G4TBMagneticFieldSetup(phfield);
 
+  if (m_NumThreads > 0)
+  {
+    // the worker threads share the field map, only field maps without lookup cache are thread safe
+    const PHFieldConfig *field_cfg = PHFieldUtility::GetFieldConfigNode(default_field_cfg.get(), topNode);
+    switch (field_cfg->get_field_config())
+    {
+    case PHFieldConfig::kFieldUniform:
+    case PHFieldConfig::kField3DCylindrical:
+    case PHFieldConfig::kField3DCartesianGrid:
+      break;
+    default:
+      std::cout << PHWHERE << " field map type " << field_cfg->get_field_config()
+                << " is not thread safe, use PHFieldConfig::kField3DCartesianGrid for multi threaded running" << std::endl;
+      gSystem->Exit(1);
+      exit(1);
+    }
+    m_WorkerField = phfield;
+  }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -373,6 +471,19 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     reco->InitRun(topNode);
   }
 
+  if (m_NumThreads > 0)
+  {
+    for (PHG4Subsystem *g4sub : m_SubsystemList)
+    {
+      if ((g4sub->GetEventAction() || g4sub->GetStackingAction() || g4sub->GetSteppingAction() || g4sub->GetTrackingAction()) && !g4sub->SupportsWorkerThreads())
+      {
+        std::cout << PHWHERE << " " << g4sub->Name() << " does not support multi threaded running, use set_threads(0)" << std::endl;
+        gSystem->Exit(1);
+        exit(1);
+      }
+    }
+  }
+
   // create phenix detector, add subsystems, and register to GEANT
   // create display settings before detector
   m_DisplayAction = new PHG4PhenixDisplayAction(Name());
@@ -387,6 +498,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
   m_Detector->SetWorldSizeZ(m_WorldSize[2] * cm);
   m_Detector->SetWorldShape(m_WorldShape);
   m_Detector->SetWorldMaterial(m_WorldMaterial);
+  m_Detector->SetWorkerField(m_WorkerField);
 
   for (PHG4Subsystem *g4sub : m_SubsystemList)
   {
@@ -405,6 +517,17 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
   }
 
   setupInputEventNodeReader(topNode);
+  // in multi threaded running the actions registered here are not used, every worker thread
+  // gets its own set from PHG4ActionInitialization::Build()
+  const bool setUserActions = !m_disableUserActions && m_NumThreads <= 0;
+  if (m_NumThreads > 0)
+  {
+    m_SubEventMerger = new PHG4SubEventMerger();
+    m_SubEventMerger->load_nodes(topNode);
+    m_ActionInitialization = new PHG4ActionInitialization(m_SubsystemList, m_SubEventMerger, m_disableUserActions);
+    m_RunManager->SetUserInitialization(m_ActionInitialization);
+  }
+
   // create main event action, add subsystemts and register to GEANT
   m_EventAction = new PHG4PhenixEventAction();
 
@@ -417,7 +540,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (setUserActions)
   {
     m_RunManager->SetUserAction(m_EventAction);
   }
@@ -437,7 +560,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (setUserActions)
   {
     m_RunManager->SetUserAction(m_StackingAction);
   }
@@ -458,7 +581,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (setUserActions)
   {
     m_RunManager->SetUserAction(m_SteppingAction);
   }
@@ -480,7 +603,7 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
     }
   }
 
-  if (not m_disableUserActions)
+  if (setUserActions)
   {
     m_RunManager->SetUserAction(m_TrackingAction);
   }
@@ -496,67 +619,12 @@ int PHG4Reco::InitRun(PHCompositeNode *topNode)
   }
 #endif
 
-  // add cerenkov and optical photon processes
-  // std::cout << std::endl << "Ignore the next message - we implemented this correctly" << std::endl;
-  G4Cerenkov *theCerenkovProcess = new G4Cerenkov("Cerenkov");
-  // std::cout << "End of bogus warning message" << std::endl << std::endl;
-  G4Scintillation *theScintillationProcess = new G4Scintillation("Scintillation");
-
-  /*
-    if (Verbosity() > 0)
-    {
-    // This segfaults
-    theCerenkovProcess->DumpPhysicsTable();
-    }
-  */
-  theCerenkovProcess->SetMaxNumPhotonsPerStep(300);
-  theCerenkovProcess->SetMaxBetaChangePerStep(10.0);
-  theCerenkovProcess->SetTrackSecondariesFirst(false);  // current PHG4TruthTrackingAction does not support suspect active track and track secondary first
-#if G4VERSION_NUMBER < 1100
-  theScintillationProcess->SetScintillationYieldFactor(1.0);
-#endif
-  theScintillationProcess->SetTrackSecondariesFirst(false);
-  // theScintillationProcess->SetScintillationExcitationRatio(1.0);
-
-  // Use Birks Correction in the Scintillation process
-
-  // G4EmSaturation* emSaturation = G4LossTableManager::Instance()->EmSaturation();
-  // theScintillationProcess->AddSaturation(emSaturation);
-
-  G4ParticleTable *theParticleTable = G4ParticleTable::GetParticleTable();
-  G4ParticleTable::G4PTblDicIterator *_theParticleIterator;
-  _theParticleIterator = theParticleTable->GetIterator();
-  _theParticleIterator->reset();
-  while ((*_theParticleIterator)())
+  // add cerenkov and optical photon processes, in multi threaded running
+  // this is done for every thread by the PHG4OpticalProcessConstructor
+  if (m_NumThreads <= 0)
   {
-    G4ParticleDefinition *particle = _theParticleIterator->value();
-    G4String particleName = particle->GetParticleName();
-    G4ProcessManager *pmanager = particle->GetProcessManager();
-    if (theCerenkovProcess->IsApplicable(*particle))
-    {
-      pmanager->AddProcess(theCerenkovProcess);
-      pmanager->SetProcessOrdering(theCerenkovProcess, idxPostStep);
-    }
-    if (theScintillationProcess->IsApplicable(*particle))
-    {
-      pmanager->AddProcess(theScintillationProcess);
-      pmanager->SetProcessOrderingToLast(theScintillationProcess, idxAtRest);
-      pmanager->SetProcessOrderingToLast(theScintillationProcess, idxPostStep);
-    }
-    for (PHG4Subsystem *g4sub : m_SubsystemList)
-    {
-      g4sub->AddProcesses(particle);
-    }
+    AddOpticalProcesses();
   }
-  G4ProcessManager *pmanager = G4OpticalPhoton::OpticalPhoton()->GetProcessManager();
-  // std::cout << " AddDiscreteProcess to OpticalPhoton " << std::endl;
-  pmanager->AddDiscreteProcess(new G4OpAbsorption());
-  pmanager->AddDiscreteProcess(new G4OpRayleigh());
-  pmanager->AddDiscreteProcess(new G4OpMieHG());
-  pmanager->AddDiscreteProcess(new G4OpBoundaryProcess());
-  pmanager->AddDiscreteProcess(new G4OpWLS());
-  pmanager->AddDiscreteProcess(new G4PhotoElectricEffect());
-  // pmanager->DumpInfo();
 
   // needs large amount of memory which kills central hijing events
   // store generated trajectories
@@ -694,7 +762,24 @@ int PHG4Reco::process_event(PHCompositeNode *topNode)
               << "run one event :" << std::endl;
     ineve->identify();
   }
-  m_RunManager->BeamOn(1);
+  if (m_ActionInitialization)
+  {
+    // split the primaries into sub events which are simulated in parallel
+    // and merged back in sub event order
+    const int nparticles = std::distance(ineve->GetParticles().first, ineve->GetParticles().second);
+    const int nsubevents = std::max(1, std::min(m_NumSubEvents > 0 ? m_NumSubEvents : m_NumThreads, nparticles));
+    m_ActionInitialization->SetInEvent(ineve, nsubevents);
+    m_SubEventMerger->start_event(nsubevents);
+    m_RunManager->BeamOn(nsubevents);
+    if (!m_disableUserActions)
+    {
+      m_SubEventMerger->merge_subevents();
+    }
+  }
+  else
+  {
+    m_RunManager->BeamOn(1);
+  }
 
   for (PHG4Subsystem *g4sub : m_SubsystemList)
   {
@@ -740,6 +825,72 @@ void PHG4Reco::Print(const std::string &what) const
   return;
 }
 
+//_________________________________________________________________
+void PHG4Reco::AddOpticalProcesses()
+{
+  // add cerenkov and optical photon processes
+  // std::cout << std::endl << "Ignore the next message - we implemented this correctly" << std::endl;
+  G4Cerenkov *theCerenkovProcess = new G4Cerenkov("Cerenkov");
+  // std::cout << "End of bogus warning message" << std::endl << std::endl;
+  G4Scintillation *theScintillationProcess = new G4Scintillation("Scintillation");
+
+  /*
+    if (Verbosity() > 0)
+    {
+    // This segfaults
+    theCerenkovProcess->DumpPhysicsTable();
+    }
+  */
+  theCerenkovProcess->SetMaxNumPhotonsPerStep(300);
+  theCerenkovProcess->SetMaxBetaChangePerStep(10.0);
+  theCerenkovProcess->SetTrackSecondariesFirst(false);  // current PHG4TruthTrackingAction does not support suspect active track and track secondary first
+#if G4VERSION_NUMBER < 1100
+  theScintillationProcess->SetScintillationYieldFactor(1.0);
+#endif
+  theScintillationProcess->SetTrackSecondariesFirst(false);
+  // theScintillationProcess->SetScintillationExcitationRatio(1.0);
+
+  // Use Birks Correction in the Scintillation process
+
+  // G4EmSaturation* emSaturation = G4LossTableManager::Instance()->EmSaturation();
+  // theScintillationProcess->AddSaturation(emSaturation);
+
+  G4ParticleTable *theParticleTable = G4ParticleTable::GetParticleTable();
+  G4ParticleTable::G4PTblDicIterator *_theParticleIterator;
+  _theParticleIterator = theParticleTable->GetIterator();
+  _theParticleIterator->reset();
+  while ((*_theParticleIterator)())
+  {
+    G4ParticleDefinition *particle = _theParticleIterator->value();
+    G4String particleName = particle->GetParticleName();
+    G4ProcessManager *pmanager = particle->GetProcessManager();
+    if (theCerenkovProcess->IsApplicable(*particle))
+    {
+      pmanager->AddProcess(theCerenkovProcess);
+      pmanager->SetProcessOrdering(theCerenkovProcess, idxPostStep);
+    }
+    if (theScintillationProcess->IsApplicable(*particle))
+    {
+      pmanager->AddProcess(theScintillationProcess);
+      pmanager->SetProcessOrderingToLast(theScintillationProcess, idxAtRest);
+      pmanager->SetProcessOrderingToLast(theScintillationProcess, idxPostStep);
+    }
+    for (PHG4Subsystem *g4sub : m_SubsystemList)
+    {
+      g4sub->AddProcesses(particle);
+    }
+  }
+  G4ProcessManager *pmanager = G4OpticalPhoton::OpticalPhoton()->GetProcessManager();
+  // std::cout << " AddDiscreteProcess to OpticalPhoton " << std::endl;
+  pmanager->AddDiscreteProcess(new G4OpAbsorption());
+  pmanager->AddDiscreteProcess(new G4OpRayleigh());
+  pmanager->AddDiscreteProcess(new G4OpMieHG());
+  pmanager->AddDiscreteProcess(new G4OpBoundaryProcess());
+  pmanager->AddDiscreteProcess(new G4OpWLS());
+  pmanager->AddDiscreteProcess(new G4PhotoElectricEffect());
+  // pmanager->DumpInfo();
+}
+
 int PHG4Reco::setupInputEventNodeReader(PHCompositeNode *topNode)
 {
   PHG4InEvent *ineve = findNode::getClass<PHG4InEvent>(topNode, "PHG4INEVENT");
@@ -758,7 +909,11 @@ int PHG4Reco::setupInputEventNodeReader(PHCompositeNode *topNode)
   {
     m_GeneratorAction = new PHG4PrimaryGeneratorAction();
   }
-  m_RunManager->SetUserAction(m_GeneratorAction);
+  // in multi threaded running the worker threads have their own generators
+  if (m_NumThreads <= 0)
+  {
+    m_RunManager->SetUserAction(m_GeneratorAction);
+  }
   return 0;
 }
 
@@ -19,6 +19,8 @@ class G4UImanager;
 class G4UImessenger;
 class G4VisManager;
 class PHCompositeNode;
+class PHField;
+class PHG4ActionInitialization;
 class PHG4DisplayAction;
 class PHG4PhenixDetector;
 class PHG4PhenixEventAction;
@@ -26,6 +28,7 @@ class PHG4PhenixStackingAction;
 class PHG4PhenixSteppingAction;
 class PHG4PhenixTrackingAction;
 class PHG4PrimaryGeneratorAction;
+class PHG4SubEventMerger;
 class PHG4Subsystem;
 class PHG4UIsession;
 
@@ -140,6 +143,23 @@ class PHG4Reco : public SubsysReco
   void setDisableUserActions(bool b = true) { m_disableUserActions = b; }
   void ApplyDisplayAction();
 
+  //! run geant multi threaded with n worker threads (0, the default, runs the sequential G4RunManager).
+  //! The primaries of every event are split into sub events which are simulated in parallel
+  //! and merged back in sub event order. All subsystems with user actions need to support
+  //! this (PHG4Subsystem::SupportsWorkerThreads()), the magnetic field map must be thread safe
+  //! (uniform, PHFieldConfig::kField3DCylindrical or PHFieldConfig::kField3DCartesianGrid)
+  void set_threads(const int n) { m_NumThreads = n; }
+
+  //! use the task based G4TaskRunManager instead of the G4MTRunManager for multi threaded running
+  void set_task_run_manager(const bool b = true) { m_UseTaskRunManager = b; }
+
+  //! number of sub events per event for multi threaded running, default is the number of threads.
+  //! The simulated events depend on the number of sub events, not on the number of threads
+  void set_subevents(const int n) { m_NumSubEvents = n; }
+
+  //! add cerenkov, scintillation, optical photon and subsystem specific processes
+  void AddOpticalProcesses();
+
   void CustomizeEvtGenDecay(const std::string &DecayFile)
   {
     EvtGenDecayFile = DecayFile;
@@ -220,6 +240,20 @@ class PHG4Reco : public SubsysReco
 
   bool m_SaveDstGeometryFlag = true;
   bool m_disableUserActions = false;
+
+  //! multi threaded running
+  int m_NumThreads = 0;
+  int m_NumSubEvents = 0;
+  bool m_UseTaskRunManager = false;
+
+  //! field map shared by the worker threads
+  PHField *m_WorkerField = nullptr;
+
+  //! builds the worker thread actions, owned by the run manager
+  PHG4ActionInitialization *m_ActionInitialization = nullptr;
+
+  //! merges the sub events of the worker threads
+  PHG4SubEventMerger *m_SubEventMerger = nullptr;
 };
 
 #endif
@@ -0,0 +1,372 @@
+#include "PHG4SubEventMerger.h"
+
+#include "PHG4Hit.h"  // for PHG4Hit
+#include "PHG4HitContainer.h"
+#include "PHG4HitDefs.h"  // for keytype
+#include "PHG4Hitv1.h"
+#include "PHG4Particle.h"  // for PHG4Particle
+#include "PHG4Particlev2.h"
+#include "PHG4Particlev3.h"
+#include "PHG4Shower.h"
+#include "PHG4TruthInfoContainer.h"
+#include "PHG4VtxPoint.h"  // for PHG4VtxPoint
+#include "PHG4VtxPointv1.h"
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>    // for PHIODataNode
+#include <phool/PHNode.h>          // for PHNode
+#include <phool/PHNodeIterator.h>  // for PHNodeIterator
+#include <phool/PHNodeOperation.h>
+#include <phool/PHObject.h>  // for PHObject
+#include <phool/getClass.h>
+#include <phool/phool.h>  // for PHWHERE
+
+#include <TObject.h>
+
+#include <iostream>
+#include <limits>
+#include <set>
+#include <utility>
+
+namespace
+{
+  //! utility class to find all PHG4Hit container nodes from the DST node
+  class FindG4HitContainer : public PHNodeOperation
+  {
+   public:
+    //! container map alias
+    using ContainerMap = std::map<std::string, PHG4HitContainer *>;
+
+    //! get container map
+    const ContainerMap &containers() const
+    {
+      return m_containers;
+    }
+
+   protected:
+    //! iterator action
+    void perform(PHNode *node) override
+    {
+      // check type name. Only load PHIODataNode
+      if (node->getType() != "PHIODataNode")
+      {
+        return;
+      }
+
+      // cast to IODataNode and check data
+      auto ionode = static_cast<PHIODataNode<TObject> *>(node);
+      auto data = dynamic_cast<PHG4HitContainer *>(ionode->getData());
+      if (data)
+      {
+        m_containers.insert(std::make_pair(node->getName(), data));
+      }
+    }
+
+   private:
+    //! container map
+    ContainerMap m_containers;
+  };
+
+}  // namespace
+
+//_____________________________________________________________________________
+PHG4SubEventMerger::~PHG4SubEventMerger()
+{
+  for (PHCompositeNode *topNode : m_SubEvents)
+  {
+    delete topNode;
+  }
+}
+
+//_____________________________________________________________________________
+void PHG4SubEventMerger::load_nodes(PHCompositeNode *topNode)
+{
+  PHNodeIterator iter(topNode);
+  PHCompositeNode *dstNode = dynamic_cast<PHCompositeNode *>(iter.findFirst("PHCompositeNode", "DST"));
+
+  // find all G4Hit containers under dstNode
+  FindG4HitContainer nodeFinder;
+  PHNodeIterator(dstNode).forEach(nodeFinder);
+  m_g4hitscontainers = nodeFinder.containers();
+
+  // g4 truth info, only there if the truth subsystem is registered
+  m_g4truthinfo = findNode::getClass<PHG4TruthInfoContainer>(dstNode, "G4TruthInfo");
+}
+
+//_____________________________________________________________________________
+PHCompositeNode *PHG4SubEventMerger::create_subevent_nodes() const
+{
+  PHCompositeNode *topNode = new PHCompositeNode("TOP");
+  PHCompositeNode *dstNode = new PHCompositeNode("DST");
+  topNode->addNode(dstNode);
+
+  // same hit containers as the main node tree, the ids are used to
+  // identify the containers in the showers
+  for (const auto &pair : m_g4hitscontainers)
+  {
+    PHG4HitContainer *hits = new PHG4HitContainer(pair.first);
+    hits->SetID(pair.second->GetID());
+    const auto range = pair.second->getLayers();
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      hits->AddLayer(*iter);
+    }
+    dstNode->addNode(new PHIODataNode<PHObject>(hits, pair.first, "PHObject"));
+  }
+
+  if (m_g4truthinfo)
+  {
+    dstNode->addNode(new PHIODataNode<PHObject>(new PHG4TruthInfoContainer(), "G4TruthInfo", "PHObject"));
+  }
+  return topNode;
+}
+
+//_____________________________________________________________________________
+void PHG4SubEventMerger::start_event(const int nsubevents)
+{
+  m_PrimaryVertexIds.clear();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_SubEvents.assign(nsubevents, nullptr);
+}
+
+//_____________________________________________________________________________
+void PHG4SubEventMerger::set_subevent(const int i, PHCompositeNode *topNode)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (i < 0 || i >= (int) m_SubEvents.size() || m_SubEvents[i])
+  {
+    std::cout << PHWHERE << " invalid sub event " << i << ", dropping it" << std::endl;
+    delete topNode;
+    return;
+  }
+  m_SubEvents[i] = topNode;
+}
+
+//_____________________________________________________________________________
+void PHG4SubEventMerger::merge_subevents()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (unsigned int i = 0; i < m_SubEvents.size(); ++i)
+  {
+    if (!m_SubEvents[i])
+    {
+      std::cout << PHWHERE << " sub event " << i << " was not simulated" << std::endl;
+      continue;
+    }
+    copy_subevent(m_SubEvents[i]);
+    delete m_SubEvents[i];
+    m_SubEvents[i] = nullptr;
+  }
+}
+
+//_____________________________________________________________________________
+void PHG4SubEventMerger::copy_subevent(PHCompositeNode *topNode)
+{
+  // the sub event truth container starts empty, so its primary ids count up from 1
+  // and its secondary ids down from -1. They are shifted past the ids already in the
+  // destination which keeps the ordering within the sub event and needs no lookup.
+  // The same offsets apply to shower ids which are the ids of the primary particles
+  int trk_offset_primary = 0;
+  int trk_offset_secondary = 0;
+  int vtx_offset_secondary = 0;
+  if (m_g4truthinfo)
+  {
+    trk_offset_primary = m_g4truthinfo->maxtrkindex();
+    trk_offset_secondary = m_g4truthinfo->mintrkindex();
+    vtx_offset_secondary = m_g4truthinfo->minvtxindex();
+  }
+  auto convert_trkid = [&](const int id)
+  {
+    if (id > 0)
+    {
+      return id + trk_offset_primary;
+    }
+    if (id < 0)
+    {
+      return id + trk_offset_secondary;
+    }
+    return id;
+  };
+
+  // primary vertices are looked up, they can be shared between sub events
+  std::map<int, int> vtxid_map;
+  auto convert_vtxid = [&](const int id)
+  {
+    if (id > 0)
+    {
+      const auto keyiter = vtxid_map.find(id);
+      if (keyiter != vtxid_map.end())
+      {
+        return keyiter->second;
+      }
+      std::cout << "PHG4SubEventMerger::copy_subevent - vertex id " << id << " not found in map" << std::endl;
+      return id;
+    }
+    if (id < 0)
+    {
+      return id + vtx_offset_secondary;
+    }
+    return id;
+  };
+
+  const auto container_truth = findNode::getClass<PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
+  if (container_truth && m_g4truthinfo)
+  {
+    {
+      // primary vertices, merge the ones at the same position like PHG4TruthTrackingAction does within an event
+      const auto range = container_truth->GetPrimaryVtxRange();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        const auto &sourceVertex = iter->second;
+        const std::array<double, 3> position = {sourceVertex->get_x(), sourceVertex->get_y(), sourceVertex->get_z()};
+        auto [keyiter, inserted] = m_PrimaryVertexIds.insert(std::make_pair(position, 0));
+        if (inserted)
+        {
+          keyiter->second = m_g4truthinfo->maxvtxindex() + 1;
+          auto newVertex = new PHG4VtxPointv1(sourceVertex);
+          newVertex->set_id(keyiter->second);
+          m_g4truthinfo->AddVertex(keyiter->second, newVertex);
+        }
+        vtxid_map.insert(std::make_pair(sourceVertex->get_id(), keyiter->second));
+      }
+    }
+
+    {
+      // secondary vertices
+      const auto range = container_truth->GetSecondaryVtxRange();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        const auto &sourceVertex = iter->second;
+        auto newVertex = new PHG4VtxPointv1(sourceVertex);
+        newVertex->set_id(convert_vtxid(sourceVertex->get_id()));
+        m_g4truthinfo->AddVertex(newVertex->get_id(), newVertex);
+      }
+    }
+
+    {
+      // particles, ions are stored as PHG4Particlev3 by PHG4TruthTrackingAction
+      const auto range = container_truth->GetParticleRange();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        const auto &source = iter->second;
+        PHG4Particle *dest = nullptr;
+        if (dynamic_cast<const PHG4Particlev3 *>(source))
+        {
+          dest = new PHG4Particlev3(source);
+        }
+        else
+        {
+          dest = new PHG4Particlev2(source);
+        }
+        dest->set_track_id(convert_trkid(source->get_track_id()));
+        dest->set_parent_id(convert_trkid(source->get_parent_id()));
+        dest->set_primary_id(convert_trkid(source->get_primary_id()));
+        dest->set_vtx_id(convert_vtxid(source->get_vtx_id()));
+        m_g4truthinfo->AddParticle(dest->get_track_id(), dest);
+      }
+    }
+
+    {
+      // embed flags
+      const auto trkrange = container_truth->GetEmbeddedTrkIds();
+      for (auto iter = trkrange.first; iter != trkrange.second; ++iter)
+      {
+        m_g4truthinfo->AddEmbededTrkId(convert_trkid(iter->first), iter->second);
+      }
+      const auto vtxrange = container_truth->GetEmbeddedVtxIds();
+      for (auto iter = vtxrange.first; iter != vtxrange.second; ++iter)
+      {
+        m_g4truthinfo->AddEmbededVtxId(convert_vtxid(iter->first), iter->second);
+      }
+    }
+  }
+
+  // copy g4hits, keep track of the new hit keys for the showers
+  // container id => (source key => destination key)
+  std::map<int, std::map<PHG4HitDefs::keytype, PHG4HitDefs::keytype>> hitkey_map;
+  for (const auto &pair : m_g4hitscontainers)
+  {
+    auto container_hit = findNode::getClass<PHG4HitContainer>(topNode, pair.first);
+    if (!container_hit)
+    {
+      std::cout << "PHG4SubEventMerger::copy_subevent - invalid source container " << pair.first << std::endl;
+      continue;
+    }
+
+    auto &keymap = hitkey_map[container_hit->GetID()];
+    {
+      // hits
+      const auto range = container_hit->getHits();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        // clone hit
+        const auto &sourceHit = iter->second;
+        auto newHit = new PHG4Hitv1(sourceHit);
+
+        // update track and shower id
+        newHit->set_trkid(convert_trkid(sourceHit->get_trkid()));
+        if (sourceHit->get_shower_id() != std::numeric_limits<int>::min())
+        {
+          newHit->set_shower_id(convert_trkid(sourceHit->get_shower_id()));
+        }
+
+        /*
+         * this will generate a new key for the hit and assign it to the hit
+         * this ensures that there is no conflict with the hits from the other sub events
+         */
+        const auto newiter = pair.second->AddHit(newHit->get_detid(), newHit);
+        keymap.insert(std::make_pair(iter->first, newiter->first));
+      }
+    }
+
+    {
+      // layers
+      const auto range = container_hit->getLayers();
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        pair.second->AddLayer(*iter);
+      }
+    }
+  }
+
+  // showers, they reference particles, vertices and hits
+  if (container_truth && m_g4truthinfo)
+  {
+    const auto range = container_truth->GetShowerRange();
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      const auto &source = iter->second;
+      PHG4Shower *dest = source->CloneMe();
+      dest->set_id(convert_trkid(source->get_id()));
+      dest->set_parent_particle_id(convert_trkid(source->get_parent_particle_id()));
+      dest->set_parent_shower_id(convert_trkid(source->get_parent_shower_id()));
+
+      dest->clear_g4particle_id();
+      for (const int id : source->g4particle_ids())
+      {
+        dest->add_g4particle_id(convert_trkid(id));
+      }
+
+      dest->clear_g4vertex_id();
+      for (const int id : source->g4vertex_ids())
+      {
+        dest->add_g4vertex_id(convert_vtxid(id));
+      }
+
+      dest->clear_g4hit_id();
+      for (const auto &hitids : source->g4hit_ids())
+      {
+        const auto &keymap = hitkey_map[hitids.first];
+        for (const PHG4HitDefs::keytype key : hitids.second)
+        {
+          const auto keyiter = keymap.find(key);
+          if (keyiter != keymap.end())
+          {
+            dest->add_g4hit_id(hitids.first, keyiter->second);
+          }
+        }
+      }
+      m_g4truthinfo->AddShower(dest->get_id(), dest);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4MAIN_PHG4SUBEVENTMERGER_H
+#define G4MAIN_PHG4SUBEVENTMERGER_H
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class PHCompositeNode;
+class PHG4HitContainer;
+class PHG4TruthInfoContainer;
+
+/*!
+ * collects the node trees the geant worker threads fill for the sub events of
+ * one event in multi threaded running (PHG4Reco::set_threads()) and copies them
+ * into the g4hit containers and the truth information of the main node tree.
+ * Sub events are merged in order of their index, independent of which thread
+ * simulated them or when it finished, so the merged event is reproducible.
+ * Track, vertex, shower and hit ids are renumbered like Fun4AllDstPileupMerger does
+ * for background events, primary vertices at the same position are merged.
+ */
+class PHG4SubEventMerger final
+{
+ public:
+  //! constructor
+  PHG4SubEventMerger() = default;
+
+  //! destructor
+  ~PHG4SubEventMerger();
+
+  //! load destination nodes from the top node
+  void load_nodes(PHCompositeNode *);
+
+  //! create an empty node tree for one sub event, called on the worker threads
+  PHCompositeNode *create_subevent_nodes() const;
+
+  //! prepare for the next event, split into nsubevents sub events
+  void start_event(const int nsubevents);
+
+  //! store the node tree of sub event i, called on the worker threads
+  void set_subevent(const int i, PHCompositeNode *);
+
+  //! copy all sub events to the destination nodes in sub event order and delete their node trees
+  void merge_subevents();
+
+ private:
+  //! copy the content of one sub event node tree to the destination
+  void copy_subevent(PHCompositeNode *);
+
+  //! maps g4hit containers to node names
+  std::map<std::string, PHG4HitContainer *> m_g4hitscontainers;
+
+  //! truth information
+  PHG4TruthInfoContainer *m_g4truthinfo = nullptr;
+
+  //! primary vertex ids of the current event by position
+  std::map<std::array<double, 3>, int> m_PrimaryVertexIds;
+
+  //! guards m_SubEvents
+  std::mutex m_Mutex;
+
+  //! node trees of the sub events of the current event
+  std::vector<PHCompositeNode *> m_SubEvents;
+};
+
+#endif
@@ -19,6 +19,15 @@ class PHG4StackingAction;
 class PHG4SteppingAction;
 class PHG4TrackingAction;
 
+//! user actions of a subsystem for one geant worker thread, see PHG4Subsystem::CreateWorkerActions()
+struct PHG4WorkerActions
+{
+  PHG4EventAction *event_action = nullptr;
+  PHG4SteppingAction *stepping_action = nullptr;
+  PHG4TrackingAction *tracking_action = nullptr;
+  PHG4StackingAction *stacking_action = nullptr;
+};
+
 class PHG4Subsystem : public SubsysReco
 {
  public:
@@ -69,6 +78,14 @@ class PHG4Subsystem : public SubsysReco
 
   virtual PHG4StackingAction *GetStackingAction() const { return nullptr; }
 
+  //! multi threaded running (PHG4Reco::set_threads()) is only possible if all
+  //! subsystems with user actions return true here and implement CreateWorkerActions()
+  virtual bool SupportsWorkerThreads() const { return false; }
+
+  //! create a new set of this subsystems user actions for a geant worker thread.
+  //! Called after InitRun(), the actions are owned by the worker thread
+  virtual void CreateWorkerActions(PHG4WorkerActions & /*actions*/) {}
+
   void OverlapCheck(const bool chk = true) { overlapcheck = chk; }
 
   bool CheckOverlap() const { return overlapcheck; }
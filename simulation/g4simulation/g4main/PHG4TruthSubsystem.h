@@ -40,6 +40,10 @@ class PHG4TruthSubsystem : public PHG4Subsystem
   PHG4EventAction *GetEventAction(void) const override;
   PHG4TrackingAction *GetTrackingAction(void) const override;
 
+  //! multi threaded running
+  bool SupportsWorkerThreads() const override { return true; }
+  void CreateWorkerActions(PHG4WorkerActions &actions) override;
+
   //! only save the G4 truth information that is associated with the embedded particle
   void SetSaveOnlyEmbeded(bool b = true) { m_SaveOnlyEmbededFlag = b; };
 
@@ -7,6 +7,7 @@
 #include <trackbase/TrkrHit.h>  // for TrkrHit
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitTruthAssoc.h>
 
 #include <g4detectors/PHG4CylinderGeom.h>
@@ -185,50 +186,73 @@ void PHG4MvtxDigitizer::DigitizeMvtxLadderCells(PHCompositeNode *topNode)
 
     // get all of the hits from this hitset
     TrkrHitSet *hitset = hitset_iter->second;
-    TrkrHitSet::ConstRange hit_range = hitset->getHits();
     std::set<TrkrDefs::hitkey> hits_rm;
-    for (TrkrHitSet::ConstIterator hit_iter = hit_range.first;
-         hit_iter != hit_range.second;
-         ++hit_iter)
-    {
-      TrkrHit *hit = hit_iter->second;
 
-      // Convert the signal value to an ADC value and write that to the hit
+    // convert the signal value of one hit to an ADC value, hits below threshold are flagged for removal
+    auto digitize = [&](const TrkrDefs::hitkey hitkey, const double energy)
+    {
       // unsigned int adc = hit->getEnergy() / (TrkrDefs::MvtxEnergyScaleup *_energy_scale[layer]);
       if (Verbosity() > 0)
       {
-        std::cout << "    PHG4MvtxDigitizer: found hit with key: " << hit_iter->first << " and signal " << hit->getEnergy() / TrkrDefs::MvtxEnergyScaleup << " in layer " << layer << std::endl;
+        std::cout << "    PHG4MvtxDigitizer: found hit with key: " << hitkey << " and signal " << energy / TrkrDefs::MvtxEnergyScaleup << " in layer " << layer << std::endl;
       }
       // Remove the hits with energy under threshold
-      bool rm_hit = false;
-      if ((hit->getEnergy() / TrkrDefs::MvtxEnergyScaleup) < _energy_threshold)
+      if ((energy / TrkrDefs::MvtxEnergyScaleup) < _energy_threshold)
       {
         if (Verbosity() > 0)
         {
           std::cout << "         remove hit, below energy threshold of " << _energy_threshold << std::endl;
         }
-        rm_hit = true;
+        hits_rm.insert(hitkey);
       }
-      unsigned short adc = (unsigned short) (hit->getEnergy() / (TrkrDefs::MvtxEnergyScaleup * _energy_scale[layer]));
+      unsigned short adc = (unsigned short) (energy / (TrkrDefs::MvtxEnergyScaleup * _energy_scale[layer]));
       if (adc > _max_adc[layer])
       {
         adc = _max_adc[layer];
       }
-      hit->setAdc(adc);
+      return adc;
+    };
 
-      if (rm_hit)
+    TrkrHitSetv2 *flat = dynamic_cast<TrkrHitSetv2 *>(hitset);
+    if (flat)
+    {
+      // the adc is replaced in place, hit keys do not change
+      const auto &hitkeys = flat->getHitKeys();
+      const auto &adcs = flat->getAdcs();
+      for (unsigned int i = 0; i < hitkeys.size(); ++i)
+      {
+        flat->setAdc(hitkeys[i], digitize(hitkeys[i], (double) adcs[i] / TrkrDefs::EdepScaleFactor));
+      }
+    }
+    else
+    {
+      TrkrHitSet::ConstRange hit_range = hitset->getHits();
+      for (TrkrHitSet::ConstIterator hit_iter = hit_range.first;
+           hit_iter != hit_range.second;
+           ++hit_iter)
       {
-        hits_rm.insert(hit_iter->first);
+        TrkrHit *hit = hit_iter->second;
+        hit->setAdc(digitize(hit_iter->first, hit->getEnergy()));
       }
     }
 
+    // flat hitsets are compacted in one pass
+    if (flat && !hits_rm.empty())
+    {
+      flat->removeHits([&hits_rm](const TrkrDefs::hitkey key, const unsigned int /*adc*/)
+                       { return hits_rm.count(key) > 0; });
+    }
+
     for (const auto &key : hits_rm)
     {
       if (Verbosity() > 0)
       {
         std::cout << "    PHG4MvtxDigitizer: remove hit with key: " << key << std::endl;
       }
-      hitset->removeHit(key);
+      if (!flat)
+      {
+        hitset->removeHit(key);
+      }
       if (hittruthassoc)
       {
         hittruthassoc->removeAssoc(hitsetkey, key);
@@ -11,6 +11,7 @@
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>  // make iwyu happy
 #include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitTruthAssoc.h>  // make iwyu happy
 #include <trackbase/TrkrHitTruthAssocv1.h>
 #include <trackbase/TrkrHitv2.h>  // for TrkrHit
@@ -142,6 +143,10 @@ int PHG4MvtxHitReco::InitRun(PHCompositeNode* topNode)
     auto newNode = new PHIODataNode<PHObject>(hitsetcontainer, "TRKR_HITSET", "PHObject");
     trkrnode->addNode(newNode);
   }
+  if (m_flat_hitsets)
+  {
+    hitsetcontainer->setFlatHitSets(true);
+  }
 
   // create hit truth association if needed
   auto hittruthassoc = findNode::getClass<TrkrHitTruthAssoc>(topNode, "TRKR_HITTRUTHASSOC");
@@ -678,10 +683,8 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
           // generate the key for this hit
           TrkrDefs::hitkey hitkey = MvtxDefs::genHitKey(vzbin[i1], vxbin[i1]);
           // See if this hit already exists
-          TrkrHit* hit = nullptr;
-          hit = hitsetit->second->getHit(hitkey);
-
-          if (hit)
+          auto flat = dynamic_cast<TrkrHitSetv2*>(hitsetit->second);
+          if (flat ? flat->hasHit(hitkey) : (hitsetit->second->getHit(hitkey) != nullptr))
           {
             if (Verbosity() > 0)
             {
@@ -700,10 +703,16 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
           if ((std::find(m_deadPixelMap.begin(), m_deadPixelMap.end(), std::make_pair(hitsetkeymask, hitkey)) == m_deadPixelMap.end()) && (std::find(m_hotPixelMap.begin(), m_hotPixelMap.end(), std::make_pair(hitsetkeymask, hitkey)) == m_hotPixelMap.end()))
           {
             // create hit and insert in hitset
-            hit = new TrkrHitv2();
-
-            hit->addEnergy(hitenergy);
-            hitsetit->second->addHitSpecificKey(hitkey, hit);
+            if (flat)
+            {
+              flat->addEnergy(hitkey, hitenergy);
+            }
+            else
+            {
+              TrkrHit* hit = new TrkrHitv2();
+              hit->addEnergy(hitenergy);
+              hitsetit->second->addHitSpecificKey(hitkey, hit);
+            }
           }
           else
           {
@@ -714,7 +723,7 @@ int PHG4MvtxHitReco::process_event(PHCompositeNode* topNode)
 
           if (Verbosity() > 0)
           {
-            std::cout << "Layer: " << layer << ", Stave: " << (uint16_t) MvtxDefs::getStaveId(hitsetkey) << ", Chip: " << (uint16_t) MvtxDefs::getChipId(hitsetkey) << ", Row: " << (uint16_t) MvtxDefs::getRow(hitkey) << ", Col: " << (uint16_t) MvtxDefs::getCol(hitkey) << ", Strobe: " << (int) MvtxDefs::getStrobeId(hitsetkey) << ", added hit " << hitkey << " to hitset " << hitsetkey << " with energy " << hit->getEnergy() / TrkrDefs::MvtxEnergyScaleup << std::endl;
+            std::cout << "Layer: " << layer << ", Stave: " << (uint16_t) MvtxDefs::getStaveId(hitsetkey) << ", Chip: " << (uint16_t) MvtxDefs::getChipId(hitsetkey) << ", Row: " << (uint16_t) MvtxDefs::getRow(hitkey) << ", Col: " << (uint16_t) MvtxDefs::getCol(hitkey) << ", Strobe: " << (int) MvtxDefs::getStrobeId(hitsetkey) << ", added hit " << hitkey << " to hitset " << hitsetkey << " with energy " << hitsetit->second->getHit(hitkey)->getEnergy() / TrkrDefs::MvtxEnergyScaleup << std::endl;
           }
 
           // now we update the TrkrHitTruthAssoc map - the map contains <hitsetkey, std::pair <hitkey, g4hitkey> >
@@ -925,7 +934,7 @@ void PHG4MvtxHitReco::addtruthhitset(
   {
     // create a new one
     hit = new TrkrHitv2();
-    hitsetit->second->addHitSpecificKey(hitkey, hit);
+    hit = hitsetit->second->addHitSpecificKey(hitkey, hit)->second;
   }
   // Either way, add the energy to it  -- adc values will be added at digitization
   hit->addEnergy(neffelectrons);
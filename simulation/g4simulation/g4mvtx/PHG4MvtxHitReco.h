@@ -53,6 +53,9 @@ class PHG4MvtxHitReco : public SubsysReco, public PHParameterInterface
   //! parameters
   void SetDefaultParameters() override;
 
+  //! store the hits in TrkrHitSetv2 (flat hitkey, adc vectors) instead of one TrkrHitv2 per hit
+  void set_flat_hitsets(bool b) { m_flat_hitsets = b; }
+
  private:
   void makePixelMask(hitMask& aMask, const std::string& dbName, const std::string& totalPixelsToMask);
 
@@ -75,6 +78,8 @@ class PHG4MvtxHitReco : public SubsysReco, public PHParameterInterface
 
   bool m_in_sphenix_srdo = false;
 
+  bool m_flat_hitsets = false;
+
   class Deleter
   {
    public:
@@ -5,6 +5,7 @@
 #include <trackbase/TrkrHit.h>
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitTruthAssoc.h>
 #include <trackbase/TrkrHitv2.h>
 
@@ -497,7 +498,7 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
 				  auto hitset_iter = trkrhitsetcontainer->findOrAddHitSet(hitsetkey);
 				  
 				  hit = new TrkrHitv2();
-				  hitset_iter->second->addHitSpecificKey(hitkey, hit);
+				  hit = hitset_iter->second->addHitSpecificKey(hitkey, hit)->second;
 				  
 				  if (Verbosity() > 2) {
 				    if (layer == print_layer) { 
@@ -571,6 +572,27 @@ void PHG4TpcDigitizer::DigitizeCylinderCells(PHCompositeNode *topNode)
       
       // get all of the hits from this hitset
       TrkrHitSet *hitset = hitset_iter->second;
+
+      // flat hitsets are compacted in one pass, no need to store the keys
+      if (auto flat = dynamic_cast<TrkrHitSetv2 *>(hitset))
+	{
+	  flat->removeHits([&](const TrkrDefs::hitkey hitkey, const unsigned int adc)
+			   {
+			     if (Verbosity() > 5)
+			       {
+				 std::cout << "    layer " << layer << "  hitkey " << hitkey << " pad " << TpcDefs::getPad(hitkey)
+					   << " t bin " << TpcDefs::getTBin(hitkey)
+					   << " adc " << adc << std::endl;
+			       }
+			     if (adc == 0 && Verbosity() > 20 && layer == print_layer)
+			       {
+				 std::cout << "removed hit with hitsetkey " << hitsetkey
+					   << " and hitkey " << hitkey << std::endl;
+			       }
+			     return adc == 0; });
+	  continue;
+	}
+
       TrkrHitSet::ConstRange hit_range = hitset->getHits();
       for (TrkrHitSet::ConstIterator hit_iter = hit_range.first;
 	   hit_iter != hit_range.second;
@@ -14,6 +14,7 @@
 #include <TH3.h>
 #include <TTree.h>
 
+#include <algorithm>
 #include <cmath>    // for sqrt, fabs, NAN
 #include <cstdlib>  // for exit
 #include <iostream>
@@ -86,6 +87,18 @@ void PHG4TpcDistortion::Init()
       hReach[0] = dynamic_cast<TH3*>(m_static_tfile->Get("hReachesReadout_negz"));
       hReach[1] = dynamic_cast<TH3*>(m_static_tfile->Get("hReachesReadout_posz"));
     }
+
+    if (m_use_grid)
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        if (!hDRint[i] || !hDPint[i] || !hDZint[i] || (m_do_ReachesReadout && !hReach[i]) ||
+            !m_static_grid[i].build({hDRint[i], hDPint[i], hDZint[i], hReach[i]}))
+        {
+          std::cout << "PHG4TpcDistortion::Init - cannot build static distortion grid, interpolating from histograms" << std::endl;
+        }
+      }
+    }
   }
 
   if (m_do_time_ordered_distortions)
@@ -145,6 +158,17 @@ void PHG4TpcDistortion::load_event(int event_num)
       std::cout << "Distortion map sequence repeating as of event number " << event_num << std::endl;
     }
     TimeTree->GetEntry(event_num);
+
+    if (m_use_grid)
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        if (!m_time_ordered_grid[i].build({TimehDR[i], TimehDP[i], TimehDZ[i], m_do_ReachesReadout ? TimehRR[i] : nullptr}) && Verbosity())
+        {
+          std::cout << "PHG4TpcDistortion::load_event - cannot build time ordered distortion grid, interpolating from histograms" << std::endl;
+        }
+      }
+    }
   }
 
   return;
@@ -231,6 +255,78 @@ double PHG4TpcDistortion::get_reaches_readout(double r, double phi, double z) co
   }
 }
 
+void PHG4TpcDistortion::get_distortions(double r, double phi, double z, double& dr, double& drphi, double& dz, double& reaches) const
+{
+  TpcDistortionGrid::Values values = {};
+  const bool use_grid = get_grid_distortions(r, phi, z, values);
+  if (!use_grid || m_validate_grid)
+  {
+    const TpcDistortionGrid::Values reference = {
+        {get_distortion('r', r, phi, z),
+         get_distortion('p', r, phi, z),
+         get_distortion('z', r, phi, z),
+         m_do_ReachesReadout ? get_distortion('R', r, phi, z) : 0}};
+    if (use_grid)
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        if (std::abs(values[i] - reference[i]) > 1e-6 * std::max(1., std::abs(reference[i])))
+        {
+          std::cout << "PHG4TpcDistortion::get_distortions - grid mismatch at (r, phi, z) = (" << r << ", " << phi << ", " << z << ")"
+                    << " component " << i << " grid: " << values[i] << " histogram: " << reference[i] << std::endl;
+        }
+      }
+    }
+    values = reference;
+  }
+
+  dr = values[0];
+  // if the hist is in radians, multiply by r to get the rphi distortion
+  drphi = m_phi_hist_in_radians ? r * values[1] : values[1];
+  dz = values[2];
+  reaches = m_do_ReachesReadout ? values[3] : 1;
+}
+
+//__________________________________________________________________________________________________________
+bool PHG4TpcDistortion::get_grid_distortions(double r, double phi, double z, TpcDistortionGrid::Values& values) const
+{
+  if (!m_use_grid)
+  {
+    return false;
+  }
+
+  if (phi < 0)
+  {
+    phi += 2 * M_PI;
+  }
+  const int zpart = (z > 0 ? 1 : 0);
+
+  if ((m_do_static_distortions && !m_static_grid[zpart].valid()) ||
+      (m_do_time_ordered_distortions && !m_time_ordered_grid[zpart].valid()))
+  {
+    return false;
+  }
+
+  values.fill(0);
+  TpcDistortionGrid::Values grid_values;
+  if (m_do_static_distortions && m_static_grid[zpart].interpolate(phi, r, z, grid_values))
+  {
+    for (unsigned int i = 0; i < values.size(); ++i)
+    {
+      values[i] += grid_values[i];
+    }
+  }
+  if (m_do_time_ordered_distortions && m_time_ordered_grid[zpart].interpolate(phi, r, z, grid_values))
+  {
+    for (unsigned int i = 0; i < values.size(); ++i)
+    {
+      values[i] += grid_values[i];
+    }
+  }
+  return true;
+}
+
+//__________________________________________________________________________________________________________
 double PHG4TpcDistortion::get_distortion(char axis, double r, double phi, double z) const
 {
   if (phi < 0)
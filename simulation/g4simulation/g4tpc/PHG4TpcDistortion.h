@@ -11,6 +11,9 @@
 #ifndef G4TPC_PHG4TPCDISTORTION_H
 #define G4TPC_PHG4TPCDISTORTION_H
 
+#include <tpc/TpcDistortionGrid.h>
+
+#include <array>
 #include <memory>
 #include <string>
 
@@ -49,6 +52,9 @@ class PHG4TpcDistortion
   // The ReachesReadout serves as a fourth axis in the distortion histogram
   double get_reaches_readout(double r, double phi, double z) const;
 
+  //! radial, R*phi and z distortions and reaches readout at once, for a given cylindrical truth location of the primary ionization
+  void get_distortions(double r, double phi, double z, double &dr, double &drphi, double &dz, double &reaches) const;
+
   //! Gets the verbosity of this module.
   int Verbosity() const
   {
@@ -95,6 +101,18 @@ class PHG4TpcDistortion
     m_phi_hist_in_radians = flag;
   }
 
+  //! interpolate from dense copies of the histograms (default), rather than from the histograms themselves
+  void set_use_grid(bool value)
+  {
+    m_use_grid = value;
+  }
+
+  //! compare grid and histogram interpolation in get_distortions, print differences
+  void set_validate_grid(bool value)
+  {
+    m_validate_grid = value;
+  }
+
   //! initialize
   void Init();
 
@@ -113,6 +131,9 @@ class PHG4TpcDistortion
   //! get distortion for a set of histogram and an input momentum distribution
   double get_distortion(char axis, double r, double phi, double z) const;
 
+  //! sum of static and time ordered (r, phi, z, reaches readout) interpolated from the grids. False if grids are not available
+  bool get_grid_distortions(double r, double phi, double z, TpcDistortionGrid::Values &values) const;
+
   //! The verbosity level. 0 means not verbose at all.
   int verbosity = 0;
 
@@ -121,6 +142,10 @@ class PHG4TpcDistortion
 
   bool m_do_ReachesReadout = false;
 
+  //! dense grids
+  bool m_use_grid = true;
+  bool m_validate_grid = false;
+
   //!@name static histograms
   //@{
   bool m_do_static_distortions = false;
@@ -130,6 +155,7 @@ class PHG4TpcDistortion
   TH3 *hDPint[2] = {nullptr, nullptr};
   TH3 *hDZint[2] = {nullptr, nullptr};
   TH3 *hReach[2] = {nullptr, nullptr};
+  std::array<TpcDistortionGrid, 2> m_static_grid;
   //@}
 
   //!@name time ordered histograms
@@ -142,6 +168,7 @@ class PHG4TpcDistortion
   TH3 *TimehDP[2] = {nullptr, nullptr};
   TH3 *TimehDZ[2] = {nullptr, nullptr};
   TH3 *TimehRR[2] = {nullptr, nullptr};
+  std::array<TpcDistortionGrid, 2> m_time_ordered_grid;
   //@}
 };
 
@@ -5,6 +5,8 @@
 #include "PHG4TpcDistortion.h"
 #include "PHG4TpcPadPlane.h"  // for PHG4TpcPadPlane
 #include "TpcClusterBuilder.h"
+#include "TpcHitAccumulator.h"
+#include "TpcPhiloxRandom.h"
 
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/TpcDefs.h>
@@ -15,6 +17,7 @@
 #include <trackbase/TrkrHit.h>  // for TrkrHit
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainerv1.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitTruthAssoc.h>  // for TrkrHitTruthA...
 #include <trackbase/TrkrHitTruthAssocv1.h>
 #include <trackbase/TrkrHitv2.h>
@@ -47,6 +50,7 @@
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
 #include <phool/PHRandomSeed.h>
+#include <phool/PHThreadPool.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE
 
@@ -61,9 +65,11 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_alloc
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>    // for sqrt, abs, NAN
+#include <cstdint>
 #include <cstdlib>  // for exit
 #include <iostream>
 #include <map>      // for _Rb_tree_cons...
@@ -76,6 +82,83 @@ namespace
   {
     return x * x;
   }
+
+  //! first counter word of the per g4hit random numbers, electrons use their index
+  constexpr uint32_t hit_stream = 0xFFFFFFFF;
+
+  //! uniform random numbers from consecutive counters of one stream
+  class PhiloxStream
+  {
+   public:
+    PhiloxStream(const TpcPhiloxRandom &rng, const uint32_t stream, const uint64_t key)
+      : m_rng(rng)
+      , m_stream(stream)
+      , m_key(key)
+    {
+    }
+
+    double uniform()
+    {
+      if (m_pos == 4)
+      {
+        m_block = m_rng(m_stream, m_counter++, m_key);
+        m_pos = 0;
+      }
+      return TpcPhiloxRandom::uniform(m_block[m_pos++]);
+    }
+
+   private:
+    const TpcPhiloxRandom &m_rng;
+    uint32_t m_stream{0};
+    uint32_t m_counter{0};
+    uint64_t m_key{0};
+    TpcPhiloxRandom::Block m_block{};
+    unsigned int m_pos{4};
+  };
+
+  //! poisson random number. Multiplication of uniforms for small means,
+  //! transformed rejection with squeeze (PTRS, W. Hoermann 1993) otherwise
+  unsigned int poisson(PhiloxStream &stream, const double mu)
+  {
+    if (mu < 10)
+    {
+      const double limit = std::exp(-mu);
+      unsigned int k = 0;
+      double prod = stream.uniform();
+      while (prod > limit)
+      {
+        ++k;
+        prod *= stream.uniform();
+      }
+      return k;
+    }
+
+    const double slam = std::sqrt(mu);
+    const double loglam = std::log(mu);
+    const double b = 0.931 + 2.53 * slam;
+    const double a = -0.059 + 0.02483 * b;
+    const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+    const double vr = 0.9277 - 3.6224 / (b - 2);
+    while (true)
+    {
+      const double u = stream.uniform() - 0.5;
+      const double v = stream.uniform();
+      const double us = 0.5 - std::abs(u);
+      const double k = std::floor((2 * a / us + b) * u + mu + 0.43);
+      if (us >= 0.07 && v <= vr)
+      {
+        return static_cast<unsigned int>(k);
+      }
+      if (k < 0 || (us < 0.013 && v > us))
+      {
+        continue;
+      }
+      if (std::log(v) + std::log(invalpha) - std::log(a / (us * us) + b) <= -mu + k * loglam - std::lgamma(k + 1))
+      {
+        return static_cast<unsigned int>(k);
+      }
+    }
+  }
 }  // namespace
 
 PHG4TpcElectronDrift::PHG4TpcElectronDrift(const std::string &name)
@@ -89,6 +172,8 @@ PHG4TpcElectronDrift::PHG4TpcElectronDrift(const std::string &name)
   set_seed(PHRandomSeed());
 }
 
+PHG4TpcElectronDrift::~PHG4TpcElectronDrift() = default;
+
 //_____________________________________________________________
 int PHG4TpcElectronDrift::Init(PHCompositeNode *topNode)
 {
@@ -156,6 +241,13 @@ int PHG4TpcElectronDrift::InitRun(PHCompositeNode *topNode)
     DetNode->addNode(newNode);
   }
 
+  if (m_flat_hitsets)
+  {
+    hitsetcontainer->setFlatHitSets(true);
+    temp_hitsetcontainer->setFlatHitSets(true);
+    single_hitsetcontainer->setFlatHitSets(true);
+  }
+
   truthtracks = findNode::getClass<TrkrTruthTrackContainer>(topNode, "TRKR_TRUTHTRACKCONTAINER");
   if (!truthtracks)
   {
@@ -396,6 +488,22 @@ int PHG4TpcElectronDrift::InitRun(PHCompositeNode *topNode)
     }
   }
 
+  if (m_use_counter_rng && m_num_threads != 1 && !m_threadpool)
+  {
+    m_threadpool = std::make_unique<PHThreadPool>(m_num_threads);
+    if (Verbosity() > 0)
+    {
+      std::cout << PHWHERE << "electron transport with " << m_threadpool->size() << " threads"
+                << " (single threaded while QA histograms or ntuples are filled)" << std::endl;
+    }
+  }
+  m_scratch.resize(m_threadpool ? m_threadpool->size() : 1);
+
+  if (m_use_hit_accumulator && !m_hit_accumulator)
+  {
+    m_hit_accumulator = std::make_unique<TpcHitAccumulator>();
+  }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -455,6 +563,35 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
 
   int trkid = -1;
 
+  // with the counter based generator the electrons are transported in blocks of g4hits
+  // ahead of the loop below, which maps them to the pad plane in the original g4hit order
+  TpcPhiloxRandom philox;
+  if (m_use_counter_rng)
+  {
+    philox = TpcPhiloxRandom((static_cast<uint64_t>(event_num) << 32U) | m_seed);
+    m_hit_list.clear();
+    for (auto hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter)
+    {
+      m_hit_list.push_back(hiter);
+    }
+    m_block_first = 0;
+    m_block_electrons.clear();
+  }
+
+  // one electron on the pad plane, either in the accumulation buffer or in the temporary hitset containers
+  const auto map_to_pad_plane = [this](double x, double y, double t, unsigned int side, PHG4HitContainer::ConstIterator hiter)
+  {
+    if (m_hit_accumulator)
+    {
+      padplane->MapToPadPlane(truth_clusterer, *m_hit_accumulator, x, y, t, side, hiter, ntpad, nthit);
+    }
+    else
+    {
+      padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
+                              temp_hitsetcontainer.get(), hittruthassoc, x, y, t, side, hiter, ntpad, nthit);
+    }
+  };
+
   PHG4Hit *prior_g4hit = nullptr;  // used to check for jumps in g4hits;
   // if there is a big jump (such as crossing into the INTT area or out of the TPC)
   // then cluster the truth clusters before adding a new hit. This prevents
@@ -528,7 +665,22 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
     // drifted electrons, then copy to the node tree later
 
     double eion = hiter->second->get_eion();
-    unsigned int n_electrons = gsl_ran_poisson(RandomGenerator.get(), eion * electrons_per_gev);
+    unsigned int n_electrons = 0;
+    const HitElectrons *drifted = nullptr;
+    if (m_use_counter_rng)
+    {
+      const std::size_t index = count_g4hits - 1;
+      if (index >= m_block_first + m_block_electrons.size())
+      {
+        drift_block(philox, index);
+      }
+      drifted = &m_block_electrons[index - m_block_first];
+      n_electrons = drifted->n_electrons;
+    }
+    else
+    {
+      n_electrons = gsl_ran_poisson(RandomGenerator.get(), eion * electrons_per_gev);
+    }
     //    count_electrons += n_electrons;
 
     if (Verbosity() > 100)
@@ -560,163 +712,114 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
     }
 
     int notReachingReadout = 0;
-    int notInAcceptance = 0;
-    for (unsigned int i = 0; i < n_electrons; i++)
-    {
-      // We choose the electron starting position at random from a flat
-      // distribution along the path length the parameter t is the fraction of
-      // the distance along the path betwen entry and exit points, it has
-      // values between 0 and 1
-      const double f = gsl_ran_flat(RandomGenerator.get(), 0.0, 1.0);
-
-      const double x_start = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
-      const double y_start = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
-      const double z_start = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
-      const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
-
-      unsigned int side = 0;
-      if (z_start > 0)
-      {
-        side = 1;
-      }
-
-      const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
-      const double rantrans =
-          gsl_ran_gaussian(RandomGenerator.get(), r_sigma) +
-          gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_trans);
-
-      const double t_path = (tpc_length / 2. - std::abs(z_start)) / drift_velocity;
-      const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / drift_velocity;
-      const double rantime =
-          gsl_ran_gaussian(RandomGenerator.get(), t_sigma) +
-          gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_long) / drift_velocity;
-      double t_final = t_start + t_path + rantime;
-
-      if (t_final < min_time || t_final > max_time)
-      {
-        continue;
-      }
-
-      double z_final;
-      if (z_start < 0)
+    if (drifted)
+    {
+      notReachingReadout = drifted->notReachingReadout;
+      for (const auto &electron : drifted->electrons)
       {
-        z_final = -tpc_length / 2. + t_final * drift_velocity;
+        map_to_pad_plane(electron.x, electron.y, electron.t, electron.side, hiter);
       }
-      else
+    }
+    else
+    {
+      for (unsigned int i = 0; i < n_electrons; i++)
       {
-        z_final = tpc_length / 2. - t_final * drift_velocity;
-      }
-
-      const double radstart = std::sqrt(square(x_start) + square(y_start));
-      const double phistart = std::atan2(y_start, x_start);
-      const double ranphi = gsl_ran_flat(RandomGenerator.get(), -M_PI, M_PI);
-
-      double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
-      double y_final = y_start + rantrans * std::sin(ranphi);
+        // We choose the electron starting position at random from a flat
+        // distribution along the path length the parameter t is the fraction of
+        // the distance along the path betwen entry and exit points, it has
+        // values between 0 and 1
+        const double f = gsl_ran_flat(RandomGenerator.get(), 0.0, 1.0);
+
+        const double x_start = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
+        const double y_start = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
+        const double z_start = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
+        const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
+
+        unsigned int side = 0;
+        if (z_start > 0)
+        {
+          side = 1;
+        }
 
-      double rad_final = sqrt(square(x_final) + square(y_final));
-      double phi_final = atan2(y_final, x_final);
+        const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
+        const double rantrans =
+            gsl_ran_gaussian(RandomGenerator.get(), r_sigma) +
+            gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_trans);
 
-      if (do_ElectronDriftQAHistos)
-      {
-        z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
-        deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
-        deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
-      }
+        const double t_path = (tpc_length / 2. - std::abs(z_start)) / drift_velocity;
+        const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / drift_velocity;
+        const double rantime =
+            gsl_ran_gaussian(RandomGenerator.get(), t_sigma) +
+            gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_long) / drift_velocity;
+        double t_final = t_start + t_path + rantime;
 
-      if (m_distortionMap)
-      {
-        // zhangcanyu
-        const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
-        if (reaches < thresholdforreachesreadout)
+        if (t_final < min_time || t_final > max_time)
         {
-          notReachingReadout++;
           continue;
         }
 
-        const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
-        const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
-        const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
-
-        rad_final += r_distortion;
-        phi_final += phi_distortion;
-        z_final += z_distortion;
+        double z_final;
         if (z_start < 0)
         {
-          t_final = (z_final + tpc_length / 2.0) / drift_velocity;
+          z_final = -tpc_length / 2. + t_final * drift_velocity;
         }
         else
         {
-          t_final = (tpc_length / 2.0 - z_final) / drift_velocity;
+          z_final = tpc_length / 2. - t_final * drift_velocity;
         }
 
-        x_final = rad_final * std::cos(phi_final);
-        y_final = rad_final * std::sin(phi_final);
+        const double ranphi = gsl_ran_flat(RandomGenerator.get(), -M_PI, M_PI);
 
-        //	if(i < 1)
-        //{std::cout << " electron " << i << " r_distortion " << r_distortion << " phi_distortion " << phi_distortion << " rad_final " << rad_final << " phi_final " << phi_final << " r*dphi distortion " << rad_final * phi_distortion << " z_distortion " << z_distortion << std::endl;}
+        double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
+        double y_final = y_start + rantrans * std::sin(ranphi);
+        double rad_final = 0;
 
-        if (do_ElectronDriftQAHistos)
+        if (!distort_electron(x_start, y_start, z_start, rantrans, x_final, y_final, z_final, t_final, rad_final, notReachingReadout))
         {
-          const double phi_final_nodiff = phistart + phi_distortion;
-          const double rad_final_nodiff = radstart + r_distortion;
-          deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
-          deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
-          deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
-          deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
-
-          // Fill Diagnostic plots, written into ElectronDriftQA.root
-          hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
-          hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
-          hitmapstart_z->Fill(z_start, radstart);
-          hitmapend_z->Fill(z_final, rad_final);
-          deltar->Fill(radstart, rad_final - radstart);    // total delta r
-          deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
-          deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+          continue;
         }
-      }
-
-      // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
-      if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
-      {
-        notInAcceptance++;
-        continue;
-      }
 
-      if (Verbosity() > 1000)
-      //      if(i < 1)
-      {
-        std::cout << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl;
-        std::cout << "radstart " << radstart << " x_start: " << x_start
-                  << ", y_start: " << y_start
-                  << ",z_start: " << z_start
-                  << " t_start " << t_start
-                  << " t_path " << t_path
-                  << " t_sigma " << t_sigma
-                  << " rantime " << rantime
-                  << std::endl;
-
-        std::cout << "       rad_final " << rad_final << " x_final " << x_final
-                  << " y_final " << y_final
-                  << " z_final " << z_final << " t_final " << t_final
-                  << " zdiff " << z_final - z_start << std::endl;
-      }
+        if (Verbosity() > 1000)
+        //      if(i < 1)
+        {
+          std::cout << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl;
+          std::cout << "radstart " << std::sqrt(square(x_start) + square(y_start)) << " x_start: " << x_start
+                    << ", y_start: " << y_start
+                    << ",z_start: " << z_start
+                    << " t_start " << t_start
+                    << " t_path " << t_path
+                    << " t_sigma " << t_sigma
+                    << " rantime " << rantime
+                    << std::endl;
+
+          std::cout << "       rad_final " << rad_final << " x_final " << x_final
+                    << " y_final " << y_final
+                    << " z_final " << z_final << " t_final " << t_final
+                    << " zdiff " << z_final - z_start << std::endl;
+        }
 
-      if (Verbosity() > 0)
-      {
-        assert(nt);
-        nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
-      }
-      padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
-                              temp_hitsetcontainer.get(), hittruthassoc, x_final, y_final, t_final,
-                              side, hiter, ntpad, nthit);
-    }  // end loop over electrons for this g4hit
+        if (Verbosity() > 0)
+        {
+          assert(nt);
+          nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
+        }
+        map_to_pad_plane(x_final, y_final, t_final, side, hiter);
+      }  // end loop over electrons for this g4hit
+    }
 
     if (do_ElectronDriftQAHistos)
     {
       ratioElectronsRR->Fill((double) (n_electrons - notReachingReadout) / n_electrons);
     }
 
+    if (m_hit_accumulator)
+    {
+      // hits and truth association are added to the node tree after the loop over g4hits
+      m_hit_accumulator->endG4Hit(hiter->first);
+      ++ihit;
+      continue;
+    }
+
     TrkrHitSetContainer::ConstRange single_hitset_range = single_hitsetcontainer->getHitSets(TrkrDefs::TrkrId::tpcId);
     for (TrkrHitSetContainer::ConstIterator single_hitset_iter = single_hitset_range.first;
          single_hitset_iter != single_hitset_range.second;
@@ -733,6 +836,14 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
         std::cout << " hitsetkey " << node_hitsetkey << " layer " << layer << " sector " << sector << " side " << side << std::endl;
       }
       // get all of the hits from the single hitset
+      if (auto single_flat = dynamic_cast<TrkrHitSetv2 *>(single_hitset_iter->second))
+      {
+        for (const auto &single_hitkey : single_flat->getHitKeys())
+        {
+          hittruthassoc->addAssoc(node_hitsetkey, single_hitkey, hiter->first);
+        }
+        continue;
+      }
       TrkrHitSet::ConstRange single_hit_range = single_hitset_iter->second->getHits();
       for (TrkrHitSet::ConstIterator single_hit_iter = single_hit_range.first;
            single_hit_iter != single_hit_range.second;
@@ -777,6 +888,20 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
         // find or add this hitset on the node tree
         TrkrHitSetContainer::Iterator node_hitsetit = hitsetcontainer->findOrAddHitSet(node_hitsetkey);
 
+        // flat hitsets, same sums as the TrkrHit based copy below
+        auto temp_flat = dynamic_cast<TrkrHitSetv2 *>(temp_hitset_iter->second);
+        auto node_flat = dynamic_cast<TrkrHitSetv2 *>(node_hitsetit->second);
+        if (temp_flat && node_flat)
+        {
+          const auto &temp_hitkeys = temp_flat->getHitKeys();
+          const auto &temp_adcs = temp_flat->getAdcs();
+          for (unsigned int i = 0; i < temp_hitkeys.size(); ++i)
+          {
+            node_flat->addEnergy(temp_hitkeys[i], (double) temp_adcs[i] / TrkrDefs::EdepScaleFactor);
+          }
+          continue;
+        }
+
         // get all of the hits from the temporary hitset
         TrkrHitSet::ConstRange temp_hit_range = temp_hitset_iter->second->getHits();
         for (TrkrHitSet::ConstIterator temp_hit_iter = temp_hit_range.first;
@@ -802,7 +927,7 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
           {
             // Otherwise, create a new one
             node_hit = new TrkrHitv2();
-            node_hitsetit->second->addHitSpecificKey(temp_hitkey, node_hit);
+            node_hit = node_hitsetit->second->addHitSpecificKey(temp_hitkey, node_hit)->second;
           }
 
           // Either way, add the energy to it
@@ -830,6 +955,11 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
 
   }  // end loop over g4hits
 
+  if (m_hit_accumulator)
+  {
+    m_hit_accumulator->emit(hitsetcontainer, hittruthassoc);
+  }
+
   if (truth_track)
   {
     truth_clusterer.cluster_hits(truth_track);
@@ -897,6 +1027,220 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+bool PHG4TpcElectronDrift::distort_electron(const double x_start, const double y_start, const double z_start, const double rantrans,
+                                            double &x_final, double &y_final, double &z_final, double &t_final,
+                                            double &rad_final, int &notReachingReadout)
+{
+  const double radstart = std::sqrt(square(x_start) + square(y_start));
+  const double phistart = std::atan2(y_start, x_start);
+
+  rad_final = sqrt(square(x_final) + square(y_final));
+  double phi_final = atan2(y_final, x_final);
+
+  if (do_ElectronDriftQAHistos)
+  {
+    z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
+    deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
+    deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
+  }
+
+  if (m_distortionMap)
+  {
+    // all distortions from a single lookup
+    double r_distortion = 0;
+    double rphi_distortion = 0;
+    double z_distortion = 0;
+    double reaches = 1;
+    m_distortionMap->get_distortions(radstart, phistart, z_start, r_distortion, rphi_distortion, z_distortion, reaches);
+
+    // zhangcanyu
+    if (reaches < thresholdforreachesreadout)
+    {
+      notReachingReadout++;
+      return false;
+    }
+
+    const double phi_distortion = rphi_distortion / radstart;
+
+    rad_final += r_distortion;
+    phi_final += phi_distortion;
+    z_final += z_distortion;
+    if (z_start < 0)
+    {
+      t_final = (z_final + tpc_length / 2.0) / drift_velocity;
+    }
+    else
+    {
+      t_final = (tpc_length / 2.0 - z_final) / drift_velocity;
+    }
+
+    x_final = rad_final * std::cos(phi_final);
+    y_final = rad_final * std::sin(phi_final);
+
+    if (do_ElectronDriftQAHistos)
+    {
+      const double phi_final_nodiff = phistart + phi_distortion;
+      const double rad_final_nodiff = radstart + r_distortion;
+      deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
+      deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
+      deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
+      deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
+
+      // Fill Diagnostic plots, written into ElectronDriftQA.root
+      hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
+      hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
+      hitmapstart_z->Fill(z_start, radstart);
+      hitmapend_z->Fill(z_final, rad_final);
+      deltar->Fill(radstart, rad_final - radstart);    // total delta r
+      deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
+      deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+    }
+  }
+
+  // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
+  return !(rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0);
+}
+
+void PHG4TpcElectronDrift::drift_block(const TpcPhiloxRandom &rng, const std::size_t first)
+{
+  // g4hits per block and per thread pool task
+  static constexpr std::size_t block_size = 4096;
+  static constexpr std::size_t hits_per_task = 32;
+
+  const std::size_t nhits = std::min(block_size, m_hit_list.size() - first);
+  m_block_first = first;
+  m_block_electrons.resize(nhits);
+
+  // histograms and ntuples are not thread safe
+  if (m_threadpool && !do_ElectronDriftQAHistos && Verbosity() == 0)
+  {
+    const std::size_t ntasks = (nhits + hits_per_task - 1) / hits_per_task;
+    m_threadpool->parallel_for(ntasks, [&](std::size_t task, unsigned int worker)
+                               {
+      const std::size_t end = std::min(nhits, (task + 1) * hits_per_task);
+      for (std::size_t i = task * hits_per_task; i < end; ++i)
+      {
+        drift_hit(rng, first + i, m_block_electrons[i], m_scratch[worker]);
+      } });
+  }
+  else
+  {
+    for (std::size_t i = 0; i < nhits; ++i)
+    {
+      drift_hit(rng, first + i, m_block_electrons[i], m_scratch[0]);
+    }
+  }
+}
+
+void PHG4TpcElectronDrift::drift_hit(const TpcPhiloxRandom &rng, const std::size_t index, HitElectrons &drifted, DriftScratch &scratch)
+{
+  const auto &hiter = m_hit_list[index];
+  const PHG4Hit *hit = hiter->second;
+  const uint64_t g4hitkey = hiter->first;
+
+  drifted.n_electrons = 0;
+  drifted.notReachingReadout = 0;
+  drifted.electrons.clear();
+
+  if (std::fmax(hit->get_t(0), hit->get_t(1)) > max_time)
+  {
+    return;
+  }
+
+  PhiloxStream hit_randoms(rng, hit_stream, g4hitkey);
+  drifted.n_electrons = poisson(hit_randoms, hit->get_eion() * electrons_per_gev);
+  const unsigned int n = drifted.n_electrons;
+  if (n == 0)
+  {
+    return;
+  }
+
+  for (auto vec : {&scratch.f, &scratch.ranphi, &scratch.gaus_trans, &scratch.gaus_smear_trans,
+                   &scratch.gaus_long, &scratch.gaus_smear_long, &scratch.x_start, &scratch.y_start,
+                   &scratch.z_start, &scratch.rantrans, &scratch.t_final, &scratch.x_final, &scratch.y_final})
+  {
+    vec->resize(n);
+  }
+
+  // random numbers of electron i only depend on (seed, event, g4hit, i)
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    const auto r0 = rng(i, 0, g4hitkey);
+    const auto r1 = rng(i, 1, g4hitkey);
+    scratch.f[i] = TpcPhiloxRandom::uniform(r0[0]);
+    scratch.ranphi[i] = -M_PI + 2. * M_PI * TpcPhiloxRandom::uniform(r0[1]);
+    TpcPhiloxRandom::gaussian_pair(r0[2], r0[3], scratch.gaus_trans[i], scratch.gaus_smear_trans[i]);
+    TpcPhiloxRandom::gaussian_pair(r1[0], r1[1], scratch.gaus_long[i], scratch.gaus_smear_long[i]);
+  }
+
+  // drift and diffusion, branch free so that the compiler can vectorize it
+  const double x0 = hit->get_x(0);
+  const double y0 = hit->get_y(0);
+  const double z0 = hit->get_z(0);
+  const double t0 = hit->get_t(0);
+  const double dx = hit->get_x(1) - x0;
+  const double dy = hit->get_y(1) - y0;
+  const double dz = hit->get_z(1) - z0;
+  const double dt = hit->get_t(1) - t0;
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    const double f = scratch.f[i];
+    const double z_start = z0 + f * dz;
+    const double drift_length = tpc_length / 2. - std::abs(z_start);
+    const double sqrt_length = std::sqrt(drift_length);
+    const double rantrans = diffusion_trans * sqrt_length * scratch.gaus_trans[i] + added_smear_sigma_trans * scratch.gaus_smear_trans[i];
+    const double rantime = (diffusion_long * sqrt_length * scratch.gaus_long[i] + added_smear_sigma_long * scratch.gaus_smear_long[i]) / drift_velocity;
+    scratch.x_start[i] = x0 + f * dx;
+    scratch.y_start[i] = y0 + f * dy;
+    scratch.z_start[i] = z_start;
+    scratch.rantrans[i] = rantrans;
+    scratch.t_final[i] = t0 + f * dt + drift_length / drift_velocity + rantime;
+    scratch.x_final[i] = scratch.x_start[i] + rantrans * std::cos(scratch.ranphi[i]);
+    scratch.y_final[i] = scratch.y_start[i] + rantrans * std::sin(scratch.ranphi[i]);
+  }
+
+  // time window, distortions and acceptance
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    double t_final = scratch.t_final[i];
+    if (t_final < min_time || t_final > max_time)
+    {
+      continue;
+    }
+
+    const double z_start = scratch.z_start[i];
+    double z_final = (z_start < 0) ? -tpc_length / 2. + t_final * drift_velocity : tpc_length / 2. - t_final * drift_velocity;
+    double x_final = scratch.x_final[i];
+    double y_final = scratch.y_final[i];
+    double rad_final = 0;
+    if (!distort_electron(scratch.x_start[i], scratch.y_start[i], z_start, scratch.rantrans[i],
+                          x_final, y_final, z_final, t_final, rad_final, drifted.notReachingReadout))
+    {
+      continue;
+    }
+
+    if (Verbosity() > 1000)
+    {
+      std::cout << "electron " << i << " g4hitid " << g4hitkey << " f " << scratch.f[i]
+                << " x_start: " << scratch.x_start[i] << ", y_start: " << scratch.y_start[i] << ", z_start: " << z_start << std::endl;
+      std::cout << "       rad_final " << rad_final << " x_final " << x_final
+                << " y_final " << y_final
+                << " z_final " << z_final << " t_final " << t_final
+                << " zdiff " << z_final - z_start << std::endl;
+    }
+
+    if (Verbosity() > 0)
+    {
+      assert(nt);
+      const double t_start = t0 + scratch.f[i] * dt;
+      const double t_sigma = diffusion_long * std::sqrt(tpc_length / 2. - std::abs(z_start)) / drift_velocity;
+      nt->Fill(index, t_start, t_final, t_sigma, rad_final, z_start, z_final);
+    }
+
+    drifted.electrons.push_back({x_final, y_final, t_final, static_cast<unsigned int>(z_start > 0 ? 1 : 0)});
+  }
+}
+
 int PHG4TpcElectronDrift::End(PHCompositeNode * /*topNode*/)
 {
   if (Verbosity() > 0)
@@ -941,6 +1285,7 @@ int PHG4TpcElectronDrift::End(PHCompositeNode * /*topNode*/)
 void PHG4TpcElectronDrift::set_seed(const unsigned int seed)
 {
   gsl_rng_set(RandomGenerator.get(), seed);
+  m_seed = seed;
 }
 
 void PHG4TpcElectronDrift::SetDefaultParameters()
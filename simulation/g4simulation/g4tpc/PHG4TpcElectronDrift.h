@@ -17,10 +17,12 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <fstream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 class PHG4TpcPadPlane;
 class PHG4TpcDistortion;
@@ -38,12 +40,15 @@ class DistortedTrackContainer;
 class TpcClusterBuilder;
 class PHG4TpcCylinderGeomContainer;
 class ClusHitsVerbose;
+class PHThreadPool;
+class TpcHitAccumulator;
+class TpcPhiloxRandom;
 
 class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
 {
  public:
   PHG4TpcElectronDrift(const std::string &name = "PHG4TpcElectronDrift");
-  ~PHG4TpcElectronDrift() override{};
+  ~PHG4TpcElectronDrift() override;
   int Init(PHCompositeNode *) override;
   int InitRun(PHCompositeNode *) override;
   int process_event(PHCompositeNode *) override;
@@ -83,9 +88,70 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
   void set_zero_bfield_flag(bool flag) { zero_bfield = flag; };
   void set_zero_bfield_diffusion_factor(double f) { zero_bfield_diffusion_factor = f; };
   void use_PDG_gas_params() { m_use_PDG_gas_params = true; }
+
+  //! draw the electrons from a counter based generator keyed on (seed, event, g4hit, electron)
+  /*! the drifted electrons do not depend on the order in which the g4hits are transported, so this can run multi threaded */
+  void set_use_counter_rng(bool b) { m_use_counter_rng = b; }
+
+  //! number of threads for the electron transport with the counter based generator, 0 uses all hardware threads
+  void set_num_threads(unsigned int n) { m_num_threads = n; }
+
+  //! sum the pad plane charge in a dense per hitset buffer, added to the node tree once per event
+  /*! same hits and truth association as the default, which goes through temporary hitset containers */
+  void set_use_hit_accumulator(bool b) { m_use_hit_accumulator = b; }
+
+  //! store the TPC hits in TrkrHitSetv2 (flat hitkey, adc vectors) instead of one TrkrHitv2 per hit
+  void set_flat_hitsets(bool b) { m_flat_hitsets = b; }
+
   ClusHitsVerbosev1 *mClusHitsVerbose{nullptr};
 
  private:
+  //! one electron after drift, diffusion and distortion
+  struct DriftedElectron
+  {
+    double x{0};
+    double y{0};
+    double t{0};
+    unsigned int side{0};
+  };
+
+  //! transported electrons of one g4hit
+  struct HitElectrons
+  {
+    unsigned int n_electrons{0};
+    int notReachingReadout{0};
+    std::vector<DriftedElectron> electrons;
+  };
+
+  //! per thread arrays for the batch transport of the electrons of one g4hit
+  struct DriftScratch
+  {
+    std::vector<double> f;
+    std::vector<double> ranphi;
+    std::vector<double> gaus_trans;
+    std::vector<double> gaus_smear_trans;
+    std::vector<double> gaus_long;
+    std::vector<double> gaus_smear_long;
+    std::vector<double> x_start;
+    std::vector<double> y_start;
+    std::vector<double> z_start;
+    std::vector<double> rantrans;
+    std::vector<double> t_final;
+    std::vector<double> x_final;
+    std::vector<double> y_final;
+  };
+
+  //! distortion and acceptance for one diffused electron, false if the electron is lost
+  bool distort_electron(double x_start, double y_start, double z_start, double rantrans,
+                        double &x_final, double &y_final, double &z_final, double &t_final,
+                        double &rad_final, int &notReachingReadout);
+
+  //! transport the electrons of the g4hits [first, first + block size) of m_hit_list
+  void drift_block(const TpcPhiloxRandom &rng, std::size_t first);
+
+  //! transport the electrons of g4hit index of m_hit_list
+  void drift_hit(const TpcPhiloxRandom &rng, std::size_t index, HitElectrons &drifted, DriftScratch &scratch);
+
   TrkrHitSetContainer *hitsetcontainer{nullptr};
   TrkrHitTruthAssoc *hittruthassoc{nullptr};
   TrkrTruthTrackContainer *truthtracks{nullptr};
@@ -144,6 +210,25 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
   bool zero_bfield{false};
   bool m_use_PDG_gas_params{false};
 
+  //!@name counter based generator and multi threaded transport
+  //@{
+  bool m_use_counter_rng{false};
+  unsigned int m_seed{0};
+  unsigned int m_num_threads{1};
+  std::unique_ptr<PHThreadPool> m_threadpool;
+  std::vector<DriftScratch> m_scratch;
+  std::vector<PHG4HitContainer::ConstIterator> m_hit_list;
+  std::vector<HitElectrons> m_block_electrons;
+  std::size_t m_block_first{0};
+  //@}
+
+  //! pad plane accumulation buffer, used instead of the temporary hitset containers if set
+  bool m_use_hit_accumulator{false};
+  std::unique_ptr<TpcHitAccumulator> m_hit_accumulator;
+
+  //! create TrkrHitSetv2 in the node tree and temporary hitset containers
+  bool m_flat_hitsets{false};
+
   std::unique_ptr<TrkrHitSetContainer> temp_hitsetcontainer;
   std::unique_ptr<TrkrHitSetContainer> single_hitsetcontainer;
   std::unique_ptr<PHG4TpcPadPlane> padplane;
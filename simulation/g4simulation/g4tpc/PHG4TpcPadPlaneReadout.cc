@@ -1,4 +1,5 @@
 #include "PHG4TpcPadPlaneReadout.h"
+#include "TpcHitAccumulator.h"
 
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <g4detectors/PHG4CellDefs.h>  // for genkey, keytype
@@ -17,6 +18,7 @@
 #include <trackbase/TrkrHit.h>   // for TrkrHit
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
 #include <trackbase/TrkrHitv2.h>  // for TrkrHit
 
 #include <g4tracking/TrkrTruthTrack.h>
@@ -33,9 +35,11 @@
 
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_alloc
+#include <gsl/gsl_sf_gamma.h>
 
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>  // for getenv
 #include <iostream>
@@ -69,6 +73,72 @@ namespace
 
   static constexpr unsigned int print_layer = 18;
 
+  //! maximum number of electrons after GEM amplification in the Polya sampling
+  static constexpr double polya_xmax = 5000;
+
+  //! pad response table: steps per sigma, and range beyond the pad half width in sigma.
+  //! the response is below 1e-15 outside
+  static constexpr double pad_response_steps = 128;
+  static constexpr double pad_response_range = 10;
+
+  //! erf table: steps per unit and range. erf is 1 - 2e-17 at the upper end
+  static constexpr double erf_table_steps = 1024;
+  static constexpr double erf_table_max = 6;
+
+  //! Polya tables: CDF steps per average gain and range, number of inverse CDF steps
+  static constexpr double polya_cdf_steps = 256;
+  static constexpr double polya_cdf_max = 40;
+  static constexpr unsigned int polya_icdf_steps = 8192;
+
+  //! fraction of a gaussian charge cloud of width sigma, centered at x_loc from the pad center,
+  //! seen by a pad of half width pitch
+  /*
+  this corresponds to integrating the charge distribution Gaussian function (centered on rphi and of width cloud_sig_rp),
+  convoluted with a strip response function, which is triangular from -pitch to +pitch, with a maximum of 1. at stript center
+  */
+  double pad_response_exact(const double x_loc, const double pitch, const double sigma)
+  {
+    return (pitch - x_loc) * (std::erf(x_loc / (M_SQRT2 * sigma)) - std::erf((x_loc - pitch) / (M_SQRT2 * sigma))) / (pitch * 2) + (pitch + x_loc) * (std::erf((x_loc + pitch) / (M_SQRT2 * sigma)) - std::erf(x_loc / (M_SQRT2 * sigma))) / (pitch * 2) + (gaus(x_loc - pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch + (gaus(x_loc + pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch;
+  }
+
+  //! CDF of the Polya distribution of gain / average gain
+  double polya_cdf(const double theta, const double z)
+  {
+    return gsl_sf_gamma_inc_P(1 + theta, (1 + theta) * z);
+  }
+
+  //! inverse of polya_cdf by bisection
+  double polya_inverse_cdf(const double theta, const double u)
+  {
+    double lo = 0;
+    double hi = polya_cdf_max;
+    for (int i = 0; i < 60; ++i)
+    {
+      const double mid = 0.5 * (lo + hi);
+      if (polya_cdf(theta, mid) < u)
+      {
+        lo = mid;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+    return 0.5 * (lo + hi);
+  }
+
+  //! linear interpolation in a table with nodes at i / stepinv, clamped to the last node
+  inline double interpolate_table(const std::vector<double> &table, const double x, const double stepinv)
+  {
+    const double u = x * stepinv;
+    const std::size_t i = static_cast<std::size_t>(u);
+    if (i + 1 >= table.size())
+    {
+      return table.back();
+    }
+    return table[i] + (u - i) * (table[i + 1] - table[i]);
+  }
+
 }  // namespace
 
 PHG4TpcPadPlaneReadout::PHG4TpcPadPlaneReadout(const std::string &name)
@@ -194,11 +264,114 @@ int PHG4TpcPadPlaneReadout::InitRun(PHCompositeNode *topNode)
 	}
     } 
 
-  
+  if (m_useLookupTables)
+  {
+    build_lookup_tables();
+  }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::build_lookup_tables()
+{
+  // pad response. The cloud width is the same for all layers, the pad pitch depends on the layer radius.
+  // The response only depends on |x_loc| / sigma and pitch / sigma so one table per layer is sufficient
+  m_pad_response_table.clear();
+  PHG4TpcCylinderGeomContainer::ConstRange layerrange = GeomContainer->get_begin_end();
+  for (auto layeriter = layerrange.first; layeriter != layerrange.second; ++layeriter)
+  {
+    const unsigned int layer = layeriter->second->get_layer();
+    if (layer >= m_pad_response_table.size())
+    {
+      m_pad_response_table.resize(layer + 1);
+    }
+    // same pitch as in populate_zigzag_phibins
+    const double pitch = layeriter->second->get_phistep() * layeriter->second->get_radius();
+    const unsigned int nsteps = std::ceil((pitch / sigmaT + pad_response_range) * pad_response_steps);
+    auto &table = m_pad_response_table[layer];
+    table.resize(nsteps + 1);
+    for (unsigned int i = 0; i <= nsteps; ++i)
+    {
+      table[i] = pad_response_exact(i * sigmaT / pad_response_steps, pitch, sigmaT);
+    }
+  }
+
+  // erf for the time response
+  const unsigned int nerf = erf_table_max * erf_table_steps;
+  m_erf_table.resize(nerf + 1);
+  for (unsigned int i = 0; i <= nerf; ++i)
+  {
+    m_erf_table[i] = std::erf(i / erf_table_steps);
+  }
+
+  // Polya gain. Both tables are in units of the average gain, so they are valid for all module gain weights
+  const unsigned int ncdf = polya_cdf_max * polya_cdf_steps;
+  m_polya_cdf_table.resize(ncdf + 1);
+  for (unsigned int i = 0; i <= ncdf; ++i)
+  {
+    m_polya_cdf_table[i] = polya_cdf(polyaTheta, i / polya_cdf_steps);
+  }
+  m_polya_icdf_table.resize(polya_icdf_steps);
+  for (unsigned int i = 0; i < polya_icdf_steps; ++i)
+  {
+    m_polya_icdf_table[i] = polya_inverse_cdf(polyaTheta, double(i) / polya_icdf_steps);
+  }
+
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHG4TpcPadPlaneReadout::build_lookup_tables - pad response tables for " << m_pad_response_table.size()
+              << " layers, erf table " << m_erf_table.size() << " entries, Polya tables "
+              << m_polya_cdf_table.size() << "/" << m_polya_icdf_table.size() << " entries" << std::endl;
+  }
+}
+
+//_________________________________________________________
+double PHG4TpcPadPlaneReadout::pad_response(const unsigned int layer, const double x_loc, const double pitch, const double sigma) const
+{
+  if (!m_useLookupTables || layer >= m_pad_response_table.size() || m_pad_response_table[layer].empty() || sigma != sigmaT)
+  {
+    return pad_response_exact(x_loc, pitch, sigma);
+  }
+  // the response is symmetric in x_loc
+  const auto &table = m_pad_response_table[layer];
+  const double u = std::abs(x_loc) / sigma * pad_response_steps;
+  const std::size_t i = static_cast<std::size_t>(u);
+  if (i + 1 >= table.size())
+  {
+    return 0;
+  }
+  return table[i] + (u - i) * (table[i + 1] - table[i]);
+}
+
+//_________________________________________________________
+double PHG4TpcPadPlaneReadout::tpc_erf(const double x) const
+{
+  if (!m_useLookupTables)
+  {
+    return std::erf(x);
+  }
+  const double value = interpolate_table(m_erf_table, std::abs(x), erf_table_steps);
+  return (x < 0) ? -value : value;
+}
+
+//_________________________________________________________
+double PHG4TpcPadPlaneReadout::getSingleEGEMAmplificationPolyaTable(const double q_bar)
+{
+  // the rejection sampling is limited to polya_xmax electrons,
+  // here the uniform random number is limited to the CDF value at that point instead
+  const double umax = interpolate_table(m_polya_cdf_table, polya_xmax / q_bar, polya_cdf_steps);
+  const double u = gsl_rng_uniform(RandomGenerator) * umax;
+  const double x = u * polya_icdf_steps;
+  const std::size_t i = static_cast<std::size_t>(x);
+  if (i + 1 >= m_polya_icdf_table.size())
+  {
+    // linear interpolation is poor in the far tail, invert exactly there
+    return q_bar * polya_inverse_cdf(polyaTheta, u);
+  }
+  return q_bar * (m_polya_icdf_table[i] + (x - i) * (m_polya_icdf_table[i + 1] - m_polya_icdf_table[i]));
+}
+
 //_________________________________________________________
 double PHG4TpcPadPlaneReadout::getSingleEGEMAmplification()
 {
@@ -210,6 +383,10 @@ double PHG4TpcPadPlaneReadout::getSingleEGEMAmplification()
   // Bob A.: I like Tom's suggestion to use the exponential distribution as a first approximation
   //         for the single electron gain distribution -
   //         and yes, the parameter you're looking for is of course the slope, which is the inverse gain.
+  if (m_usePolya && m_useLookupTables)
+  {
+    return getSingleEGEMAmplificationPolyaTable(averageGEMGain);
+  }
   double nelec = gsl_ran_exponential(RandomGenerator, averageGEMGain);
   if (m_usePolya)
   { 
@@ -243,6 +420,10 @@ double PHG4TpcPadPlaneReadout::getSingleEGEMAmplification(double weight)
   //         for the single electron gain distribution -
   //         and yes, the parameter you're looking for is of course the slope, which is the inverse gain.
   double q_bar = averageGEMGain * weight;
+  if (m_usePolya && m_useLookupTables)
+  {
+    return getSingleEGEMAmplificationPolyaTable(q_bar);
+  }
   double nelec = gsl_ran_exponential(RandomGenerator, q_bar);
   if (m_usePolya)
   {
@@ -282,6 +463,26 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
     TrkrHitTruthAssoc * /*hittruthassoc*/,
     const double x_gem, const double y_gem, const double t_gem, const unsigned int side,
     PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/)
+{
+  map_to_pad_plane(tpc_truth_clusterer, single_hitsetcontainer, hitsetcontainer, nullptr, x_gem, y_gem, t_gem, side, hiter);
+}
+
+void PHG4TpcPadPlaneReadout::MapToPadPlane(
+    TpcClusterBuilder &tpc_truth_clusterer,
+    TpcHitAccumulator &accumulator,
+    const double x_gem, const double y_gem, const double t_gem, const unsigned int side,
+    PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/)
+{
+  map_to_pad_plane(tpc_truth_clusterer, nullptr, nullptr, &accumulator, x_gem, y_gem, t_gem, side, hiter);
+}
+
+void PHG4TpcPadPlaneReadout::map_to_pad_plane(
+    TpcClusterBuilder &tpc_truth_clusterer,
+    TrkrHitSetContainer *single_hitsetcontainer,
+    TrkrHitSetContainer *hitsetcontainer,
+    TpcHitAccumulator *accumulator,
+    const double x_gem, const double y_gem, const double t_gem, const unsigned int side,
+    PHG4HitContainer::ConstIterator hiter)
 {
   // One electron per call of this method
   // The x_gem and y_gem values have already been randomized within the transverse drift diffusion width
@@ -582,27 +783,49 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
       unsigned int pads_per_sector = phibins / 12;
       unsigned int sector = pad_num / pads_per_sector;
       TrkrDefs::hitsetkey hitsetkey = TpcDefs::genHitSetKey(layernum, sector, side);
-      // Use existing hitset or add new one if needed
-      TrkrHitSetContainer::Iterator hitsetit = hitsetcontainer->findOrAddHitSet(hitsetkey);
-      TrkrHitSetContainer::Iterator single_hitsetit = single_hitsetcontainer->findOrAddHitSet(hitsetkey);
 
       // generate the key for this hit, requires tbin and phibin
       TrkrDefs::hitkey hitkey = TpcDefs::genHitKey((unsigned int) pad_num, (unsigned int) tbin_num);
-      // See if this hit already exists
-      TrkrHit *hit = nullptr;
-      hit = hitsetit->second->getHit(hitkey);
-      if (!hit)
+
+      tpc_truth_clusterer.addhitset(hitsetkey, hitkey, neffelectrons);
+
+      if (accumulator)
       {
-        // create a new one
-        hit = new TrkrHitv2();
-        hitsetit->second->addHitSpecificKey(hitkey, hit);
+        // summed in place, the hits are added to the hitset container once per event
+        accumulator->addEnergy(layernum, sector, side, pads_per_sector, tbins, pad_num, tbin_num, neffelectrons);
+        continue;
       }
-      // Either way, add the energy to it  -- adc values will be added at digitization
-      hit->addEnergy(neffelectrons);
 
-      tpc_truth_clusterer.addhitset(hitsetkey, hitkey, neffelectrons);
+      // Use existing hitset or add new one if needed
+      TrkrHitSetContainer::Iterator hitsetit = hitsetcontainer->findOrAddHitSet(hitsetkey);
+      TrkrHitSetContainer::Iterator single_hitsetit = single_hitsetcontainer->findOrAddHitSet(hitsetkey);
+
+      // flat hitsets create the hit if needed and add the energy in place
+      if (auto flat = dynamic_cast<TrkrHitSetv2 *>(hitsetit->second))
+      {
+        flat->addEnergy(hitkey, neffelectrons);
+      }
+      else
+      {
+        // See if this hit already exists
+        TrkrHit *hit = nullptr;
+        hit = hitsetit->second->getHit(hitkey);
+        if (!hit)
+        {
+          // create a new one
+          hit = new TrkrHitv2();
+          hit = hitsetit->second->addHitSpecificKey(hitkey, hit)->second;
+        }
+        // Either way, add the energy to it  -- adc values will be added at digitization
+        hit->addEnergy(neffelectrons);
+      }
 
       // repeat for the single_hitsetcontainer
+      if (auto single_flat = dynamic_cast<TrkrHitSetv2 *>(single_hitsetit->second))
+      {
+        single_flat->addEnergy(hitkey, neffelectrons);
+        continue;
+      }
       // See if this hit already exists
       TrkrHit *single_hit = nullptr;
       single_hit = single_hitsetit->second->getHit(hitkey);
@@ -610,7 +833,7 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
       {
         // create a new one
         single_hit = new TrkrHitv2();
-        single_hitsetit->second->addHitSpecificKey(hitkey, single_hit);
+        single_hit = single_hitsetit->second->addHitSpecificKey(hitkey, single_hit)->second;
       }
       // Either way, add the energy to it  -- adc values will be added at digitization
       single_hit->addEnergy(neffelectrons);
@@ -834,12 +1057,7 @@ void PHG4TpcPadPlaneReadout::populate_zigzag_phibins(const unsigned int side, co
 
     const double x_loc = x_loc_tmp;
     // calculate fraction of the total charge on this strip
-    /*
-    this corresponds to integrating the charge distribution Gaussian function (centered on rphi and of width cloud_sig_rp),
-    convoluted with a strip response function, which is triangular from -pitch to +pitch, with a maximum of 1. at stript center
-    */
-    overlap[ipad] =
-        (pitch - x_loc) * (std::erf(x_loc / (M_SQRT2 * sigma)) - std::erf((x_loc - pitch) / (M_SQRT2 * sigma))) / (pitch * 2) + (pitch + x_loc) * (std::erf((x_loc + pitch) / (M_SQRT2 * sigma)) - std::erf(x_loc / (M_SQRT2 * sigma))) / (pitch * 2) + (gaus(x_loc - pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch + (gaus(x_loc + pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch;
+    overlap[ipad] = pad_response(layernum, x_loc, pitch, sigma);
   }
 
   // now we have the overlap for each pad
@@ -928,7 +1146,7 @@ void PHG4TpcPadPlaneReadout::populate_tbins(const double t, const std::array<dou
       double tLim1 = 0.0;
       double tLim2 = 0.5 * M_SQRT2 * (-0.5 * tstepsize - tdisp) * cloud_sig_tt_inv[index1];
       // 1/2 * the erf is the integral probability from the argument Z value to zero, so this is the integral probability between the Z limits
-      double t_integral1 = 0.5 * (erf(tLim1) - erf(tLim2));
+      double t_integral1 = 0.5 * (tpc_erf(tLim1) - tpc_erf(tLim2));
 
       if (Verbosity() > 1000)
       {
@@ -941,7 +1159,7 @@ void PHG4TpcPadPlaneReadout::populate_tbins(const double t, const std::array<dou
 
       tLim2 = 0.0;
       tLim1 = 0.5 * M_SQRT2 * (0.5 * tstepsize - tdisp) * cloud_sig_tt_inv[index2];
-      double t_integral2 = 0.5 * (erf(tLim1) - erf(tLim2));
+      double t_integral2 = 0.5 * (tpc_erf(tLim1) - tpc_erf(tLim2));
 
       if (Verbosity() > 1000)
       {
@@ -983,7 +1201,7 @@ void PHG4TpcPadPlaneReadout::populate_tbins(const double t, const std::array<dou
       }
       double tLim1 = 0.5 * M_SQRT2 * ((it + 0.5) * tstepsize - tdisp) * cloud_sig_tt_inv[index];
       double tLim2 = 0.5 * M_SQRT2 * ((it - 0.5) * tstepsize - tdisp) * cloud_sig_tt_inv[index];
-      t_integral = 0.5 * (erf(tLim1) - erf(tLim2));
+      t_integral = 0.5 * (tpc_erf(tLim1) - tpc_erf(tLim2));
 
       if (Verbosity() > 1000)
       {
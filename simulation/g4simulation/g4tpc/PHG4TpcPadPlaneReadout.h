@@ -20,6 +20,7 @@ class PHG4TpcCylinderGeom;
 class TH2;
 class TF1;
 class TNtuple;
+class TpcHitAccumulator;
 class TrkrHitSetContainer;
 class TrkrHitTruthAssoc;
 
@@ -40,6 +41,10 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   void SetUseLangauGEMGain(const int flagLangau) {m_useLangau = flagLangau;}
   void SetLangauParsFileName(const std::string &name) {m_tpc_langau_pars_file = name;}
 
+  //! use precomputed tables for the pad and time response and for the Polya gain sampling.
+  //! Off by default, the exact calculation is kept for validation
+  void SetUseLookupTables(const bool flag) { m_useLookupTables = flag; }
+
   void SetDriftVelocity(double vd) override { drift_velocity = vd; }
   void SetReadoutTime(float t) override { extended_readout_time = t; }
   // otherwise warning of inconsistent overload since only one MapToPadPlane methow is overridden
@@ -47,16 +52,33 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
 
   void MapToPadPlane(TpcClusterBuilder &tpc_clustbuilder, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc * /*hittruthassoc*/, const double x_gem, const double y_gem, const double t_gem, const unsigned int side, PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) override;
 
+  void MapToPadPlane(TpcClusterBuilder &tpc_clustbuilder, TpcHitAccumulator &accumulator, const double x_gem, const double y_gem, const double t_gem, const unsigned int side, PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) override;
+
   void SetDefaultParameters() override;
   void UpdateInternalParameters() override;
 
  private:
+  //! charge of one electron on the pad plane, added to the hitset containers or to the accumulator if not null
+  void map_to_pad_plane(TpcClusterBuilder &tpc_clustbuilder, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TpcHitAccumulator *accumulator, const double x_gem, const double y_gem, const double t_gem, const unsigned int side, PHG4HitContainer::ConstIterator hiter);
+
   //  void populate_rectangular_phibins(const unsigned int layernum, const double phi, const double cloud_sig_rp, std::vector<int> &pad_phibin, std::vector<double> &pad_phibin_share);
   void populate_zigzag_phibins(const unsigned int side, const unsigned int layernum, const double phi, const double cloud_sig_rp, std::vector<int> &pad_phibin, std::vector<double> &pad_phibin_share);
   void populate_tbins(const double t, const std::array<double, 2> &cloud_sig_tt, std::vector<int> &adc_tbin, std::vector<double> &adc_tbin_share);
 
   double check_phi(const unsigned int side, const double phi, const double radius);
 
+  //! fill the pad response, erf and Polya tables
+  void build_lookup_tables();
+
+  //! fraction of a gaussian charge cloud of width sigma, centered at x_loc from the pad center, seen by a pad of half width pitch
+  double pad_response(const unsigned int layer, const double x_loc, const double pitch, const double sigma) const;
+
+  //! erf, from the table if lookup tables are used
+  double tpc_erf(const double x) const;
+
+  //! Polya distributed gain with average q_bar, inverse CDF sampling from the tables
+  double getSingleEGEMAmplificationPolyaTable(const double q_bar);
+
   PHG4TpcCylinderGeomContainer *GeomContainer = nullptr;
   PHG4TpcCylinderGeom *LayerGeom = nullptr;
 
@@ -102,6 +124,23 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   bool m_useLangau = false;
   std::string m_tpc_langau_pars_file = "";
 
+  //!@name lookup tables, used with SetUseLookupTables(true)
+  //@{
+  bool m_useLookupTables = false;
+
+  //! pad response per layer as a function of |x_loc| / sigmaT, with the pitch of that layer
+  std::vector<std::vector<float>> m_pad_response_table;
+
+  //! erf on [0, erf_table_max]
+  std::vector<double> m_erf_table;
+
+  //! Polya CDF as a function of gain / average gain
+  std::vector<double> m_polya_cdf_table;
+
+  //! inverse of the Polya CDF, gain / average gain on a uniform grid in probability
+  std::vector<double> m_polya_icdf_table;
+  //@}
+
   gsl_rng *RandomGenerator = nullptr;
 
   std::array<TH2 *, 2> h_gain{nullptr};
@@ -0,0 +1,130 @@
+#include "TpcHitAccumulator.h"
+
+#include <trackbase/TpcDefs.h>
+#include <trackbase/TrkrHit.h>
+#include <trackbase/TrkrHitSet.h>
+#include <trackbase/TrkrHitSetContainer.h>
+#include <trackbase/TrkrHitSetv2.h>
+#include <trackbase/TrkrHitTruthAssoc.h>
+#include <trackbase/TrkrHitv2.h>
+
+#include <algorithm>
+#include <climits>
+
+//_________________________________________________________
+void TpcHitAccumulator::addEnergy(unsigned int layer, unsigned int sector, unsigned int side,
+                                  unsigned int pads_per_sector, unsigned int ntbins,
+                                  unsigned int pad, unsigned int tbin, double energy)
+{
+  if (sector >= NSectors || side >= NSides || tbin >= ntbins || pads_per_sector == 0)
+  {
+    return;
+  }
+
+  const unsigned int ibuffer = index(layer, sector, side);
+  if (ibuffer >= m_hitsets.size())
+  {
+    m_hitsets.resize(ibuffer + 1);
+  }
+
+  auto& buffer = m_hitsets[ibuffer];
+  if (buffer.cells.empty())
+  {
+    // first contribution in this event, (re)allocate if needed
+    if (buffer.npads != pads_per_sector || buffer.ntbins != ntbins)
+    {
+      buffer.hitsetkey = TpcDefs::genHitSetKey(layer, sector, side);
+      buffer.pad_start = sector * pads_per_sector;
+      buffer.npads = pads_per_sector;
+      buffer.ntbins = ntbins;
+      const std::size_t ncells = static_cast<std::size_t>(pads_per_sector) * ntbins;
+      buffer.adc.assign(ncells, 0);
+      buffer.touched.assign((ncells + 63) / 64, 0);
+    }
+    m_active.push_back(ibuffer);
+  }
+
+  const unsigned int cell = (pad - buffer.pad_start) * ntbins + tbin;
+  const uint64_t bit = uint64_t(1) << (cell % 64);
+  if (!(buffer.touched[cell / 64] & bit))
+  {
+    buffer.touched[cell / 64] |= bit;
+    buffer.cells.push_back(cell);
+  }
+
+  // same as TrkrHitv2::addEnergy
+  auto& adc = buffer.adc[cell];
+  const double ein = energy * TrkrDefs::EdepScaleFactor;
+  if ((double) adc + ein > (double) USHRT_MAX)
+  {
+    adc = USHRT_MAX;
+  }
+  else
+  {
+    adc += (unsigned short) (ein);
+  }
+
+  m_g4hit_cells.emplace_back(buffer.hitsetkey, TpcDefs::genHitKey(pad, tbin));
+}
+
+//_________________________________________________________
+void TpcHitAccumulator::endG4Hit(PHG4HitDefs::keytype g4hitkey)
+{
+  // one association per g4hit and cell, ordered as the hits in the hitset container
+  std::sort(m_g4hit_cells.begin(), m_g4hit_cells.end());
+  m_g4hit_cells.erase(std::unique(m_g4hit_cells.begin(), m_g4hit_cells.end()), m_g4hit_cells.end());
+  for (const auto& [hitsetkey, hitkey] : m_g4hit_cells)
+  {
+    m_assoc.push_back({hitsetkey, hitkey, g4hitkey});
+  }
+  m_g4hit_cells.clear();
+}
+
+//_________________________________________________________
+void TpcHitAccumulator::emit(TrkrHitSetContainer* hitsetcontainer, TrkrHitTruthAssoc* hittruthassoc)
+{
+  std::sort(m_active.begin(), m_active.end());
+  for (const auto& ibuffer : m_active)
+  {
+    auto& buffer = m_hitsets[ibuffer];
+    std::sort(buffer.cells.begin(), buffer.cells.end());
+
+    auto hitsetit = hitsetcontainer->findOrAddHitSet(buffer.hitsetkey);
+    auto flat = dynamic_cast<TrkrHitSetv2*>(hitsetit->second);
+    for (const auto& cell : buffer.cells)
+    {
+      const unsigned int pad = buffer.pad_start + cell / buffer.ntbins;
+      const unsigned int tbin = cell % buffer.ntbins;
+      const TrkrDefs::hitkey hitkey = TpcDefs::genHitKey(pad, tbin);
+
+      if (flat)
+      {
+        flat->addEnergy(hitkey, (double) buffer.adc[cell] / TrkrDefs::EdepScaleFactor);
+      }
+      else
+      {
+        TrkrHit* hit = hitsetit->second->getHit(hitkey);
+        if (!hit)
+        {
+          hit = hitsetit->second->addHitSpecificKey(hitkey, new TrkrHitv2)->second;
+        }
+        hit->addEnergy((double) buffer.adc[cell] / TrkrDefs::EdepScaleFactor);
+      }
+
+      buffer.adc[cell] = 0;
+      buffer.touched[cell / 64] = 0;
+    }
+    buffer.cells.clear();
+  }
+  m_active.clear();
+
+  if (hittruthassoc)
+  {
+    for (const auto& assoc : m_assoc)
+    {
+      hittruthassoc->addAssoc(assoc.hitsetkey, assoc.hitkey, assoc.g4hitkey);
+    }
+  }
+  m_assoc.clear();
+  m_g4hit_cells.clear();
+}
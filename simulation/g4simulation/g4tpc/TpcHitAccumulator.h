@@ -0,0 +1,94 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4TPC_TPCHITACCUMULATOR_H
+#define G4TPC_TPCHITACCUMULATOR_H
+
+#include <trackbase/TrkrDefs.h>
+
+#include <g4main/PHG4HitDefs.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class TrkrHitSetContainer;
+class TrkrHitTruthAssoc;
+
+//! dense accumulation buffer for the TPC pad plane readout
+/*!
+ * The charge of each pad and time bin is summed in place, in one (pad, tbin) adc array
+ * per layer, sector and side, instead of looking up a TrkrHit in a TrkrHitSetContainer
+ * for every contribution. The arrays are allocated the first time a hitset is touched
+ * and kept from one event to the next.
+ *
+ * Contributions are truncated and saturated as in TrkrHitv2::addEnergy, so that the emitted hits
+ * have the same adc as when they are added one by one to the hitset container.
+ * The pad and time bins touched by each g4hit are recorded, and added to the truth association
+ * together with the hits, once per event.
+ */
+class TpcHitAccumulator
+{
+ public:
+  //! add the energy of one pad and time bin contribution
+  /*!
+   * pad is the pad index in the layer, pads_per_sector and ntbins the size of the hitset,
+   * used when the hitset is first touched. Contributions outside of the hitset are ignored
+   */
+  void addEnergy(unsigned int layer, unsigned int sector, unsigned int side,
+                 unsigned int pads_per_sector, unsigned int ntbins,
+                 unsigned int pad, unsigned int tbin, double energy);
+
+  //! associate the pad and time bins touched since the last call to given g4hit
+  void endG4Hit(PHG4HitDefs::keytype g4hitkey);
+
+  //! add the accumulated hits to the hitset container and the truth association, then reset
+  void emit(TrkrHitSetContainer* hitsetcontainer, TrkrHitTruthAssoc* hittruthassoc);
+
+ private:
+  //! adc of one TPC hitset
+  struct HitSetBuffer
+  {
+    TrkrDefs::hitsetkey hitsetkey = TrkrDefs::HITSETKEYMAX;
+    unsigned int pad_start = 0;
+    unsigned int npads = 0;
+    unsigned int ntbins = 0;
+
+    //! adc, same range as TrkrHitv2, indexed by local pad * ntbins + tbin
+    std::vector<unsigned short> adc;
+
+    //! one bit per cell, set if the cell was touched in this event
+    std::vector<uint64_t> touched;
+
+    //! touched cells, in the order they were first touched
+    std::vector<unsigned int> cells;
+  };
+
+  //! buffer index for given layer, sector and side
+  static unsigned int index(unsigned int layer, unsigned int sector, unsigned int side)
+  {
+    return (layer * NSides + side) * NSectors + sector;
+  }
+
+  static constexpr unsigned int NSides = 2;
+  static constexpr unsigned int NSectors = 12;
+
+  //! one buffer per layer, side and sector
+  std::vector<HitSetBuffer> m_hitsets;
+
+  //! buffers touched in this event
+  std::vector<unsigned int> m_active;
+
+  //! (hitsetkey, hitkey) touched since the last call to endG4Hit
+  std::vector<std::pair<TrkrDefs::hitsetkey, TrkrDefs::hitkey>> m_g4hit_cells;
+
+  //! truth association recorded in this event
+  struct Assoc
+  {
+    TrkrDefs::hitsetkey hitsetkey;
+    TrkrDefs::hitkey hitkey;
+    PHG4HitDefs::keytype g4hitkey;
+  };
+  std::vector<Assoc> m_assoc;
+};
+
+#endif  // G4TPC_TPCHITACCUMULATOR_H
@@ -0,0 +1,71 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4TPC_TPCPHILOXRANDOM_H
+#define G4TPC_TPCPHILOXRANDOM_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+//! counter based random numbers (Philox4x32-10, Salmon et al., SC11)
+/*!
+ * The generator has no state besides its key. Each call maps a 128 bit counter
+ * to four independent 32 bit random numbers, so the random numbers used for a given
+ * object (e.g. one drifted electron) only depend on the key and on the counter
+ * chosen for that object, not on the order in which objects are processed.
+ */
+class TpcPhiloxRandom
+{
+ public:
+  using Block = std::array<uint32_t, 4>;
+
+  TpcPhiloxRandom() = default;
+
+  explicit TpcPhiloxRandom(const uint64_t key)
+    : m_key{static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32U)}
+  {
+  }
+
+  //! four random numbers for counter (c0, c1, c23)
+  Block operator()(const uint32_t c0, const uint32_t c1, const uint64_t c23) const
+  {
+    Block ctr{c0, c1, static_cast<uint32_t>(c23), static_cast<uint32_t>(c23 >> 32U)};
+    uint32_t k0 = m_key[0];
+    uint32_t k1 = m_key[1];
+    for (int round = 0; round < 10; ++round)
+    {
+      const uint64_t p0 = static_cast<uint64_t>(M0) * ctr[0];
+      const uint64_t p1 = static_cast<uint64_t>(M1) * ctr[2];
+      ctr = {static_cast<uint32_t>(p1 >> 32U) ^ ctr[1] ^ k0, static_cast<uint32_t>(p1),
+             static_cast<uint32_t>(p0 >> 32U) ^ ctr[3] ^ k1, static_cast<uint32_t>(p0)};
+      k0 += W0;
+      k1 += W1;
+    }
+    return ctr;
+  }
+
+  //! uniform in (0, 1), never 0 or 1
+  static double uniform(const uint32_t x)
+  {
+    return (x + 0.5) * (1. / 4294967296.);
+  }
+
+  //! two unit gaussians from two random numbers (Box-Muller)
+  static void gaussian_pair(const uint32_t x1, const uint32_t x2, double &g1, double &g2)
+  {
+    const double r = std::sqrt(-2. * std::log(uniform(x1)));
+    const double phi = 2. * M_PI * uniform(x2);
+    g1 = r * std::cos(phi);
+    g2 = r * std::sin(phi);
+  }
+
+ private:
+  static constexpr uint32_t M0 = 0xD2511F53;
+  static constexpr uint32_t M1 = 0xCD9E8D57;
+  static constexpr uint32_t W0 = 0x9E3779B9;
+  static constexpr uint32_t W1 = 0xBB67AE85;
+
+  std::array<uint32_t, 2> m_key{};
+};
+
+#endif